@@ -92,6 +92,8 @@
         'event_tracer.h',
         'exp_filter.cc',
         'exp_filter.h',
+        'fakeclock.cc',
+        'fakeclock.h',
         'logging.cc',
         'logging.h',
         'md5.cc',
@@ -209,4 +209,29 @@ TEST(ByteBufferTest, TestReadWriteBuffer) {
   }
 }
 
+// Test that a cleared buffer keeps its storage, so that it can be reused for
+// many messages without reallocating.
+TEST(ByteBufferTest, TestReuseAfterClear) {
+  ByteBuffer buffer;
+  std::string payload(5000, 'a');
+  buffer.WriteString(payload);
+  const size_t capacity = buffer.Capacity();
+  EXPECT_LE(payload.size(), capacity);
+
+  for (int i = 0; i < 3; ++i) {
+    buffer.Clear();
+    EXPECT_EQ(0U, buffer.Length());
+    EXPECT_EQ(capacity, buffer.Capacity());
+    buffer.WriteUInt16(static_cast<uint16_t>(i));
+    buffer.WriteString(payload);
+    EXPECT_EQ(capacity, buffer.Capacity());
+    uint16_t value;
+    std::string read_payload;
+    EXPECT_TRUE(buffer.ReadUInt16(&value));
+    EXPECT_EQ(i, value);
+    EXPECT_TRUE(buffer.ReadString(&read_payload, payload.size()));
+    EXPECT_EQ(payload, read_payload);
+  }
+}
+
 }  // namespace rtc
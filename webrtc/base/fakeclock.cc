@@ -0,0 +1,41 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/fakeclock.h"
+
+#include "webrtc/base/checks.h"
+
+namespace rtc {
+
+uint64_t FakeClock::TimeNanos() const {
+  CritScope cs(&lock_);
+  return time_nanos_;
+}
+
+void FakeClock::SetTimeNanos(uint64_t nanos) {
+  CritScope cs(&lock_);
+  RTC_DCHECK(nanos >= time_nanos_);
+  time_nanos_ = nanos;
+}
+
+void FakeClock::AdvanceTimeNanos(uint64_t nanos) {
+  CritScope cs(&lock_);
+  time_nanos_ += nanos;
+}
+
+ScopedFakeClock::ScopedFakeClock() {
+  prev_clock_ = SetClockForTesting(this);
+}
+
+ScopedFakeClock::~ScopedFakeClock() {
+  SetClockForTesting(prev_clock_);
+}
+
+}  // namespace rtc
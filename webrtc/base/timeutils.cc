@@ -34,7 +34,15 @@ namespace rtc {
 
 const uint32_t HALF = 0x80000000;
 
-uint64_t TimeNanos() {
+static ClockInterface* g_clock = nullptr;
+
+ClockInterface* SetClockForTesting(ClockInterface* clock) {
+  ClockInterface* prev = g_clock;
+  g_clock = clock;
+  return prev;
+}
+
+uint64_t SystemTimeNanos() {
   int64_t ticks = 0;
 #if defined(WEBRTC_MAC)
   static mach_timebase_info_data_t timebase;
@@ -78,6 +86,13 @@ uint64_t TimeNanos() {
   return ticks;
 }
 
+uint64_t TimeNanos() {
+  if (g_clock) {
+    return g_clock->TimeNanos();
+  }
+  return SystemTimeNanos();
+}
+
 uint32_t Time() {
   return static_cast<uint32_t>(TimeNanos() / kNumNanosecsPerMillisec);
 }
@@ -34,6 +34,27 @@ static const int64_t kJan1970AsNtpMillisecs = INT64_C(2208988800000);
 
 typedef uint32_t TimeStamp;
 
+// Interface for a source of monotonic time, in nanoseconds. The functions
+// below normally read the system clock, but tests can substitute their own
+// clock with SetClockForTesting(); see fakeclock.h.
+class ClockInterface {
+ public:
+  virtual ~ClockInterface() {}
+  virtual uint64_t TimeNanos() const = 0;
+};
+
+// Sets the global source of time used by Time(), TimeMicros() and
+// TimeNanos(). Passing null restores the system clock. Returns the previously
+// set clock, or null if the system clock was in use.
+//
+// Not thread safe; should only be called while no other thread is reading the
+// time, e.g. at the start and end of a test.
+ClockInterface* SetClockForTesting(ClockInterface* clock);
+
+// Returns the actual system time, even if a clock is set for testing.
+// Useful for timeouts that should not depend on simulated time.
+uint64_t SystemTimeNanos();
+
 // Returns the current time in milliseconds.
 uint32_t Time();
 // Returns the current time in microseconds.
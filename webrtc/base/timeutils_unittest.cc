@@ -9,6 +9,7 @@
  */
 
 #include "webrtc/base/common.h"
+#include "webrtc/base/fakeclock.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/helpers.h"
 #include "webrtc/base/thread.h"
@@ -262,4 +263,42 @@ TEST_F(TmToSeconds, TestTmToSeconds) {
   TestTmToSeconds(100000);
 }
 
+// Test that all functions in timeutils.h read the clock set for testing, and
+// that the system clock is used again once it is unset.
+TEST(FakeClock, TimeFunctionsUseFakeClock) {
+  FakeClock clock;
+  ClockInterface* prev_clock = SetClockForTesting(&clock);
+  EXPECT_EQ(nullptr, prev_clock);
+
+  clock.SetTimeNanos(987654321u);
+  EXPECT_EQ(987u, Time());
+  EXPECT_EQ(987654u, TimeMicros());
+  EXPECT_EQ(987654321u, TimeNanos());
+  EXPECT_EQ(1000u, TimeAfter(13));
+
+  clock.AdvanceTimeMillis(1000);
+  EXPECT_EQ(1987u, Time());
+  EXPECT_EQ(1987654321u, TimeNanos());
+
+  SetClockForTesting(prev_clock);
+  // The system clock is monotonic and unrelated to the fake time.
+  uint64_t system_time = SystemTimeNanos();
+  EXPECT_NE(1987654321u, TimeNanos());
+  EXPECT_LE(system_time, TimeNanos());
+}
+
+TEST(FakeClock, ScopedFakeClockRestoresPreviousClock) {
+  FakeClock outer;
+  ClockInterface* prev_clock = SetClockForTesting(&outer);
+  outer.SetTimeNanos(kNumNanosecsPerSec);
+  {
+    ScopedFakeClock inner;
+    EXPECT_EQ(0u, Time());
+    inner.AdvanceTimeMillis(5);
+    EXPECT_EQ(5u, Time());
+  }
+  EXPECT_EQ(1000u, Time());
+  SetClockForTesting(prev_clock);
+}
+
 }  // namespace rtc
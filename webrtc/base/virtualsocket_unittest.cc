@@ -15,6 +15,7 @@
 #endif
 
 #include "webrtc/base/arraysize.h"
+#include "webrtc/base/fakeclock.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/testclient.h"
@@ -909,6 +910,33 @@ TEST_F(VirtualSocketServerTest, delay_v4) {
   DelayTest(kIPv4AnyAddress);
 }
 
+// Same as delay_v4, but in virtual time: the fake clock, not the wall clock,
+// advances through the ten seconds of simulated traffic.
+TEST_F(VirtualSocketServerTest, delay_v4_virtual_time) {
+  ScopedFakeClock clock;
+  clock.SetTimeNanos(kNumNanosecsPerSec);
+  ss_->set_fake_clock(&clock);
+  DelayTest(kIPv4AnyAddress);
+  EXPECT_LE(11000u, Time());
+  ss_->set_fake_clock(NULL);
+}
+
+// A wake-up, as sent by another thread posting a message, ends a virtual-time
+// wait at the current time instead of at the end of the timeout.
+TEST_F(VirtualSocketServerTest, VirtualTimeWaitStopsAtWakeUp) {
+  ScopedFakeClock clock;
+  clock.SetTimeNanos(kNumNanosecsPerSec);
+  ss_->set_fake_clock(&clock);
+  uint32_t start = Time();
+  ss_->WakeUp();
+  EXPECT_TRUE(ss_->Wait(1000, true));
+  EXPECT_EQ(start, Time());
+  // The wake-up has been consumed, so the next wait runs to its timeout.
+  EXPECT_TRUE(ss_->Wait(1000, true));
+  EXPECT_EQ(start + 1000, Time());
+  ss_->set_fake_clock(NULL);
+}
+
 // See: https://code.google.com/p/webrtc/issues/detail?id=2409
 TEST_F(VirtualSocketServerTest, DISABLED_delay_v6) {
   DelayTest(kIPv6AnyAddress);
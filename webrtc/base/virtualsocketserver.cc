@@ -17,8 +17,10 @@
 #include <map>
 #include <vector>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/common.h"
+#include "webrtc/base/fakeclock.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/physicalsocketserver.h"
 #include "webrtc/base/socketaddresspair.h"
@@ -508,7 +510,8 @@ VirtualSocketServer::VirtualSocketServer(SocketServer* ss)
       send_buffer_capacity_(kDefaultTcpBufferSize),
       recv_buffer_capacity_(kDefaultTcpBufferSize),
       delay_mean_(0), delay_stddev_(0), delay_samples_(NUM_SAMPLES),
-      delay_dist_(NULL), drop_prob_(0.0) {
+      delay_dist_(NULL), drop_prob_(0.0), fake_clock_(NULL),
+      wakeup_pending_(0) {
   if (!server_) {
     server_ = new PhysicalSocketServer();
     server_owned_ = true;
@@ -578,15 +581,37 @@ void VirtualSocketServer::SetMessageQueue(MessageQueue* msg_queue) {
   }
 }
 
+void VirtualSocketServer::set_fake_clock(FakeClock* fake_clock) {
+  fake_clock_ = fake_clock;
+  // Packets are never scheduled earlier than |network_delay_|, which may have
+  // been taken from a different clock.
+  network_delay_ = Time();
+}
+
 bool VirtualSocketServer::Wait(int cmsWait, bool process_io) {
   ASSERT(msg_queue_ == Thread::Current());
   if (stop_on_idle_ && Thread::Current()->empty()) {
     return false;
   }
+  if (fake_clock_ && cmsWait != kForever) {
+    // |cmsWait| is at most the time until the next delayed message is due.
+    // Poll the real server so that wake-ups and messages from other threads
+    // are still noticed. If there was one, the wait ends now; otherwise jump
+    // straight to that point in time.
+    if (!socketserver()->Wait(0, process_io)) {
+      return false;
+    }
+    bool woken_up = AtomicOps::CompareAndSwap(&wakeup_pending_, 1, 0) == 1;
+    if (!woken_up && cmsWait > 0) {
+      fake_clock_->AdvanceTimeMillis(cmsWait);
+    }
+    return true;
+  }
   return socketserver()->Wait(cmsWait, process_io);
 }
 
 void VirtualSocketServer::WakeUp() {
+  AtomicOps::ReleaseStore(&wakeup_pending_, 1);
   socketserver()->WakeUp();
 }
 
@@ -21,6 +21,7 @@
 
 namespace rtc {
 
+class FakeClock;
 class Packet;
 class VirtualSocket;
 class SocketAddressPair;
@@ -89,6 +90,18 @@ class VirtualSocketServer : public SocketServer, public sigslot::has_slots<> {
     drop_prob_ = drop_prob;
   }
 
+  // Switches the server to virtual time. Instead of blocking, Wait() then
+  // advances |fake_clock| to the next scheduled event (e.g. the delivery of a
+  // delayed packet), so simulated network delays cost no wall-clock time and
+  // runs are reproducible. The clock should be installed as the global clock,
+  // see ScopedFakeClock, and must outlive the server. Pass null to go back to
+  // real time. Virtual time only advances while the thread running this
+  // server waits, so it is meant for simulations driven from that thread.
+  // A wake-up from another thread, e.g. a posted message, ends the wait
+  // without advancing the clock.
+  void set_fake_clock(FakeClock* fake_clock);
+  FakeClock* fake_clock() const { return fake_clock_; }
+
   // SocketFactory:
   Socket* CreateSocket(int type) override;
   Socket* CreateSocket(int family, int type) override;
@@ -247,6 +260,9 @@ class VirtualSocketServer : public SocketServer, public sigslot::has_slots<> {
   CriticalSection delay_crit_;
 
   double drop_prob_;
+  FakeClock* fake_clock_;
+  // Set by WakeUp() and cleared by a virtual-time Wait().
+  volatile int wakeup_pending_;
   RTC_DISALLOW_COPY_AND_ASSIGN(VirtualSocketServer);
 };
 
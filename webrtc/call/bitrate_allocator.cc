@@ -24,8 +24,13 @@ const int kTransmissionMaxBitrateMultiplier = 2;
 const int kDefaultBitrateBps = 300000;
 
 BitrateAllocator::BitrateAllocator()
-    : crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+    : notification_crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
       bitrate_observers_(),
+      next_observer_id_(0),
+      sum_min_bitrates_(0),
+      sum_max_bitrates_(0),
+      allocated_bitrate_sum_(0),
       bitrate_observers_modified_(false),
       enforce_min_bitrate_(true),
       last_bitrate_bps_(kDefaultBitrateBps),
@@ -35,160 +40,201 @@ BitrateAllocator::BitrateAllocator()
 uint32_t BitrateAllocator::OnNetworkChanged(uint32_t bitrate,
                                             uint8_t fraction_loss,
                                             int64_t rtt) {
-  CriticalSectionScoped lock(crit_sect_.get());
-  last_bitrate_bps_ = bitrate;
-  last_fraction_loss_ = fraction_loss;
-  last_rtt_ = rtt;
-  uint32_t allocated_bitrate_bps = 0;
-  ObserverBitrateMap allocation = AllocateBitrates();
-  for (const auto& kv : allocation) {
-    kv.first->OnNetworkChanged(kv.second, last_fraction_loss_, last_rtt_);
-    allocated_bitrate_bps += kv.second;
+  CriticalSectionScoped notification_lock(notification_crit_sect_.get());
+  ObserverList observers;
+  uint32_t allocated_bitrate_bps;
+  {
+    CriticalSectionScoped lock(crit_sect_.get());
+    if (!bitrate_observers_modified_ && bitrate == last_bitrate_bps_ &&
+        fraction_loss == last_fraction_loss_ && rtt == last_rtt_) {
+      // Same input, same allocation.
+      return allocated_bitrate_sum_;
+    }
+    last_bitrate_bps_ = bitrate;
+    last_fraction_loss_ = fraction_loss;
+    last_rtt_ = rtt;
+    observers = AllocateBitrates();
+    allocated_bitrate_bps = allocated_bitrate_sum_;
   }
+  NotifyObservers(observers);
   return allocated_bitrate_bps;
 }
 
-BitrateAllocator::ObserverBitrateMap BitrateAllocator::AllocateBitrates() {
+BitrateAllocator::ObserverList BitrateAllocator::AllocateBitrates() {
+  bitrate_observers_modified_ = false;
+  allocated_bitrate_sum_ = 0;
   if (bitrate_observers_.empty())
-    return ObserverBitrateMap();
+    return ObserverList();
 
-  uint32_t sum_min_bitrates = 0;
-  for (const auto& observer : bitrate_observers_)
-    sum_min_bitrates += observer.second.min_bitrate;
-  if (last_bitrate_bps_ <= sum_min_bitrates)
-    return LowRateAllocation(last_bitrate_bps_);
+  if (last_bitrate_bps_ <= sum_min_bitrates_)
+    LowRateAllocation(last_bitrate_bps_);
   else
-    return NormalRateAllocation(last_bitrate_bps_, sum_min_bitrates);
+    NormalRateAllocation(last_bitrate_bps_);
+
+  // Only tell the observers about what has changed for them.
+  ObserverList observers;
+  for (const auto& config : bitrate_observers_) {
+    allocated_bitrate_sum_ += config.allocated_bitrate;
+    if (NeedsNotification(config))
+      observers.push_back(config.observer);
+  }
+  return observers;
+}
+
+bool BitrateAllocator::NeedsNotification(
+    const ObserverConfiguration& config) const {
+  return config.notified_bitrate != config.allocated_bitrate ||
+         config.notified_fraction_loss != last_fraction_loss_ ||
+         config.notified_rtt != last_rtt_;
+}
+
+void BitrateAllocator::NotifyObservers(const ObserverList& observers) {
+  for (BitrateObserver* observer : observers) {
+    uint32_t bitrate;
+    uint8_t fraction_loss;
+    int64_t rtt;
+    {
+      // The allocation is read when it is delivered rather than when it was
+      // computed: an observer may have been removed, or been given a newer
+      // allocation, by a callback made earlier in this loop.
+      CriticalSectionScoped lock(crit_sect_.get());
+      auto index_it = bitrate_observer_index_.find(observer);
+      if (index_it == bitrate_observer_index_.end())
+        continue;
+      ObserverConfiguration& config = *index_it->second;
+      if (!NeedsNotification(config))
+        continue;
+      bitrate = config.allocated_bitrate;
+      fraction_loss = last_fraction_loss_;
+      rtt = last_rtt_;
+      config.notified_bitrate = bitrate;
+      config.notified_fraction_loss = fraction_loss;
+      config.notified_rtt = rtt;
+    }
+    observer->OnNetworkChanged(bitrate, fraction_loss, rtt);
+  }
 }
 
 int BitrateAllocator::AddBitrateObserver(BitrateObserver* observer,
                                          uint32_t min_bitrate_bps,
                                          uint32_t max_bitrate_bps) {
-  CriticalSectionScoped lock(crit_sect_.get());
-
-  BitrateObserverConfList::iterator it =
-      FindObserverConfigurationPair(observer);
-
-  // Allow the max bitrate to be exceeded for FEC and retransmissions.
-  // TODO(holmer): We have to get rid of this hack as it makes it difficult to
-  // properly allocate bitrate. The allocator should instead distribute any
-  // extra bitrate after all streams have maxed out.
-  max_bitrate_bps *= kTransmissionMaxBitrateMultiplier;
-  if (it != bitrate_observers_.end()) {
-    // Update current configuration.
-    it->second.min_bitrate = min_bitrate_bps;
-    it->second.max_bitrate = max_bitrate_bps;
-  } else {
-    // Add new settings.
-    bitrate_observers_.push_back(BitrateObserverConfiguration(
-        observer, BitrateConfiguration(min_bitrate_bps, max_bitrate_bps)));
+  CriticalSectionScoped notification_lock(notification_crit_sect_.get());
+  ObserverList observers;
+  int new_observer_bitrate_bps;
+  {
+    CriticalSectionScoped lock(crit_sect_.get());
+
+    // Allow the max bitrate to be exceeded for FEC and retransmissions.
+    // TODO(holmer): We have to get rid of this hack as it makes it difficult
+    // to properly allocate bitrate. The allocator should instead distribute
+    // any extra bitrate after all streams have maxed out.
+    max_bitrate_bps *= kTransmissionMaxBitrateMultiplier;
+
+    ObserverConfiguration* config;
+    auto index_it = bitrate_observer_index_.find(observer);
+    if (index_it != bitrate_observer_index_.end()) {
+      // Update current configuration.
+      config = &*index_it->second;
+      RemoveFromSortingMap(*config);
+      config->min_bitrate = min_bitrate_bps;
+      config->max_bitrate = max_bitrate_bps;
+    } else {
+      // Add new settings.
+      bitrate_observers_.push_back(ObserverConfiguration(
+          observer, next_observer_id_++, min_bitrate_bps, max_bitrate_bps));
+      bitrate_observer_index_[observer] = --bitrate_observers_.end();
+      config = &bitrate_observers_.back();
+    }
+    AddToSortingMap(config);
     bitrate_observers_modified_ = true;
-  }
 
-  ObserverBitrateMap allocation = AllocateBitrates();
-  int new_observer_bitrate_bps = 0;
-  for (auto& kv : allocation) {
-    kv.first->OnNetworkChanged(kv.second, last_fraction_loss_, last_rtt_);
-    if (kv.first == observer)
-      new_observer_bitrate_bps = kv.second;
+    observers = AllocateBitrates();
+    new_observer_bitrate_bps = config->allocated_bitrate;
   }
+  NotifyObservers(observers);
   return new_observer_bitrate_bps;
 }
 
 void BitrateAllocator::RemoveBitrateObserver(BitrateObserver* observer) {
+  // Wait for any notification in progress, it may be for |observer|. Doesn't
+  // block if called from within a callback, since the lock is recursive.
+  CriticalSectionScoped notification_lock(notification_crit_sect_.get());
   CriticalSectionScoped lock(crit_sect_.get());
-  BitrateObserverConfList::iterator it =
-      FindObserverConfigurationPair(observer);
-  if (it != bitrate_observers_.end()) {
-    bitrate_observers_.erase(it);
+  auto index_it = bitrate_observer_index_.find(observer);
+  if (index_it != bitrate_observer_index_.end()) {
+    RemoveFromSortingMap(*index_it->second);
+    bitrate_observers_.erase(index_it->second);
+    bitrate_observer_index_.erase(index_it);
     bitrate_observers_modified_ = true;
   }
 }
 
 void BitrateAllocator::GetMinMaxBitrateSumBps(int* min_bitrate_sum_bps,
                                               int* max_bitrate_sum_bps) const {
-  *min_bitrate_sum_bps = 0;
-  *max_bitrate_sum_bps = 0;
-
   CriticalSectionScoped lock(crit_sect_.get());
-  for (const auto& observer : bitrate_observers_) {
-    *min_bitrate_sum_bps += observer.second.min_bitrate;
-    *max_bitrate_sum_bps += observer.second.max_bitrate;
-  }
+  *min_bitrate_sum_bps = static_cast<int>(sum_min_bitrates_);
+  *max_bitrate_sum_bps = static_cast<int>(sum_max_bitrates_);
 }
 
-BitrateAllocator::BitrateObserverConfList::iterator
-BitrateAllocator::FindObserverConfigurationPair(
-    const BitrateObserver* observer) {
-  for (auto it = bitrate_observers_.begin(); it != bitrate_observers_.end();
-       ++it) {
-    if (it->first == observer)
-      return it;
-  }
-  return bitrate_observers_.end();
+void BitrateAllocator::AddToSortingMap(ObserverConfiguration* config) {
+  observers_by_max_bitrate_[std::make_pair(config->max_bitrate, config->id)] =
+      config;
+  sum_min_bitrates_ += config->min_bitrate;
+  sum_max_bitrates_ += config->max_bitrate;
+}
+
+void BitrateAllocator::RemoveFromSortingMap(
+    const ObserverConfiguration& config) {
+  observers_by_max_bitrate_.erase(
+      std::make_pair(config.max_bitrate, config.id));
+  sum_min_bitrates_ -= config.min_bitrate;
+  sum_max_bitrates_ -= config.max_bitrate;
 }
 
 void BitrateAllocator::EnforceMinBitrate(bool enforce_min_bitrate) {
   CriticalSectionScoped lock(crit_sect_.get());
   enforce_min_bitrate_ = enforce_min_bitrate;
+  bitrate_observers_modified_ = true;
 }
 
-BitrateAllocator::ObserverBitrateMap BitrateAllocator::NormalRateAllocation(
-    uint32_t bitrate,
-    uint32_t sum_min_bitrates) {
+void BitrateAllocator::NormalRateAllocation(uint32_t bitrate) {
   uint32_t number_of_observers =
       static_cast<uint32_t>(bitrate_observers_.size());
   uint32_t bitrate_per_observer =
-      (bitrate - sum_min_bitrates) / number_of_observers;
-  // Use map to sort list based on max bitrate.
-  ObserverSortingMap list_max_bitrates;
-  for (const auto& observer : bitrate_observers_) {
-    list_max_bitrates.insert(std::pair<uint32_t, ObserverConfiguration>(
-        observer.second.max_bitrate,
-        ObserverConfiguration(observer.first, observer.second.min_bitrate)));
-  }
-  ObserverBitrateMap allocation;
-  ObserverSortingMap::iterator max_it = list_max_bitrates.begin();
-  while (max_it != list_max_bitrates.end()) {
+      (bitrate - sum_min_bitrates_) / number_of_observers;
+  // Go through the observers in order of increasing max bitrate.
+  for (const auto& kv : observers_by_max_bitrate_) {
+    ObserverConfiguration* config = kv.second;
     number_of_observers--;
-    uint32_t observer_allowance =
-        max_it->second.min_bitrate + bitrate_per_observer;
-    if (max_it->first < observer_allowance) {
+    uint32_t observer_allowance = config->min_bitrate + bitrate_per_observer;
+    if (config->max_bitrate < observer_allowance) {
       // We have more than enough for this observer.
       // Carry the remainder forward.
-      uint32_t remainder = observer_allowance - max_it->first;
+      uint32_t remainder = observer_allowance - config->max_bitrate;
       if (number_of_observers != 0) {
         bitrate_per_observer += remainder / number_of_observers;
       }
-      allocation[max_it->second.observer] = max_it->first;
+      config->allocated_bitrate = config->max_bitrate;
     } else {
-      allocation[max_it->second.observer] = observer_allowance;
+      config->allocated_bitrate = observer_allowance;
     }
-    list_max_bitrates.erase(max_it);
-    // Prepare next iteration.
-    max_it = list_max_bitrates.begin();
   }
-  return allocation;
 }
 
-BitrateAllocator::ObserverBitrateMap BitrateAllocator::LowRateAllocation(
-    uint32_t bitrate) {
-  ObserverBitrateMap allocation;
+void BitrateAllocator::LowRateAllocation(uint32_t bitrate) {
   if (enforce_min_bitrate_) {
     // Min bitrate to all observers.
-    for (const auto& observer : bitrate_observers_)
-      allocation[observer.first] = observer.second.min_bitrate;
+    for (auto& config : bitrate_observers_)
+      config.allocated_bitrate = config.min_bitrate;
   } else {
     // Allocate up to |min_bitrate| to one observer at a time, until
     // |bitrate| is depleted.
     uint32_t remainder = bitrate;
-    for (const auto& observer : bitrate_observers_) {
-      uint32_t allocated_bitrate =
-          std::min(remainder, observer.second.min_bitrate);
-      allocation[observer.first] = allocated_bitrate;
+    for (auto& config : bitrate_observers_) {
+      uint32_t allocated_bitrate = std::min(remainder, config.min_bitrate);
+      config.allocated_bitrate = allocated_bitrate;
       remainder -= allocated_bitrate;
     }
   }
-  return allocation;
 }
 }  // namespace webrtc
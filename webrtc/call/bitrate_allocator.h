@@ -18,6 +18,7 @@
 #include <list>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/thread_annotations.h"
@@ -27,6 +28,12 @@ namespace webrtc {
 
 class BitrateObserver;
 
+// Observers are kept both in insertion order and ordered by max bitrate, and
+// the sums of their min and max bitrates are maintained as they come and go,
+// so adding, updating or removing one is O(log n) and a reallocation is a
+// single O(n) pass without sorting or allocating. Observers are only notified
+// when their allocation, the fraction loss or the rtt has changed, and never
+// while |crit_sect_| is held, so they may call back into the allocator.
 class BitrateAllocator {
  public:
   BitrateAllocator();
@@ -48,6 +55,9 @@ class BitrateAllocator {
                          uint32_t min_bitrate_bps,
                          uint32_t max_bitrate_bps);
 
+  // Once this returns, |observer| will not be called again. Waits for a
+  // notification in progress on another thread, so it must not be called
+  // from a thread that a callback is waiting for.
   void RemoveBitrateObserver(BitrateObserver* observer);
 
   void GetMinMaxBitrateSumBps(int* min_bitrate_sum_bps,
@@ -61,37 +71,72 @@ class BitrateAllocator {
   void EnforceMinBitrate(bool enforce_min_bitrate);
 
  private:
-  struct BitrateConfiguration {
-    BitrateConfiguration(uint32_t min_bitrate, uint32_t max_bitrate)
-        : min_bitrate(min_bitrate), max_bitrate(max_bitrate) {}
-    uint32_t min_bitrate;
-    uint32_t max_bitrate;
-  };
   struct ObserverConfiguration {
-    ObserverConfiguration(BitrateObserver* observer, uint32_t bitrate)
-        : observer(observer), min_bitrate(bitrate) {}
+    ObserverConfiguration(BitrateObserver* observer,
+                          int id,
+                          uint32_t min_bitrate,
+                          uint32_t max_bitrate)
+        : observer(observer),
+          id(id),
+          min_bitrate(min_bitrate),
+          max_bitrate(max_bitrate),
+          allocated_bitrate(0),
+          notified_bitrate(-1),
+          notified_fraction_loss(0),
+          notified_rtt(0) {}
     BitrateObserver* const observer;
+    // Insertion order, used to break ties between equal max bitrates.
+    const int id;
     uint32_t min_bitrate;
+    uint32_t max_bitrate;
+    uint32_t allocated_bitrate;
+    // Last values |observer| was told about, -1 for the bitrate if none.
+    int64_t notified_bitrate;
+    uint8_t notified_fraction_loss;
+    int64_t notified_rtt;
   };
-  typedef std::pair<BitrateObserver*, BitrateConfiguration>
-      BitrateObserverConfiguration;
-  typedef std::list<BitrateObserverConfiguration> BitrateObserverConfList;
-  typedef std::multimap<uint32_t, ObserverConfiguration> ObserverSortingMap;
-  typedef std::map<BitrateObserver*, int> ObserverBitrateMap;
-
-  BitrateObserverConfList::iterator FindObserverConfigurationPair(
-      const BitrateObserver* observer) EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
-  ObserverBitrateMap AllocateBitrates() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
-  ObserverBitrateMap NormalRateAllocation(uint32_t bitrate,
-                                          uint32_t sum_min_bitrates)
+  typedef std::list<ObserverConfiguration> ObserverConfList;
+  typedef std::map<const BitrateObserver*, ObserverConfList::iterator>
+      ObserverConfIndex;
+  // Keyed on max bitrate and id.
+  typedef std::map<std::pair<uint32_t, int>, ObserverConfiguration*>
+      ObserverSortingMap;
+  typedef std::vector<BitrateObserver*> ObserverList;
+
+  void AddToSortingMap(ObserverConfiguration* config)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+  void RemoveFromSortingMap(const ObserverConfiguration& config)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
 
-  ObserverBitrateMap LowRateAllocation(uint32_t bitrate)
+  // Updates |allocated_bitrate| of all observers and returns the ones that
+  // have to be notified.
+  ObserverList AllocateBitrates() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+  bool NeedsNotification(const ObserverConfiguration& config) const
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+  void NormalRateAllocation(uint32_t bitrate)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+  void LowRateAllocation(uint32_t bitrate)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+
+  // Tells |observers| about their current allocation, unless they have been
+  // removed or already know about it. Takes |crit_sect_| itself.
+  void NotifyObservers(const ObserverList& observers)
+      EXCLUSIVE_LOCKS_REQUIRED(notification_crit_sect_);
 
+  // Held while computing and delivering a new allocation, so that an
+  // observer is not called after RemoveBitrateObserver() has returned.
+  // Recursive, so observers can add or remove observers from their callback.
+  // Taken before |crit_sect_|.
+  rtc::scoped_ptr<CriticalSectionWrapper> notification_crit_sect_;
   rtc::scoped_ptr<CriticalSectionWrapper> crit_sect_;
   // Stored in a list to keep track of the insertion order.
-  BitrateObserverConfList bitrate_observers_ GUARDED_BY(crit_sect_);
+  ObserverConfList bitrate_observers_ GUARDED_BY(crit_sect_);
+  ObserverConfIndex bitrate_observer_index_ GUARDED_BY(crit_sect_);
+  ObserverSortingMap observers_by_max_bitrate_ GUARDED_BY(crit_sect_);
+  int next_observer_id_ GUARDED_BY(crit_sect_);
+  uint32_t sum_min_bitrates_ GUARDED_BY(crit_sect_);
+  uint32_t sum_max_bitrates_ GUARDED_BY(crit_sect_);
+  uint32_t allocated_bitrate_sum_ GUARDED_BY(crit_sect_);
   bool bitrate_observers_modified_ GUARDED_BY(crit_sect_);
   bool enforce_min_bitrate_ GUARDED_BY(crit_sect_);
   uint32_t last_bitrate_bps_ GUARDED_BY(crit_sect_);
@@ -12,6 +12,8 @@
 #include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/call/bitrate_allocator.h"
 #include "webrtc/modules/bitrate_controller/include/bitrate_controller.h"
 
@@ -20,7 +22,7 @@ namespace webrtc {
 class TestBitrateObserver : public BitrateObserver {
  public:
   TestBitrateObserver()
-      : last_bitrate_(0), last_fraction_loss_(0), last_rtt_(0) {}
+      : last_bitrate_(0), last_fraction_loss_(0), last_rtt_(0), num_calls_(0) {}
 
   virtual void OnNetworkChanged(uint32_t bitrate,
                                 uint8_t fraction_loss,
@@ -28,10 +30,42 @@ class TestBitrateObserver : public BitrateObserver {
     last_bitrate_ = bitrate;
     last_fraction_loss_ = fraction_loss;
     last_rtt_ = rtt;
+    ++num_calls_;
   }
   uint32_t last_bitrate_;
   uint8_t last_fraction_loss_;
   int64_t last_rtt_;
+  int num_calls_;
+};
+
+// Calls back into the allocator the first time it is notified after being
+// armed.
+class ReentrantBitrateObserver : public TestBitrateObserver {
+ public:
+  explicit ReentrantBitrateObserver(BitrateAllocator* allocator)
+      : allocator_(allocator), observer_to_remove_(nullptr), new_bitrate_(0) {}
+
+  void OnNetworkChanged(uint32_t bitrate,
+                        uint8_t fraction_loss,
+                        int64_t rtt) override {
+    TestBitrateObserver::OnNetworkChanged(bitrate, fraction_loss, rtt);
+    if (observer_to_remove_) {
+      BitrateObserver* observer = observer_to_remove_;
+      observer_to_remove_ = nullptr;
+      allocator_->RemoveBitrateObserver(observer);
+    }
+    if (new_bitrate_ > 0) {
+      uint32_t new_bitrate = new_bitrate_;
+      new_bitrate_ = 0;
+      allocator_->OnNetworkChanged(new_bitrate, fraction_loss, rtt);
+    }
+  }
+
+  BitrateObserver* observer_to_remove_;
+  uint32_t new_bitrate_;
+
+ private:
+  BitrateAllocator* const allocator_;
 };
 
 class BitrateAllocatorTest : public ::testing::Test {
@@ -100,6 +134,140 @@ TEST_F(BitrateAllocatorTest, TwoBitrateObserversOneRtcpObserver) {
   EXPECT_EQ(600000u, bitrate_observer_2.last_bitrate_);
 }
 
+TEST_F(BitrateAllocatorTest, OnlyNotifiesObserversOfChanges) {
+  TestBitrateObserver bitrate_observer_1;
+  TestBitrateObserver bitrate_observer_2;
+  allocator_->AddBitrateObserver(&bitrate_observer_1, 100000, 200000);
+  allocator_->AddBitrateObserver(&bitrate_observer_2, 100000, 1000000);
+  allocator_->OnNetworkChanged(1000000, 0, 50);
+  EXPECT_EQ(400000u, bitrate_observer_1.last_bitrate_);
+  EXPECT_EQ(600000u, bitrate_observer_2.last_bitrate_);
+  int num_calls_1 = bitrate_observer_1.num_calls_;
+  int num_calls_2 = bitrate_observer_2.num_calls_;
+
+  // Nothing changed.
+  EXPECT_EQ(1000000u, allocator_->OnNetworkChanged(1000000, 0, 50));
+  EXPECT_EQ(num_calls_1, bitrate_observer_1.num_calls_);
+  EXPECT_EQ(num_calls_2, bitrate_observer_2.num_calls_);
+
+  // The first observer stays capped at twice its max bitrate.
+  EXPECT_EQ(1100000u, allocator_->OnNetworkChanged(1100000, 0, 50));
+  EXPECT_EQ(num_calls_1, bitrate_observer_1.num_calls_);
+  EXPECT_EQ(num_calls_2 + 1, bitrate_observer_2.num_calls_);
+  EXPECT_EQ(700000u, bitrate_observer_2.last_bitrate_);
+
+  // A new rtt is passed on to everyone.
+  allocator_->OnNetworkChanged(1100000, 0, 100);
+  EXPECT_EQ(num_calls_1 + 1, bitrate_observer_1.num_calls_);
+  EXPECT_EQ(num_calls_2 + 2, bitrate_observer_2.num_calls_);
+  EXPECT_EQ(100, bitrate_observer_1.last_rtt_);
+  EXPECT_EQ(100, bitrate_observer_2.last_rtt_);
+
+  // Removing an observer reallocates on the next update.
+  allocator_->RemoveBitrateObserver(&bitrate_observer_1);
+  allocator_->OnNetworkChanged(1100000, 0, 100);
+  EXPECT_EQ(num_calls_1 + 1, bitrate_observer_1.num_calls_);
+  EXPECT_EQ(1100000u, bitrate_observer_2.last_bitrate_);
+
+  allocator_->RemoveBitrateObserver(&bitrate_observer_2);
+}
+
+TEST_F(BitrateAllocatorTest, MinMaxBitrateSums) {
+  TestBitrateObserver bitrate_observer_1;
+  TestBitrateObserver bitrate_observer_2;
+  int min_sum_bps;
+  int max_sum_bps;
+  allocator_->GetMinMaxBitrateSumBps(&min_sum_bps, &max_sum_bps);
+  EXPECT_EQ(0, min_sum_bps);
+  EXPECT_EQ(0, max_sum_bps);
+
+  allocator_->AddBitrateObserver(&bitrate_observer_1, 100000, 300000);
+  allocator_->AddBitrateObserver(&bitrate_observer_2, 200000, 400000);
+  allocator_->GetMinMaxBitrateSumBps(&min_sum_bps, &max_sum_bps);
+  EXPECT_EQ(300000, min_sum_bps);
+  EXPECT_EQ(1400000, max_sum_bps);
+
+  allocator_->AddBitrateObserver(&bitrate_observer_1, 50000, 100000);
+  allocator_->GetMinMaxBitrateSumBps(&min_sum_bps, &max_sum_bps);
+  EXPECT_EQ(250000, min_sum_bps);
+  EXPECT_EQ(1000000, max_sum_bps);
+
+  allocator_->RemoveBitrateObserver(&bitrate_observer_2);
+  allocator_->GetMinMaxBitrateSumBps(&min_sum_bps, &max_sum_bps);
+  EXPECT_EQ(50000, min_sum_bps);
+  EXPECT_EQ(200000, max_sum_bps);
+
+  allocator_->RemoveBitrateObserver(&bitrate_observer_1);
+}
+
+TEST_F(BitrateAllocatorTest, ObserverRemovedFromCallbackIsNotCalled) {
+  ReentrantBitrateObserver bitrate_observer_1(allocator_.get());
+  TestBitrateObserver bitrate_observer_2;
+  allocator_->AddBitrateObserver(&bitrate_observer_1, 100000, 1500000);
+  allocator_->AddBitrateObserver(&bitrate_observer_2, 100000, 1500000);
+  const int num_calls_2 = bitrate_observer_2.num_calls_;
+
+  // |bitrate_observer_2| is due a new allocation, but is removed before it
+  // gets its turn.
+  bitrate_observer_1.observer_to_remove_ = &bitrate_observer_2;
+  allocator_->OnNetworkChanged(600000, 0, 0);
+  EXPECT_EQ(300000u, bitrate_observer_1.last_bitrate_);
+  EXPECT_EQ(num_calls_2, bitrate_observer_2.num_calls_);
+
+  // It can also remove itself.
+  bitrate_observer_1.observer_to_remove_ = &bitrate_observer_1;
+  allocator_->OnNetworkChanged(200000, 0, 0);
+  const int num_calls_1 = bitrate_observer_1.num_calls_;
+  allocator_->OnNetworkChanged(400000, 0, 0);
+  EXPECT_EQ(num_calls_1, bitrate_observer_1.num_calls_);
+}
+
+TEST_F(BitrateAllocatorTest, AllocationFromCallbackIsNotOverwritten) {
+  ReentrantBitrateObserver bitrate_observer_1(allocator_.get());
+  TestBitrateObserver bitrate_observer_2;
+  allocator_->AddBitrateObserver(&bitrate_observer_1, 100000, 1500000);
+  allocator_->AddBitrateObserver(&bitrate_observer_2, 100000, 1500000);
+  const int num_calls_2 = bitrate_observer_2.num_calls_;
+
+  // The estimate changes again while the first observer is being told about
+  // the previous one. The second observer only hears about the newest.
+  bitrate_observer_1.new_bitrate_ = 600000;
+  allocator_->OnNetworkChanged(400000, 0, 0);
+  EXPECT_EQ(300000u, bitrate_observer_1.last_bitrate_);
+  EXPECT_EQ(300000u, bitrate_observer_2.last_bitrate_);
+  EXPECT_EQ(num_calls_2 + 1, bitrate_observer_2.num_calls_);
+
+  allocator_->RemoveBitrateObserver(&bitrate_observer_1);
+  allocator_->RemoveBitrateObserver(&bitrate_observer_2);
+}
+
+// Logs the cost of reallocating among many send streams as the bandwidth
+// estimate moves. It only measures time, so it is disabled by default.
+TEST_F(BitrateAllocatorTest, DISABLED_AllocationCostWith100Observers) {
+  const int kNumObservers = 100;
+  const int kNumUpdates = 10000;
+  std::vector<TestBitrateObserver> observers(kNumObservers);
+  for (int i = 0; i < kNumObservers; ++i) {
+    allocator_->AddBitrateObserver(&observers[i], 30000 + 1000 * i,
+                                   500000 + 10000 * (i % 10));
+  }
+  uint64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumUpdates; ++i) {
+    // Sweep the estimate between 5 and 55 Mbps, crossing the sum of min
+    // bitrates.
+    allocator_->OnNetworkChanged(5000000 + 5000 * (i % 10000), 0, 50);
+  }
+  uint64_t elapsed_us = rtc::TimeMicros() - start_us;
+  LOG(LS_INFO) << "Bitrate allocation among " << kNumObservers
+               << " observers: "
+               << static_cast<double>(elapsed_us) / kNumUpdates
+               << " us per update.";
+  EXPECT_LT(0, observers[0].num_calls_);
+
+  for (auto& observer : observers)
+    allocator_->RemoveBitrateObserver(&observer);
+}
+
 class BitrateAllocatorTestNoEnforceMin : public ::testing::Test {
  protected:
   BitrateAllocatorTestNoEnforceMin() : allocator_(new BitrateAllocator()) {
@@ -10,25 +10,161 @@
 
 #include "webrtc/common_audio/include/audio_util.h"
 
+#include "webrtc/base/atomicops.h"
+#include "webrtc/common_audio/audio_util_avx2.h"
+#include "webrtc/common_audio/audio_util_sse2.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 
-void FloatToS16(const float* src, size_t size, int16_t* dest) {
+namespace {
+
+void FloatToS16_C(const float* src, size_t size, int16_t* dest) {
   for (size_t i = 0; i < size; ++i)
     dest[i] = FloatToS16(src[i]);
 }
 
-void S16ToFloat(const int16_t* src, size_t size, float* dest) {
+void S16ToFloat_C(const int16_t* src, size_t size, float* dest) {
   for (size_t i = 0; i < size; ++i)
     dest[i] = S16ToFloat(src[i]);
 }
 
-void FloatS16ToS16(const float* src, size_t size, int16_t* dest) {
+void FloatS16ToS16_C(const float* src, size_t size, int16_t* dest) {
   for (size_t i = 0; i < size; ++i)
     dest[i] = FloatS16ToS16(src[i]);
 }
 
+template <typename T>
+void DeinterleaveStereo_C(const T* interleaved,
+                          size_t samples_per_channel,
+                          T* left,
+                          T* right) {
+  T* const deinterleaved[] = {left, right};
+  DeinterleaveImpl(interleaved, samples_per_channel, 2, deinterleaved);
+}
+
+template <typename T>
+void InterleaveStereo_C(const T* left,
+                        const T* right,
+                        size_t samples_per_channel,
+                        T* interleaved) {
+  const T* const deinterleaved[] = {left, right};
+  InterleaveImpl(deinterleaved, samples_per_channel, 2, interleaved);
+}
+
+void DownmixStereoToMono_C(const int16_t* left,
+                           const int16_t* right,
+                           size_t num_frames,
+                           int16_t* out) {
+  const int16_t* const input_channels[] = {left, right};
+  DownmixToMonoImpl<int16_t, int32_t>(input_channels, num_frames, 2, out);
+}
+
+void DownmixInterleavedStereoToMono_C(const int16_t* interleaved,
+                                      size_t num_frames,
+                                      int16_t* out) {
+  DownmixInterleavedToMonoImpl<int16_t, int32_t>(interleaved, num_frames, 2,
+                                                 out);
+}
+
+// The loops that have SIMD versions, for one instruction set.
+struct Kernels {
+  void (*float_to_s16)(const float*, size_t, int16_t*);
+  void (*s16_to_float)(const int16_t*, size_t, float*);
+  void (*float_s16_to_s16)(const float*, size_t, int16_t*);
+  void (*deinterleave_stereo_s16)(const int16_t*, size_t, int16_t*, int16_t*);
+  void (*deinterleave_stereo_float)(const float*, size_t, float*, float*);
+  void (*interleave_stereo_s16)(const int16_t*, const int16_t*, size_t,
+                                int16_t*);
+  void (*interleave_stereo_float)(const float*, const float*, size_t, float*);
+  void (*downmix_stereo_s16)(const int16_t*, const int16_t*, size_t,
+                             int16_t*);
+  void (*downmix_interleaved_stereo_s16)(const int16_t*, size_t, int16_t*);
+};
+
+const Kernels kKernelsC = {
+    FloatToS16_C,
+    S16ToFloat_C,
+    FloatS16ToS16_C,
+    DeinterleaveStereo_C<int16_t>,
+    DeinterleaveStereo_C<float>,
+    InterleaveStereo_C<int16_t>,
+    InterleaveStereo_C<float>,
+    DownmixStereoToMono_C,
+    DownmixInterleavedStereoToMono_C,
+};
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+const Kernels kKernelsSSE2 = {
+    FloatToS16_SSE2,
+    S16ToFloat_SSE2,
+    FloatS16ToS16_SSE2,
+    DeinterleaveStereo_SSE2,
+    DeinterleaveStereo_SSE2,
+    InterleaveStereo_SSE2,
+    InterleaveStereo_SSE2,
+    DownmixStereoToMono_SSE2,
+    DownmixInterleavedStereoToMono_SSE2,
+};
+
+const Kernels kKernelsAVX2 = {
+    FloatToS16_AVX2,
+    S16ToFloat_AVX2,
+    FloatS16ToS16_AVX2,
+    DeinterleaveStereo_SSE2,
+    DeinterleaveStereo_SSE2,
+    InterleaveStereo_SSE2,
+    InterleaveStereo_SSE2,
+    DownmixStereoToMono_SSE2,
+    DownmixInterleavedStereoToMono_SSE2,
+};
+#endif
+
+const Kernels* DetectKernels() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2))
+    return &kKernelsAVX2;
+#if defined(__SSE2__)
+  return &kKernelsSSE2;
+#else
+  return WebRtc_GetCPUInfo(kSSE2) ? &kKernelsSSE2 : &kKernelsC;
+#endif
+#else
+  // There are no NEON kernels yet, since none could be run on ARM.
+  return &kKernelsC;
+#endif
+}
+
+const Kernels* volatile g_kernels = nullptr;
+
+// These run on every 10 ms frame of every stream, so the CPU is detected once
+// rather than on each call.
+const Kernels* GetKernels() {
+  const Kernels* kernels = rtc::AtomicOps::AtomicLoadPtr(&g_kernels);
+  if (!kernels) {
+    // Threads racing here all detect the same kernels.
+    kernels = DetectKernels();
+    rtc::AtomicOps::CompareAndSwapPtr(
+        &g_kernels, static_cast<const Kernels*>(nullptr), kernels);
+  }
+  return kernels;
+}
+
+}  // namespace
+
+void FloatToS16(const float* src, size_t size, int16_t* dest) {
+  GetKernels()->float_to_s16(src, size, dest);
+}
+
+void S16ToFloat(const int16_t* src, size_t size, float* dest) {
+  GetKernels()->s16_to_float(src, size, dest);
+}
+
+void FloatS16ToS16(const float* src, size_t size, int16_t* dest) {
+  GetKernels()->float_s16_to_s16(src, size, dest);
+}
+
 void FloatToFloatS16(const float* src, size_t size, float* dest) {
   for (size_t i = 0; i < size; ++i)
     dest[i] = FloatToFloatS16(src[i]);
@@ -39,11 +175,86 @@ void FloatS16ToFloat(const float* src, size_t size, float* dest) {
     dest[i] = FloatS16ToFloat(src[i]);
 }
 
+template <>
+void Deinterleave<int16_t>(const int16_t* interleaved,
+                           size_t samples_per_channel,
+                           int num_channels,
+                           int16_t* const* deinterleaved) {
+  if (num_channels == 2) {
+    GetKernels()->deinterleave_stereo_s16(interleaved, samples_per_channel,
+                                          deinterleaved[0], deinterleaved[1]);
+    return;
+  }
+  DeinterleaveImpl(interleaved, samples_per_channel, num_channels,
+                   deinterleaved);
+}
+
+template <>
+void Deinterleave<float>(const float* interleaved,
+                         size_t samples_per_channel,
+                         int num_channels,
+                         float* const* deinterleaved) {
+  if (num_channels == 2) {
+    GetKernels()->deinterleave_stereo_float(interleaved, samples_per_channel,
+                                            deinterleaved[0], deinterleaved[1]);
+    return;
+  }
+  DeinterleaveImpl(interleaved, samples_per_channel, num_channels,
+                   deinterleaved);
+}
+
+template <>
+void Interleave<int16_t>(const int16_t* const* deinterleaved,
+                         size_t samples_per_channel,
+                         int num_channels,
+                         int16_t* interleaved) {
+  if (num_channels == 2) {
+    GetKernels()->interleave_stereo_s16(deinterleaved[0], deinterleaved[1],
+                                        samples_per_channel, interleaved);
+    return;
+  }
+  InterleaveImpl(deinterleaved, samples_per_channel, num_channels,
+                 interleaved);
+}
+
+template <>
+void Interleave<float>(const float* const* deinterleaved,
+                       size_t samples_per_channel,
+                       int num_channels,
+                       float* interleaved) {
+  if (num_channels == 2) {
+    GetKernels()->interleave_stereo_float(deinterleaved[0], deinterleaved[1],
+                                          samples_per_channel, interleaved);
+    return;
+  }
+  InterleaveImpl(deinterleaved, samples_per_channel, num_channels,
+                 interleaved);
+}
+
+template <>
+void DownmixToMono<int16_t, int32_t>(const int16_t* const* input_channels,
+                                     size_t num_frames,
+                                     int num_channels,
+                                     int16_t* out) {
+  if (num_channels == 2) {
+    GetKernels()->downmix_stereo_s16(input_channels[0], input_channels[1],
+                                     num_frames, out);
+    return;
+  }
+  DownmixToMonoImpl<int16_t, int32_t>(input_channels, num_frames,
+                                      num_channels, out);
+}
+
 template <>
 void DownmixInterleavedToMono<int16_t>(const int16_t* interleaved,
                                        size_t num_frames,
                                        int num_channels,
                                        int16_t* deinterleaved) {
+  if (num_channels == 2) {
+    GetKernels()->downmix_interleaved_stereo_s16(interleaved, num_frames,
+                                                 deinterleaved);
+    return;
+  }
   DownmixInterleavedToMonoImpl<int16_t, int32_t>(interleaved, num_frames,
                                                  num_channels, deinterleaved);
 }
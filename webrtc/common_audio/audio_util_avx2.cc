@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/audio_util_avx2.h"
+
+#include <immintrin.h>
+
+#include "webrtc/common_audio/include/audio_util.h"
+
+namespace webrtc {
+
+namespace {
+
+// Same rounding as FloatToS16(float), with the result left in 32-bit lanes.
+inline __m256i FloatToS32(__m256 v) {
+  v = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(-1.f)),
+                    _mm256_set1_ps(1.f));
+  const __m256 positive =
+      _mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_GT_OQ);
+  const __m256 scale =
+      _mm256_blendv_ps(_mm256_set1_ps(-limits_int16::min()),
+                       _mm256_set1_ps(limits_int16::max()), positive);
+  const __m256 offset = _mm256_blendv_ps(_mm256_set1_ps(-0.5f),
+                                         _mm256_set1_ps(0.5f), positive);
+  return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v, scale), offset));
+}
+
+// Same rounding as FloatS16ToS16(float), with the result left in 32-bit
+// lanes.
+inline __m256i FloatS16ToS32(__m256 v) {
+  v = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(limits_int16::min())),
+                    _mm256_set1_ps(limits_int16::max()));
+  const __m256 offset =
+      _mm256_blendv_ps(_mm256_set1_ps(-0.5f), _mm256_set1_ps(0.5f),
+                       _mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_GT_OQ));
+  return _mm256_cvttps_epi32(_mm256_add_ps(v, offset));
+}
+
+// Saturates eight 32-bit lanes to S16 and stores them.
+inline void StoreS32AsS16(int16_t* dest, __m256i v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                   _mm_packs_epi32(_mm256_castsi256_si128(v),
+                                   _mm256_extracti128_si256(v, 1)));
+}
+
+}  // namespace
+
+void FloatToS16_AVX2(const float* src, size_t size, int16_t* dest) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+    StoreS32AsS16(dest + i, FloatToS32(_mm256_loadu_ps(src + i)));
+  for (; i < size; ++i)
+    dest[i] = FloatToS16(src[i]);
+}
+
+void S16ToFloat_AVX2(const int16_t* src, size_t size, float* dest) {
+  const __m256 kMaxInverse = _mm256_set1_ps(1.f / limits_int16::max());
+  const __m256 kMinInverse = _mm256_set1_ps(-1.f / limits_int16::min());
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m256i v = _mm256_cvtepi16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    const __m256 positive = _mm256_castsi256_ps(
+        _mm256_cmpgt_epi32(v, _mm256_setzero_si256()));
+    _mm256_storeu_ps(
+        dest + i,
+        _mm256_mul_ps(_mm256_cvtepi32_ps(v),
+                      _mm256_blendv_ps(kMinInverse, kMaxInverse, positive)));
+  }
+  for (; i < size; ++i)
+    dest[i] = S16ToFloat(src[i]);
+}
+
+void FloatS16ToS16_AVX2(const float* src, size_t size, int16_t* dest) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+    StoreS32AsS16(dest + i, FloatS16ToS32(_mm256_loadu_ps(src + i)));
+  for (; i < size; ++i)
+    dest[i] = FloatS16ToS16(src[i]);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,28 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_AUDIO_UTIL_AVX2_H_
+#define WEBRTC_COMMON_AUDIO_AUDIO_UTIL_AVX2_H_
+
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// AVX2 versions of the audio_util.h conversions. The stereo shuffles gain
+// nothing from the wider registers over SSE2 and have no AVX2 version.
+void FloatToS16_AVX2(const float* src, size_t size, int16_t* dest);
+void S16ToFloat_AVX2(const int16_t* src, size_t size, float* dest);
+void FloatS16ToS16_AVX2(const float* src, size_t size, int16_t* dest);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_AUDIO_UTIL_AVX2_H_
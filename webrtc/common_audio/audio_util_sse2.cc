@@ -0,0 +1,219 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/audio_util_sse2.h"
+
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/include/audio_util.h"
+
+namespace webrtc {
+
+namespace {
+
+inline __m128 Select(__m128 mask, __m128 if_true, __m128 if_false) {
+  return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+}
+
+// Sign extends the low or high four samples of |v| to 32 bits.
+inline __m128i S16LowToS32(__m128i v) {
+  return _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+}
+
+inline __m128i S16HighToS32(__m128i v) {
+  return _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+}
+
+// Same rounding as FloatToS16(float), with the result left in 32-bit lanes.
+inline __m128i FloatToS32(__m128 v) {
+  v = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-1.f)), _mm_set1_ps(1.f));
+  const __m128 positive = _mm_cmpgt_ps(v, _mm_setzero_ps());
+  const __m128 scale = Select(positive, _mm_set1_ps(limits_int16::max()),
+                              _mm_set1_ps(-limits_int16::min()));
+  const __m128 offset =
+      Select(positive, _mm_set1_ps(0.5f), _mm_set1_ps(-0.5f));
+  return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), offset));
+}
+
+inline __m128 S32ToFloat(__m128i v) {
+  const __m128 positive =
+      _mm_castsi128_ps(_mm_cmpgt_epi32(v, _mm_setzero_si128()));
+  const __m128 scale = Select(positive, _mm_set1_ps(1.f / limits_int16::max()),
+                              _mm_set1_ps(-1.f / limits_int16::min()));
+  return _mm_mul_ps(_mm_cvtepi32_ps(v), scale);
+}
+
+// Same rounding as FloatS16ToS16(float), with the result left in 32-bit
+// lanes.
+inline __m128i FloatS16ToS32(__m128 v) {
+  v = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(limits_int16::min())),
+                 _mm_set1_ps(limits_int16::max()));
+  const __m128 offset = Select(_mm_cmpgt_ps(v, _mm_setzero_ps()),
+                               _mm_set1_ps(0.5f), _mm_set1_ps(-0.5f));
+  return _mm_cvttps_epi32(_mm_add_ps(v, offset));
+}
+
+// Halves |sum| rounding toward zero, like dividing by two does. Adding the
+// sign bit first makes the arithmetic shift round negative sums up.
+inline __m128i HalveS32(__m128i sum) {
+  return _mm_srai_epi32(_mm_add_epi32(sum, _mm_srli_epi32(sum, 31)), 1);
+}
+
+inline __m128i LoadS16(const int16_t* src) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+inline void StoreS16(int16_t* dest, __m128i v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), v);
+}
+
+}  // namespace
+
+void FloatToS16_SSE2(const float* src, size_t size, int16_t* dest) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    StoreS16(dest + i, _mm_packs_epi32(FloatToS32(_mm_loadu_ps(src + i)),
+                                       FloatToS32(_mm_loadu_ps(src + i + 4))));
+  }
+  for (; i < size; ++i)
+    dest[i] = FloatToS16(src[i]);
+}
+
+void S16ToFloat_SSE2(const int16_t* src, size_t size, float* dest) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m128i v = LoadS16(src + i);
+    _mm_storeu_ps(dest + i, S32ToFloat(S16LowToS32(v)));
+    _mm_storeu_ps(dest + i + 4, S32ToFloat(S16HighToS32(v)));
+  }
+  for (; i < size; ++i)
+    dest[i] = S16ToFloat(src[i]);
+}
+
+void FloatS16ToS16_SSE2(const float* src, size_t size, int16_t* dest) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    StoreS16(dest + i,
+             _mm_packs_epi32(FloatS16ToS32(_mm_loadu_ps(src + i)),
+                             FloatS16ToS32(_mm_loadu_ps(src + i + 4))));
+  }
+  for (; i < size; ++i)
+    dest[i] = FloatS16ToS16(src[i]);
+}
+
+void DeinterleaveStereo_SSE2(const int16_t* interleaved,
+                             size_t samples_per_channel,
+                             int16_t* left,
+                             int16_t* right) {
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    // Each 32-bit lane holds a left sample in its low half and a right sample
+    // in its high half.
+    const __m128i a = LoadS16(interleaved + 2 * i);
+    const __m128i b = LoadS16(interleaved + 2 * i + 8);
+    StoreS16(left + i,
+             _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                             _mm_srai_epi32(_mm_slli_epi32(b, 16), 16)));
+    StoreS16(right + i,
+             _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16)));
+  }
+  for (; i < samples_per_channel; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+void DeinterleaveStereo_SSE2(const float* interleaved,
+                             size_t samples_per_channel,
+                             float* left,
+                             float* right) {
+  size_t i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4) {
+    const __m128 a = _mm_loadu_ps(interleaved + 2 * i);
+    const __m128 b = _mm_loadu_ps(interleaved + 2 * i + 4);
+    _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  for (; i < samples_per_channel; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+void InterleaveStereo_SSE2(const int16_t* left,
+                           const int16_t* right,
+                           size_t samples_per_channel,
+                           int16_t* interleaved) {
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    const __m128i l = LoadS16(left + i);
+    const __m128i r = LoadS16(right + i);
+    StoreS16(interleaved + 2 * i, _mm_unpacklo_epi16(l, r));
+    StoreS16(interleaved + 2 * i + 8, _mm_unpackhi_epi16(l, r));
+  }
+  for (; i < samples_per_channel; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+void InterleaveStereo_SSE2(const float* left,
+                           const float* right,
+                           size_t samples_per_channel,
+                           float* interleaved) {
+  size_t i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4) {
+    const __m128 l = _mm_loadu_ps(left + i);
+    const __m128 r = _mm_loadu_ps(right + i);
+    _mm_storeu_ps(interleaved + 2 * i, _mm_unpacklo_ps(l, r));
+    _mm_storeu_ps(interleaved + 2 * i + 4, _mm_unpackhi_ps(l, r));
+  }
+  for (; i < samples_per_channel; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+void DownmixStereoToMono_SSE2(const int16_t* left,
+                              const int16_t* right,
+                              size_t num_frames,
+                              int16_t* out) {
+  size_t i = 0;
+  for (; i + 8 <= num_frames; i += 8) {
+    const __m128i l = LoadS16(left + i);
+    const __m128i r = LoadS16(right + i);
+    const __m128i low =
+        HalveS32(_mm_add_epi32(S16LowToS32(l), S16LowToS32(r)));
+    const __m128i high =
+        HalveS32(_mm_add_epi32(S16HighToS32(l), S16HighToS32(r)));
+    StoreS16(out + i, _mm_packs_epi32(low, high));
+  }
+  for (; i < num_frames; ++i)
+    out[i] = (static_cast<int32_t>(left[i]) + right[i]) / 2;
+}
+
+void DownmixInterleavedStereoToMono_SSE2(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* out) {
+  const __m128i kOnes = _mm_set1_epi16(1);
+  size_t i = 0;
+  for (; i + 8 <= num_frames; i += 8) {
+    // Multiplying by one and adding pairs sums each frame into 32 bits.
+    const __m128i a = _mm_madd_epi16(LoadS16(interleaved + 2 * i), kOnes);
+    const __m128i b = _mm_madd_epi16(LoadS16(interleaved + 2 * i + 8), kOnes);
+    StoreS16(out + i, _mm_packs_epi32(HalveS32(a), HalveS32(b)));
+  }
+  for (; i < num_frames; ++i) {
+    out[i] = (static_cast<int32_t>(interleaved[2 * i]) +
+              interleaved[2 * i + 1]) / 2;
+  }
+}
+
+}  // namespace webrtc
@@ -8,9 +8,16 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/arraysize.h"
+#include "webrtc/common_audio/audio_util_avx2.h"
+#include "webrtc/common_audio/audio_util_sse2.h"
 #include "webrtc/common_audio/include/audio_util.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/include/tick_util.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -227,5 +234,313 @@ TEST(AudioUtilTest, DownmixToMonoTest) {
   }
 }
 
+
+// Lengths around the SIMD widths, and 10 ms at 8 to 48 kHz, mono and stereo.
+const size_t kLengths[] = {1, 3, 4, 7, 8, 9, 15, 16, 17, 31,
+                           80, 160, 320, 441, 480, 882, 960};
+const size_t kMaxLength = 960;
+
+// Samples spanning the whole int16_t range, in a scrambled order.
+int16_t ScrambledS16(size_t i) {
+  return static_cast<int16_t>(static_cast<int>((i * 7919 + 12345) % 65536) -
+                              32768);
+}
+
+void FillS16(int16_t* data, size_t length) {
+  for (size_t i = 0; i < length; ++i)
+    data[i] = ScrambledS16(i);
+}
+
+// Samples spanning slightly more than [-|max|, |max|], starting with
+// |special| values that are rounded or clipped at the edges.
+void FillFloat(float* data,
+               size_t length,
+               float max,
+               const float* special,
+               size_t num_special) {
+  for (size_t i = 0; i < length; ++i) {
+    data[i] =
+        i < num_special ? special[i] : ScrambledS16(i) * 1.1f * max / 32768;
+  }
+}
+
+typedef void (*FloatToS16Function)(const float*, size_t, int16_t*);
+typedef void (*S16ToFloatFunction)(const int16_t*, size_t, float*);
+
+void ExpectConversionsMatchScalar(FloatToS16Function float_to_s16,
+                                  S16ToFloatFunction s16_to_float,
+                                  FloatToS16Function float_s16_to_s16) {
+  const float kSpecialFloat[] = {0.f, 1.f, -1.f, 1.1f, -1.1f,
+                                 0.4f / 32767.f, 0.6f / 32767.f,
+                                 -0.4f / 32768.f, -0.6f / 32768.f};
+  const float kSpecialFloatS16[] = {0.f, 32767.f, -32768.f, 32766.5f,
+                                    -32767.5f, 0.5f, -0.5f, 1e9f, -1e9f};
+  for (size_t length : kLengths) {
+    SCOPED_TRACE(length);
+    float float_input[kMaxLength];
+    int16_t s16_input[kMaxLength];
+    int16_t s16_output[kMaxLength];
+    int16_t s16_reference[kMaxLength];
+    float float_output[kMaxLength];
+    float float_reference[kMaxLength];
+
+    FillFloat(float_input, length, 1.f, kSpecialFloat,
+              arraysize(kSpecialFloat));
+    float_to_s16(float_input, length, s16_output);
+    for (size_t i = 0; i < length; ++i)
+      s16_reference[i] = FloatToS16(float_input[i]);
+    ExpectArraysEq(s16_reference, s16_output, length);
+
+    FillS16(s16_input, length);
+    s16_to_float(s16_input, length, float_output);
+    for (size_t i = 0; i < length; ++i)
+      float_reference[i] = S16ToFloat(s16_input[i]);
+    ExpectArraysEq(float_reference, float_output, length);
+
+    FillFloat(float_input, length, 32768.f, kSpecialFloatS16,
+              arraysize(kSpecialFloatS16));
+    float_s16_to_s16(float_input, length, s16_output);
+    for (size_t i = 0; i < length; ++i)
+      s16_reference[i] = FloatS16ToS16(float_input[i]);
+    ExpectArraysEq(s16_reference, s16_output, length);
+  }
+}
+
+TEST(AudioUtilTest, ConversionsMatchScalar) {
+  ExpectConversionsMatchScalar(FloatToS16, S16ToFloat, FloatS16ToS16);
+}
+
+// The dispatch only runs one of the kernels, so test each of them directly.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(AudioUtilTest, ConversionsMatchScalarSSE2) {
+  ASSERT_TRUE(WebRtc_GetCPUInfo(kSSE2));
+  ExpectConversionsMatchScalar(FloatToS16_SSE2, S16ToFloat_SSE2,
+                               FloatS16ToS16_SSE2);
+}
+
+TEST(AudioUtilTest, ConversionsMatchScalarAVX2) {
+  if (!WebRtc_GetCPUInfo(kAVX2))
+    return;
+  ExpectConversionsMatchScalar(FloatToS16_AVX2, S16ToFloat_AVX2,
+                               FloatS16ToS16_AVX2);
+}
+#endif
+
+template <typename T>
+void ExpectStereoMatchesScalar(const T* interleaved, size_t num_frames) {
+  T left[kMaxLength], right[kMaxLength];
+  T reference_left[kMaxLength], reference_right[kMaxLength];
+  T* const channels[] = {left, right};
+  T* const reference_channels[] = {reference_left, reference_right};
+  Deinterleave(interleaved, num_frames, 2, channels);
+  DeinterleaveImpl(interleaved, num_frames, 2, reference_channels);
+  ExpectArraysEq(reference_left, left, num_frames);
+  ExpectArraysEq(reference_right, right, num_frames);
+
+  T output[2 * kMaxLength];
+  Interleave(channels, num_frames, 2, output);
+  ExpectArraysEq(interleaved, output, 2 * num_frames);
+}
+
+TEST(AudioUtilTest, StereoMatchesScalar) {
+  for (size_t num_frames : kLengths) {
+    SCOPED_TRACE(num_frames);
+    int16_t s16_interleaved[2 * kMaxLength];
+    FillS16(s16_interleaved, 2 * num_frames);
+    ExpectStereoMatchesScalar(s16_interleaved, num_frames);
+
+    float float_interleaved[2 * kMaxLength];
+    FillFloat(float_interleaved, 2 * num_frames, 1.f, nullptr, 0);
+    ExpectStereoMatchesScalar(float_interleaved, num_frames);
+
+    int16_t mono[kMaxLength];
+    int16_t reference_mono[kMaxLength];
+    DownmixInterleavedToMono(s16_interleaved, num_frames, 2, mono);
+    DownmixInterleavedToMonoImpl<int16_t, int32_t>(s16_interleaved,
+                                                   num_frames, 2,
+                                                   reference_mono);
+    ExpectArraysEq(reference_mono, mono, num_frames);
+
+    int16_t left[kMaxLength], right[kMaxLength];
+    int16_t* const channels[] = {left, right};
+    Deinterleave(s16_interleaved, num_frames, 2, channels);
+    DownmixToMono<int16_t, int32_t>(channels, num_frames, 2, mono);
+    DownmixToMonoImpl<int16_t, int32_t>(channels, num_frames, 2,
+                                        reference_mono);
+    ExpectArraysEq(reference_mono, mono, num_frames);
+  }
+}
+
+// Buffers for one benchmarked frame.
+struct BenchmarkFrame {
+  size_t samples_per_channel;
+  int num_channels;
+  float float_interleaved[2 * kMaxLength];
+  int16_t s16_interleaved[2 * kMaxLength];
+  float float_left[kMaxLength];
+  float float_right[kMaxLength];
+  int16_t s16_left[kMaxLength];
+  int16_t s16_right[kMaxLength];
+  int16_t s16_mono[kMaxLength];
+  float* float_channels[2];
+  int16_t* s16_channels[2];
+
+  size_t size() const { return samples_per_channel * num_channels; }
+};
+
+void FloatToS16Scalar(BenchmarkFrame* f) {
+  for (size_t i = 0; i < f->size(); ++i)
+    f->s16_interleaved[i] = FloatToS16(f->float_interleaved[i]);
+}
+
+void FloatToS16Dispatched(BenchmarkFrame* f) {
+  FloatToS16(f->float_interleaved, f->size(), f->s16_interleaved);
+}
+
+void S16ToFloatScalar(BenchmarkFrame* f) {
+  for (size_t i = 0; i < f->size(); ++i)
+    f->float_interleaved[i] = S16ToFloat(f->s16_interleaved[i]);
+}
+
+void S16ToFloatDispatched(BenchmarkFrame* f) {
+  S16ToFloat(f->s16_interleaved, f->size(), f->float_interleaved);
+}
+
+void FloatS16ToS16Scalar(BenchmarkFrame* f) {
+  for (size_t i = 0; i < f->size(); ++i)
+    f->s16_interleaved[i] = FloatS16ToS16(f->float_interleaved[i]);
+}
+
+void FloatS16ToS16Dispatched(BenchmarkFrame* f) {
+  FloatS16ToS16(f->float_interleaved, f->size(), f->s16_interleaved);
+}
+
+void DeinterleaveS16Scalar(BenchmarkFrame* f) {
+  DeinterleaveImpl(f->s16_interleaved, f->samples_per_channel,
+                   f->num_channels, f->s16_channels);
+}
+
+void DeinterleaveS16Dispatched(BenchmarkFrame* f) {
+  Deinterleave(f->s16_interleaved, f->samples_per_channel, f->num_channels,
+               f->s16_channels);
+}
+
+void DeinterleaveFloatScalar(BenchmarkFrame* f) {
+  DeinterleaveImpl(f->float_interleaved, f->samples_per_channel,
+                   f->num_channels, f->float_channels);
+}
+
+void DeinterleaveFloatDispatched(BenchmarkFrame* f) {
+  Deinterleave(f->float_interleaved, f->samples_per_channel, f->num_channels,
+               f->float_channels);
+}
+
+void InterleaveS16Scalar(BenchmarkFrame* f) {
+  InterleaveImpl(f->s16_channels, f->samples_per_channel, f->num_channels,
+                 f->s16_interleaved);
+}
+
+void InterleaveS16Dispatched(BenchmarkFrame* f) {
+  Interleave(f->s16_channels, f->samples_per_channel, f->num_channels,
+             f->s16_interleaved);
+}
+
+void InterleaveFloatScalar(BenchmarkFrame* f) {
+  InterleaveImpl(f->float_channels, f->samples_per_channel,
+                 f->num_channels, f->float_interleaved);
+}
+
+void InterleaveFloatDispatched(BenchmarkFrame* f) {
+  Interleave(f->float_channels, f->samples_per_channel, f->num_channels,
+             f->float_interleaved);
+}
+
+void DownmixInterleavedScalar(BenchmarkFrame* f) {
+  DownmixInterleavedToMonoImpl<int16_t, int32_t>(
+      f->s16_interleaved, f->samples_per_channel, f->num_channels,
+      f->s16_mono);
+}
+
+void DownmixInterleavedDispatched(BenchmarkFrame* f) {
+  DownmixInterleavedToMono(f->s16_interleaved, f->samples_per_channel,
+                           f->num_channels, f->s16_mono);
+}
+
+void DownmixScalar(BenchmarkFrame* f) {
+  DownmixToMonoImpl<int16_t, int32_t>(f->s16_channels,
+                                      f->samples_per_channel,
+                                      f->num_channels, f->s16_mono);
+}
+
+void DownmixDispatched(BenchmarkFrame* f) {
+  DownmixToMono<int16_t, int32_t>(f->s16_channels, f->samples_per_channel,
+                                  f->num_channels, f->s16_mono);
+}
+
+struct BenchmarkedFunction {
+  const char* name;
+  void (*scalar)(BenchmarkFrame*);
+  void (*dispatched)(BenchmarkFrame*);
+};
+
+double MicrosecondsPerCall(void (*function)(BenchmarkFrame*),
+                           BenchmarkFrame* frame,
+                           int iterations) {
+  const TickTime start = TickTime::Now();
+  for (int i = 0; i < iterations; ++i)
+    function(frame);
+  return static_cast<double>((TickTime::Now() - start).Microseconds()) /
+         iterations;
+}
+
+// Times the dispatched functions against the scalar loops on 10 ms frames at
+// every sample rate, mono and stereo.
+TEST(AudioUtilTest, DISABLED_Benchmark) {
+  const int kIterations = 2000;
+  const size_t kSamplesPer10Ms[] = {80, 160, 320, 441, 480};
+  const BenchmarkedFunction kFunctions[] = {
+      {"FloatToS16", FloatToS16Scalar, FloatToS16Dispatched},
+      {"S16ToFloat", S16ToFloatScalar, S16ToFloatDispatched},
+      {"FloatS16ToS16", FloatS16ToS16Scalar, FloatS16ToS16Dispatched},
+      {"Deinterleave<int16_t>", DeinterleaveS16Scalar,
+       DeinterleaveS16Dispatched},
+      {"Deinterleave<float>", DeinterleaveFloatScalar,
+       DeinterleaveFloatDispatched},
+      {"Interleave<int16_t>", InterleaveS16Scalar, InterleaveS16Dispatched},
+      {"Interleave<float>", InterleaveFloatScalar, InterleaveFloatDispatched},
+      {"DownmixInterleavedToMono", DownmixInterleavedScalar,
+       DownmixInterleavedDispatched},
+      {"DownmixToMono", DownmixScalar, DownmixDispatched},
+  };
+
+  BenchmarkFrame frame;
+  frame.float_channels[0] = frame.float_left;
+  frame.float_channels[1] = frame.float_right;
+  frame.s16_channels[0] = frame.s16_left;
+  frame.s16_channels[1] = frame.s16_right;
+  FillFloat(frame.float_interleaved, 2 * kMaxLength, 1.f, nullptr, 0);
+  FillS16(frame.s16_interleaved, 2 * kMaxLength);
+  FillS16(frame.s16_left, kMaxLength);
+  FillS16(frame.s16_right, kMaxLength);
+
+  printf("Benchmarking %d iterations:\n", kIterations);
+  for (const BenchmarkedFunction& function : kFunctions) {
+    for (size_t samples_per_channel : kSamplesPer10Ms) {
+      for (int num_channels = 1; num_channels <= 2; ++num_channels) {
+        frame.samples_per_channel = samples_per_channel;
+        frame.num_channels = num_channels;
+        const double scalar_us =
+            MicrosecondsPerCall(function.scalar, &frame, kIterations);
+        const double dispatched_us =
+            MicrosecondsPerCall(function.dispatched, &frame, kIterations);
+        printf("%s %3d x %d: scalar %.3f us, dispatched %.3f us (%.2fx)\n",
+               function.name, static_cast<int>(samples_per_channel),
+               num_channels, scalar_us, dispatched_us,
+               dispatched_us > 0 ? scalar_us / dispatched_us : 0.0);
+      }
+    }
+  }
+}
+
 }  // namespace
 }  // namespace webrtc
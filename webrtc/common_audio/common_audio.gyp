@@ -135,7 +135,10 @@
           ],
         }],
         ['target_arch=="ia32" or target_arch=="x64"', {
-          'dependencies': ['common_audio_sse2',],
+          'dependencies': [
+            'common_audio_avx2',
+            'common_audio_sse2',
+          ],
         }],
         ['build_with_neon==1', {
           'dependencies': ['common_audio_neon',],
@@ -198,6 +201,8 @@
           'target_name': 'common_audio_sse2',
           'type': 'static_library',
           'sources': [
+            'audio_util_sse2.cc',
+            'audio_util_sse2.h',
             'fir_filter_sse.cc',
             'resampler/sinc_resampler_sse.cc',
           ],
@@ -210,6 +215,24 @@
             }],
           ],
         },
+        {
+          # Compiled with AVX2 enabled. The functions are only used after
+          # checking that the CPU supports them.
+          'target_name': 'common_audio_avx2',
+          'type': 'static_library',
+          'sources': [
+            'audio_util_avx2.cc',
+            'audio_util_avx2.h',
+          ],
+          'conditions': [
+            ['os_posix==1', {
+              'cflags': [ '-mavx2', ],
+              'xcode_settings': {
+                'OTHER_CFLAGS': [ '-mavx2', ],
+              },
+            }],
+          ],
+        },
       ],  # targets
     }],
     ['build_with_neon==1', {
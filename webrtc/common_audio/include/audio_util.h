@@ -80,15 +80,13 @@ void CopyAudioIfNeeded(const T* const* src,
   }
 }
 
-// Deinterleave audio from |interleaved| to the channel buffers pointed to
-// by |deinterleaved|. There must be sufficient space allocated in the
-// |deinterleaved| buffers (|num_channel| buffers with |samples_per_channel|
-// per buffer).
+// Scalar (de)interleaving, used for the types and channel counts that have no
+// SIMD version.
 template <typename T>
-void Deinterleave(const T* interleaved,
-                  size_t samples_per_channel,
-                  int num_channels,
-                  T* const* deinterleaved) {
+void DeinterleaveImpl(const T* interleaved,
+                      size_t samples_per_channel,
+                      int num_channels,
+                      T* const* deinterleaved) {
   for (int i = 0; i < num_channels; ++i) {
     T* channel = deinterleaved[i];
     int interleaved_idx = i;
@@ -99,14 +97,11 @@ void Deinterleave(const T* interleaved,
   }
 }
 
-// Interleave audio from the channel buffers pointed to by |deinterleaved| to
-// |interleaved|. There must be sufficient space allocated in |interleaved|
-// (|samples_per_channel| * |num_channels|).
 template <typename T>
-void Interleave(const T* const* deinterleaved,
-                size_t samples_per_channel,
-                int num_channels,
-                T* interleaved) {
+void InterleaveImpl(const T* const* deinterleaved,
+                    size_t samples_per_channel,
+                    int num_channels,
+                    T* interleaved) {
   for (int i = 0; i < num_channels; ++i) {
     const T* channel = deinterleaved[i];
     int interleaved_idx = i;
@@ -117,6 +112,54 @@ void Interleave(const T* const* deinterleaved,
   }
 }
 
+// Deinterleave audio from |interleaved| to the channel buffers pointed to
+// by |deinterleaved|. There must be sufficient space allocated in the
+// |deinterleaved| buffers (|num_channel| buffers with |samples_per_channel|
+// per buffer).
+template <typename T>
+void Deinterleave(const T* interleaved,
+                  size_t samples_per_channel,
+                  int num_channels,
+                  T* const* deinterleaved) {
+  DeinterleaveImpl(interleaved, samples_per_channel, num_channels,
+                   deinterleaved);
+}
+
+// The int16_t and float versions use SIMD for stereo when the CPU has it.
+template <>
+void Deinterleave<int16_t>(const int16_t* interleaved,
+                           size_t samples_per_channel,
+                           int num_channels,
+                           int16_t* const* deinterleaved);
+template <>
+void Deinterleave<float>(const float* interleaved,
+                         size_t samples_per_channel,
+                         int num_channels,
+                         float* const* deinterleaved);
+
+// Interleave audio from the channel buffers pointed to by |deinterleaved| to
+// |interleaved|. There must be sufficient space allocated in |interleaved|
+// (|samples_per_channel| * |num_channels|).
+template <typename T>
+void Interleave(const T* const* deinterleaved,
+                size_t samples_per_channel,
+                int num_channels,
+                T* interleaved) {
+  InterleaveImpl(deinterleaved, samples_per_channel, num_channels,
+                 interleaved);
+}
+
+template <>
+void Interleave<int16_t>(const int16_t* const* deinterleaved,
+                         size_t samples_per_channel,
+                         int num_channels,
+                         int16_t* interleaved);
+template <>
+void Interleave<float>(const float* const* deinterleaved,
+                       size_t samples_per_channel,
+                       int num_channels,
+                       float* interleaved);
+
 // Copies audio from a single channel buffer pointed to by |mono| to each
 // channel of |interleaved|. There must be sufficient space allocated in
 // |interleaved| (|samples_per_channel| * |num_channels|).
@@ -134,10 +177,10 @@ void UpmixMonoToInterleaved(const T* mono,
 }
 
 template <typename T, typename Intermediate>
-void DownmixToMono(const T* const* input_channels,
-                   size_t num_frames,
-                   int num_channels,
-                   T* out) {
+void DownmixToMonoImpl(const T* const* input_channels,
+                       size_t num_frames,
+                       int num_channels,
+                       T* out) {
   for (size_t i = 0; i < num_frames; ++i) {
     Intermediate value = input_channels[0][i];
     for (int j = 1; j < num_channels; ++j) {
@@ -147,6 +190,24 @@ void DownmixToMono(const T* const* input_channels,
   }
 }
 
+// Downmixes a multichannel signal to a single channel by averaging all
+// channels.
+template <typename T, typename Intermediate>
+void DownmixToMono(const T* const* input_channels,
+                   size_t num_frames,
+                   int num_channels,
+                   T* out) {
+  DownmixToMonoImpl<T, Intermediate>(input_channels, num_frames, num_channels,
+                                     out);
+}
+
+// Uses SIMD for stereo when the CPU has it.
+template <>
+void DownmixToMono<int16_t, int32_t>(const int16_t* const* input_channels,
+                                     size_t num_frames,
+                                     int num_channels,
+                                     int16_t* out);
+
 // Downmixes an interleaved multichannel signal to a single channel by averaging
 // all channels.
 template <typename T, typename Intermediate>
@@ -144,6 +144,26 @@ struct VoicePacing {
   bool enabled;
 };
 
+// Encodes the sending voice channels on up to |num_threads| threads, the
+// audio capture thread included, instead of one after the other on the capture
+// thread. Meant for many send channels sharing one capture. The channels'
+// transports are then called from several threads at once.
+struct VoiceParallelEncode {
+  VoiceParallelEncode() : num_threads(1) {}
+  explicit VoiceParallelEncode(int value) : num_threads(value) {}
+  int num_threads;
+};
+
+// Has the voice engine's playout mixer take each channel's audio at the rate
+// it was decoded at, and resample only the channels that are mixed, summed per
+// rate. Saves a resampling per channel per 10 ms with many playout channels
+// of which only a few are mixed.
+struct VoiceNativeRateMixing {
+  VoiceNativeRateMixing() : enabled(false) {}
+  explicit VoiceNativeRateMixing(bool value) : enabled(value) {}
+  bool enabled;
+};
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_CONFIG_H_
@@ -235,11 +235,11 @@ int AcmReceiver::GetAudio(int desired_freq_hz, AudioFrame* audio_frame) {
       (desired_freq_hz != -1) && (current_sample_rate_hz != desired_freq_hz);
 
   if (need_resampling && !resampled_last_output_frame_) {
-    // Prime the resampler with the last frame.
-    int16_t temp_output[AudioFrame::kMaxDataSizeSamples];
+    // Prime the resampler with the last frame. The output is overwritten
+    // below, so |audio_frame| serves as scratch space.
     int samples_per_channel_int = resampler_.Resample10Msec(
         last_audio_buffer_.get(), current_sample_rate_hz, desired_freq_hz,
-        num_channels, AudioFrame::kMaxDataSizeSamples, temp_output);
+        num_channels, AudioFrame::kMaxDataSizeSamples, audio_frame->data_);
     if (samples_per_channel_int < 0) {
       LOG(LERROR) << "AcmReceiver::GetAudio - "
                      "Resampling last_audio_buffer_ failed.";
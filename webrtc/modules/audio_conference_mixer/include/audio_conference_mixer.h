@@ -69,6 +69,12 @@ public:
     // downsampling of audio contributing to the mixed audio.
     virtual int32_t SetMinimumMixingFrequency(Frequency freq) = 0;
 
+    // When enabled, participants are asked for audio at their own sample rate
+    // instead of the mixing frequency. Only the frames that are mixed are
+    // resampled, after being summed per sample rate, so each rate is resampled
+    // once. This saves resampling every participant that isn't mixed.
+    virtual void SetNativeRateMixing(bool enable) = 0;
+
 protected:
     AudioConferenceMixer() {}
 };
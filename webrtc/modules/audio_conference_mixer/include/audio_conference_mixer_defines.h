@@ -22,7 +22,9 @@ class MixerParticipant
 {
 public:
     // The implementation of this function should update audioFrame with new
-    // audio every time it's called.
+    // audio every time it's called. The audio is wanted at the sample rate
+    // audioFrame->sample_rate_hz_ is set to when called, or at any rate if it
+    // is -1; the mixer resamples frames that aren't at its own frequency.
     //
     // If it returns -1, the frame will not be added to the mix.
     virtual int32_t GetAudioFrame(int32_t id,
@@ -8,6 +8,9 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+#include <limits>
+
 #include "webrtc/modules/audio_conference_mixer/include/audio_conference_mixer_defines.h"
 #include "webrtc/modules/audio_conference_mixer/source/audio_conference_mixer_impl.h"
 #include "webrtc/modules/audio_conference_mixer/source/audio_frame_manipulator.h"
@@ -49,6 +52,19 @@ void MixFrames(AudioFrame* mixed_frame, AudioFrame* frame, bool use_limiter) {
   *mixed_frame += *frame;
 }
 
+// CalculateEnergy() sums over the samples of a frame, which puts frames at a
+// lower sample rate than the mix at a disadvantage when they are compared.
+// Scale their energy to what it would be at |output_frequency|.
+void CalculateMixingEnergy(AudioFrame* frame, int output_frequency) {
+  CalculateEnergy(*frame);
+  if (frame->sample_rate_hz_ > 0 && frame->sample_rate_hz_ < output_frequency) {
+    const uint64_t energy = static_cast<uint64_t>(frame->energy_) *
+                            output_frequency / frame->sample_rate_hz_;
+    frame->energy_ = static_cast<uint32_t>(
+        std::min<uint64_t>(energy, std::numeric_limits<uint32_t>::max()));
+  }
+}
+
 // Return the max number of channels from a |list| composed of AudioFrames.
 int MaxNumChannels(const AudioFrameList* list) {
   int max_num_channels = 1;
@@ -122,7 +138,8 @@ AudioConferenceMixerImpl::AudioConferenceMixerImpl(int id)
       use_limiter_(true),
       _timeStamp(0),
       _timeScheduler(kProcessPeriodicityInMs),
-      _processCalls(0) {}
+      _processCalls(0),
+      native_rate_mixing_(false) {}
 
 bool AudioConferenceMixerImpl::Init() {
     _crit.reset(CriticalSectionWrapper::CreateCriticalSection());
@@ -297,6 +314,7 @@ int32_t AudioConferenceMixerImpl::Process() {
         MixFromList(mixedAudio, mixList);
         MixAnonomouslyFromList(mixedAudio, additionalFramesList);
         MixAnonomouslyFromList(mixedAudio, rampOutList);
+        MixRateGroups(mixedAudio);
 
         if(mixedAudio->samples_per_channel_ == 0) {
             // Nothing was mixed, set the audio samples to silence.
@@ -486,6 +504,11 @@ int32_t AudioConferenceMixerImpl::SetMinimumMixingFrequency(
     }
 }
 
+void AudioConferenceMixerImpl::SetNativeRateMixing(bool enable) {
+    CriticalSectionScoped cs(_cbCrit.get());
+    native_rate_mixing_ = enable;
+}
+
 // Check all AudioFrames that are to be mixed. The highest sampling frequency
 // found is the lowest that can be used without losing information.
 int32_t AudioConferenceMixerImpl::GetLowestMixingFrequency() const {
@@ -552,7 +575,9 @@ void AudioConferenceMixerImpl::UpdateToMix(
             assert(false);
             return;
         }
-        audioFrame->sample_rate_hz_ = _outputFrequency;
+        // -1 lets the participant return audio at its own rate.
+        audioFrame->sample_rate_hz_ =
+            native_rate_mixing_ ? -1 : _outputFrequency;
 
         if((*participant)->GetAudioFrame(_id, audioFrame) != 0) {
             WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
@@ -583,14 +608,14 @@ void AudioConferenceMixerImpl::UpdateToMix(
                 // There are already more active participants than should be
                 // mixed. Only keep the ones with the highest energy.
                 AudioFrameList::iterator replaceItem;
-                CalculateEnergy(*audioFrame);
+                CalculateMixingEnergy(audioFrame, _outputFrequency);
                 uint32_t lowestEnergy = audioFrame->energy_;
 
                 bool found_replace_item = false;
                 for (AudioFrameList::iterator iter = activeList.begin();
                      iter != activeList.end();
                      ++iter) {
-                    CalculateEnergy(**iter);
+                    CalculateMixingEnergy(*iter, _outputFrequency);
                     if((*iter)->energy_ < lowestEnergy) {
                         replaceItem = iter;
                         lowestEnergy = (*iter)->energy_;
@@ -729,7 +754,9 @@ void AudioConferenceMixerImpl::GetAdditionalAudio(
             assert(false);
             return;
         }
-        audioFrame->sample_rate_hz_ = _outputFrequency;
+        // -1 lets the participant return audio at its own rate.
+        audioFrame->sample_rate_hz_ =
+            native_rate_mixing_ ? -1 : _outputFrequency;
         if((*participant)->GetAudioFrame(_id, audioFrame) != 0) {
             WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
                          "failed to GetAudioFrame() from participant");
@@ -841,7 +868,7 @@ bool AudioConferenceMixerImpl::RemoveParticipantFromList(
 
 int32_t AudioConferenceMixerImpl::MixFromList(
     AudioFrame* mixedAudio,
-    const AudioFrameList& audioFrameList) const {
+    const AudioFrameList& audioFrameList) {
     WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
                  "MixFromList(mixedAudio, audioFrameList)");
     if(audioFrameList.empty()) return 0;
@@ -872,7 +899,7 @@ int32_t AudioConferenceMixerImpl::MixFromList(
             assert(false);
             position = 0;
         }
-        MixFrames(mixedAudio, (*iter), use_limiter_);
+        MixFrame(mixedAudio, *iter);
 
         position++;
     }
@@ -883,7 +910,7 @@ int32_t AudioConferenceMixerImpl::MixFromList(
 // TODO(andrew): consolidate this function with MixFromList.
 int32_t AudioConferenceMixerImpl::MixAnonomouslyFromList(
     AudioFrame* mixedAudio,
-    const AudioFrameList& audioFrameList) const {
+    const AudioFrameList& audioFrameList) {
     WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
                  "MixAnonomouslyFromList(mixedAudio, audioFrameList)");
 
@@ -892,11 +919,79 @@ int32_t AudioConferenceMixerImpl::MixAnonomouslyFromList(
     for (AudioFrameList::const_iterator iter = audioFrameList.begin();
          iter != audioFrameList.end();
          ++iter) {
-        MixFrames(mixedAudio, *iter, use_limiter_);
+        MixFrame(mixedAudio, *iter);
     }
     return 0;
 }
 
+void AudioConferenceMixerImpl::MixFrame(AudioFrame* mixedAudio,
+                                        AudioFrame* frame) {
+    if (frame->sample_rate_hz_ == _outputFrequency) {
+        MixFrames(mixedAudio, frame, use_limiter_);
+        return;
+    }
+    // Resampling is linear, so the frames at one rate can be summed first and
+    // resampled once. The sum has as many channels as the mix.
+    RateGroup& group = rate_groups_[frame->sample_rate_hz_];
+    if (group.frame == NULL) {
+        if (_audioFramePool->PopMemory(group.frame) == -1) {
+            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
+                         "failed PopMemory() call");
+            assert(false);
+            return;
+        }
+        group.frame->UpdateFrame(-1, 0, NULL, 0, frame->sample_rate_hz_,
+                                 AudioFrame::kNormalSpeech,
+                                 AudioFrame::kVadPassive,
+                                 mixedAudio->num_channels_);
+    }
+    MixFrames(group.frame, frame, use_limiter_);
+}
+
+void AudioConferenceMixerImpl::MixRateGroups(AudioFrame* mixedAudio) {
+    for (std::map<int, RateGroup>::iterator it = rate_groups_.begin();
+         it != rate_groups_.end();
+         ++it) {
+        AudioFrame* sum = it->second.frame;
+        if (sum == NULL)
+            continue;
+        it->second.frame = NULL;
+        AudioFrame* resampled = NULL;
+        if (_audioFramePool->PopMemory(resampled) == -1) {
+            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
+                         "failed PopMemory() call");
+            assert(false);
+            _audioFramePool->PushMemory(sum);
+            continue;
+        }
+        // The resampler isn't run while no frame is mixed at its rate. Frames
+        // leave the mix ramped out, so its state then holds near silence.
+        PushResampler<int16_t>& resampler = it->second.resampler;
+        int samples = -1;
+        if (resampler.InitializeIfNeeded(it->first, _outputFrequency,
+                                         sum->num_channels_) == 0) {
+            samples = resampler.Resample(
+                sum->data_, sum->samples_per_channel_ * sum->num_channels_,
+                resampled->data_, AudioFrame::kMaxDataSizeSamples);
+        }
+        if (samples < 0) {
+            WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
+                         "failed to resample audio at %d Hz", it->first);
+        } else {
+            resampled->UpdateFrame(-1, 0, NULL, 0, _outputFrequency,
+                                   sum->speech_type_, sum->vad_activity_,
+                                   sum->num_channels_);
+            resampled->samples_per_channel_ =
+                static_cast<size_t>(samples / sum->num_channels_);
+            // The frames were already scaled down for the limiter when they
+            // were summed.
+            MixFrames(mixedAudio, resampled, false);
+        }
+        _audioFramePool->PushMemory(resampled);
+        _audioFramePool->PushMemory(sum);
+    }
+}
+
 bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame* mixedAudio) const {
     if (!use_limiter_) {
       return true;
@@ -15,6 +15,7 @@
 #include <map>
 
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_audio/resampler/include/push_resampler.h"
 #include "webrtc/engine_configurations.h"
 #include "webrtc/modules/audio_conference_mixer/include/audio_conference_mixer.h"
 #include "webrtc/modules/audio_conference_mixer/source/memory_pool.h"
@@ -74,6 +75,7 @@ public:
                                 bool mixable) override;
     bool MixabilityStatus(const MixerParticipant& participant) const override;
     int32_t SetMinimumMixingFrequency(Frequency freq) override;
+    void SetNativeRateMixing(bool enable) override;
     int32_t SetAnonymousMixabilityStatus(
         MixerParticipant* participant, bool mixable) override;
     bool AnonymousMixabilityStatus(
@@ -136,13 +138,21 @@ private:
 
     // Mix the AudioFrames stored in audioFrameList into mixedAudio.
     int32_t MixFromList(AudioFrame* mixedAudio,
-                        const AudioFrameList& audioFrameList) const;
+                        const AudioFrameList& audioFrameList);
 
     // Mix the AudioFrames stored in audioFrameList into mixedAudio. No
     // record will be kept of this mix (e.g. the corresponding MixerParticipants
     // will not be marked as IsMixed()
     int32_t MixAnonomouslyFromList(AudioFrame* mixedAudio,
-                                   const AudioFrameList& audioFrameList) const;
+                                   const AudioFrameList& audioFrameList);
+
+    // Mixes |frame| into |mixedAudio| if it is at the output frequency, and
+    // into the sum of the frames at its sample rate otherwise.
+    void MixFrame(AudioFrame* mixedAudio, AudioFrame* frame);
+
+    // Resamples the sum of each sample rate to the output frequency and mixes
+    // it into |mixedAudio|.
+    void MixRateGroups(AudioFrame* mixedAudio);
 
     bool LimitMixedAudio(AudioFrame* mixedAudio) const;
 
@@ -184,6 +194,19 @@ private:
 
     // Used for inhibiting saturation in mixing.
     rtc::scoped_ptr<AudioProcessing> _limiter;
+
+    // Ask the participants for audio at their own sample rate.
+    bool native_rate_mixing_;
+
+    // The frames to mix that aren't at the output frequency, summed per sample
+    // rate. The resampler of a rate keeps its state between calls to
+    // Process(); the sum is taken from |_audioFramePool| while mixing.
+    struct RateGroup {
+        RateGroup() : frame(NULL) {}
+        AudioFrame* frame;
+        PushResampler<int16_t> resampler;
+    };
+    std::map<int, RateGroup> rate_groups_;
 };
 }  // namespace webrtc
 
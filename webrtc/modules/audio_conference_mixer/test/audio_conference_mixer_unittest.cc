@@ -8,10 +8,20 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_audio/resampler/include/push_resampler.h"
 #include "webrtc/modules/audio_conference_mixer/include/audio_conference_mixer.h"
 #include "webrtc/modules/audio_conference_mixer/include/audio_conference_mixer_defines.h"
+#include "webrtc/system_wrappers/include/tick_util.h"
 
 namespace webrtc {
 
@@ -47,6 +57,95 @@ class MockMixerParticipant : public MixerParticipant {
   }
 };
 
+// Plays a tone at |sample_rate_hz|. Like a voice channel, it resamples its
+// audio to the rate the mixer asks for, unless that is -1.
+class ToneParticipant : public MixerParticipant {
+ public:
+  ToneParticipant(int id,
+                  int sample_rate_hz,
+                  float frequency_hz,
+                  int16_t amplitude)
+      : id_(id),
+        sample_rate_hz_(sample_rate_hz),
+        frequency_hz_(frequency_hz),
+        amplitude_(amplitude),
+        position_(0) {}
+
+  int32_t GetAudioFrame(const int32_t id, AudioFrame* audio_frame) override {
+    const int wanted_rate_hz = audio_frame->sample_rate_hz_;
+    const size_t samples = static_cast<size_t>(sample_rate_hz_ / 100);
+    int16_t* tone =
+        wanted_rate_hz == -1 || wanted_rate_hz == sample_rate_hz_
+            ? audio_frame->data_
+            : tone_;
+    for (size_t i = 0; i < samples; ++i, ++position_) {
+      tone[i] = static_cast<int16_t>(
+          amplitude_ * sin(2 * M_PI * frequency_hz_ * position_ /
+                           sample_rate_hz_));
+    }
+    audio_frame->samples_per_channel_ = samples;
+    audio_frame->sample_rate_hz_ = sample_rate_hz_;
+    if (tone != audio_frame->data_) {
+      EXPECT_EQ(0, resampler_.InitializeIfNeeded(sample_rate_hz_,
+                                                 wanted_rate_hz, 1));
+      const int resampled = resampler_.Resample(
+          tone, samples, audio_frame->data_, AudioFrame::kMaxDataSizeSamples);
+      EXPECT_LT(0, resampled);
+      audio_frame->samples_per_channel_ = static_cast<size_t>(resampled);
+      audio_frame->sample_rate_hz_ = wanted_rate_hz;
+    }
+    audio_frame->id_ = id_;
+    audio_frame->num_channels_ = 1;
+    audio_frame->speech_type_ = AudioFrame::kNormalSpeech;
+    audio_frame->vad_activity_ = AudioFrame::kVadActive;
+    return 0;
+  }
+
+  int32_t NeededFrequency(const int32_t id) const override {
+    return sample_rate_hz_;
+  }
+
+ private:
+  const int id_;
+  const int sample_rate_hz_;
+  const float frequency_hz_;
+  const int16_t amplitude_;
+  int position_;
+  int16_t tone_[AudioFrame::kMaxDataSizeSamples];
+  PushResampler<int16_t> resampler_;
+};
+
+// Remembers the frames it was handed.
+class FrameCountingParticipant : public ToneParticipant {
+ public:
+  FrameCountingParticipant(int id, int16_t amplitude,
+                           std::set<AudioFrame*>* frames)
+      : ToneParticipant(id, 16000, 300, amplitude), frames_(frames) {}
+
+  int32_t GetAudioFrame(const int32_t id, AudioFrame* audio_frame) override {
+    frames_->insert(audio_frame);
+    return ToneParticipant::GetAudioFrame(id, audio_frame);
+  }
+
+ private:
+  std::set<AudioFrame*>* frames_;
+};
+
+// Keeps a copy of the last mixed frame.
+class MixedFrameCopier : public AudioMixerOutputReceiver {
+ public:
+  void NewMixedAudio(const int32_t id,
+                     const AudioFrame& general_audio_frame,
+                     const AudioFrame** unique_audio_frames,
+                     const uint32_t size) override {
+    frame_.CopyFrom(general_audio_frame);
+  }
+  const AudioFrame& frame() const { return frame_; }
+
+ private:
+  AudioFrame frame_;
+};
+
 TEST(AudioConferenceMixer, AnonymousAndNamed) {
   const int kId = 1;
   // Should not matter even if partipants are more than
@@ -162,4 +261,182 @@ TEST(AudioConferenceMixer, LargestEnergyVadActiveMixed) {
   EXPECT_EQ(0, mixer->UnRegisterMixedStreamCallback());
 }
 
+// The frames a participant hands back unmixed are given to the next one, so a
+// mix iteration only touches a few frames of the pool however many
+// participants there are.
+TEST(AudioConferenceMixer, ParticipantsReuseRecentlyPooledFrames) {
+  const int kParticipants = 100;
+  rtc::scoped_ptr<AudioConferenceMixer> mixer(AudioConferenceMixer::Create(1));
+  MixedFrameCopier receiver;
+  EXPECT_EQ(0, mixer->RegisterMixedStreamCallback(&receiver));
+  std::set<AudioFrame*> frames;
+  std::vector<FrameCountingParticipant*> participants;
+  for (int i = 0; i < kParticipants; ++i) {
+    participants.push_back(new FrameCountingParticipant(
+        i, static_cast<int16_t>(10 * (i + 1)), &frames));
+    EXPECT_EQ(0, mixer->SetMixabilityStatus(participants.back(), true));
+  }
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(0, mixer->Process());
+  // The mixed participants' frames, the one passed around and the frames
+  // being ramped out.
+  EXPECT_LE(frames.size(),
+            2u * AudioConferenceMixer::kMaximumAmountOfMixedParticipants + 1);
+  for (FrameCountingParticipant* participant : participants) {
+    EXPECT_EQ(0, mixer->SetMixabilityStatus(participant, false));
+    delete participant;
+  }
+}
+
+// Prints the pooled frame memory a mix iteration touches and its cost, for
+// growing numbers of participants.
+TEST(AudioConferenceMixer, DISABLED_PooledFramesCost) {
+  const int kFrames = 1000;
+  const int kParticipants[] = {3, 10, 100, 500};
+  for (int num_participants : kParticipants) {
+    rtc::scoped_ptr<AudioConferenceMixer> mixer(
+        AudioConferenceMixer::Create(1));
+    MixedFrameCopier receiver;
+    EXPECT_EQ(0, mixer->RegisterMixedStreamCallback(&receiver));
+    std::set<AudioFrame*> frames;
+    std::vector<FrameCountingParticipant*> participants;
+    for (int i = 0; i < num_participants; ++i) {
+      participants.push_back(new FrameCountingParticipant(
+          i, static_cast<int16_t>(10 * (i + 1)), &frames));
+      EXPECT_EQ(0, mixer->SetMixabilityStatus(participants.back(), true));
+    }
+    const TickTime start = TickTime::Now();
+    for (int i = 0; i < kFrames; ++i)
+      EXPECT_EQ(0, mixer->Process());
+    const int64_t runtime_us = (TickTime::Now() - start).Microseconds();
+    printf("%d participants: %d pooled frames, %d KB, %d us / frame\n",
+           num_participants, static_cast<int>(frames.size()),
+           static_cast<int>(frames.size() * sizeof(AudioFrame) / 1024),
+           static_cast<int>(runtime_us / kFrames));
+    for (FrameCountingParticipant* participant : participants) {
+      EXPECT_EQ(0, mixer->SetMixabilityStatus(participant, false));
+      delete participant;
+    }
+  }
+}
+
+// A 48 kHz participant has the mix done at 48 kHz. Summing the two 16 kHz
+// participants before resampling them should make no audible difference.
+TEST(AudioConferenceMixer, NativeRateMixingMatchesMixingAtOutputRate) {
+  const int kFrames = 50;
+  // The first frames are ramped in at different rates in the two modes.
+  const int kSkippedFrames = 2;
+  rtc::scoped_ptr<AudioConferenceMixer> mixers[2];
+  MixedFrameCopier receivers[2];
+  rtc::scoped_ptr<ToneParticipant> participants[2][3];
+  for (int i = 0; i < 2; ++i) {
+    mixers[i].reset(AudioConferenceMixer::Create(1));
+    mixers[i]->SetNativeRateMixing(i == 1);
+    EXPECT_EQ(0, mixers[i]->RegisterMixedStreamCallback(&receivers[i]));
+    participants[i][0].reset(new ToneParticipant(0, 48000, 1000, 3000));
+    participants[i][1].reset(new ToneParticipant(1, 16000, 400, 3000));
+    participants[i][2].reset(new ToneParticipant(2, 16000, 2500, 3000));
+    for (auto& participant : participants[i])
+      EXPECT_EQ(0, mixers[i]->SetMixabilityStatus(participant.get(), true));
+  }
+
+  for (int frame = 0; frame < kFrames; ++frame) {
+    for (int i = 0; i < 2; ++i)
+      EXPECT_EQ(0, mixers[i]->Process());
+    const AudioFrame& reference = receivers[0].frame();
+    const AudioFrame& native = receivers[1].frame();
+    ASSERT_EQ(48000, native.sample_rate_hz_);
+    ASSERT_EQ(reference.samples_per_channel_, native.samples_per_channel_);
+    ASSERT_EQ(reference.num_channels_, native.num_channels_);
+    if (frame < kSkippedFrames)
+      continue;
+    int max_diff = 0;
+    for (size_t j = 0; j < native.samples_per_channel_; ++j) {
+      max_diff = std::max(max_diff,
+                          abs(reference.data_[j] - native.data_[j]));
+    }
+    // Only the rounding differs, which the limiter's gain scales up.
+    EXPECT_LE(max_diff, 16) << "frame " << frame;
+  }
+  for (int i = 0; i < 2; ++i) {
+    for (auto& participant : participants[i])
+      EXPECT_TRUE(participant->IsMixed());
+  }
+}
+
+// Mixes many 16 kHz participants at 48 kHz with and without native rate
+// mixing. Both pick the same, loudest, participants.
+TEST(AudioConferenceMixer, NativeRateMixingOfManyParticipants) {
+  const int kParticipants = 200;
+  const int kFrames = 20;
+  for (int i = 0; i < 2; ++i) {
+    rtc::scoped_ptr<AudioConferenceMixer> mixer(
+        AudioConferenceMixer::Create(1));
+    mixer->SetNativeRateMixing(i == 1);
+    MixedFrameCopier receiver;
+    EXPECT_EQ(0, mixer->RegisterMixedStreamCallback(&receiver));
+    std::vector<ToneParticipant*> participants;
+    participants.push_back(new ToneParticipant(0, 48000, 1000, 1000));
+    for (int j = 1; j < kParticipants; ++j) {
+      participants.push_back(
+          new ToneParticipant(j, 16000, 200.0f + j, static_cast<int16_t>(j)));
+    }
+    for (ToneParticipant* participant : participants)
+      EXPECT_EQ(0, mixer->SetMixabilityStatus(participant, true));
+
+    for (int frame = 0; frame < kFrames; ++frame)
+      EXPECT_EQ(0, mixer->Process());
+
+    EXPECT_EQ(48000, receiver.frame().sample_rate_hz_);
+    // The loudest participants are mixed.
+    int mixed = 0;
+    for (ToneParticipant* participant : participants)
+      mixed += participant->IsMixed() ? 1 : 0;
+    EXPECT_EQ(AudioConferenceMixer::kMaximumAmountOfMixedParticipants, mixed);
+    EXPECT_TRUE(participants.back()->IsMixed());
+    for (ToneParticipant* participant : participants) {
+      EXPECT_EQ(0, mixer->SetMixabilityStatus(participant, false));
+      delete participant;
+    }
+  }
+}
+
+// Prints the cost of a mix iteration of many 16 kHz participants at 48 kHz,
+// with and without native rate mixing. It only measures time, so it is
+// disabled by default.
+TEST(AudioConferenceMixer, DISABLED_NativeRateMixingPlayoutCost) {
+  const int kParticipants = 200;
+  const int kFrames = 100;
+  int64_t runtime_us[2] = {0, 0};
+  for (int i = 0; i < 2; ++i) {
+    rtc::scoped_ptr<AudioConferenceMixer> mixer(
+        AudioConferenceMixer::Create(1));
+    mixer->SetNativeRateMixing(i == 1);
+    MixedFrameCopier receiver;
+    EXPECT_EQ(0, mixer->RegisterMixedStreamCallback(&receiver));
+    std::vector<ToneParticipant*> participants;
+    participants.push_back(new ToneParticipant(0, 48000, 1000, 1000));
+    for (int j = 1; j < kParticipants; ++j) {
+      participants.push_back(
+          new ToneParticipant(j, 16000, 200.0f + j, static_cast<int16_t>(j)));
+    }
+    for (ToneParticipant* participant : participants)
+      EXPECT_EQ(0, mixer->SetMixabilityStatus(participant, true));
+
+    const TickTime start = TickTime::Now();
+    for (int frame = 0; frame < kFrames; ++frame)
+      EXPECT_EQ(0, mixer->Process());
+    runtime_us[i] = (TickTime::Now() - start).Microseconds();
+
+    for (ToneParticipant* participant : participants) {
+      EXPECT_EQ(0, mixer->SetMixabilityStatus(participant, false));
+      delete participant;
+    }
+  }
+  printf("Mixing %d participants: %d us / frame at the output rate, %d us / "
+         "frame at their native rate\n",
+         kParticipants, static_cast<int>(runtime_us[0] / kFrames),
+         static_cast<int>(runtime_us[1] / kFrames));
+}
+
 }  // namespace webrtc
@@ -24,7 +24,8 @@ const int kRecordingBufferSize = kRecordingFixedSampleRate / 100
 
 FileAudioDevice::FileAudioDevice(const int32_t id,
                                  const char* inputFilename,
-                                 const char* outputFilename):
+                                 const char* outputFilename,
+                                 FileAudioDeviceTicker* ticker):
     _ptrAudioBuffer(NULL),
     _recordingBuffer(NULL),
     _playoutBuffer(NULL),
@@ -42,10 +43,14 @@ FileAudioDevice::FileAudioDevice(const int32_t id,
     _inputFile(*FileWrapper::Create()),
     _outputFilename(outputFilename),
     _inputFilename(inputFilename),
-    _clock(Clock::GetRealTimeClock()) {
+    _clock(Clock::GetRealTimeClock()),
+    _ticker(ticker) {
 }
 
 FileAudioDevice::~FileAudioDevice() {
+  // The ticker outlives this device, so it must not tick it once it is gone.
+  if (_ticker)
+    _ticker->RemoveClient(this);
   if (_outputFile.Open()) {
       _outputFile.Flush();
       _outputFile.CloseFile();
@@ -185,32 +190,40 @@ bool FileAudioDevice::RecordingIsInitialized() const {
 }
 
 int32_t FileAudioDevice::StartPlayout() {
-  if (_playing) {
-      return 0;
-  }
+  {
+    // A ticker may already be calling OnTick() for recording, so everything
+    // Play10Ms() uses is set up under the lock, with |_playing| set last.
+    CriticalSectionScoped lock(&_critSect);
+    if (_playing) {
+        return 0;
+    }
 
-  _playoutFramesIn10MS = static_cast<size_t>(kPlayoutFixedSampleRate / 100);
-  _playing = true;
-  _playoutFramesLeft = 0;
+    _playoutFramesIn10MS = static_cast<size_t>(kPlayoutFixedSampleRate / 100);
+    _playoutFramesLeft = 0;
 
-  if (!_playoutBuffer) {
-      _playoutBuffer = new int8_t[2 *
-                                  kPlayoutNumChannels *
-                                  kPlayoutFixedSampleRate/100];
-  }
-  if (!_playoutBuffer) {
-    _playing = false;
-    return -1;
+    if (!_playoutBuffer) {
+        _playoutBuffer = new int8_t[2 *
+                                    kPlayoutNumChannels *
+                                    kPlayoutFixedSampleRate/100];
+    }
+    if (!_playoutBuffer) {
+      return -1;
+    }
+
+    // PLAYOUT
+    if (!_outputFilename.empty() && _outputFile.OpenFile(
+          _outputFilename.c_str(), false, false, false) == -1) {
+      printf("Failed to open playout file %s!\n", _outputFilename.c_str());
+      delete [] _playoutBuffer;
+      _playoutBuffer = NULL;
+      return -1;
+    }
+    _playing = true;
   }
 
-  // PLAYOUT
-  if (!_outputFilename.empty() && _outputFile.OpenFile(
-        _outputFilename.c_str(), false, false, false) == -1) {
-    printf("Failed to open playout file %s!\n", _outputFilename.c_str());
-    _playing = false;
-    delete [] _playoutBuffer;
-    _playoutBuffer = NULL;
-    return -1;
+  if (_ticker) {
+    _ticker->AddClient(this);
+    return 0;
   }
 
   _ptrThreadPlay.reset(new rtc::PlatformThread(
@@ -221,9 +234,11 @@ int32_t FileAudioDevice::StartPlayout() {
 }
 
 int32_t FileAudioDevice::StopPlayout() {
+  bool recording;
   {
       CriticalSectionScoped lock(&_critSect);
       _playing = false;
+      recording = _recording;
   }
 
   // stop playout thread first
@@ -231,17 +246,24 @@ int32_t FileAudioDevice::StopPlayout() {
       _ptrThreadPlay->Stop();
       _ptrThreadPlay.reset();
   }
+  // A tick in progress sees |_playing| cleared under the lock and leaves the
+  // buffer alone, so the ticker only has to drop the device once neither
+  // direction is running.
+  if (_ticker && !recording)
+    _ticker->RemoveClient(this);
 
-  CriticalSectionScoped lock(&_critSect);
+  {
+    CriticalSectionScoped lock(&_critSect);
 
-  _playoutFramesLeft = 0;
-  delete [] _playoutBuffer;
-  _playoutBuffer = NULL;
-  if (_outputFile.Open()) {
-      _outputFile.Flush();
-      _outputFile.CloseFile();
+    _playoutFramesLeft = 0;
+    delete [] _playoutBuffer;
+    _playoutBuffer = NULL;
+    if (_outputFile.Open()) {
+        _outputFile.Flush();
+        _outputFile.CloseFile();
+    }
   }
-   return 0;
+  return 0;
 }
 
 bool FileAudioDevice::Playing() const {
@@ -249,24 +271,32 @@ bool FileAudioDevice::Playing() const {
 }
 
 int32_t FileAudioDevice::StartRecording() {
-  _recording = true;
-
-  // Make sure we only create the buffer once.
-  _recordingBufferSizeIn10MS = _recordingFramesIn10MS *
-                               kRecordingNumChannels *
-                               2;
-  if (!_recordingBuffer) {
-      _recordingBuffer = new int8_t[_recordingBufferSizeIn10MS];
+  {
+    // As in StartPlayout(), |_recording| is set last under the lock.
+    CriticalSectionScoped lock(&_critSect);
+
+    // Make sure we only create the buffer once.
+    _recordingBufferSizeIn10MS = _recordingFramesIn10MS *
+                                 kRecordingNumChannels *
+                                 2;
+    if (!_recordingBuffer) {
+        _recordingBuffer = new int8_t[_recordingBufferSizeIn10MS];
+    }
+
+    if (!_inputFilename.empty() && _inputFile.OpenFile(
+          _inputFilename.c_str(), true, true, false) == -1) {
+      printf("Failed to open audio input file %s!\n",
+             _inputFilename.c_str());
+      delete[] _recordingBuffer;
+      _recordingBuffer = NULL;
+      return -1;
+    }
+    _recording = true;
   }
 
-  if (!_inputFilename.empty() && _inputFile.OpenFile(
-        _inputFilename.c_str(), true, true, false) == -1) {
-    printf("Failed to open audio input file %s!\n",
-           _inputFilename.c_str());
-    _recording = false;
-    delete[] _recordingBuffer;
-    _recordingBuffer = NULL;
-    return -1;
+  if (_ticker) {
+    _ticker->AddClient(this);
+    return 0;
   }
 
   _ptrThreadRec.reset(new rtc::PlatformThread(
@@ -280,21 +310,27 @@ int32_t FileAudioDevice::StartRecording() {
 
 
 int32_t FileAudioDevice::StopRecording() {
+  bool playing;
   {
     CriticalSectionScoped lock(&_critSect);
     _recording = false;
+    playing = _playing;
   }
 
   if (_ptrThreadRec) {
       _ptrThreadRec->Stop();
       _ptrThreadRec.reset();
   }
+  if (_ticker && !playing)
+    _ticker->RemoveClient(this);
 
-  CriticalSectionScoped lock(&_critSect);
-  _recordingFramesLeft = 0;
-  if (_recordingBuffer) {
-      delete [] _recordingBuffer;
-      _recordingBuffer = NULL;
+  {
+    CriticalSectionScoped lock(&_critSect);
+    _recordingFramesLeft = 0;
+    if (_recordingBuffer) {
+        delete [] _recordingBuffer;
+        _recordingBuffer = NULL;
+    }
   }
   return 0;
 }
@@ -487,18 +523,10 @@ bool FileAudioDevice::PlayThreadProcess()
     if (_lastCallPlayoutMillis == 0 ||
         currentTime - _lastCallPlayoutMillis >= 10) {
         _critSect.Leave();
-        _ptrAudioBuffer->RequestPlayoutData(_playoutFramesIn10MS);
+        Play10Ms();
         _critSect.Enter();
-
-        _playoutFramesLeft = _ptrAudioBuffer->GetPlayoutData(_playoutBuffer);
-        assert(_playoutFramesLeft == _playoutFramesIn10MS);
-        if (_outputFile.Open()) {
-          _outputFile.Write(_playoutBuffer, kPlayoutBufferSize);
-          _outputFile.Flush();
-        }
         _lastCallPlayoutMillis = currentTime;
     }
-    _playoutFramesLeft = 0;
     _critSect.Leave();
     SleepMs(10 - (_clock->CurrentNtpInMilliseconds() - currentTime));
     return true;
@@ -516,15 +544,9 @@ bool FileAudioDevice::RecThreadProcess()
     if (_lastCallRecordMillis == 0 ||
         currentTime - _lastCallRecordMillis >= 10) {
       if (_inputFile.Open()) {
-        if (_inputFile.Read(_recordingBuffer, kRecordingBufferSize) > 0) {
-          _ptrAudioBuffer->SetRecordedBuffer(_recordingBuffer,
-                                             _recordingFramesIn10MS);
-        } else {
-          _inputFile.Rewind();
-        }
         _lastCallRecordMillis = currentTime;
         _critSect.Leave();
-        _ptrAudioBuffer->DeliverRecordedData();
+        Record10Ms();
         _critSect.Enter();
       }
     }
@@ -534,4 +556,51 @@ bool FileAudioDevice::RecThreadProcess()
     return true;
 }
 
+void FileAudioDevice::Play10Ms() {
+  _ptrAudioBuffer->RequestPlayoutData(_playoutFramesIn10MS);
+
+  CriticalSectionScoped lock(&_critSect);
+  // Playout may have been stopped while the data was requested.
+  if (!_playing || !_playoutBuffer)
+    return;
+  _playoutFramesLeft = _ptrAudioBuffer->GetPlayoutData(_playoutBuffer);
+  assert(_playoutFramesLeft == _playoutFramesIn10MS);
+  if (_outputFile.Open()) {
+    _outputFile.Write(_playoutBuffer, kPlayoutBufferSize);
+    _outputFile.Flush();
+  }
+  _playoutFramesLeft = 0;
+}
+
+void FileAudioDevice::Record10Ms() {
+  {
+    CriticalSectionScoped lock(&_critSect);
+    if (!_recording || !_recordingBuffer || !_inputFile.Open())
+      return;
+    if (_inputFile.Read(_recordingBuffer, kRecordingBufferSize) > 0) {
+      _ptrAudioBuffer->SetRecordedBuffer(_recordingBuffer,
+                                         _recordingFramesIn10MS);
+    } else {
+      _inputFile.Rewind();
+    }
+  }
+  _ptrAudioBuffer->DeliverRecordedData();
+}
+
+void FileAudioDevice::OnTick() {
+  bool playing;
+  bool recording;
+  {
+    CriticalSectionScoped lock(&_critSect);
+    playing = _playing;
+    recording = _recording;
+  }
+  // Play10Ms() and Record10Ms() check the flags again under the lock, since
+  // the device may be stopped in between.
+  if (playing)
+    Play10Ms();
+  if (recording)
+    Record10Ms();
+}
+
 }  // namespace webrtc
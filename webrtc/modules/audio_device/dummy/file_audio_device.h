@@ -16,6 +16,7 @@
 #include <string>
 
 #include "webrtc/modules/audio_device/audio_device_generic.h"
+#include "webrtc/modules/audio_device/dummy/file_audio_device_ticker.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/include/file_wrapper.h"
 #include "webrtc/system_wrappers/include/clock.h"
@@ -29,7 +30,8 @@ class EventWrapper;
 
 // This is a fake audio device which plays audio from a file as its microphone
 // and plays out into a file.
-class FileAudioDevice : public AudioDeviceGeneric {
+class FileAudioDevice : public AudioDeviceGeneric,
+                        public FileAudioDeviceTicker::Client {
  public:
   // Constructs a file audio device with |id|. It will read audio from
   // |inputFilename| and record output audio to |outputFilename|.
@@ -37,9 +39,14 @@ class FileAudioDevice : public AudioDeviceGeneric {
   // The input file should be a readable 48k stereo raw file, and the output
   // file should point to a writable location. The output format will also be
   // 48k stereo raw audio.
+  //
+  // If |ticker| is set, recording and playout are driven by its thread
+  // instead of by two threads of the device's own. It must outlive the
+  // device.
   FileAudioDevice(const int32_t id,
                   const char* inputFilename,
-                  const char* outputFilename);
+                  const char* outputFilename,
+                  FileAudioDeviceTicker* ticker = nullptr);
   virtual ~FileAudioDevice();
 
   // Retrieve the currently utilized audio layer
@@ -166,6 +173,12 @@ class FileAudioDevice : public AudioDeviceGeneric {
   static bool PlayThreadFunc(void*);
   bool RecThreadProcess();
   bool PlayThreadProcess();
+  // Play out and record 10 ms of audio.
+  void Play10Ms();
+  void Record10Ms();
+
+  // FileAudioDeviceTicker::Client implementation.
+  void OnTick() override;
 
   int32_t _playout_index;
   int32_t _record_index;
@@ -196,6 +209,7 @@ class FileAudioDevice : public AudioDeviceGeneric {
   std::string _inputFilename;
 
   Clock* _clock;
+  FileAudioDeviceTicker* const _ticker;
 };
 
 }  // namespace webrtc
@@ -19,6 +19,7 @@ namespace webrtc {
 bool FileAudioDeviceFactory::_isConfigured = false;
 char FileAudioDeviceFactory::_inputAudioFilename[MAX_FILENAME_LEN] = "";
 char FileAudioDeviceFactory::_outputAudioFilename[MAX_FILENAME_LEN] = "";
+FileAudioDeviceTicker* FileAudioDeviceFactory::_ticker = nullptr;
 
 FileAudioDevice* FileAudioDeviceFactory::CreateFileAudioDevice(
     const int32_t id) {
@@ -28,7 +29,8 @@ FileAudioDevice* FileAudioDeviceFactory::CreateFileAudioDevice(
            "but did not set input/output files to use. Bailing out.\n");
     exit(1);
   }
-  return new FileAudioDevice(id, _inputAudioFilename, _outputAudioFilename);
+  return new FileAudioDevice(id, _inputAudioFilename, _outputAudioFilename,
+                             _ticker);
 }
 
 void FileAudioDeviceFactory::SetFilenamesToUse(
@@ -49,4 +51,8 @@ void FileAudioDeviceFactory::SetFilenamesToUse(
 #endif
 }
 
+void FileAudioDeviceFactory::SetTickerToUse(FileAudioDeviceTicker* ticker) {
+  _ticker = ticker;
+}
+
 }  // namespace webrtc
@@ -16,6 +16,7 @@
 namespace webrtc {
 
 class FileAudioDevice;
+class FileAudioDeviceTicker;
 
 // This class is used by audio_device_impl.cc when WebRTC is compiled with
 // WEBRTC_DUMMY_FILE_DEVICES. The application must include this file and set the
@@ -30,11 +31,17 @@ class FileAudioDeviceFactory {
   static void SetFilenamesToUse(const char* inputAudioFilename,
                                 const char* outputAudioFilename);
 
+  // Makes the devices created from now on run on |ticker| rather than on
+  // threads of their own, so that many of them can run in one process.
+  // |ticker| must outlive the devices; null goes back to separate threads.
+  static void SetTickerToUse(FileAudioDeviceTicker* ticker);
+
  private:
   static const uint32_t MAX_FILENAME_LEN = 512;
   static bool _isConfigured;
   static char _inputAudioFilename[MAX_FILENAME_LEN];
   static char _outputAudioFilename[MAX_FILENAME_LEN];
+  static FileAudioDeviceTicker* _ticker;
 };
 
 }  // namespace webrtc
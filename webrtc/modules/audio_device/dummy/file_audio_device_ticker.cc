@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_device/dummy/file_audio_device_ticker.h"
+
+#include <algorithm>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/timeutils.h"
+
+namespace webrtc {
+
+namespace {
+
+const int64_t kTickUs = FileAudioDeviceTicker::kTickMs * 1000;
+
+int64_t NowUs() {
+  return static_cast<int64_t>(rtc::TimeMicros());
+}
+
+}  // namespace
+
+const int FileAudioDeviceTicker::kTickMs;
+const int FileAudioDeviceTicker::kMaxTicksBehind;
+
+FileAudioDeviceTicker::FileAudioDeviceTicker()
+    : stop_event_(false, false), stopping_(0), next_tick_us_(0) {}
+
+FileAudioDeviceTicker::~FileAudioDeviceTicker() {
+  if (thread_) {
+    rtc::AtomicOps::ReleaseStore(&stopping_, 1);
+    stop_event_.Set();
+    thread_->Stop();
+  }
+}
+
+void FileAudioDeviceTicker::AddClient(Client* client) {
+  rtc::CritScope lock(&clients_crit_);
+  if (std::find(clients_.begin(), clients_.end(), client) == clients_.end())
+    clients_.push_back(client);
+  if (!thread_) {
+    next_tick_us_ = NowUs();
+    thread_.reset(new rtc::PlatformThread(&TickerThread, this,
+                                          "webrtc_audio_module_ticker"));
+    thread_->Start();
+    thread_->SetPriority(rtc::kRealtimePriority);
+  }
+}
+
+void FileAudioDeviceTicker::RemoveClient(Client* client) {
+  rtc::CritScope lock(&clients_crit_);
+  clients_.erase(std::remove(clients_.begin(), clients_.end(), client),
+                 clients_.end());
+}
+
+FileAudioDeviceTicker::Stats FileAudioDeviceTicker::GetStats() const {
+  rtc::CritScope lock(&stats_crit_);
+  return stats_;
+}
+
+void FileAudioDeviceTicker::ResetStats() {
+  rtc::CritScope lock(&stats_crit_);
+  stats_ = Stats();
+}
+
+bool FileAudioDeviceTicker::TickerThread(void* obj) {
+  return static_cast<FileAudioDeviceTicker*>(obj)->Process();
+}
+
+bool FileAudioDeviceTicker::Process() {
+  int64_t now_us = NowUs();
+  if (now_us < next_tick_us_) {
+    // Round up so that the tick isn't delivered early.
+    stop_event_.Wait(static_cast<int>((next_tick_us_ - now_us + 999) / 1000));
+    if (rtc::AtomicOps::AcquireLoad(&stopping_))
+      return false;
+    now_us = NowUs();
+    if (now_us < next_tick_us_)
+      return true;
+  }
+  if (rtc::AtomicOps::AcquireLoad(&stopping_))
+    return false;
+
+  int64_t delay_us = now_us - next_tick_us_;
+  int64_t dropped_ticks = 0;
+  if (delay_us >= kMaxTicksBehind * kTickUs) {
+    dropped_ticks = delay_us / kTickUs;
+    delay_us -= dropped_ticks * kTickUs;
+    next_tick_us_ += dropped_ticks * kTickUs;
+  }
+  next_tick_us_ += kTickUs;
+
+  {
+    rtc::CritScope lock(&clients_crit_);
+    for (Client* client : clients_)
+      client->OnTick();
+  }
+  const int64_t tick_time_us = NowUs() - now_us;
+
+  rtc::CritScope lock(&stats_crit_);
+  ++stats_.ticks;
+  stats_.dropped_ticks += dropped_ticks;
+  stats_.total_delay_us += delay_us;
+  stats_.max_delay_us = std::max(stats_.max_delay_us, delay_us);
+  stats_.max_tick_time_us = std::max(stats_.max_tick_time_us, tick_time_us);
+  return true;
+}
+
+}  // namespace webrtc
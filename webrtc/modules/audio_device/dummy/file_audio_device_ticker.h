@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_AUDIO_DEVICE_FILE_AUDIO_DEVICE_TICKER_H
+#define WEBRTC_AUDIO_DEVICE_FILE_AUDIO_DEVICE_TICKER_H
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// A single thread that calls OnTick() on all its clients every 10 ms. It lets
+// many FileAudioDevices run in one process, e.g. to load test a voice engine
+// with hundreds of virtual clients, without two threads per device.
+//
+// Ticks are scheduled on absolute times, so a late tick doesn't delay the
+// ones after it. If the clients take so long that the ticker falls more than
+// kMaxTicksBehind ticks behind, the missed ticks are dropped and counted.
+class FileAudioDeviceTicker {
+ public:
+  class Client {
+   public:
+    // Called on the ticker thread once per tick.
+    virtual void OnTick() = 0;
+
+   protected:
+    virtual ~Client() {}
+  };
+
+  struct Stats {
+    Stats()
+        : ticks(0),
+          dropped_ticks(0),
+          total_delay_us(0),
+          max_delay_us(0),
+          max_tick_time_us(0) {}
+    // Ticks delivered.
+    int64_t ticks;
+    // Ticks skipped after falling too far behind.
+    int64_t dropped_ticks;
+    // How late the ticks were delivered compared to when they were due.
+    int64_t total_delay_us;
+    int64_t max_delay_us;
+    // Longest time spent on the clients of one tick.
+    int64_t max_tick_time_us;
+  };
+
+  static const int kTickMs = 10;
+  static const int kMaxTicksBehind = 10;
+
+  FileAudioDeviceTicker();
+  ~FileAudioDeviceTicker();
+
+  // Adds |client| if it isn't ticked already. The thread is started with the
+  // first client.
+  void AddClient(Client* client);
+  // Removes |client|. Once this returns, OnTick() is neither running nor
+  // called again on it.
+  void RemoveClient(Client* client);
+
+  Stats GetStats() const;
+  void ResetStats();
+
+ private:
+  static bool TickerThread(void* obj);
+  bool Process();
+
+  // Held while the clients are ticked.
+  rtc::CriticalSection clients_crit_;
+  std::vector<Client*> clients_;
+
+  mutable rtc::CriticalSection stats_crit_;
+  Stats stats_;
+
+  rtc::Event stop_event_;
+  // Set on the owner's thread and read on the ticker thread.
+  volatile int stopping_;
+  int64_t next_tick_us_;
+  rtc::scoped_ptr<rtc::PlatformThread> thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(FileAudioDeviceTicker);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_AUDIO_DEVICE_FILE_AUDIO_DEVICE_TICKER_H
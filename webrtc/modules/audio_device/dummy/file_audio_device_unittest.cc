@@ -0,0 +1,172 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_device/dummy/file_audio_device.h"
+
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_device/dummy/file_audio_device_ticker.h"
+#include "webrtc/modules/audio_device/mock_audio_device_buffer.h"
+
+using ::testing::_;
+using ::testing::AtLeast;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+namespace webrtc {
+
+namespace {
+
+const int kWaitMs = 5000;
+
+class CountingClient : public FileAudioDeviceTicker::Client {
+ public:
+  explicit CountingClient(int signal_after)
+      : signal_after_(signal_after), ticks_(0), done_(false, false) {}
+  virtual ~CountingClient() {}
+
+  void OnTick() override {
+    if (rtc::AtomicOps::Increment(&ticks_) == signal_after_)
+      done_.Set();
+  }
+
+  int ticks() { return rtc::AtomicOps::AcquireLoad(&ticks_); }
+  bool Wait() { return done_.Wait(kWaitMs); }
+
+ private:
+  const int signal_after_;
+  volatile int ticks_;
+  rtc::Event done_;
+};
+
+}  // namespace
+
+TEST(FileAudioDeviceTickerTest, TicksAllClients) {
+  FileAudioDeviceTicker ticker;
+  CountingClient client1(10);
+  CountingClient client2(10);
+  ticker.AddClient(&client1);
+  ticker.AddClient(&client2);
+  // Adding a client twice doesn't tick it twice.
+  ticker.AddClient(&client2);
+  ASSERT_TRUE(client1.Wait());
+  ASSERT_TRUE(client2.Wait());
+
+  ticker.RemoveClient(&client1);
+  const int removed_ticks = client1.ticks();
+  CountingClient client3(5);
+  ticker.AddClient(&client3);
+  ASSERT_TRUE(client3.Wait());
+  EXPECT_EQ(removed_ticks, client1.ticks());
+  ticker.RemoveClient(&client2);
+  ticker.RemoveClient(&client3);
+
+  const FileAudioDeviceTicker::Stats stats = ticker.GetStats();
+  EXPECT_GE(stats.ticks, client2.ticks());
+  EXPECT_GE(stats.max_delay_us, 0);
+  EXPECT_LE(stats.total_delay_us, stats.ticks * stats.max_delay_us);
+  ticker.ResetStats();
+  EXPECT_EQ(0, ticker.GetStats().ticks);
+}
+
+// Many devices on one ticker are all played out, and stop being called once
+// stopped.
+TEST(FileAudioDeviceTest, DevicesShareTicker) {
+  const int kNumDevices = 20;
+  const size_t kSamplesPer10Ms = 480;
+  FileAudioDeviceTicker ticker;
+  NiceMock<MockAudioDeviceBuffer> buffers[kNumDevices];
+  rtc::scoped_ptr<FileAudioDevice> devices[kNumDevices];
+  for (int i = 0; i < kNumDevices; ++i) {
+    EXPECT_CALL(buffers[i], RequestPlayoutData(kSamplesPer10Ms))
+        .Times(AtLeast(1));
+    ON_CALL(buffers[i], GetPlayoutData(_))
+        .WillByDefault(Return(kSamplesPer10Ms));
+    devices[i].reset(new FileAudioDevice(i, "", "", &ticker));
+    devices[i]->AttachAudioBuffer(&buffers[i]);
+    EXPECT_EQ(0, devices[i]->InitPlayout());
+    EXPECT_EQ(0, devices[i]->StartPlayout());
+  }
+  // Every device is ticked once the last one added has been.
+  CountingClient last_client(3);
+  ticker.AddClient(&last_client);
+  ASSERT_TRUE(last_client.Wait());
+  ticker.RemoveClient(&last_client);
+
+  for (int i = 0; i < kNumDevices; ++i) {
+    EXPECT_EQ(0, devices[i]->StopPlayout());
+    ::testing::Mock::VerifyAndClearExpectations(&buffers[i]);
+    EXPECT_CALL(buffers[i], RequestPlayoutData(_)).Times(0);
+  }
+  CountingClient after_stop_client(3);
+  ticker.AddClient(&after_stop_client);
+  ASSERT_TRUE(after_stop_client.Wait());
+  ticker.RemoveClient(&after_stop_client);
+}
+
+// Starting and stopping recording on a device that is playing out leaves the
+// playout running on the ticker.
+TEST(FileAudioDeviceTest, RecordingStartsAndStopsWhilePlaying) {
+  const size_t kSamplesPer10Ms = 480;
+  FileAudioDeviceTicker ticker;
+  NiceMock<MockAudioDeviceBuffer> buffer;
+  CountingClient playout(3);
+  ON_CALL(buffer, GetPlayoutData(_))
+      .WillByDefault(Invoke([&playout, kSamplesPer10Ms](void*) {
+        playout.OnTick();
+        return static_cast<int32_t>(kSamplesPer10Ms);
+      }));
+  FileAudioDevice device(0, "", "", &ticker);
+  device.AttachAudioBuffer(&buffer);
+  EXPECT_EQ(0, device.InitPlayout());
+  EXPECT_EQ(0, device.InitRecording());
+  EXPECT_EQ(0, device.StartPlayout());
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(0, device.StartRecording());
+    EXPECT_EQ(0, device.StopRecording());
+  }
+  EXPECT_EQ(0, device.StartRecording());
+  ASSERT_TRUE(playout.Wait());
+  EXPECT_EQ(0, device.StopPlayout());
+  EXPECT_EQ(0, device.StopRecording());
+}
+
+// A device that is deleted while playing out is no longer ticked.
+TEST(FileAudioDeviceTest, DeletedDeviceIsNotTicked) {
+  const size_t kSamplesPer10Ms = 480;
+  FileAudioDeviceTicker ticker;
+  NiceMock<MockAudioDeviceBuffer> buffer;
+  CountingClient playout(3);
+  ON_CALL(buffer, GetPlayoutData(_))
+      .WillByDefault(Invoke([&playout, kSamplesPer10Ms](void*) {
+        playout.OnTick();
+        return static_cast<int32_t>(kSamplesPer10Ms);
+      }));
+  rtc::scoped_ptr<FileAudioDevice> device(
+      new FileAudioDevice(0, "", "", &ticker));
+  device->AttachAudioBuffer(&buffer);
+  EXPECT_EQ(0, device->InitPlayout());
+  EXPECT_EQ(0, device->StartPlayout());
+  ASSERT_TRUE(playout.Wait());
+  device.reset();
+
+  ::testing::Mock::VerifyAndClearExpectations(&buffer);
+  EXPECT_CALL(buffer, RequestPlayoutData(_)).Times(0);
+  CountingClient after_delete_client(3);
+  ticker.AddClient(&after_delete_client);
+  ASSERT_TRUE(after_delete_client.Wait());
+  ticker.RemoveClient(&after_delete_client);
+}
+
+}  // namespace webrtc
@@ -13,18 +13,43 @@
 #include <assert.h>
 
 #include <algorithm>
+#include <limits>
 
 namespace webrtc {
 
+namespace {
+
+bool CompareRectTop(const DesktopRect& a, const DesktopRect& b) {
+  return a.top() < b.top();
+}
+
+}  // namespace
+
 DesktopRegion::RowSpan::RowSpan(int32_t left, int32_t right)
     : left(left), right(right) {
 }
 
-DesktopRegion::Row::Row(int32_t top, int32_t bottom)
-    : top(top), bottom(bottom) {
+DesktopRegion::Row::Row(int32_t top,
+                        int32_t bottom,
+                        size_t spans_begin,
+                        size_t spans_end)
+    : top(top),
+      bottom(bottom),
+      spans_begin(spans_begin),
+      spans_end(spans_end) {
 }
 
-DesktopRegion::Row::~Row() {}
+DesktopRegion::RowsView::RowsView(const DesktopRegion& region)
+    : rows(region.rows_.data()),
+      num_rows(region.rows_.size()),
+      spans(region.spans_.data()) {
+}
+
+DesktopRegion::RowsView::RowsView(const Row* rows,
+                                  size_t num_rows,
+                                  const RowSpan* spans)
+    : rows(rows), num_rows(num_rows), spans(spans) {
+}
 
 DesktopRegion::DesktopRegion() {}
 
@@ -36,48 +61,27 @@ DesktopRegion::DesktopRegion(const DesktopRect* rects, int count) {
   AddRects(rects, count);
 }
 
-DesktopRegion::DesktopRegion(const DesktopRegion& other) {
-  *this = other;
+DesktopRegion::DesktopRegion(const DesktopRegion& other)
+    : rows_(other.rows_), spans_(other.spans_) {
 }
 
-DesktopRegion::~DesktopRegion() {
-  Clear();
-}
+DesktopRegion::~DesktopRegion() {}
 
 DesktopRegion& DesktopRegion::operator=(const DesktopRegion& other) {
-  Clear();
   rows_ = other.rows_;
-  for (Rows::iterator it = rows_.begin(); it != rows_.end(); ++it) {
-    // Copy each row.
-    Row* row = it->second;
-    it->second = new Row(*row);
-  }
+  spans_ = other.spans_;
   return *this;
 }
 
 bool DesktopRegion::Equals(const DesktopRegion& region) const {
-  // Iterate over rows of the tow regions and compare each row.
-  Rows::const_iterator it1 = rows_.begin();
-  Rows::const_iterator it2 = region.rows_.begin();
-  while (it1 != rows_.end()) {
-    if (it2 == region.rows_.end() ||
-        it1->first != it2->first ||
-        it1->second->top != it2->second->top ||
-        it1->second->bottom != it2->second->bottom ||
-        it1->second->spans != it2->second->spans) {
-      return false;
-    }
-    ++it1;
-    ++it2;
-  }
-  return it2 == region.rows_.end();
+  // Spans are stored in the order of the rows, so equal regions have the same
+  // arrays.
+  return rows_ == region.rows_ && spans_ == region.spans_;
 }
 
 void DesktopRegion::Clear() {
-  for (Rows::iterator row = rows_.begin(); row != rows_.end(); ++row) {
-    delete row->second;
-  }
   rows_.clear();
+  spans_.clear();
 }
 
 void DesktopRegion::SetRect(const DesktopRect& rect) {
@@ -89,403 +93,262 @@ void DesktopRegion::AddRect(const DesktopRect& rect) {
   if (rect.is_empty())
     return;
 
-  // Top of the part of the |rect| that hasn't been inserted yet. Increased as
-  // we iterate over the rows until it reaches |rect.bottom()|.
-  int top = rect.top();
-
-  // Iterate over all rows that may intersect with |rect| and add new rows when
-  // necessary.
-  Rows::iterator row = rows_.upper_bound(top);
-  while (top < rect.bottom()) {
-    if (row == rows_.end() || top < row->second->top)  {
-      // If |top| is above the top of the current |row| then add a new row above
-      // the current one.
-      int32_t bottom = rect.bottom();
-      if (row != rows_.end() && row->second->top < bottom)
-        bottom = row->second->top;
-      row = rows_.insert(
-          row, Rows::value_type(bottom, new Row(top, bottom)));
-    } else if (top > row->second->top) {
-      // If the |top| falls in the middle of the |row| then split |row| into
-      // two, at |top|, and leave |row| referring to the lower of the two,
-      // ready to insert a new span into.
-      assert(top <= row->second->bottom);
-      Rows::iterator new_row = rows_.insert(
-          row, Rows::value_type(top, new Row(row->second->top, top)));
-      row->second->top = top;
-      new_row->second->spans = row->second->spans;
-    }
+  // Rectangles are often added from top to bottom (e.g. by Differ), in which
+  // case the new row can simply be appended.
+  if (rows_.empty() || rect.top() >= rows_.back().bottom) {
+    RowSpan span(rect.left(), rect.right());
+    AppendRow(rect.top(), rect.bottom(), kUnion, &span, &span + 1, NULL, NULL);
+    return;
+  }
 
-    if (rect.bottom() < row->second->bottom) {
-      // If the bottom of the |rect| falls in the middle of the |row| split
-      // |row| into two, at |top|, and leave |row| referring to the upper of
-      // the two, ready to insert a new span into.
-      Rows::iterator new_row = rows_.insert(
-          row, Rows::value_type(rect.bottom(), new Row(top, rect.bottom())));
-      row->second->top = rect.bottom();
-      new_row->second->spans = row->second->spans;
-      row = new_row;
+  // Rectangles in raster order also extend the last row to the right, which
+  // only changes its last span.
+  Row& last_row = rows_.back();
+  if (rect.top() == last_row.top && rect.bottom() == last_row.bottom &&
+      rect.left() >= spans_.back().left) {
+    if (rect.left() <= spans_.back().right) {
+      spans_.back().right = std::max(spans_.back().right, rect.right());
+    } else {
+      spans_.push_back(RowSpan(rect.left(), rect.right()));
+      ++last_row.spans_end;
     }
-
-    // Add a new span to the current row.
-    AddSpanToRow(row->second, rect.left(), rect.right());
-    top = row->second->bottom;
-
-    MergeWithPrecedingRow(row);
-
-    // Move to the next row.
-    ++row;
+    MergeLastRow();
+    return;
   }
 
-  if (row != rows_.end())
-    MergeWithPrecedingRow(row);
+  CombineWithRect(rect, kUnion);
 }
 
 void DesktopRegion::AddRects(const DesktopRect* rects, int count) {
-  for (int i = 0; i < count; ++i) {
-    AddRect(rects[i]);
-  }
-}
-
-void DesktopRegion::MergeWithPrecedingRow(Rows::iterator row) {
-  assert(row != rows_.end());
-
-  if (row != rows_.begin()) {
-    Rows::iterator previous_row = row;
-    previous_row--;
-
-    // If |row| and |previous_row| are next to each other and contain the same
-    // set of spans then they can be merged.
-    if (previous_row->second->bottom == row->second->top &&
-        previous_row->second->spans == row->second->spans) {
-      row->second->top = previous_row->second->top;
-      delete previous_row->second;
-      rows_.erase(previous_row);
-    }
+  if (count <= 1) {
+    if (count == 1)
+      AddRect(rects[0]);
+    return;
   }
-}
 
-void DesktopRegion::AddRegion(const DesktopRegion& region) {
-  // TODO(sergeyu): This function is not optimized - potentially it can iterate
-  // over rows of the two regions similar to how it works in Intersect().
-  for (Iterator it(region); !it.IsAtEnd(); it.Advance()) {
-    AddRect(it.rect());
+  // Build a region from |rects| in a single sweep from top to bottom and then
+  // add it at once. The sweep stops at every top and bottom edge and collects
+  // spans of the rectangles that cover the row between two edges.
+  std::vector<DesktopRect> sorted_rects;
+  std::vector<int32_t> edges;
+  sorted_rects.reserve(count);
+  edges.reserve(2 * count);
+  for (int i = 0; i < count; ++i) {
+    if (rects[i].is_empty())
+      continue;
+    sorted_rects.push_back(rects[i]);
+    edges.push_back(rects[i].top());
+    edges.push_back(rects[i].bottom());
   }
-}
-
-void DesktopRegion::Intersect(const DesktopRegion& region1,
-                              const DesktopRegion& region2) {
-  Clear();
-
-  Rows::const_iterator it1 = region1.rows_.begin();
-  Rows::const_iterator end1 = region1.rows_.end();
-  Rows::const_iterator it2 = region2.rows_.begin();
-  Rows::const_iterator end2 = region2.rows_.end();
-  if (it1 == end1 || it2 == end2)
-    return;
-
-  while (it1 != end1 && it2 != end2) {
-    // Arrange for |it1| to always be the top-most of the rows.
-    if (it2->second->top < it1->second->top) {
-      std::swap(it1, it2);
-      std::swap(end1, end2);
+  std::sort(sorted_rects.begin(), sorted_rects.end(), CompareRectTop);
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  DesktopRegion added;
+  std::vector<DesktopRect> active_rects;
+  RowSpanSet row_spans;
+  size_t next_rect = 0;
+  for (size_t i = 0; i + 1 < edges.size(); ++i) {
+    int32_t top = edges[i];
+    int32_t bottom = edges[i + 1];
+
+    size_t active = 0;
+    for (size_t j = 0; j < active_rects.size(); ++j) {
+      if (active_rects[j].bottom() > top)
+        active_rects[active++] = active_rects[j];
     }
-
-    // Skip |it1| if it doesn't intersect |it2| at all.
-    if (it1->second->bottom <= it2->second->top) {
-      ++it1;
-      continue;
+    active_rects.resize(active);
+    while (next_rect < sorted_rects.size() &&
+           sorted_rects[next_rect].top() == top) {
+      active_rects.push_back(sorted_rects[next_rect++]);
     }
+    if (active_rects.empty())
+      continue;
 
-    // Top of the |it1| row is above the top of |it2|, so top of the
-    // intersection is always the top of |it2|.
-    int32_t top = it2->second->top;
-    int32_t bottom = std::min(it1->second->bottom, it2->second->bottom);
-
-    Rows::iterator new_row = rows_.insert(
-        rows_.end(), Rows::value_type(bottom, new Row(top, bottom)));
-    IntersectRows(it1->second->spans, it2->second->spans,
-                  &new_row->second->spans);
-    if (new_row->second->spans.empty()) {
-      delete new_row->second;
-      rows_.erase(new_row);
-    } else {
-      MergeWithPrecedingRow(new_row);
+    row_spans.clear();
+    for (size_t j = 0; j < active_rects.size(); ++j) {
+      row_spans.push_back(
+          RowSpan(active_rects[j].left(), active_rects[j].right()));
     }
+    std::sort(row_spans.begin(), row_spans.end(), CompareSpanLeftEdges);
+    added.AppendRow(top, bottom, kUnion, row_spans.data(),
+                    row_spans.data() + row_spans.size(), NULL, NULL);
+  }
 
-    // If |it1| was completely consumed, move to the next one.
-    if (it1->second->bottom == bottom)
-      ++it1;
-    // If |it2| was completely consumed, move to the next one.
-    if (it2->second->bottom == bottom)
-      ++it2;
+  if (is_empty()) {
+    Swap(&added);
+  } else {
+    AddRegion(added);
   }
 }
 
-// static
-void DesktopRegion::IntersectRows(const RowSpanSet& set1,
-                                  const RowSpanSet& set2,
-                                  RowSpanSet* output) {
-  RowSpanSet::const_iterator it1 = set1.begin();
-  RowSpanSet::const_iterator end1 = set1.end();
-  RowSpanSet::const_iterator it2 = set2.begin();
-  RowSpanSet::const_iterator end2 = set2.end();
-  assert(it1 != end1 && it2 != end2);
-
-  do {
-    // Arrange for |it1| to always be the left-most of the spans.
-    if (it2->left < it1->left) {
-      std::swap(it1, it2);
-      std::swap(end1, end2);
-    }
-
-    // Skip |it1| if it doesn't intersect |it2| at all.
-    if (it1->right <= it2->left) {
-      ++it1;
-      continue;
-    }
-
-    int32_t left = it2->left;
-    int32_t right = std::min(it1->right, it2->right);
-    assert(left < right);
-
-    output->push_back(RowSpan(left, right));
+void DesktopRegion::AddRegion(const DesktopRegion& region) {
+  if (region.is_empty())
+    return;
+  DesktopRegion result;
+  result.Combine(RowsView(*this), RowsView(region), kUnion);
+  Swap(&result);
+}
 
-    // If |it1| was completely consumed, move to the next one.
-    if (it1->right == right)
-      ++it1;
-    // If |it2| was completely consumed, move to the next one.
-    if (it2->right == right)
-      ++it2;
-  } while (it1 != end1 && it2 != end2);
+void DesktopRegion::Intersect(const DesktopRegion& region1,
+                              const DesktopRegion& region2) {
+  DesktopRegion result;
+  result.Combine(RowsView(region1), RowsView(region2), kIntersect);
+  Swap(&result);
 }
 
 void DesktopRegion::IntersectWith(const DesktopRegion& region) {
-  DesktopRegion old_region;
-  Swap(&old_region);
-  Intersect(old_region, region);
+  Intersect(*this, region);
 }
 
 void DesktopRegion::IntersectWith(const DesktopRect& rect) {
-  DesktopRegion region;
-  region.AddRect(rect);
-  IntersectWith(region);
+  if (rect.is_empty()) {
+    Clear();
+    return;
+  }
+  Row rect_row(rect.top(), rect.bottom(), 0, 1);
+  RowSpan rect_span(rect.left(), rect.right());
+  DesktopRegion result;
+  result.Combine(RowsView(*this), RowsView(&rect_row, 1, &rect_span),
+                 kIntersect);
+  Swap(&result);
 }
 
 void DesktopRegion::Subtract(const DesktopRegion& region) {
-  if (region.rows_.empty())
+  if (is_empty() || region.is_empty())
     return;
-
-  // |row_b| refers to the current row being subtracted.
-  Rows::const_iterator row_b = region.rows_.begin();
-
-  // Current vertical position at which subtraction is happening.
-  int top = row_b->second->top;
-
-  // |row_a| refers to the current row we are subtracting from. Skip all rows
-  // above |top|.
-  Rows::iterator row_a = rows_.upper_bound(top);
-
-  // Step through rows of the both regions subtracting content of |row_b| from
-  // |row_a|.
-  while (row_a != rows_.end() && row_b != region.rows_.end()) {
-    // Skip |row_a| if it doesn't intersect with the |row_b|.
-    if (row_a->second->bottom <= top) {
-      // Each output row is merged with previously-processed rows before further
-      // rows are processed.
-      MergeWithPrecedingRow(row_a);
-      ++row_a;
-      continue;
-    }
-
-    if (top > row_a->second->top) {
-      // If |top| falls in the middle of |row_a| then split |row_a| into two, at
-      // |top|, and leave |row_a| referring to the lower of the two, ready to
-      // subtract spans from.
-      assert(top <= row_a->second->bottom);
-      Rows::iterator new_row = rows_.insert(
-          row_a, Rows::value_type(top, new Row(row_a->second->top, top)));
-      row_a->second->top = top;
-      new_row->second->spans = row_a->second->spans;
-    } else if (top < row_a->second->top) {
-      // If the |top| is above |row_a| then skip the range between |top| and
-      // top of |row_a| because it's empty.
-      top = row_a->second->top;
-      if (top >= row_b->second->bottom) {
-        ++row_b;
-        if (row_b != region.rows_.end())
-          top = row_b->second->top;
-        continue;
-      }
-    }
-
-    if (row_b->second->bottom < row_a->second->bottom) {
-      // If the bottom of |row_b| falls in the middle of the |row_a| split
-      // |row_a| into two, at |top|, and leave |row_a| referring to the upper of
-      // the two, ready to subtract spans from.
-      int bottom = row_b->second->bottom;
-      Rows::iterator new_row =
-          rows_.insert(row_a, Rows::value_type(bottom, new Row(top, bottom)));
-      row_a->second->top = bottom;
-      new_row->second->spans = row_a->second->spans;
-      row_a = new_row;
-    }
-
-    // At this point the vertical range covered by |row_a| lays within the
-    // range covered by |row_b|. Subtract |row_b| spans from |row_a|.
-    RowSpanSet new_spans;
-    SubtractRows(row_a->second->spans, row_b->second->spans, &new_spans);
-    new_spans.swap(row_a->second->spans);
-    top = row_a->second->bottom;
-
-    if (top >= row_b->second->bottom) {
-      ++row_b;
-      if (row_b != region.rows_.end())
-        top = row_b->second->top;
-    }
-
-    // Check if the row is empty after subtraction and delete it. Otherwise move
-    // to the next one.
-    if (row_a->second->spans.empty()) {
-      Rows::iterator row_to_delete = row_a;
-      ++row_a;
-      delete row_to_delete->second;
-      rows_.erase(row_to_delete);
-    } else {
-      MergeWithPrecedingRow(row_a);
-      ++row_a;
-    }
-  }
-
-  if (row_a != rows_.end())
-    MergeWithPrecedingRow(row_a);
+  DesktopRegion result;
+  result.Combine(RowsView(*this), RowsView(region), kSubtract);
+  Swap(&result);
 }
 
 void DesktopRegion::Subtract(const DesktopRect& rect) {
-  DesktopRegion region;
-  region.AddRect(rect);
-  Subtract(region);
+  if (is_empty() || rect.is_empty())
+    return;
+  CombineWithRect(rect, kSubtract);
 }
 
 void DesktopRegion::Translate(int32_t dx, int32_t dy) {
-  Rows new_rows;
-
-  for (Rows::iterator it = rows_.begin(); it != rows_.end(); ++it) {
-    Row* row = it->second;
-
-    row->top += dy;
-    row->bottom += dy;
-
-    if (dx != 0) {
-      // Translate each span.
-      for (RowSpanSet::iterator span = row->spans.begin();
-           span != row->spans.end(); ++span) {
-        span->left += dx;
-        span->right += dx;
-      }
+  if (dy != 0) {
+    for (Rows::iterator row = rows_.begin(); row != rows_.end(); ++row) {
+      row->top += dy;
+      row->bottom += dy;
     }
-
-    if (dy != 0)
-      new_rows.insert(new_rows.end(), Rows::value_type(row->bottom, row));
   }
 
-  if (dy != 0)
-    new_rows.swap(rows_);
+  if (dx != 0) {
+    for (RowSpanSet::iterator span = spans_.begin(); span != spans_.end();
+         ++span) {
+      span->left += dx;
+      span->right += dx;
+    }
+  }
 }
 
 void DesktopRegion::Swap(DesktopRegion* region) {
   rows_.swap(region->rows_);
+  spans_.swap(region->spans_);
 }
 
 // static
-bool DesktopRegion::CompareSpanRight(const RowSpan& r, int32_t value) {
-  return r.right < value;
+bool DesktopRegion::CompareSpanLeft(const RowSpan& r, int32_t value) {
+  return r.left < value;
 }
 
 // static
-bool DesktopRegion::CompareSpanLeft(const RowSpan& r, int32_t value) {
-  return r.left < value;
+bool DesktopRegion::CompareSpanLeftEdges(const RowSpan& a, const RowSpan& b) {
+  return a.left < b.left;
 }
 
 // static
-void DesktopRegion::AddSpanToRow(Row* row, int left, int right) {
-  // First check if the new span is located to the right of all existing spans.
-  // This is an optimization to avoid binary search in the case when rectangles
-  // are inserted sequentially from left to right.
-  if (row->spans.empty() || left > row->spans.back().right) {
-    row->spans.push_back(RowSpan(left, right));
-    return;
-  }
+bool DesktopRegion::CompareRowBottom(const Row& r, int32_t value) {
+  return r.bottom <= value;
+}
 
-  // Find the first span that ends at or after |left|.
-  RowSpanSet::iterator start =
-      std::lower_bound(row->spans.begin(), row->spans.end(), left,
-                       CompareSpanRight);
-  assert(start < row->spans.end());
-
-  // Find the first span that starts after |right|.
-  RowSpanSet::iterator end =
-      std::lower_bound(start, row->spans.end(), right + 1, CompareSpanLeft);
-  if (end == row->spans.begin()) {
-    // There are no overlaps. Just insert the new span at the beginning.
-    row->spans.insert(row->spans.begin(), RowSpan(left, right));
-    return;
-  }
+bool DesktopRegion::IsSpanInRow(const Row& row, const RowSpan& span) const {
+  // Find the first span that starts at or after |span.left| and then check if
+  // it's the same span.
+  RowSpanSet::const_iterator end = spans_.begin() + row.spans_end;
+  RowSpanSet::const_iterator it =
+      std::lower_bound(spans_.begin() + row.spans_begin, end, span.left,
+                       CompareSpanLeft);
+  return it != end && *it == span;
+}
 
-  // Move end to the left, so that it points the last span that ends at or
-  // before |right|.
-  end--;
+// static
+void DesktopRegion::UnionRows(const RowSpan* begin1, const RowSpan* end1,
+                              const RowSpan* begin2, const RowSpan* end2,
+                              RowSpanSet* output) {
+  size_t output_begin = output->size();
+
+  // Merge the two sets by the left edge, coalescing spans that overlap or
+  // touch the last one added to |output|.
+  while (begin1 != end1 || begin2 != end2) {
+    const RowSpan* span;
+    if (begin2 == end2 || (begin1 != end1 && begin1->left <= begin2->left)) {
+      span = begin1++;
+    } else {
+      span = begin2++;
+    }
 
-  // At this point [start, end] is the range of spans that intersect with the
-  // new one.
-  if (end < start) {
-    // There are no overlaps. Just insert the new span at the correct position.
-    row->spans.insert(start, RowSpan(left, right));
-    return;
+    if (output->size() > output_begin && span->left <= output->back().right) {
+      output->back().right = std::max(output->back().right, span->right);
+    } else {
+      output->push_back(*span);
+    }
   }
-
-  left = std::min(left, start->left);
-  right = std::max(right, end->right);
-
-  // Replace range [start, end] with the new span.
-  *start = RowSpan(left, right);
-  ++start;
-  ++end;
-  if (start < end)
-    row->spans.erase(start, end);
 }
 
 // static
-bool DesktopRegion::IsSpanInRow(const Row& row, const RowSpan& span) {
-  // Find the first span that starts at or after |span.left| and then check if
-  // it's the same span.
-  RowSpanSet::const_iterator it =
-      std::lower_bound(row.spans.begin(), row.spans.end(), span.left,
-                       CompareSpanLeft);
-  return it != row.spans.end() && *it == span;
+void DesktopRegion::IntersectRows(const RowSpan* begin1, const RowSpan* end1,
+                                  const RowSpan* begin2, const RowSpan* end2,
+                                  RowSpanSet* output) {
+  while (begin1 != end1 && begin2 != end2) {
+    // Arrange for |begin1| to always be the left-most of the spans.
+    if (begin2->left < begin1->left) {
+      std::swap(begin1, begin2);
+      std::swap(end1, end2);
+    }
+
+    // Skip |begin1| if it doesn't intersect |begin2| at all.
+    if (begin1->right <= begin2->left) {
+      ++begin1;
+      continue;
+    }
+
+    int32_t left = begin2->left;
+    int32_t right = std::min(begin1->right, begin2->right);
+    assert(left < right);
+
+    output->push_back(RowSpan(left, right));
+
+    // If |begin1| was completely consumed, move to the next one.
+    if (begin1->right == right)
+      ++begin1;
+    // If |begin2| was completely consumed, move to the next one.
+    if (begin2->right == right)
+      ++begin2;
+  }
 }
 
 // static
-void DesktopRegion::SubtractRows(const RowSpanSet& set_a,
-                                 const RowSpanSet& set_b,
+void DesktopRegion::SubtractRows(const RowSpan* begin_a, const RowSpan* end_a,
+                                 const RowSpan* begin_b, const RowSpan* end_b,
                                  RowSpanSet* output) {
-  assert(!set_a.empty() && !set_b.empty());
-
-  RowSpanSet::const_iterator it_b = set_b.begin();
+  const RowSpan* it_b = begin_b;
 
   // Iterate over all spans in |set_a| adding parts of it that do not intersect
   // with |set_b| to the |output|.
-  for (RowSpanSet::const_iterator it_a = set_a.begin(); it_a != set_a.end();
-       ++it_a) {
+  for (const RowSpan* it_a = begin_a; it_a != end_a; ++it_a) {
     // If there is no intersection then append the current span and continue.
-    if (it_b == set_b.end() || it_a->right < it_b->left) {
+    if (it_b == end_b || it_a->right < it_b->left) {
       output->push_back(*it_a);
       continue;
     }
 
     // Iterate over |set_b| spans that may intersect with |it_a|.
     int pos = it_a->left;
-    while (it_b != set_b.end() && it_b->left < it_a->right) {
+    while (it_b != end_b && it_b->left < it_a->right) {
       if (it_b->left > pos)
         output->push_back(RowSpan(pos, it_b->left));
       if (it_b->right > pos) {
@@ -500,13 +363,171 @@ void DesktopRegion::SubtractRows(const RowSpanSet& set_a,
   }
 }
 
+void DesktopRegion::Combine(const RowsView& a,
+                            const RowsView& b,
+                            Operation operation) {
+  assert(a.num_rows == 0 || a.rows != rows_.data());
+  assert(b.num_rows == 0 || b.rows != rows_.data());
+
+  // |y| is the top of the part of both regions that hasn't been processed yet.
+  // Every step of the loop processes a band [top, bottom) in which neither
+  // region changes, so that the spans of the output row can be found from the
+  // spans of the current rows.
+  int32_t y = std::numeric_limits<int32_t>::min();
+  size_t row_a = 0;
+  size_t row_b = 0;
+  while (row_a < a.num_rows || row_b < b.num_rows) {
+    const Row* current_a = row_a < a.num_rows ? &a.rows[row_a] : NULL;
+    const Row* current_b = row_b < b.num_rows ? &b.rows[row_b] : NULL;
+    if (!current_a && operation != kUnion)
+      break;
+    if (!current_b && operation == kIntersect)
+      break;
+
+    int32_t top = std::numeric_limits<int32_t>::max();
+    if (current_a)
+      top = std::min(top, std::max(y, current_a->top));
+    if (current_b)
+      top = std::min(top, std::max(y, current_b->top));
+
+    bool in_a = current_a && current_a->top <= top;
+    bool in_b = current_b && current_b->top <= top;
+
+    int32_t bottom = std::numeric_limits<int32_t>::max();
+    if (current_a)
+      bottom = std::min(bottom, in_a ? current_a->bottom : current_a->top);
+    if (current_b)
+      bottom = std::min(bottom, in_b ? current_b->bottom : current_b->top);
+    assert(top < bottom);
+
+    const RowSpan* begin1 = NULL;
+    const RowSpan* end1 = NULL;
+    if (in_a) {
+      begin1 = a.spans + current_a->spans_begin;
+      end1 = a.spans + current_a->spans_end;
+    }
+    const RowSpan* begin2 = NULL;
+    const RowSpan* end2 = NULL;
+    if (in_b) {
+      begin2 = b.spans + current_b->spans_begin;
+      end2 = b.spans + current_b->spans_end;
+    }
+    AppendRow(top, bottom, operation, begin1, end1, begin2, end2);
+
+    y = bottom;
+    if (current_a && current_a->bottom <= y)
+      ++row_a;
+    if (current_b && current_b->bottom <= y)
+      ++row_b;
+  }
+}
+
+void DesktopRegion::CombineWithRect(const DesktopRect& rect,
+                                    Operation operation) {
+  assert(operation != kIntersect);
+  assert(!rows_.empty());
+
+  // Only the rows that intersect |rect| can change. One more row on each side
+  // is combined as well, so that they are merged with the changed rows if
+  // necessary.
+  Rows::iterator first_row = std::lower_bound(rows_.begin(), rows_.end(),
+                                              rect.top(), CompareRowBottom);
+  Rows::iterator last_row = first_row;
+  while (last_row != rows_.end() && last_row->top < rect.bottom())
+    ++last_row;
+  if (first_row == last_row && operation == kSubtract)
+    return;
+  if (first_row != rows_.begin())
+    --first_row;
+  if (last_row != rows_.end())
+    ++last_row;
+  size_t rows_begin = first_row - rows_.begin();
+  size_t rows_end = last_row - rows_.begin();
+
+  Row rect_row(rect.top(), rect.bottom(), 0, 1);
+  RowSpan rect_span(rect.left(), rect.right());
+  DesktopRegion result;
+  result.Combine(
+      RowsView(&rows_[rows_begin], rows_end - rows_begin, spans_.data()),
+      RowsView(&rect_row, 1, &rect_span), operation);
+
+  // Replace the combined rows and their spans with the result and update
+  // positions of the spans of the rows below them.
+  size_t spans_begin = rows_[rows_begin].spans_begin;
+  size_t spans_end = rows_[rows_end - 1].spans_end;
+  for (Rows::iterator row = result.rows_.begin(); row != result.rows_.end();
+       ++row) {
+    row->spans_begin += spans_begin;
+    row->spans_end += spans_begin;
+  }
+  for (Rows::iterator row = last_row; row != rows_.end(); ++row) {
+    row->spans_begin =
+        row->spans_begin - spans_end + spans_begin + result.spans_.size();
+    row->spans_end =
+        row->spans_end - spans_end + spans_begin + result.spans_.size();
+  }
+
+  rows_.erase(first_row, last_row);
+  rows_.insert(rows_.begin() + rows_begin, result.rows_.begin(),
+               result.rows_.end());
+  spans_.erase(spans_.begin() + spans_begin, spans_.begin() + spans_end);
+  spans_.insert(spans_.begin() + spans_begin, result.spans_.begin(),
+                result.spans_.end());
+}
+
+void DesktopRegion::AppendRow(int32_t top,
+                              int32_t bottom,
+                              Operation operation,
+                              const RowSpan* begin1,
+                              const RowSpan* end1,
+                              const RowSpan* begin2,
+                              const RowSpan* end2) {
+  size_t spans_begin = spans_.size();
+  switch (operation) {
+    case kUnion:
+      UnionRows(begin1, end1, begin2, end2, &spans_);
+      break;
+    case kIntersect:
+      IntersectRows(begin1, end1, begin2, end2, &spans_);
+      break;
+    case kSubtract:
+      SubtractRows(begin1, end1, begin2, end2, &spans_);
+      break;
+  }
+  size_t spans_end = spans_.size();
+  if (spans_end == spans_begin)
+    return;
+
+  rows_.push_back(Row(top, bottom, spans_begin, spans_end));
+  MergeLastRow();
+}
+
+void DesktopRegion::MergeLastRow() {
+  // If the last row and the one above it are next to each other and contain
+  // the same set of spans then they can be merged.
+  if (rows_.size() < 2)
+    return;
+  Row& last_row = rows_.back();
+  Row& previous_row = rows_[rows_.size() - 2];
+  if (previous_row.bottom == last_row.top &&
+      previous_row.spans_end - previous_row.spans_begin ==
+          last_row.spans_end - last_row.spans_begin &&
+      std::equal(spans_.begin() + previous_row.spans_begin,
+                 spans_.begin() + previous_row.spans_end,
+                 spans_.begin() + last_row.spans_begin)) {
+    previous_row.bottom = last_row.bottom;
+    spans_.erase(spans_.begin() + last_row.spans_begin, spans_.end());
+    rows_.pop_back();
+  }
+}
+
 DesktopRegion::Iterator::Iterator(const DesktopRegion& region)
     : region_(region),
-      row_(region.rows_.begin()),
-      previous_row_(region.rows_.end()) {
+      row_(0),
+      row_span_(0) {
   if (!IsAtEnd()) {
-    assert(row_->second->spans.size() > 0);
-    row_span_ = row_->second->spans.begin();
+    assert(region_.rows_[row_].spans_end > region_.rows_[row_].spans_begin);
+    row_span_ = region_.rows_[row_].spans_begin;
     UpdateCurrentRect();
   }
 }
@@ -514,7 +535,7 @@ DesktopRegion::Iterator::Iterator(const DesktopRegion& region)
 DesktopRegion::Iterator::~Iterator() {}
 
 bool DesktopRegion::Iterator::IsAtEnd() const {
-  return row_ == region_.rows_.end();
+  return row_ == region_.rows_.size();
 }
 
 void DesktopRegion::Iterator::Advance() {
@@ -522,48 +543,43 @@ void DesktopRegion::Iterator::Advance() {
 
   while (true) {
     ++row_span_;
-    if (row_span_ == row_->second->spans.end()) {
-      previous_row_ = row_;
+    if (row_span_ == region_.rows_[row_].spans_end) {
       ++row_;
-      if (row_ != region_.rows_.end()) {
-        assert(row_->second->spans.size() > 0);
-        row_span_ = row_->second->spans.begin();
-      }
+      if (IsAtEnd())
+        return;
+      assert(region_.rows_[row_].spans_end > region_.rows_[row_].spans_begin);
+      row_span_ = region_.rows_[row_].spans_begin;
     }
 
-    if (IsAtEnd())
-      return;
-
     // If the same span exists on the previous row then skip it, as we've
     // already returned this span merged into the previous one, via
     // UpdateCurrentRect().
-    if (previous_row_ != region_.rows_.end() &&
-        previous_row_->second->bottom == row_->second->top &&
-        IsSpanInRow(*previous_row_->second, *row_span_)) {
-      continue;
+    if (row_ > 0) {
+      const Row& previous_row = region_.rows_[row_ - 1];
+      if (previous_row.bottom == region_.rows_[row_].top &&
+          region_.IsSpanInRow(previous_row, region_.spans_[row_span_])) {
+        continue;
+      }
     }
 
     break;
   }
 
-  assert(!IsAtEnd());
   UpdateCurrentRect();
 }
 
 void DesktopRegion::Iterator::UpdateCurrentRect() {
   // Merge the current rectangle with the matching spans from later rows.
-  int bottom;
-  Rows::const_iterator bottom_row = row_;
-  Rows::const_iterator previous;
-  do {
-    bottom = bottom_row->second->bottom;
-    previous = bottom_row;
+  const RowSpan& span = region_.spans_[row_span_];
+  size_t bottom_row = row_;
+  while (bottom_row + 1 < region_.rows_.size() &&
+         region_.rows_[bottom_row].bottom ==
+             region_.rows_[bottom_row + 1].top &&
+         region_.IsSpanInRow(region_.rows_[bottom_row + 1], span)) {
     ++bottom_row;
-  } while (bottom_row != region_.rows_.end() &&
-           previous->second->bottom == bottom_row->second->top &&
-           IsSpanInRow(*bottom_row->second, *row_span_));
-  rect_ = DesktopRect::MakeLTRB(row_span_->left, row_->second->top,
-                                row_span_->right, bottom);
+  }
+  rect_ = DesktopRect::MakeLTRB(span.left, region_.rows_[row_].top, span.right,
+                                region_.rows_[bottom_row].bottom);
 }
 
 }  // namespace webrtc
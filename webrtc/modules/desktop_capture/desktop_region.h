@@ -11,7 +11,8 @@
 #ifndef WEBRTC_MODULES_DESKTOP_CAPTURE_DESKTOP_REGION_H_
 #define WEBRTC_MODULES_DESKTOP_CAPTURE_DESKTOP_REGION_H_
 
-#include <map>
+#include <stddef.h>
+
 #include <vector>
 
 #include "webrtc/base/constructormagic.h"
@@ -23,7 +24,9 @@ namespace webrtc {
 // DesktopRegion represents a region of the screen or window.
 //
 // Internally each region is stored as a set of rows where each row contains one
-// or more rectangles aligned vertically.
+// or more rectangles aligned vertically. Rows and their spans are kept in two
+// flat arrays sorted by position, so that operations on regions are linear
+// sweeps over contiguous memory that don't allocate per row.
 class DesktopRegion {
  private:
   // The following private types need to be declared first because they are used
@@ -33,7 +36,7 @@ class DesktopRegion {
   struct RowSpan {
     RowSpan(int32_t left, int32_t right);
 
-    // Used by std::vector<>.
+    // Used by std::equal().
     bool operator==(const RowSpan& that) const {
       return left == that.left && right == that.right;
     }
@@ -45,21 +48,27 @@ class DesktopRegion {
   typedef std::vector<RowSpan> RowSpanSet;
 
   // Row represents a single row of a region. A row is set of rectangles that
-  // have the same vertical position.
+  // have the same vertical position. Spans of the row are stored in
+  // [spans_begin, spans_end) of |spans_|.
   struct Row {
-    Row(int32_t top, int32_t bottom);
-    ~Row();
+    Row(int32_t top, int32_t bottom, size_t spans_begin, size_t spans_end);
+
+    bool operator==(const Row& that) const {
+      return top == that.top && bottom == that.bottom &&
+             spans_begin == that.spans_begin && spans_end == that.spans_end;
+    }
 
     int32_t top;
     int32_t bottom;
 
-    RowSpanSet spans;
+    size_t spans_begin;
+    size_t spans_end;
   };
 
-  // Type used to store list of rows in the region. The bottom position of row
-  // is used as the key so that rows are always ordered by their position. The
-  // map stores pointers to make Translate() more efficient.
-  typedef std::map<int, Row*> Rows;
+  // Rows are sorted by position, don't overlap, contain at least one span and
+  // adjacent rows never have the same spans, so that each region has exactly
+  // one representation. Spans of each row are sorted and don't touch.
+  typedef std::vector<Row> Rows;
 
  public:
   // Iterator that can be used to iterate over rectangles of a DesktopRegion.
@@ -82,9 +91,10 @@ class DesktopRegion {
     // into |rect_|, to generate more efficient output.
     void UpdateCurrentRect();
 
-    Rows::const_iterator row_;
-    Rows::const_iterator previous_row_;
-    RowSpanSet::const_iterator row_span_;
+    // Indices of the current row in |region_.rows_| and of the current span in
+    // |region_.spans_|.
+    size_t row_;
+    size_t row_span_;
     DesktopRect rect_;
   };
 
@@ -106,7 +116,8 @@ class DesktopRegion {
   // Reset region to contain just |rect|.
   void SetRect(const DesktopRect& rect);
 
-  // Adds specified rect(s) or region to the region.
+  // Adds specified rect(s) or region to the region. Adding many rects at once
+  // with AddRects() is faster than adding them one by one.
   void AddRect(const DesktopRect& rect);
   void AddRects(const DesktopRect* rects, int count);
   void AddRegion(const DesktopRegion& region);
@@ -132,33 +143,71 @@ class DesktopRegion {
   void Swap(DesktopRegion* region);
 
  private:
-  // Comparison functions used for std::lower_bound(). Compare left or right
-  // edges withs a given |value|.
+  enum Operation {
+    kUnion,
+    kIntersect,
+    kSubtract,
+  };
+
+  // Read-only rows and spans of a region, or of a single rectangle, that are
+  // combined with another region by Combine().
+  struct RowsView {
+    explicit RowsView(const DesktopRegion& region);
+    RowsView(const Row* rows, size_t num_rows, const RowSpan* spans);
+
+    const Row* rows;
+    size_t num_rows;
+    const RowSpan* spans;
+  };
+
+  // Comparison function used for std::lower_bound(). Compares left edge with a
+  // given |value|.
   static bool CompareSpanLeft(const RowSpan& r, int32_t value);
-  static bool CompareSpanRight(const RowSpan& r, int32_t value);
 
-  // Adds a new span to the row, coalescing spans if necessary.
-  static void AddSpanToRow(Row* row, int32_t left, int32_t right);
+  // Orders spans by their left edge, for std::sort().
+  static bool CompareSpanLeftEdges(const RowSpan& a, const RowSpan& b);
 
-  // Returns true if the |span| exists in the given |row|.
-  static bool IsSpanInRow(const Row& row, const RowSpan& rect);
+  // Compares bottom edge of a row with a given |value|.
+  static bool CompareRowBottom(const Row& r, int32_t value);
 
-  // Calculates the intersection of two sets of spans.
-  static void IntersectRows(const RowSpanSet& set1,
-                            const RowSpanSet& set2,
+  // Returns true if the |span| exists in the given |row|.
+  bool IsSpanInRow(const Row& row, const RowSpan& span) const;
+
+  // Appends to |output| the spans that are covered by both (kIntersect),
+  // either (kUnion) or only the first (kSubtract) of two sorted span sets.
+  static void UnionRows(const RowSpan* begin1, const RowSpan* end1,
+                        const RowSpan* begin2, const RowSpan* end2,
+                        RowSpanSet* output);
+  static void IntersectRows(const RowSpan* begin1, const RowSpan* end1,
+                            const RowSpan* begin2, const RowSpan* end2,
                             RowSpanSet* output);
-
-  static void SubtractRows(const RowSpanSet& set_a,
-                           const RowSpanSet& set_b,
+  static void SubtractRows(const RowSpan* begin_a, const RowSpan* end_a,
+                           const RowSpan* begin_b, const RowSpan* end_b,
                            RowSpanSet* output);
 
-  // Merges |row| with the row above it if they contain the same spans. Doesn't
-  // do anything if called with |row| set to rows_.begin() (i.e. first row of
-  // the region). If the rows were merged |row| remains a valid iterator to the
-  // merged row.
-  void MergeWithPrecedingRow(Rows::iterator row);
+  // Sweeps over rows of |a| and |b| from top to bottom and appends the result
+  // of |operation| on them to the region. Neither of them may refer to the
+  // rows of this region.
+  void Combine(const RowsView& a, const RowsView& b, Operation operation);
+
+  // Combines |rect| with the region in place, recomputing only the rows that
+  // |rect| intersects. Used for kUnion and kSubtract, where the other rows
+  // don't change.
+  void CombineWithRect(const DesktopRect& rect, Operation operation);
+
+  // Appends a row with the result of |operation| on two span sets, merging it
+  // with the preceding row if they are adjacent and contain the same spans.
+  // Doesn't add anything if the result is empty.
+  void AppendRow(int32_t top, int32_t bottom, Operation operation,
+                 const RowSpan* begin1, const RowSpan* end1,
+                 const RowSpan* begin2, const RowSpan* end2);
+
+  // Merges the last row into the one above it if they are adjacent and contain
+  // the same spans.
+  void MergeLastRow();
 
   Rows rows_;
+  RowSpanSet spans_;
 };
 
 }  // namespace webrtc
@@ -11,8 +11,11 @@
 #include "webrtc/modules/desktop_capture/desktop_region.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 
 namespace webrtc {
 
@@ -38,6 +41,63 @@ void CompareRegion(const DesktopRegion& region,
   EXPECT_TRUE(it.IsAtEnd());
 }
 
+std::vector<DesktopRect> RandomRects(int count, int width, int height,
+                                     int max_size) {
+  std::vector<DesktopRect> rects;
+  for (int i = 0; i < count; ++i) {
+    rects.push_back(DesktopRect::MakeXYWH(
+        RadmonInt(width), RadmonInt(height), 1 + RadmonInt(max_size),
+        1 + RadmonInt(max_size)));
+  }
+  return rects;
+}
+
+// Map of the pixels covered by rects or regions in a kMapSize x kMapSize area.
+const int kMapSize = 64;
+
+class RegionMap {
+ public:
+  RegionMap() : pixels_(kMapSize * kMapSize, 0) {}
+
+  void Fill(const DesktopRect& rect, int value) {
+    DesktopRect clipped = rect;
+    clipped.IntersectWith(DesktopRect::MakeWH(kMapSize, kMapSize));
+    for (int y = clipped.top(); y < clipped.bottom(); ++y) {
+      for (int x = clipped.left(); x < clipped.right(); ++x)
+        pixels_[y * kMapSize + x] = value;
+    }
+  }
+
+  // Fills the map with the rects of |region|, which must not overlap.
+  void FillRegion(const DesktopRegion& region) {
+    for (DesktopRegion::Iterator it(region); !it.IsAtEnd(); it.Advance()) {
+      for (int y = it.rect().top(); y < it.rect().bottom(); ++y) {
+        for (int x = it.rect().left(); x < it.rect().right(); ++x) {
+          ASSERT_EQ(0, pixels_[y * kMapSize + x]);
+          pixels_[y * kMapSize + x] = 1;
+        }
+      }
+    }
+  }
+
+  bool Equals(const RegionMap& other) const {
+    return pixels_ == other.pixels_;
+  }
+
+  void Intersect(const RegionMap& other) {
+    for (size_t i = 0; i < pixels_.size(); ++i)
+      pixels_[i] &= other.pixels_[i];
+  }
+
+  void Subtract(const RegionMap& other) {
+    for (size_t i = 0; i < pixels_.size(); ++i)
+      pixels_[i] &= ~other.pixels_[i];
+  }
+
+ private:
+  std::vector<int> pixels_;
+};
+
 }  // namespace
 
 // Verify that regions are empty when created.
@@ -686,6 +746,169 @@ TEST(DesktopRegionTest, SubtractRectOnSameCol) {
   }
 }
 
+// Compares all operations on regions built from random rects with the same
+// operations on pixel maps.
+TEST(DesktopRegionTest, RandomRegionsMatchMaps) {
+  for (int i = 0; i < 200; ++i) {
+    SCOPED_TRACE(i);
+    std::vector<DesktopRect> rects1 =
+        RandomRects(1 + RadmonInt(20), kMapSize, kMapSize, 24);
+    std::vector<DesktopRect> rects2 =
+        RandomRects(1 + RadmonInt(20), kMapSize, kMapSize, 24);
+
+    RegionMap map1;
+    RegionMap map2;
+    DesktopRegion region1;
+    DesktopRegion region2;
+    for (size_t j = 0; j < rects1.size(); ++j) {
+      map1.Fill(rects1[j], 1);
+      region1.AddRect(rects1[j]);
+    }
+    for (size_t j = 0; j < rects2.size(); ++j)
+      map2.Fill(rects2[j], 1);
+    region2.AddRects(&rects2[0], static_cast<int>(rects2.size()));
+    region1.IntersectWith(DesktopRect::MakeWH(kMapSize, kMapSize));
+    region2.IntersectWith(DesktopRect::MakeWH(kMapSize, kMapSize));
+
+    // Regions built one rect at a time and all at once are the same.
+    DesktopRegion batch_region1(&rects1[0], static_cast<int>(rects1.size()));
+    batch_region1.IntersectWith(DesktopRect::MakeWH(kMapSize, kMapSize));
+    EXPECT_TRUE(region1.Equals(batch_region1));
+
+    RegionMap result_map;
+    result_map.FillRegion(region1);
+    EXPECT_TRUE(result_map.Equals(map1));
+
+    DesktopRegion sum = region1;
+    sum.AddRegion(region2);
+    RegionMap sum_map = map1;
+    for (size_t j = 0; j < rects2.size(); ++j)
+      sum_map.Fill(rects2[j], 1);
+    result_map = RegionMap();
+    result_map.FillRegion(sum);
+    EXPECT_TRUE(result_map.Equals(sum_map));
+
+    DesktopRegion intersection;
+    intersection.Intersect(region1, region2);
+    RegionMap intersection_map = map1;
+    intersection_map.Intersect(map2);
+    result_map = RegionMap();
+    result_map.FillRegion(intersection);
+    EXPECT_TRUE(result_map.Equals(intersection_map));
+
+    DesktopRegion difference = region1;
+    difference.Subtract(region2);
+    RegionMap difference_map = map1;
+    difference_map.Subtract(map2);
+    result_map = RegionMap();
+    result_map.FillRegion(difference);
+    EXPECT_TRUE(result_map.Equals(difference_map));
+
+    // Subtracting rects one by one gives the same region.
+    DesktopRegion rect_difference = region1;
+    for (size_t j = 0; j < rects2.size(); ++j)
+      rect_difference.Subtract(rects2[j]);
+    EXPECT_TRUE(rect_difference.Equals(difference));
+  }
+}
+
+// Rects added row by row from left to right, with rows that sometimes repeat
+// the spans of the row above.
+TEST(DesktopRegionTest, RasterOrderRectsMatchMaps) {
+  for (int i = 0; i < 200; ++i) {
+    SCOPED_TRACE(i);
+    std::vector<DesktopRect> rects;
+    std::vector<DesktopRect> row_rects;
+    for (int top = RadmonInt(4); top < kMapSize;) {
+      const int height = 1 + RadmonInt(8);
+      if (row_rects.empty() || RadmonInt(3) != 0) {
+        row_rects.clear();
+        // Rects may overlap or touch the previous one.
+        for (int left = RadmonInt(8); left < kMapSize;
+             left += RadmonInt(12)) {
+          row_rects.push_back(
+              DesktopRect::MakeXYWH(left, 0, 1 + RadmonInt(8), 1));
+        }
+      }
+      for (size_t j = 0; j < row_rects.size(); ++j) {
+        rects.push_back(DesktopRect::MakeXYWH(
+            row_rects[j].left(), top, row_rects[j].width(), height));
+      }
+      top += height + RadmonInt(2);
+    }
+    if (rects.empty())
+      continue;
+
+    RegionMap map;
+    DesktopRegion region;
+    for (size_t j = 0; j < rects.size(); ++j) {
+      map.Fill(rects[j], 1);
+      region.AddRect(rects[j]);
+    }
+    DesktopRegion batch_region(&rects[0], static_cast<int>(rects.size()));
+    EXPECT_TRUE(region.Equals(batch_region));
+    region.IntersectWith(DesktopRect::MakeWH(kMapSize, kMapSize));
+    RegionMap result_map;
+    result_map.FillRegion(region);
+    EXPECT_TRUE(result_map.Equals(map));
+  }
+}
+
+// Measures operations on regions with thousands of small rects, as produced by
+// fine-grained damage notifications.
+TEST(DesktopRegionTest, DISABLED_LargeRandomRectSetsTime) {
+  const int kWidth = 1920;
+  const int kHeight = 1080;
+  const int kNumRects[] = {1000, 5000};
+  const int kNumRuns = 3;
+  for (int num_rects : kNumRects) {
+    std::vector<DesktopRect> rects =
+        RandomRects(num_rects, kWidth, kHeight, 32);
+    std::vector<DesktopRect> other_rects =
+        RandomRects(num_rects, kWidth, kHeight, 32);
+    DesktopRegion other(&other_rects[0], num_rects);
+
+    int64_t add_rect_us = 0;
+    int64_t add_rects_us = 0;
+    int64_t subtract_us = 0;
+    int64_t intersect_us = 0;
+    int64_t iterate_us = 0;
+    for (int run = 0; run < kNumRuns; ++run) {
+      int64_t start_us = rtc::TimeMicros();
+      DesktopRegion region;
+      for (int i = 0; i < num_rects; ++i)
+        region.AddRect(rects[i]);
+      add_rect_us += rtc::TimeMicros() - start_us;
+
+      start_us = rtc::TimeMicros();
+      DesktopRegion batch_region(&rects[0], num_rects);
+      add_rects_us += rtc::TimeMicros() - start_us;
+      EXPECT_TRUE(region.Equals(batch_region));
+
+      start_us = rtc::TimeMicros();
+      DesktopRegion difference = region;
+      difference.Subtract(other);
+      subtract_us += rtc::TimeMicros() - start_us;
+
+      start_us = rtc::TimeMicros();
+      DesktopRegion intersection;
+      intersection.Intersect(region, other);
+      intersect_us += rtc::TimeMicros() - start_us;
+
+      start_us = rtc::TimeMicros();
+      int count = 0;
+      for (DesktopRegion::Iterator it(region); !it.IsAtEnd(); it.Advance())
+        ++count;
+      iterate_us += rtc::TimeMicros() - start_us;
+      EXPECT_GT(count, 0);
+    }
+    LOG(LS_INFO) << num_rects << " rects: AddRect() " << add_rect_us / kNumRuns
+                 << " us, AddRects() " << add_rects_us / kNumRuns
+                 << " us, Subtract() " << subtract_us / kNumRuns
+                 << " us, Intersect() " << intersect_us / kNumRuns
+                 << " us, iteration " << iterate_us / kNumRuns << " us.";
+  }
+}
 
 TEST(DesktopRegionTest, DISABLED_Performance) {
   for (int c = 0; c < 1000; ++c) {
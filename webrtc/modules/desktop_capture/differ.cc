@@ -12,12 +12,27 @@
 
 #include "string.h"
 
+#include <algorithm>
+
 #include "webrtc/modules/desktop_capture/differ_block.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 #include "webrtc/system_wrappers/include/logging.h"
 
 namespace webrtc {
 
+const int Differ::kMinPixelsForThreads;
+const int Differ::kMaxThreads;
+
 Differ::Differ(int width, int height, int bpp, int stride) {
+  Init(width, height, bpp, stride, 0);
+}
+
+Differ::Differ(int width, int height, int bpp, int stride, int max_threads) {
+  Init(width, height, bpp, stride, max_threads);
+}
+
+void Differ::Init(int width, int height, int bpp, int stride,
+                  int max_threads) {
   // Dimensions of screen.
   width_ = width;
   height_ = height;
@@ -30,6 +45,22 @@ Differ::Differ(int width, int height, int bpp, int stride) {
   diff_info_height_ = ((height_ + kBlockSize - 1) / kBlockSize) + 1;
   diff_info_size_ = diff_info_width_ * diff_info_height_ * sizeof(bool);
   diff_info_.reset(new bool[diff_info_size_]);
+
+  prev_buffer_ = nullptr;
+  curr_buffer_ = nullptr;
+  num_block_rows_ = diff_info_height_ - 1;
+  num_bands_ = 1;
+  if (max_threads <= 0) {
+    max_threads =
+        std::min(static_cast<int>(CpuInfo::DetectNumberOfCores()), kMaxThreads);
+  }
+  if (max_threads > 1 && width_ * height_ >= kMinPixelsForThreads) {
+    workers_.reset(new RowBandWorkers(max_threads, "DifferWorker",
+                                      rtc::kNormalPriority));
+    // Changes tend to be bunched up, so several bands per thread keep one
+    // busy band from holding up the others.
+    num_bands_ = std::min(num_block_rows_, 4 * max_threads);
+  }
 }
 
 Differ::~Differ() {}
@@ -49,74 +80,71 @@ void Differ::MarkDirtyBlocks(const uint8_t* prev_buffer,
                              const uint8_t* curr_buffer) {
   memset(diff_info_.get(), 0, diff_info_size_);
 
+  prev_buffer_ = prev_buffer;
+  curr_buffer_ = curr_buffer;
+  if (workers_) {
+    workers_->Run(&MarkDirtyBlockRows, this, num_bands_);
+  } else {
+    for (int y = 0; y < num_block_rows_; y++)
+      MarkDirtyBlockRow(y);
+  }
+  prev_buffer_ = nullptr;
+  curr_buffer_ = nullptr;
+}
+
+void Differ::MarkDirtyBlockRows(void* obj, int band) {
+  Differ* differ = static_cast<Differ*>(obj);
+  const int first_row = band * differ->num_block_rows_ / differ->num_bands_;
+  const int end_row = (band + 1) * differ->num_block_rows_ / differ->num_bands_;
+  for (int y = first_row; y < end_row; y++)
+    differ->MarkDirtyBlockRow(y);
+}
+
+void Differ::MarkDirtyBlockRow(int y) {
   // Calc number of full blocks.
   int x_full_blocks = width_ / kBlockSize;
-  int y_full_blocks = height_ / kBlockSize;
 
   // Calc size of partial blocks which may be present on right and bottom edge.
   int partial_column_width = width_ - (x_full_blocks * kBlockSize);
-  int partial_row_height = height_ - (y_full_blocks * kBlockSize);
+  // If the screen height is not a multiple of the block size, then the last
+  // row is a partial row. This situation is far more common than the
+  // 'partial column' case.
+  int row_height = std::min(kBlockSize, height_ - y * kBlockSize);
 
   // Offset from the start of one block-column to the next.
   int block_x_offset = bytes_per_pixel_ * kBlockSize;
-  // Offset from the start of one block-row to the next.
-  int block_y_stride = (width_ * bytes_per_pixel_) * kBlockSize;
-  // Offset from the start of one diff_info row to the next.
-  int diff_info_stride = diff_info_width_ * sizeof(bool);
 
-  const uint8_t* prev_block_row_start = prev_buffer;
-  const uint8_t* curr_block_row_start = curr_buffer;
-  bool* diff_info_row_start = diff_info_.get();
+  const uint8_t* prev_block = prev_buffer_ + y * kBlockSize * bytes_per_row_;
+  const uint8_t* curr_block = curr_buffer_ + y * kBlockSize * bytes_per_row_;
+  bool* diff_info = diff_info_.get() + y * diff_info_width_;
 
-  for (int y = 0; y < y_full_blocks; y++) {
-    const uint8_t* prev_block = prev_block_row_start;
-    const uint8_t* curr_block = curr_block_row_start;
-    bool* diff_info = diff_info_row_start;
+  // Most of a screen is usually unchanged between frames. Comparing whole
+  // lines first lets an unchanged row of blocks be skipped without looking at
+  // the blocks one by one.
+  if (PartialBlocksEqual(prev_block, curr_block, bytes_per_row_, width_,
+                         row_height)) {
+    return;
+  }
 
-    for (int x = 0; x < x_full_blocks; x++) {
-      // Mark this block as being modified so that it gets incorporated into
-      // a dirty rect.
+  for (int x = 0; x < x_full_blocks; x++) {
+    // Mark this block as being modified so that it gets incorporated into
+    // a dirty rect.
+    if (row_height == kBlockSize) {
       *diff_info = BlockDifference(prev_block, curr_block, bytes_per_row_);
-      prev_block += block_x_offset;
-      curr_block += block_x_offset;
-      diff_info += sizeof(bool);
-    }
-
-    // If there is a partial column at the end, handle it.
-    // This condition should rarely, if ever, occur.
-    if (partial_column_width != 0) {
+    } else {
       *diff_info = !PartialBlocksEqual(prev_block, curr_block, bytes_per_row_,
-                                       partial_column_width, kBlockSize);
-      diff_info += sizeof(bool);
+                                       kBlockSize, row_height);
     }
-
-    // Update pointers for next row.
-    prev_block_row_start += block_y_stride;
-    curr_block_row_start += block_y_stride;
-    diff_info_row_start += diff_info_stride;
+    prev_block += block_x_offset;
+    curr_block += block_x_offset;
+    diff_info += sizeof(bool);
   }
 
-  // If the screen height is not a multiple of the block size, then this
-  // handles the last partial row. This situation is far more common than the
-  // 'partial column' case.
-  if (partial_row_height != 0) {
-    const uint8_t* prev_block = prev_block_row_start;
-    const uint8_t* curr_block = curr_block_row_start;
-    bool* diff_info = diff_info_row_start;
-    for (int x = 0; x < x_full_blocks; x++) {
-      *diff_info = !PartialBlocksEqual(prev_block, curr_block,
-                                       bytes_per_row_,
-                                       kBlockSize, partial_row_height);
-      prev_block += block_x_offset;
-      curr_block += block_x_offset;
-      diff_info += sizeof(bool);
-    }
-    if (partial_column_width != 0) {
-      *diff_info = !PartialBlocksEqual(prev_block, curr_block, bytes_per_row_,
-                                       partial_column_width,
-                                       partial_row_height);
-      diff_info += sizeof(bool);
-    }
+  // If there is a partial column at the end, handle it.
+  // This condition should rarely, if ever, occur.
+  if (partial_column_width != 0) {
+    *diff_info = !PartialBlocksEqual(prev_block, curr_block, bytes_per_row_,
+                                     partial_column_width, row_height);
   }
 }
 
@@ -135,6 +163,7 @@ bool Differ::PartialBlocksEqual(const uint8_t* prev_buffer,
 
 void Differ::MergeBlocks(DesktopRegion* region) {
   region->Clear();
+  dirty_rects_.clear();
 
   bool* diff_info_row_start = diff_info_.get();
   int diff_info_stride = diff_info_width_ * sizeof(bool);
@@ -196,7 +225,7 @@ void Differ::MergeBlocks(DesktopRegion* region) {
         if (top + height > height_) {
           height = height_ - top;
         }
-        region->AddRect(DesktopRect::MakeXYWH(left, top, width, height));
+        dirty_rects_.push_back(DesktopRect::MakeXYWH(left, top, width, height));
       }
 
       // Increment to next block in this row.
@@ -206,6 +235,10 @@ void Differ::MergeBlocks(DesktopRegion* region) {
     // Go to start of next row.
     diff_info_row_start += diff_info_stride;
   }
+
+  if (!dirty_rects_.empty()) {
+    region->AddRects(&dirty_rects_[0], static_cast<int>(dirty_rects_.size()));
+  }
 }
 
 }  // namespace webrtc
@@ -15,6 +15,7 @@
 
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/desktop_capture/desktop_region.h"
+#include "webrtc/system_wrappers/include/row_band_workers.h"
 
 namespace webrtc {
 
@@ -29,8 +30,16 @@ class Differ {
   // Create a differ that operates on bitmaps with the specified width, height
   // and bytes_per_pixel.
   Differ(int width, int height, int bytes_per_pixel, int stride);
+  // As above, spreading the work of bitmaps of at least |kMinPixelsForThreads|
+  // pixels over up to |max_threads| threads, the calling one included. 0
+  // picks one per core, up to |kMaxThreads|.
+  Differ(int width, int height, int bytes_per_pixel, int stride,
+         int max_threads);
   ~Differ();
 
+  static const int kMinPixelsForThreads = 1920 * 1080;
+  static const int kMaxThreads = 4;
+
   int width() { return width_; }
   int height() { return height_; }
   int bytes_per_pixel() { return bytes_per_pixel_; }
@@ -45,9 +54,16 @@ class Differ {
   // Allow tests to access our private parts.
   friend class DifferTest;
 
+  void Init(int width, int height, int bpp, int stride, int max_threads);
+
   // Identify all of the blocks that contain changed pixels.
   void MarkDirtyBlocks(const uint8_t* prev_buffer, const uint8_t* curr_buffer);
 
+  // Marks the blocks of the block rows in band |band| of |obj|, a Differ, for
+  // the buffers passed to MarkDirtyBlocks().
+  static void MarkDirtyBlockRows(void* obj, int band);
+  void MarkDirtyBlockRow(int y);
+
   // After the dirty blocks have been identified, this routine merges adjacent
   // blocks into a region.
   // The goal is to minimize the region that covers the dirty blocks.
@@ -81,6 +97,18 @@ class Differ {
   int diff_info_height_;
   int diff_info_size_;
 
+  // Rects found by MergeBlocks(), kept to avoid reallocating them every frame.
+  std::vector<DesktopRect> dirty_rects_;
+
+  // Buffers and bands of the MarkDirtyBlocks() call in progress.
+  const uint8_t* prev_buffer_;
+  const uint8_t* curr_buffer_;
+  int num_block_rows_;
+  int num_bands_;
+
+  // Set if the bitmaps are large enough to be split between threads.
+  rtc::scoped_ptr<RowBandWorkers> workers_;
+
   RTC_DISALLOW_COPY_AND_ASSIGN(Differ);
 };
 
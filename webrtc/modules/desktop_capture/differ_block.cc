@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include "build/build_config.h"
+#include "webrtc/modules/desktop_capture/differ_block_avx2.h"
 #include "webrtc/modules/desktop_capture/differ_block_sse2.h"
 #include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
@@ -43,9 +44,14 @@ bool BlockDifference(const uint8_t* image1,
     // TODO(hclam): Implement a NEON version.
     diff_proc = &BlockDifference_C;
 #else
+    bool have_avx2 = WebRtc_GetCPUInfo(kAVX2) != 0;
     bool have_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
-    // For x86 processors, check if SSE2 is supported.
-    if (have_sse2 && kBlockSize == 32) {
+    // For x86 processors, check if AVX2 or SSE2 is supported.
+    if (have_avx2 && kBlockSize == 32) {
+      diff_proc = &BlockDifference_AVX2_W32;
+    } else if (have_avx2 && kBlockSize == 16) {
+      diff_proc = &BlockDifference_AVX2_W16;
+    } else if (have_sse2 && kBlockSize == 32) {
       diff_proc = &BlockDifference_SSE2_W32;
     } else if (have_sse2 && kBlockSize == 16) {
       diff_proc = &BlockDifference_SSE2_W16;
@@ -15,30 +15,123 @@
 
 #include "webrtc/modules/desktop_capture/desktop_frame.h"
 #include "webrtc/modules/desktop_capture/shared_desktop_frame.h"
+#include "webrtc/modules/desktop_capture/shared_memory.h"
 #include "webrtc/system_wrappers/include/logging.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 
-ScreenCaptureFrameQueue::ScreenCaptureFrameQueue() : current_(0) {}
+const int ScreenCaptureFrameQueue::kDefaultQueueLength;
+const int ScreenCaptureFrameQueue::kMaxQueueLength;
+
+ScreenCaptureFrameQueue::ScreenCaptureFrameQueue() {
+  Init(kDefaultQueueLength);
+}
+
+ScreenCaptureFrameQueue::ScreenCaptureFrameQueue(int queue_length) {
+  Init(queue_length);
+}
 
 ScreenCaptureFrameQueue::~ScreenCaptureFrameQueue() {}
 
+void ScreenCaptureFrameQueue::Init(int queue_length) {
+  assert(queue_length >= 2 && queue_length <= kMaxQueueLength);
+  queue_length_ = queue_length;
+  current_ = 0;
+  previous_ = -1;
+  sequence_ = 0;
+  last_sequence_ = -1;
+  std::fill(frame_sequence_, frame_sequence_ + kMaxQueueLength, -1);
+}
+
 void ScreenCaptureFrameQueue::MoveToNextFrame() {
-  current_ = (current_ + 1) % kQueueLength;
+  previous_ = current_;
+  ++sequence_;
+  updated_regions_[sequence_ % kMaxQueueLength].Clear();
 
-  // Verify that the frame is not shared, i.e. that consumer has released it
-  // before attempting to capture again.
-  assert(!frames_[current_].get() || !frames_[current_]->IsShared());
+  // Reuse the frame that was captured the longest time ago among the frames
+  // the consumer doesn't hold. Empty slots are only used if there is no such
+  // frame, so that new frames are allocated only while the consumer holds on
+  // to frames.
+  int next = -1;
+  for (int i = 0; i < queue_length_; ++i) {
+    if (i == previous_ || !frames_[i].get() || frames_[i]->IsShared())
+      continue;
+    if (next < 0 || frame_sequence_[i] < frame_sequence_[next])
+      next = i;
+  }
+  for (int i = 0; next < 0 && i < queue_length_; ++i) {
+    if (i != previous_ && !frames_[i].get())
+      next = i;
+  }
+  if (next < 0) {
+    // The consumer holds all the frames. Give up the oldest one: the consumer
+    // keeps its reference to the buffer, and the caller allocates a new frame.
+    for (int i = 0; i < queue_length_; ++i) {
+      if (i != previous_ &&
+          (next < 0 || frame_sequence_[i] < frame_sequence_[next])) {
+        next = i;
+      }
+    }
+    LOG(LS_VERBOSE) << "All " << queue_length_
+                    << " frames are in use, allocating a new one.";
+    frames_[next].reset();
+  }
+
+  current_ = next;
+  last_sequence_ = frames_[current_].get() ? frame_sequence_[current_] : -1;
+  frame_sequence_[current_] = sequence_;
 }
 
 void ScreenCaptureFrameQueue::ReplaceCurrentFrame(DesktopFrame* frame) {
   frames_[current_].reset(SharedDesktopFrame::Wrap(frame));
+  last_sequence_ = -1;
+}
+
+void ScreenCaptureFrameQueue::AllocateCurrentFrame(
+    const DesktopSize& size,
+    DesktopCapturer::Callback* callback) {
+  if (current_frame() && current_frame()->size().equals(size))
+    return;
+
+  const int stride = size.width() * DesktopFrame::kBytesPerPixel;
+  SharedMemory* shared_memory =
+      callback ? callback->CreateSharedMemory(stride * size.height()) : NULL;
+  if (shared_memory) {
+    ReplaceCurrentFrame(
+        new SharedMemoryDesktopFrame(size, stride, shared_memory));
+  } else {
+    ReplaceCurrentFrame(new BasicDesktopFrame(size));
+  }
 }
 
 void ScreenCaptureFrameQueue::Reset() {
-  for (int i = 0; i < kQueueLength; ++i)
+  for (int i = 0; i < kMaxQueueLength; ++i) {
     frames_[i].reset();
+    frame_sequence_[i] = -1;
+  }
+  previous_ = -1;
+  last_sequence_ = -1;
+}
+
+void ScreenCaptureFrameQueue::SetUpdatedRegion(const DesktopRegion& region) {
+  updated_regions_[sequence_ % kMaxQueueLength] = region;
+}
+
+void ScreenCaptureFrameQueue::GetOutdatedRegion(DesktopRegion* region) const {
+  region->Clear();
+  if (!current_frame())
+    return;
+
+  // Everything is out of date in a new frame, or if the regions captured since
+  // the frame was last captured are no longer known.
+  if (last_sequence_ < 0 || sequence_ - last_sequence_ > kMaxQueueLength) {
+    region->SetRect(DesktopRect::MakeSize(current_frame()->size()));
+    return;
+  }
+
+  for (int sequence = last_sequence_ + 1; sequence < sequence_; ++sequence)
+    region->AddRegion(updated_regions_[sequence % kMaxQueueLength]);
 }
 
 }  // namespace webrtc
@@ -12,6 +12,8 @@
 #define WEBRTC_MODULES_DESKTOP_CAPTURE_SCREEN_CAPTURE_FRAME_QUEUE_H_
 
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/desktop_capture/desktop_capturer.h"
+#include "webrtc/modules/desktop_capture/desktop_region.h"
 #include "webrtc/modules/desktop_capture/shared_desktop_frame.h"
 #include "webrtc/typedefs.h"
 
@@ -27,16 +29,24 @@ namespace webrtc {
 // MoveToNextFrame() call, if any.
 //
 // The caller is expected to (re)allocate frames if current_frame() returns
-// NULL. The caller can mark all frames in the queue for reallocation (when,
-// say, frame dimensions change). The queue records which frames need updating
-// which the caller can query.
+// NULL, either itself or with AllocateCurrentFrame(). The caller can mark all
+// frames in the queue for reallocation (when, say, frame dimensions change).
+// The queue records which frames need updating which the caller can query.
 //
-// Frame consumer is expected to never hold more than kQueueLength frames
-// created by this function and it should release the earliest one before trying
-// to capture a new frame (i.e. before MoveToNextFrame() is called).
+// Frames handed to the consumer as SharedDesktopFrame clones of the current
+// frame are tracked, and MoveToNextFrame() skips frames the consumer still
+// holds, so that the consumer can keep frames (e.g. while encoding them)
+// without copying them. If the consumer holds all frames in the queue, the
+// oldest one is given up to the consumer and replaced by a new one.
 class ScreenCaptureFrameQueue {
  public:
+  // Allows the consumer to hold on to one frame while the capturer reads the
+  // previous frame and writes the current one.
+  static const int kDefaultQueueLength = 3;
+  static const int kMaxQueueLength = 8;
+
   ScreenCaptureFrameQueue();
+  explicit ScreenCaptureFrameQueue(int queue_length);
   ~ScreenCaptureFrameQueue();
 
   // Moves to the next frame in the queue, moving the 'current' frame to become
@@ -47,24 +57,58 @@ class ScreenCaptureFrameQueue {
   // existing frame (if any) is destroyed. Takes ownership of |frame|.
   void ReplaceCurrentFrame(DesktopFrame* frame);
 
+  // Replaces the current frame with a new frame of |size|, unless there is a
+  // current frame of that size already. The new frame is stored in shared
+  // memory created by |callback| if it provides it, so that the consumer can
+  // use the frame without copying it, and on the heap otherwise.
+  void AllocateCurrentFrame(const DesktopSize& size,
+                            DesktopCapturer::Callback* callback);
+
   // Marks all frames obsolete and resets the previous frame pointer. No
   // frames are freed though as the caller can still access them.
   void Reset();
 
+  // Records the region of the current frame that the caller has captured.
+  void SetUpdatedRegion(const DesktopRegion& region);
+
+  // Returns the region that is out of date in the current frame compared to
+  // the previous one, i.e. the regions captured into other frames since the
+  // current frame was captured. That's the whole frame for new frames.
+  void GetOutdatedRegion(DesktopRegion* region) const;
+
   SharedDesktopFrame* current_frame() const {
     return frames_[current_].get();
   }
 
   SharedDesktopFrame* previous_frame() const {
-    return frames_[(current_ + kQueueLength - 1) % kQueueLength].get();
+    return previous_ >= 0 ? frames_[previous_].get() : NULL;
   }
 
  private:
-  // Index of the current frame.
+  // Used by both constructors.
+  void Init(int queue_length);
+
+  int queue_length_;
+
+  // Index of the current and of the previous frame, or -1 if there is no
+  // previous frame.
   int current_;
+  int previous_;
+
+  rtc::scoped_ptr<SharedDesktopFrame> frames_[kMaxQueueLength];
+
+  // Number of MoveToNextFrame() calls so far, and the value it had when each
+  // frame was last the current frame.
+  int sequence_;
+  int frame_sequence_[kMaxQueueLength];
+
+  // Value of |sequence_| when the current frame was the current frame before,
+  // or -1 if it's a new frame.
+  int last_sequence_;
 
-  static const int kQueueLength = 2;
-  rtc::scoped_ptr<SharedDesktopFrame> frames_[kQueueLength];
+  // Regions passed to SetUpdatedRegion() for the last kMaxQueueLength frames,
+  // indexed by |sequence_| % kMaxQueueLength.
+  DesktopRegion updated_regions_[kMaxQueueLength];
 
   RTC_DISALLOW_COPY_AND_ASSIGN(ScreenCaptureFrameQueue);
 };
@@ -0,0 +1,248 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/screen_capture_frame_queue.h"
+
+#include <deque>
+
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/desktop_capture/desktop_frame.h"
+#include "webrtc/modules/desktop_capture/screen_capturer_mock_objects.h"
+#include "webrtc/modules/desktop_capture/shared_memory.h"
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::Invoke;
+using ::testing::Return;
+
+namespace webrtc {
+
+namespace {
+
+const int kTestSharedMemoryId = 123;
+
+class FakeSharedMemory : public SharedMemory {
+ public:
+  FakeSharedMemory(char* buffer, size_t size)
+      : SharedMemory(buffer, size, 0, kTestSharedMemoryId), buffer_(buffer) {}
+  ~FakeSharedMemory() override { delete[] buffer_; }
+
+ private:
+  char* buffer_;
+  RTC_DISALLOW_COPY_AND_ASSIGN(FakeSharedMemory);
+};
+
+SharedMemory* CreateFakeSharedMemory(size_t size) {
+  return new FakeSharedMemory(new char[size], size);
+}
+
+// Simulates a capturer that only captures the damaged part of the screen into
+// frames of |queue|, and a consumer that holds each frame for |frames_held|
+// captures (e.g. while it is being encoded). Returns the number of bytes
+// copied per frame to synchronize the frames with the previous ones.
+size_t BytesCopiedPerFrame(int queue_length, size_t frames_held) {
+  const DesktopSize kSize(1280, 720);
+  const int kNumFrames = 60;
+
+  ScreenCaptureFrameQueue queue(queue_length);
+  MockScreenCapturerCallback callback;
+  EXPECT_CALL(callback, CreateSharedMemory(_))
+      .Times(AnyNumber())
+      .WillRepeatedly(Invoke(&CreateFakeSharedMemory));
+
+  std::deque<DesktopFrame*> held_frames;
+  size_t bytes_copied = 0;
+  for (int i = 0; i < kNumFrames; ++i) {
+    queue.MoveToNextFrame();
+    queue.AllocateCurrentFrame(kSize, &callback);
+    DesktopFrame* frame = queue.current_frame();
+    EXPECT_TRUE(frame->shared_memory());
+
+    if (queue.previous_frame()) {
+      DesktopRegion outdated_region;
+      queue.GetOutdatedRegion(&outdated_region);
+      for (DesktopRegion::Iterator it(outdated_region); !it.IsAtEnd();
+           it.Advance()) {
+        frame->CopyPixelsFrom(*queue.previous_frame(), it.rect().top_left(),
+                              it.rect());
+        bytes_copied += it.rect().width() * it.rect().height() *
+                        DesktopFrame::kBytesPerPixel;
+      }
+    }
+
+    // A small part of the screen changes in each frame.
+    DesktopRect damaged_rect =
+        DesktopRect::MakeXYWH((i * 64) % kSize.width(), 0, 64, 64);
+    memset(frame->GetFrameDataAtPos(damaged_rect.top_left()), i,
+           damaged_rect.width() * DesktopFrame::kBytesPerPixel);
+    queue.SetUpdatedRegion(DesktopRegion(damaged_rect));
+
+    held_frames.push_back(queue.current_frame()->Share());
+    while (held_frames.size() > frames_held) {
+      delete held_frames.front();
+      held_frames.pop_front();
+    }
+  }
+  while (!held_frames.empty()) {
+    delete held_frames.front();
+    held_frames.pop_front();
+  }
+
+  return bytes_copied / kNumFrames;
+}
+
+}  // namespace
+
+TEST(ScreenCaptureFrameQueueTest, AlternatesBetweenTwoFrames) {
+  ScreenCaptureFrameQueue queue;
+  queue.MoveToNextFrame();
+  queue.AllocateCurrentFrame(DesktopSize(16, 16), NULL);
+  SharedDesktopFrame* first = queue.current_frame();
+  ASSERT_TRUE(first);
+  EXPECT_FALSE(first->shared_memory());
+
+  queue.MoveToNextFrame();
+  EXPECT_EQ(first, queue.previous_frame());
+  EXPECT_FALSE(queue.current_frame());
+  queue.AllocateCurrentFrame(DesktopSize(16, 16), NULL);
+  SharedDesktopFrame* second = queue.current_frame();
+
+  // No third frame is allocated unless the consumer holds frames.
+  for (int i = 0; i < 4; ++i) {
+    queue.MoveToNextFrame();
+    EXPECT_EQ(i % 2 ? second : first, queue.current_frame());
+    EXPECT_EQ(i % 2 ? first : second, queue.previous_frame());
+  }
+}
+
+TEST(ScreenCaptureFrameQueueTest, SkipsFramesHeldByConsumer) {
+  ScreenCaptureFrameQueue queue(4);
+  std::vector<DesktopFrame*> held_frames;
+  std::vector<uint8_t*> buffers;
+  for (int i = 0; i < 3; ++i) {
+    queue.MoveToNextFrame();
+    queue.AllocateCurrentFrame(DesktopSize(16, 16), NULL);
+    *queue.current_frame()->data() = i;
+    held_frames.push_back(queue.current_frame()->Share());
+    buffers.push_back(queue.current_frame()->data());
+  }
+
+  // All three frames are held, so the fourth one is new.
+  queue.MoveToNextFrame();
+  EXPECT_FALSE(queue.current_frame());
+  queue.AllocateCurrentFrame(DesktopSize(16, 16), NULL);
+
+  // Once the consumer releases the oldest frame it's reused.
+  delete held_frames[0];
+  queue.MoveToNextFrame();
+  EXPECT_EQ(buffers[0], queue.current_frame()->data());
+
+  // The consumer still sees the frames it holds unchanged.
+  EXPECT_EQ(1, *held_frames[1]->data());
+  EXPECT_EQ(2, *held_frames[2]->data());
+  delete held_frames[1];
+  delete held_frames[2];
+}
+
+TEST(ScreenCaptureFrameQueueTest, ReplacesOldestFrameWhenAllAreHeld) {
+  ScreenCaptureFrameQueue queue(2);
+  queue.MoveToNextFrame();
+  queue.AllocateCurrentFrame(DesktopSize(16, 16), NULL);
+  *queue.current_frame()->data() = 1;
+  rtc::scoped_ptr<DesktopFrame> first(queue.current_frame()->Share());
+  queue.MoveToNextFrame();
+  queue.AllocateCurrentFrame(DesktopSize(16, 16), NULL);
+  rtc::scoped_ptr<DesktopFrame> second(queue.current_frame()->Share());
+
+  queue.MoveToNextFrame();
+  EXPECT_FALSE(queue.current_frame());
+  queue.AllocateCurrentFrame(DesktopSize(16, 16), NULL);
+  *queue.current_frame()->data() = 3;
+  EXPECT_EQ(1, *first->data());
+}
+
+TEST(ScreenCaptureFrameQueueTest, OutdatedRegion) {
+  const DesktopSize kSize(100, 100);
+  ScreenCaptureFrameQueue queue(3);
+  DesktopRegion region;
+
+  // New frames are out of date.
+  queue.MoveToNextFrame();
+  queue.AllocateCurrentFrame(kSize, NULL);
+  queue.GetOutdatedRegion(&region);
+  EXPECT_TRUE(region.Equals(DesktopRegion(DesktopRect::MakeSize(kSize))));
+  queue.SetUpdatedRegion(DesktopRegion(DesktopRect::MakeXYWH(0, 0, 10, 10)));
+  rtc::scoped_ptr<DesktopFrame> held(queue.current_frame()->Share());
+
+  queue.MoveToNextFrame();
+  queue.AllocateCurrentFrame(kSize, NULL);
+  queue.SetUpdatedRegion(DesktopRegion(DesktopRect::MakeXYWH(20, 0, 10, 10)));
+  queue.MoveToNextFrame();
+  queue.AllocateCurrentFrame(kSize, NULL);
+  queue.SetUpdatedRegion(DesktopRegion(DesktopRect::MakeXYWH(40, 0, 10, 10)));
+  held.reset();
+
+  // The first frame has missed the two captures since.
+  queue.MoveToNextFrame();
+  queue.GetOutdatedRegion(&region);
+  DesktopRegion expected(DesktopRect::MakeXYWH(20, 0, 10, 10));
+  expected.AddRect(DesktopRect::MakeXYWH(40, 0, 10, 10));
+  EXPECT_TRUE(region.Equals(expected));
+
+  // After a reset everything is out of date again.
+  queue.Reset();
+  queue.MoveToNextFrame();
+  EXPECT_FALSE(queue.previous_frame());
+  queue.AllocateCurrentFrame(kSize, NULL);
+  queue.GetOutdatedRegion(&region);
+  EXPECT_TRUE(region.Equals(DesktopRegion(DesktopRect::MakeSize(kSize))));
+}
+
+TEST(ScreenCaptureFrameQueueTest, AllocatesFramesInSharedMemory) {
+  MockScreenCapturerCallback callback;
+  EXPECT_CALL(callback, CreateSharedMemory(16 * 16 * 4))
+      .WillOnce(Invoke(&CreateFakeSharedMemory))
+      .WillOnce(Return(static_cast<SharedMemory*>(NULL)));
+
+  ScreenCaptureFrameQueue queue;
+  queue.MoveToNextFrame();
+  queue.AllocateCurrentFrame(DesktopSize(16, 16), &callback);
+  ASSERT_TRUE(queue.current_frame()->shared_memory());
+  EXPECT_EQ(kTestSharedMemoryId, queue.current_frame()->shared_memory()->id());
+
+  // Frames of the same size are reused.
+  queue.AllocateCurrentFrame(DesktopSize(16, 16), &callback);
+  ASSERT_TRUE(queue.current_frame()->shared_memory());
+
+  // Falls back to the heap if there is no shared memory.
+  queue.MoveToNextFrame();
+  queue.AllocateCurrentFrame(DesktopSize(16, 16), &callback);
+  ASSERT_TRUE(queue.current_frame());
+  EXPECT_FALSE(queue.current_frame()->shared_memory());
+}
+
+TEST(ScreenCaptureFrameQueueTest, BytesCopiedPerFrame) {
+  const size_t kFrameBytes = 1280 * 720 * DesktopFrame::kBytesPerPixel;
+  for (size_t frames_held = 0; frames_held <= 3; ++frames_held) {
+    for (int queue_length = 2; queue_length <= 5; ++queue_length) {
+      size_t bytes = BytesCopiedPerFrame(queue_length, frames_held);
+      // Frames are only synchronized with the damaged regions as long as the
+      // queue has a frame that the consumer doesn't hold.
+      if (queue_length > static_cast<int>(frames_held)) {
+        EXPECT_LT(bytes, kFrameBytes / 10)
+            << "Queue of " << queue_length << " frames, consumer holds "
+            << frames_held;
+      }
+    }
+  }
+}
+
+}  // namespace webrtc
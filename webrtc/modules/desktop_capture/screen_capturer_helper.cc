@@ -12,6 +12,7 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <vector>
 
 #include "webrtc/system_wrappers/include/logging.h"
 
@@ -91,14 +92,19 @@ void ScreenCapturerHelper::ExpandToGrid(const DesktopRegion& region,
   int grid_size = 1 << log_grid_size;
   int grid_size_mask = ~(grid_size - 1);
 
-  result->Clear();
+  // The expanded rects overlap, so they are added at once rather than merged
+  // into the region one by one.
+  std::vector<DesktopRect> rects;
   for (DesktopRegion::Iterator it(region); !it.IsAtEnd(); it.Advance()) {
     int left = DownToMultiple(it.rect().left(), grid_size_mask);
     int right = UpToMultiple(it.rect().right(), grid_size, grid_size_mask);
     int top = DownToMultiple(it.rect().top(), grid_size_mask);
     int bottom = UpToMultiple(it.rect().bottom(), grid_size, grid_size_mask);
-    result->AddRect(DesktopRect::MakeLTRB(left, top, right, bottom));
+    rects.push_back(DesktopRect::MakeLTRB(left, top, right, bottom));
   }
+  result->Clear();
+  if (!rects.empty())
+    result->AddRects(&rects[0], static_cast<int>(rects.size()));
 }
 
 }  // namespace webrtc
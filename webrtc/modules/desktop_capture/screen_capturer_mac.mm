@@ -12,6 +12,7 @@
 
 #include <stddef.h>
 #include <set>
+#include <vector>
 
 #include <ApplicationServices/ApplicationServices.h>
 #include <Cocoa/Cocoa.h>
@@ -258,9 +259,6 @@ class ScreenCapturerMac : public ScreenCapturer {
   // recently captured screen.
   ScreenCapturerHelper helper_;
 
-  // Contains an invalid region from the previous capture.
-  DesktopRegion last_invalid_region_;
-
   // Monitoring display reconfiguration.
   rtc::scoped_refptr<DesktopConfigurationMonitor> desktop_config_monitor_;
 
@@ -503,16 +501,18 @@ void ScreenCapturerMac::GlBlitFast(const DesktopFrame& frame,
   // Clip to the size of our current screen.
   DesktopRect clip_rect = DesktopRect::MakeSize(frame.size());
   if (queue_.previous_frame()) {
-    // We are doing double buffer for the capture data so we just need to copy
-    // the invalid region from the previous capture in the current buffer.
+    // The frames are reused, so we just need to copy the regions captured
+    // since the current buffer was last captured from the previous capture.
     // TODO(hclam): We can reduce the amount of copying here by subtracting
-    // |capturer_helper_|s region from |last_invalid_region_|.
+    // |capturer_helper_|s region from the outdated region.
     // http://crbug.com/92354
 
     // Since the image obtained from OpenGL is upside-down, need to do some
     // magic here to copy the correct rectangle.
     const int y_offset = (frame.size().height() - 1) * frame.stride();
-    for (DesktopRegion::Iterator i(last_invalid_region_);
+    DesktopRegion outdated_region;
+    queue_.GetOutdatedRegion(&outdated_region);
+    for (DesktopRegion::Iterator i(outdated_region);
          !i.IsAtEnd(); i.Advance()) {
       DesktopRect copy_rect = i.rect();
       copy_rect.IntersectWith(clip_rect);
@@ -526,7 +526,7 @@ void ScreenCapturerMac::GlBlitFast(const DesktopFrame& frame,
       }
     }
   }
-  last_invalid_region_ = region;
+  queue_.SetUpdatedRegion(region);
 
   CGLContextObj CGL_MACRO_CONTEXT = cgl_context_;
   glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, pixel_buffer_object_.get());
@@ -909,7 +909,8 @@ void ScreenCapturerMac::ScreenRefresh(CGRectCount count,
   if (screen_pixel_bounds_.is_empty())
     return;
 
-  DesktopRegion region;
+  std::vector<DesktopRect> rects;
+  rects.reserve(count);
   DesktopVector translate_vector =
       DesktopVector().subtract(screen_pixel_bounds_.top_left());
   for (CGRectCount i = 0; i < count; ++i) {
@@ -917,10 +918,13 @@ void ScreenCapturerMac::ScreenRefresh(CGRectCount count,
     DesktopRect rect = ScaleAndRoundCGRect(rect_array[i], dip_to_pixel_scale_);
     // Translate from local desktop to capturer framebuffer coordinates.
     rect.Translate(translate_vector);
-    region.AddRect(rect);
+    rects.push_back(rect);
   }
+  if (rects.empty())
+    return;
 
-  helper_.InvalidateRegion(region);
+  helper_.InvalidateRegion(
+      DesktopRegion(&rects[0], static_cast<int>(rects.size())));
 }
 
 void ScreenCapturerMac::ScreenUpdateMove(CGScreenUpdateMoveDelta delta,
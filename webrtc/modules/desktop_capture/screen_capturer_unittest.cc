@@ -102,7 +102,7 @@ TEST_F(ScreenCapturerTest, Capture) {
   delete frame;
 }
 
-#if defined(WEBRTC_WIN)
+#if defined(WEBRTC_WIN) || defined(USE_X11)
 
 TEST_F(ScreenCapturerTest, UseSharedBuffers) {
   DesktopFrame* frame = NULL;
@@ -123,6 +123,10 @@ TEST_F(ScreenCapturerTest, UseSharedBuffers) {
   delete frame;
 }
 
+#endif  // defined(WEBRTC_WIN) || defined(USE_X11)
+
+#if defined(WEBRTC_WIN)
+
 TEST_F(ScreenCapturerTest, UseMagnifier) {
   DesktopCaptureOptions options(DesktopCaptureOptions::CreateDefault());
   options.set_allow_use_magnification_api(true);
@@ -12,6 +12,7 @@
 
 #include <string.h>
 #include <set>
+#include <vector>
 
 #include <X11/extensions/Xdamage.h>
 #include <X11/extensions/Xfixes.h>
@@ -68,11 +69,8 @@ class ScreenCapturerLinux : public ScreenCapturer,
   // Called when the screen configuration is changed.
   void ScreenConfigurationChanged();
 
-  // Synchronize the current buffer with |last_buffer_|, by copying pixels from
-  // the area of |last_invalid_rects|.
-  // Note this only works on the assumption that kNumBuffers == 2, as
-  // |last_invalid_rects| holds the differences from the previous buffer and
-  // the one prior to that (which will then be the current buffer).
+  // Synchronize the current buffer with the previous one, by copying pixels
+  // from the area captured since the current buffer was last captured.
   void SynchronizeFrame();
 
   void DeinitXlib();
@@ -107,10 +105,6 @@ class ScreenCapturerLinux : public ScreenCapturer,
   // Queue of the frames buffers.
   ScreenCaptureFrameQueue queue_;
 
-  // Invalid region from the previous capture. This is used to synchronize the
-  // current with the last buffer used.
-  DesktopRegion last_invalid_region_;
-
   // |Differ| for use when polling for changes.
   rtc::scoped_ptr<Differ> differ_;
 
@@ -252,11 +246,7 @@ void ScreenCapturerLinux::Capture(const DesktopRegion& region) {
   // If the current frame is from an older generation then allocate a new one.
   // Note that we can't reallocate other buffers at this point, since the caller
   // may still be reading from them.
-  if (!queue_.current_frame()) {
-    rtc::scoped_ptr<DesktopFrame> frame(
-        new BasicDesktopFrame(x_server_pixel_buffer_.window_size()));
-    queue_.ReplaceCurrentFrame(frame.release());
-  }
+  queue_.AllocateCurrentFrame(x_server_pixel_buffer_.window_size(), callback_);
 
   // Refresh the Differ helper used by CaptureFrame(), if needed.
   DesktopFrame* frame = queue_.current_frame();
@@ -271,7 +261,7 @@ void ScreenCapturerLinux::Capture(const DesktopRegion& region) {
   }
 
   DesktopFrame* result = CaptureScreen();
-  last_invalid_region_ = result->updated_region();
+  queue_.SetUpdatedRegion(result->updated_region());
   result->set_capture_time_ms(
       (TickTime::Now() - capture_start_time).Milliseconds());
   callback_->OnCaptureCompleted(result);
@@ -331,11 +321,14 @@ DesktopFrame* ScreenCapturerLinux::CaptureScreen() {
     XRectangle bounds;
     XRectangle* rects = XFixesFetchRegionAndBounds(display(), damage_region_,
                                                    &rects_num, &bounds);
+    std::vector<DesktopRect> damage_rects(rects_num);
     for (int i = 0; i < rects_num; ++i) {
-      updated_region->AddRect(DesktopRect::MakeXYWH(
-          rects[i].x, rects[i].y, rects[i].width, rects[i].height));
+      damage_rects[i] = DesktopRect::MakeXYWH(
+          rects[i].x, rects[i].y, rects[i].width, rects[i].height);
     }
     XFree(rects);
+    if (!damage_rects.empty())
+      updated_region->AddRects(&damage_rects[0], rects_num);
     helper_.InvalidateRegion(*updated_region);
 
     // Capture the damaged portions of the desktop.
@@ -394,14 +387,16 @@ void ScreenCapturerLinux::SynchronizeFrame() {
   // positives.
 
   // TODO(hclam): We can reduce the amount of copying here by subtracting
-  // |capturer_helper_|s region from |last_invalid_region_|.
+  // |capturer_helper_|s region from the outdated region.
   // http://crbug.com/92354
   RTC_DCHECK(queue_.previous_frame());
 
   DesktopFrame* current = queue_.current_frame();
   DesktopFrame* last = queue_.previous_frame();
   RTC_DCHECK(current != last);
-  for (DesktopRegion::Iterator it(last_invalid_region_);
+  DesktopRegion outdated_region;
+  queue_.GetOutdatedRegion(&outdated_region);
+  for (DesktopRegion::Iterator it(outdated_region);
        !it.IsAtEnd(); it.Advance()) {
     current->CopyPixelsFrom(*last, it.rect().top_left(), it.rect());
   }
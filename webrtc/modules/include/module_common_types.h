@@ -529,7 +529,6 @@ class AudioFrame {
   // NTP time of the estimated capture time in local timebase in milliseconds.
   // -1 represents an uninitialized value.
   int64_t ntp_time_ms_;
-  int16_t data_[kMaxDataSizeSamples];
   size_t samples_per_channel_;
   int sample_rate_hz_;
   int num_channels_;
@@ -541,6 +540,9 @@ class AudioFrame {
   // See https://code.google.com/p/webrtc/issues/detail?id=3315.
   uint32_t energy_;
   bool interleaved_;
+  // Last, so that the other members and the samples of a short frame are
+  // next to each other in memory rather than a whole buffer apart.
+  int16_t data_[kMaxDataSizeSamples];
 
  private:
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioFrame);
@@ -217,6 +217,7 @@
                 'audio_coding/neteq/tools/input_audio_file_unittest.cc',
                 'audio_coding/neteq/tools/packet_unittest.cc',
                 'audio_conference_mixer/test/audio_conference_mixer_unittest.cc',
+                'audio_device/dummy/file_audio_device_unittest.cc',
                 'audio_device/fine_audio_buffer_unittest.cc',
                 'audio_processing/aec/echo_cancellation_unittest.cc',
                 'audio_processing/aec/system_delay_unittest.cc',
@@ -260,6 +261,7 @@
                 'desktop_capture/differ_block_unittest.cc',
                 'desktop_capture/differ_unittest.cc',
                 'desktop_capture/mouse_cursor_monitor_unittest.cc',
+                'desktop_capture/screen_capture_frame_queue_unittest.cc',
                 'desktop_capture/screen_capturer_helper_unittest.cc',
                 'desktop_capture/screen_capturer_mac_unittest.cc',
                 'desktop_capture/screen_capturer_mock_objects.h',
@@ -285,6 +287,8 @@
                 'remote_bitrate_estimator/remote_bitrate_estimator_unittest_helper.h',
                 'remote_bitrate_estimator/remote_estimator_proxy_unittest.cc',
                 'remote_bitrate_estimator/send_time_history_unittest.cc',
+                'remote_bitrate_estimator/sequence_number_window_unittest.cc',
+                'remote_bitrate_estimator/test/bwe_scenario_runner_unittest.cc',
                 'remote_bitrate_estimator/test/bwe_test_framework_unittest.cc',
                 'remote_bitrate_estimator/test/bwe_unittest.cc',
                 'remote_bitrate_estimator/test/metric_recorder_unittest.cc',
@@ -302,6 +306,7 @@
                 'rtp_rtcp/source/producer_fec_unittest.cc',
                 'rtp_rtcp/source/receive_statistics_unittest.cc',
                 'rtp_rtcp/source/remote_ntp_time_estimator_unittest.cc',
+                'rtp_rtcp/source/rtcp_coalescing_transport_unittest.cc',
                 'rtp_rtcp/source/rtcp_format_remb_unittest.cc',
                 'rtp_rtcp/source/rtcp_packet_unittest.cc',
                 'rtp_rtcp/source/rtcp_packet/app_unittest.cc',
@@ -327,6 +332,7 @@
                 'rtp_rtcp/source/rtp_payload_registry_unittest.cc',
                 'rtp_rtcp/source/rtp_rtcp_impl_unittest.cc',
                 'rtp_rtcp/source/rtp_header_extension_unittest.cc',
+                'rtp_rtcp/source/rtp_header_parser_unittest.cc',
                 'rtp_rtcp/source/rtp_sender_unittest.cc',
                 'rtp_rtcp/source/vp8_partition_aggregator_unittest.cc',
                 'rtp_rtcp/test/testAPI/test_api.cc',
@@ -364,6 +370,7 @@
                 'video_coding/utility/quality_scaler_unittest.cc',
                 'video_processing/test/brightness_detection_test.cc',
                 'video_processing/test/content_metrics_test.cc',
+                'video_processing/test/denoiser_test.cc',
                 'video_processing/test/deflickering_test.cc',
                 'video_processing/test/video_processing_unittest.cc',
                 'video_processing/test/video_processing_unittest.h',
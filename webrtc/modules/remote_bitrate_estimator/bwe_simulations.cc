@@ -10,11 +10,15 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
+#include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_abs_send_time.h"
 #include "webrtc/modules/remote_bitrate_estimator/test/bwe_test.h"
 #include "webrtc/modules/remote_bitrate_estimator/test/packet_receiver.h"
 #include "webrtc/modules/remote_bitrate_estimator/test/packet_sender.h"
+#include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 
 namespace webrtc {
@@ -443,6 +447,65 @@ TEST_P(BweSimulation, GccComparisonChoke) {
   gcc_test.RunChoke(kFullSendSideEstimator, capacities_kbps);
 }
 
+class NullBitrateObserver : public RemoteBitrateObserver {
+ public:
+  void OnReceiveBitrateChanged(const std::vector<unsigned int>& ssrcs,
+                               unsigned int bitrate) override {}
+};
+
+// Runs many receive-side estimators on one thread, the way a server would
+// host them: every wakeup hands each estimator the batch of packets that
+// arrived since the previous one, and the estimators are then processed from
+// the same loop rather than from a process thread per call. Reports how many
+// estimators a single core keeps up with in real time. It only measures time,
+// so it is disabled by default.
+TEST(BweSimulationMultiStream, DISABLED_EstimatorsPerCore) {
+  const int kNumEstimators = 1000;
+  const int64_t kRunTimeMs = 10000;
+  const int64_t kWakeupIntervalMs = 10;
+  const int kPacketsPerWakeup = 4;
+  const size_t kPayloadSize = 1000;
+  const int64_t kOneWayDelayMs = 20;
+
+  SimulatedClock clock(0);
+  NullBitrateObserver observer;
+  std::vector<rtc::scoped_ptr<RemoteBitrateEstimator>> estimators;
+  for (int i = 0; i < kNumEstimators; ++i) {
+    estimators.push_back(rtc::scoped_ptr<RemoteBitrateEstimator>(
+        new RemoteBitrateEstimatorAbsSendTime(&observer, &clock)));
+  }
+
+  std::vector<PacketInfo> batch;
+  batch.reserve(kPacketsPerWakeup);
+  uint16_t sequence_number = 0;
+  const int64_t start_us = rtc::TimeMicros();
+  for (int64_t now_ms = 0; now_ms < kRunTimeMs; now_ms += kWakeupIntervalMs) {
+    clock.AdvanceTimeMilliseconds(kWakeupIntervalMs);
+    for (int i = 0; i < kNumEstimators; ++i) {
+      batch.clear();
+      for (int j = 0; j < kPacketsPerWakeup; ++j) {
+        int64_t send_time_ms = now_ms + j * 2;
+        // Some jitter, different for each estimator.
+        int64_t arrival_time_ms = send_time_ms + kOneWayDelayMs + (i + j) % 3;
+        // Only the first second is paced, so that probing is exercised too.
+        batch.push_back(PacketInfo(arrival_time_ms, send_time_ms,
+                                   sequence_number++, kPayloadSize,
+                                   now_ms < 1000));
+      }
+      estimators[i]->IncomingPacketFeedbackVector(batch);
+      if (estimators[i]->TimeUntilNextProcess() <= 0)
+        estimators[i]->Process();
+    }
+  }
+  const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+  ASSERT_GT(elapsed_us, 0);
+
+  webrtc::test::PrintResult(
+      "BwePerformance", "", "EstimatorsPerCore",
+      static_cast<size_t>(kNumEstimators * kRunTimeMs * 1000 / elapsed_us),
+      "estimators", false);
+}
+
 #endif  // BWE_TEST_LOGGING_COMPILE_TIME_ENABLE
 }  // namespace bwe
 }  // namespace testing
@@ -11,11 +11,13 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEND_TIME_HISTORY_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEND_TIME_HISTORY_H_
 
-#include <map>
+#include <vector>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/basictypes.h"
+#include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
+#include "webrtc/modules/remote_bitrate_estimator/include/sequence_number_window.h"
 
 namespace webrtc {
 
@@ -30,16 +32,41 @@ class SendTimeHistory {
   // populate all fields except for receive_time. The packet parameter must
   // thus be non-null and have the sequence_number field set.
   bool GetInfo(PacketInfo* packet, bool remove);
+  // Batched GetInfo() for packets in increasing sequence number order, e.g.
+  // all packets of one feedback message. Only the first sequence number is
+  // unwrapped against the history; the rest are stepped to from their
+  // predecessor. Packets not found in the history are removed from |packets|
+  // and the number of such packets is returned.
+  size_t GetInfos(std::vector<PacketInfo>* packets, bool remove);
   void Clear();
 
  private:
+  struct SentPacket {
+    SentPacket()
+        : creation_time_ms(-1),
+          send_time_ms(-1),
+          payload_size(0),
+          was_paced(false) {}
+    SentPacket(int64_t creation_time_ms, size_t payload_size, bool was_paced)
+        : creation_time_ms(creation_time_ms),
+          send_time_ms(-1),
+          payload_size(payload_size),
+          was_paced(was_paced) {}
+
+    int64_t creation_time_ms;
+    int64_t send_time_ms;
+    size_t payload_size;
+    bool was_paced;
+  };
+
   void EraseOld();
-  void UpdateOldestSequenceNumber();
 
   Clock* const clock_;
   const int64_t packet_age_limit_;
-  uint16_t oldest_sequence_number_;  // Oldest may not be lowest.
-  std::map<uint16_t, PacketInfo> history_;
+  SequenceNumberUnwrapper seq_unwrapper_;
+  // Indexed by unwrapped sequence number. Bounded to half the sequence number
+  // space, beyond which old and new sequence numbers can't be told apart.
+  SequenceNumberWindow<SentPacket> history_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(SendTimeHistory);
 };
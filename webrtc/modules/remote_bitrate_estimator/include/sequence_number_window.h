@@ -0,0 +1,188 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEQUENCE_NUMBER_WINDOW_H_
+#define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEQUENCE_NUMBER_WINDOW_H_
+
+#include <vector>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Circular buffer of values indexed by unwrapped sequence number. The window
+// covers the contiguous range [begin_seq(), end_seq()) and any sequence number
+// inside it may or may not have a value; the first and last sequence numbers
+// of a non-empty window always do. Storage grows in powers of two up to what
+// is needed to span |max_size| sequence numbers and is then reused, so
+// steady-state insertion and lookup do not allocate. T must be default
+// constructible and copyable.
+template <typename T>
+class SequenceNumberWindow {
+ public:
+  explicit SequenceNumberWindow(size_t max_size)
+      : max_size_(max_size), begin_seq_(0), size_(0) {
+    RTC_DCHECK_GT(max_size, 0u);
+  }
+
+  bool empty() const { return size_ == 0; }
+  // First and one past the last sequence number in the window. Only
+  // meaningful if the window is not empty.
+  int64_t begin_seq() const { return begin_seq_; }
+  int64_t end_seq() const { return begin_seq_ + static_cast<int64_t>(size_); }
+
+  // Value stored for begin_seq(). The window must not be empty.
+  const T& front() const {
+    RTC_DCHECK(!empty());
+    return values_[Index(begin_seq_)];
+  }
+
+  // Returns the value stored for |seq|, or nullptr if there is none.
+  const T* Find(int64_t seq) const {
+    if (!InWindow(seq) || !present_[Index(seq)])
+      return nullptr;
+    return &values_[Index(seq)];
+  }
+  T* Find(int64_t seq) {
+    return const_cast<T*>(
+        static_cast<const SequenceNumberWindow*>(this)->Find(seq));
+  }
+
+  // Stores |value| for |seq|, extending the window. If the window would then
+  // span more than |max_size| sequence numbers, the oldest values are dropped
+  // to make room. Returns false, leaving the window untouched, if |seq|
+  // already has a value or is too old to fit.
+  bool Insert(int64_t seq, const T& value) {
+    if (empty()) {
+      Reserve(1);
+      begin_seq_ = seq;
+      size_ = 1;
+    } else if (seq < begin_seq_) {
+      size_t span = static_cast<size_t>(end_seq() - seq);
+      if (span > max_size_)
+        return false;
+      Reserve(span);
+      begin_seq_ = seq;
+      size_ = span;
+    } else if (seq >= end_seq()) {
+      const int64_t min_begin_seq = seq - static_cast<int64_t>(max_size_) + 1;
+      while (!empty() && begin_seq_ < min_begin_seq)
+        PopFront();
+      if (empty())
+        begin_seq_ = seq;
+      size_t span = static_cast<size_t>(seq - begin_seq_ + 1);
+      Reserve(span);
+      size_ = span;
+    } else if (present_[Index(seq)]) {
+      return false;
+    }
+    values_[Index(seq)] = value;
+    present_[Index(seq)] = true;
+    return true;
+  }
+
+  // Removes the value for |seq|, if any, shrinking the window if it was the
+  // first or last one.
+  void Erase(int64_t seq) {
+    if (!InWindow(seq) || !present_[Index(seq)])
+      return;
+    Remove(seq);
+  }
+
+  // Find() followed by Erase(), with a single lookup. Copies the value for
+  // |seq| to |value| and removes it, or returns false if there is none.
+  bool Take(int64_t seq, T* value) {
+    if (!InWindow(seq))
+      return false;
+    const size_t index = Index(seq);
+    if (!present_[index])
+      return false;
+    *value = values_[index];
+    Remove(seq);
+    return true;
+  }
+
+  // Removes the value for begin_seq().
+  void PopFront() {
+    RTC_DCHECK(!empty());
+    present_[Index(begin_seq_)] = false;
+    TrimFront();
+  }
+
+  void Clear() {
+    while (!empty())
+      PopFront();
+  }
+
+ private:
+  bool InWindow(int64_t seq) const {
+    return size_ > 0 && seq >= begin_seq_ && seq < end_seq();
+  }
+
+  size_t Index(int64_t seq) const {
+    // Capacity is a power of two, so masking is a modulo that also works for
+    // negative sequence numbers.
+    return static_cast<size_t>(seq) & (values_.size() - 1);
+  }
+
+  // Clears the value for |seq|, which must be present, shrinking the window
+  // if it was the first or last one.
+  void Remove(int64_t seq) {
+    present_[Index(seq)] = false;
+    if (seq == begin_seq_) {
+      TrimFront();
+    } else if (seq == end_seq() - 1) {
+      while (size_ > 0 && !present_[Index(end_seq() - 1)])
+        --size_;
+    }
+  }
+
+  void TrimFront() {
+    while (size_ > 0 && !present_[Index(begin_seq_)]) {
+      ++begin_seq_;
+      --size_;
+    }
+  }
+
+  // Makes sure the buffer can hold |span| consecutive sequence numbers,
+  // moving the current contents if it has to grow.
+  void Reserve(size_t span) {
+    if (span <= values_.size())
+      return;
+    size_t capacity = values_.empty() ? 16 : values_.size();
+    while (capacity < span)
+      capacity *= 2;
+    std::vector<T> values(capacity);
+    std::vector<bool> present(capacity, false);
+    const size_t mask = capacity - 1;
+    for (int64_t seq = begin_seq_; seq < end_seq(); ++seq) {
+      if (present_[Index(seq)]) {
+        values[static_cast<size_t>(seq) & mask] = values_[Index(seq)];
+        present[static_cast<size_t>(seq) & mask] = true;
+      }
+    }
+    values_.swap(values);
+    present_.swap(present);
+  }
+
+  const size_t max_size_;
+  std::vector<T> values_;
+  std::vector<bool> present_;
+  int64_t begin_seq_;
+  size_t size_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SequenceNumberWindow);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEQUENCE_NUMBER_WINDOW_H_
@@ -86,7 +86,7 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
   }
 
   void RemoteBitrateEstimatorAbsSendTime::AddCluster(
-      std::list<Cluster>* clusters,
+      std::vector<Cluster>* clusters,
       Cluster* cluster) {
     cluster->send_mean_ms /= static_cast<float>(cluster->count);
     cluster->recv_mean_ms /= static_cast<float>(cluster->count);
@@ -110,21 +110,23 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
         detector_(OverUseDetectorOptions()),
         incoming_bitrate_(kBitrateWindowMs, 8000),
         last_process_time_(-1),
+        recent_stats_begin_(0),
         process_interval_ms_(kProcessIntervalMs),
         total_propagation_delta_ms_(0),
         total_probes_received_(0),
         first_packet_time_ms_(-1) {
   assert(observer_);
   assert(clock_);
+  probes_.reserve(kMaxProbePackets);
   LOG(LS_INFO) << "RemoteBitrateEstimatorAbsSendTime: Instantiating.";
 }
 
 void RemoteBitrateEstimatorAbsSendTime::ComputeClusters(
-    std::list<Cluster>* clusters) const {
+    std::vector<Cluster>* clusters) const {
   Cluster current;
   int64_t prev_send_time = -1;
   int64_t prev_recv_time = -1;
-  for (std::list<Probe>::const_iterator it = probes_.begin();
+  for (std::vector<Probe>::const_iterator it = probes_.begin();
        it != probes_.end();
        ++it) {
     if (prev_send_time >= 0) {
@@ -150,12 +152,11 @@ void RemoteBitrateEstimatorAbsSendTime::ComputeClusters(
     AddCluster(clusters, &current);
 }
 
-std::list<Cluster>::const_iterator
-RemoteBitrateEstimatorAbsSendTime::FindBestProbe(
-    const std::list<Cluster>& clusters) const {
+int RemoteBitrateEstimatorAbsSendTime::FindBestProbe(
+    const std::vector<Cluster>& clusters) const {
   int highest_probe_bitrate_bps = 0;
-  std::list<Cluster>::const_iterator best_it = clusters.end();
-  for (std::list<Cluster>::const_iterator it = clusters.begin();
+  int best_index = -1;
+  for (std::vector<Cluster>::const_iterator it = clusters.begin();
        it != clusters.end();
        ++it) {
     if (it->send_mean_ms == 0 || it->recv_mean_ms == 0)
@@ -169,7 +170,7 @@ RemoteBitrateEstimatorAbsSendTime::FindBestProbe(
           std::min(it->GetSendBitrateBps(), it->GetRecvBitrateBps());
       if (probe_bitrate_bps > highest_probe_bitrate_bps) {
         highest_probe_bitrate_bps = probe_bitrate_bps;
-        best_it = it;
+        best_index = static_cast<int>(it - clusters.begin());
       }
     } else {
       LOG(LS_INFO) << "Probe failed, sent at " << send_bitrate_bps
@@ -180,41 +181,42 @@ RemoteBitrateEstimatorAbsSendTime::FindBestProbe(
       break;
     }
   }
-  return best_it;
+  return best_index;
 }
 
 void RemoteBitrateEstimatorAbsSendTime::ProcessClusters(int64_t now_ms) {
-  std::list<Cluster> clusters;
-  ComputeClusters(&clusters);
-  if (clusters.empty()) {
+  clusters_.clear();
+  ComputeClusters(&clusters_);
+  if (clusters_.empty()) {
     // If we reach the max number of probe packets and still have no clusters,
     // we will remove the oldest one.
     if (probes_.size() >= kMaxProbePackets)
-      probes_.pop_front();
+      probes_.erase(probes_.begin());
     return;
   }
 
-  std::list<Cluster>::const_iterator best_it = FindBestProbe(clusters);
-  if (best_it != clusters.end()) {
+  int best_index = FindBestProbe(clusters_);
+  if (best_index >= 0) {
+    const Cluster& best = clusters_[best_index];
     int probe_bitrate_bps =
-        std::min(best_it->GetSendBitrateBps(), best_it->GetRecvBitrateBps());
+        std::min(best.GetSendBitrateBps(), best.GetRecvBitrateBps());
     // Make sure that a probe sent on a lower bitrate than our estimate can't
     // reduce the estimate.
     if (IsBitrateImproving(probe_bitrate_bps) &&
         probe_bitrate_bps > static_cast<int>(incoming_bitrate_.Rate(now_ms))) {
       LOG(LS_INFO) << "Probe successful, sent at "
-                   << best_it->GetSendBitrateBps() << " bps, received at "
-                   << best_it->GetRecvBitrateBps()
-                   << " bps. Mean send delta: " << best_it->send_mean_ms
-                   << " ms, mean recv delta: " << best_it->recv_mean_ms
-                   << " ms, num probes: " << best_it->count;
+                   << best.GetSendBitrateBps() << " bps, received at "
+                   << best.GetRecvBitrateBps()
+                   << " bps. Mean send delta: " << best.send_mean_ms
+                   << " ms, mean recv delta: " << best.recv_mean_ms
+                   << " ms, num probes: " << best.count;
       remote_rate_.SetEstimate(probe_bitrate_bps, now_ms);
     }
   }
 
   // Not probing and received non-probe packet, or finished with current set
   // of probes.
-  if (clusters.size() >= kExpectedNumberOfProbes)
+  if (clusters_.size() >= kExpectedNumberOfProbes)
     probes_.clear();
 }
 
@@ -229,8 +231,10 @@ bool RemoteBitrateEstimatorAbsSendTime::IsBitrateImproving(
 
 void RemoteBitrateEstimatorAbsSendTime::IncomingPacketFeedbackVector(
     const std::vector<PacketInfo>& packet_feedback_vector) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  const int64_t now_ms = clock_->TimeInMilliseconds();
   for (const auto& packet_info : packet_feedback_vector) {
-    IncomingPacketInfo(packet_info.arrival_time_ms,
+    IncomingPacketInfo(now_ms, packet_info.arrival_time_ms,
                        ConvertMsTo24Bits(packet_info.send_time_ms),
                        packet_info.payload_size, 0, packet_info.was_paced);
   }
@@ -245,11 +249,14 @@ void RemoteBitrateEstimatorAbsSendTime::IncomingPacket(int64_t arrival_time_ms,
                        "is missing absolute send time extension!";
     return;
   }
-  IncomingPacketInfo(arrival_time_ms, header.extension.absoluteSendTime,
+  CriticalSectionScoped cs(crit_sect_.get());
+  IncomingPacketInfo(clock_->TimeInMilliseconds(), arrival_time_ms,
+                     header.extension.absoluteSendTime,
                      payload_size, header.ssrc, was_paced);
 }
 
 void RemoteBitrateEstimatorAbsSendTime::IncomingPacketInfo(
+    int64_t now_ms,
     int64_t arrival_time_ms,
     uint32_t send_time_24bits,
     size_t payload_size,
@@ -261,8 +268,6 @@ void RemoteBitrateEstimatorAbsSendTime::IncomingPacketInfo(
   uint32_t timestamp = send_time_24bits << kAbsSendTimeInterArrivalUpshift;
   int64_t send_time_ms = static_cast<int64_t>(timestamp) * kTimestampToMs;
 
-  CriticalSectionScoped cs(crit_sect_.get());
-  int64_t now_ms = clock_->TimeInMilliseconds();
   // TODO(holmer): SSRCs are only needed for REMB, should be broken out from
   // here.
   ssrcs_[ssrc] = now_ms;
@@ -270,7 +275,7 @@ void RemoteBitrateEstimatorAbsSendTime::IncomingPacketInfo(
   const BandwidthUsage prior_state = detector_.State();
 
   if (first_packet_time_ms_ == -1)
-    first_packet_time_ms_ = clock_->TimeInMilliseconds();
+    first_packet_time_ms_ = now_ms;
 
   uint32_t ts_delta = 0;
   int64_t t_delta = 0;
@@ -325,26 +330,24 @@ void RemoteBitrateEstimatorAbsSendTime::IncomingPacketInfo(
 }
 
 int32_t RemoteBitrateEstimatorAbsSendTime::Process() {
-  if (TimeUntilNextProcess() > 0) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  const int64_t now_ms = clock_->TimeInMilliseconds();
+  if (last_process_time_ >= 0 &&
+      last_process_time_ + process_interval_ms_ > now_ms) {
     return 0;
   }
-  {
-    CriticalSectionScoped cs(crit_sect_.get());
-    UpdateEstimate(clock_->TimeInMilliseconds());
-  }
-  last_process_time_ = clock_->TimeInMilliseconds();
+  UpdateEstimate(now_ms);
+  last_process_time_ = now_ms;
   return 0;
 }
 
 int64_t RemoteBitrateEstimatorAbsSendTime::TimeUntilNextProcess() {
+  CriticalSectionScoped cs(crit_sect_.get());
   if (last_process_time_ < 0) {
     return 0;
   }
-  {
-    CriticalSectionScoped cs(crit_sect_.get());
-    return last_process_time_ + process_interval_ms_ -
-        clock_->TimeInMilliseconds();
-  }
+  return last_process_time_ + process_interval_ms_ -
+      clock_->TimeInMilliseconds();
 }
 
 void RemoteBitrateEstimatorAbsSendTime::UpdateEstimate(int64_t now_ms) {
@@ -411,8 +414,12 @@ bool RemoteBitrateEstimatorAbsSendTime::GetStats(
     ReceiveBandwidthEstimatorStats* output) const {
   {
     CriticalSectionScoped cs(crit_sect_.get());
-    output->recent_propagation_time_delta_ms = recent_propagation_delta_ms_;
-    output->recent_arrival_time_ms = recent_update_time_ms_;
+    output->recent_propagation_time_delta_ms.assign(
+        recent_propagation_delta_ms_.begin() + recent_stats_begin_,
+        recent_propagation_delta_ms_.end());
+    output->recent_arrival_time_ms.assign(
+        recent_update_time_ms_.begin() + recent_stats_begin_,
+        recent_update_time_ms_.end());
     output->total_propagation_time_delta_ms = total_propagation_delta_ms_;
   }
   RemoveStaleEntries(
@@ -427,18 +434,28 @@ void RemoteBitrateEstimatorAbsSendTime::UpdateStats(int propagation_delta_ms,
   // The caller must enter crit_sect_ before the call.
 
   // Remove the oldest entry if the size limit is reached.
-  if (recent_update_time_ms_.size() == kPropagationDeltaQueueMaxSize) {
-    recent_update_time_ms_.erase(recent_update_time_ms_.begin());
-    recent_propagation_delta_ms_.erase(recent_propagation_delta_ms_.begin());
+  if (recent_update_time_ms_.size() - recent_stats_begin_ ==
+      kPropagationDeltaQueueMaxSize) {
+    ++recent_stats_begin_;
   }
 
   recent_propagation_delta_ms_.push_back(propagation_delta_ms);
   recent_update_time_ms_.push_back(now_ms);
 
-  RemoveStaleEntries(
-      &recent_update_time_ms_,
-      &recent_propagation_delta_ms_,
-      now_ms - kPropagationDeltaQueueMaxTimeMs);
+  recent_stats_begin_ =
+      std::upper_bound(recent_update_time_ms_.begin() + recent_stats_begin_,
+                       recent_update_time_ms_.end(),
+                       now_ms - kPropagationDeltaQueueMaxTimeMs) -
+      recent_update_time_ms_.begin();
+  if (recent_stats_begin_ > recent_update_time_ms_.size() / 2) {
+    recent_update_time_ms_.erase(
+        recent_update_time_ms_.begin(),
+        recent_update_time_ms_.begin() + recent_stats_begin_);
+    recent_propagation_delta_ms_.erase(
+        recent_propagation_delta_ms_.begin(),
+        recent_propagation_delta_ms_.begin() + recent_stats_begin_);
+    recent_stats_begin_ = 0;
+  }
 
   total_propagation_delta_ms_ =
       std::max(total_propagation_delta_ms_ + propagation_delta_ms, 0);
@@ -11,7 +11,6 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_BITRATE_ESTIMATOR_ABS_SEND_TIME_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_BITRATE_ESTIMATOR_ABS_SEND_TIME_H_
 
-#include <list>
 #include <map>
 #include <vector>
 
@@ -95,15 +94,20 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   static bool IsWithinClusterBounds(int send_delta_ms,
                                     const Cluster& cluster_aggregate);
 
-  static void AddCluster(std::list<Cluster>* clusters, Cluster* cluster);
+  static void AddCluster(std::vector<Cluster>* clusters, Cluster* cluster);
 
   int Id() const;
 
-  void IncomingPacketInfo(int64_t arrival_time_ms,
+  // Processes one packet. The caller must hold |crit_sect_| and pass in the
+  // current time, so that a batch of packets is handled with a single lock
+  // acquisition and clock read.
+  void IncomingPacketInfo(int64_t now_ms,
+                          int64_t arrival_time_ms,
                           uint32_t send_time_24bits,
                           size_t payload_size,
                           uint32_t ssrc,
-                          bool was_paced);
+                          bool was_paced)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
 
   bool IsProbe(int64_t send_time_ms, int payload_size) const
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
@@ -115,10 +119,11 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   void UpdateStats(int propagation_delta_ms, int64_t now_ms)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
 
-  void ComputeClusters(std::list<Cluster>* clusters) const;
+  void ComputeClusters(std::vector<Cluster>* clusters) const;
 
-  std::list<Cluster>::const_iterator FindBestProbe(
-      const std::list<Cluster>& clusters) const
+  // Returns the index of the best cluster in |clusters|, or -1 if none of
+  // them is usable.
+  int FindBestProbe(const std::vector<Cluster>& clusters) const
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
 
   void ProcessClusters(int64_t now_ms)
@@ -136,15 +141,23 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   OveruseDetector detector_ GUARDED_BY(crit_sect_.get());
   RateStatistics incoming_bitrate_ GUARDED_BY(crit_sect_.get());
   AimdRateControl remote_rate_ GUARDED_BY(crit_sect_.get());
-  int64_t last_process_time_;
+  int64_t last_process_time_ GUARDED_BY(crit_sect_.get());
+  // Propagation deltas and their update times, oldest first, starting at
+  // |recent_stats_begin_|. Stale entries are dropped by moving the start
+  // index and only erased from the vectors once they make up half of them,
+  // so updating the stats is amortized constant time per packet.
   std::vector<int> recent_propagation_delta_ms_ GUARDED_BY(crit_sect_.get());
   std::vector<int64_t> recent_update_time_ms_ GUARDED_BY(crit_sect_.get());
+  size_t recent_stats_begin_ GUARDED_BY(crit_sect_.get());
   int64_t process_interval_ms_ GUARDED_BY(crit_sect_.get());
   int total_propagation_delta_ms_ GUARDED_BY(crit_sect_.get());
 
-  std::list<Probe> probes_;
-  size_t total_probes_received_;
-  int64_t first_packet_time_ms_;
+  // Probes and the clusters computed from them are kept in flat vectors
+  // that are reused, so probing doesn't allocate per packet.
+  std::vector<Probe> probes_ GUARDED_BY(crit_sect_.get());
+  std::vector<Cluster> clusters_ GUARDED_BY(crit_sect_.get());
+  size_t total_probes_received_ GUARDED_BY(crit_sect_.get());
+  int64_t first_packet_time_ms_ GUARDED_BY(crit_sect_.get());
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(RemoteBitrateEstimatorAbsSendTime);
 };
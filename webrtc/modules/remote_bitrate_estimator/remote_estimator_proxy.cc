@@ -22,6 +22,8 @@ namespace webrtc {
 // TODO(sprang): Tune these!
 const int RemoteEstimatorProxy::kDefaultProcessIntervalMs = 50;
 const int RemoteEstimatorProxy::kBackWindowMs = 500;
+// Half the sequence number space; older than that can't be unwrapped reliably.
+const size_t RemoteEstimatorProxy::kMaxArrivalWindowSize = 1 << 15;
 
 RemoteEstimatorProxy::RemoteEstimatorProxy(Clock* clock,
                                            PacketRouter* packet_router)
@@ -30,7 +32,8 @@ RemoteEstimatorProxy::RemoteEstimatorProxy(Clock* clock,
       last_process_time_ms_(-1),
       media_ssrc_(0),
       feedback_sequence_(0),
-      window_start_seq_(-1) {}
+      window_start_seq_(-1),
+      packet_arrival_times_(kMaxArrivalWindowSize) {}
 
 RemoteEstimatorProxy::~RemoteEstimatorProxy() {}
 
@@ -104,21 +107,23 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
   int64_t seq = unwrapper_.Unwrap(sequence_number);
 
   if (window_start_seq_ == -1) {
-    window_start_seq_ = seq;
     // Start new feedback packet, cull old packets.
-    for (auto it = packet_arrival_times_.begin();
-         it != packet_arrival_times_.end() && it->first < seq &&
-         arrival_time - it->second >= kBackWindowMs;) {
-      auto delete_it = it;
-      ++it;
-      packet_arrival_times_.erase(delete_it);
+    while (!packet_arrival_times_.empty() &&
+           packet_arrival_times_.begin_seq() < seq &&
+           arrival_time - packet_arrival_times_.front() >= kBackWindowMs) {
+      packet_arrival_times_.PopFront();
     }
-  } else if (seq < window_start_seq_) {
-    window_start_seq_ = seq;
   }
 
-  RTC_DCHECK(packet_arrival_times_.end() == packet_arrival_times_.find(seq));
-  packet_arrival_times_[seq] = arrival_time;
+  // Duplicates, and packets too old to fit in the window, are dropped.
+  if (!packet_arrival_times_.Insert(seq, arrival_time))
+    return;
+
+  if (window_start_seq_ == -1 || seq < window_start_seq_)
+    window_start_seq_ = seq;
+  // Inserting may have pushed the oldest packets out of the window.
+  if (window_start_seq_ < packet_arrival_times_.begin_seq())
+    window_start_seq_ = packet_arrival_times_.begin_seq();
 }
 
 bool RemoteEstimatorProxy::BuildFeedbackPacket(
@@ -128,34 +133,39 @@ bool RemoteEstimatorProxy::BuildFeedbackPacket(
     return false;
 
   // window_start_seq_ is the first sequence number to include in the current
-  // feedback packet. Some older may still be in the map, in case a reordering
-  // happens and we need to retransmit them.
-  auto it = packet_arrival_times_.find(window_start_seq_);
-  RTC_DCHECK(it != packet_arrival_times_.end());
+  // feedback packet. Some older may still be in the window, in case a
+  // reordering happens and we need to retransmit them.
+  const int64_t* start_time = packet_arrival_times_.Find(window_start_seq_);
+  RTC_DCHECK(start_time != nullptr);
 
   // TODO(sprang): Measure receive times in microseconds and remove the
   // conversions below.
   feedback_packet->WithMediaSourceSsrc(media_ssrc_);
-  feedback_packet->WithBase(static_cast<uint16_t>(it->first & 0xFFFF),
-                            it->second * 1000);
+  feedback_packet->WithBase(static_cast<uint16_t>(window_start_seq_ & 0xFFFF),
+                            *start_time * 1000);
   feedback_packet->WithFeedbackSequenceNumber(feedback_sequence_++);
-  for (; it != packet_arrival_times_.end(); ++it) {
+  const int64_t end_seq = packet_arrival_times_.end_seq();
+  int64_t seq = window_start_seq_;
+  for (; seq < end_seq; ++seq) {
+    const int64_t* arrival_time = packet_arrival_times_.Find(seq);
+    if (!arrival_time)
+      continue;
     if (!feedback_packet->WithReceivedPacket(
-            static_cast<uint16_t>(it->first & 0xFFFF), it->second * 1000)) {
+            static_cast<uint16_t>(seq & 0xFFFF), *arrival_time * 1000)) {
       // If we can't even add the first seq to the feedback packet, we won't be
       // able to build it at all.
-      RTC_CHECK_NE(window_start_seq_, it->first);
+      RTC_CHECK_NE(window_start_seq_, seq);
 
       // Could not add timestamp, feedback packet might be full. Return and
       // try again with a fresh packet.
-      window_start_seq_ = it->first;
+      window_start_seq_ = seq;
       break;
     }
     // Note: Don't erase items from packet_arrival_times_ after sending, in case
     // they need to be re-sent after a reordering. Removal will be handled
     // by OnPacketArrival once packets are too old.
   }
-  if (it == packet_arrival_times_.end())
+  if (seq == end_seq)
     window_start_seq_ = -1;
 
   return true;
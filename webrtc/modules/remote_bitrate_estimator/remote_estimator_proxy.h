@@ -11,12 +11,12 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 
-#include <map>
 #include <vector>
 
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
+#include "webrtc/modules/remote_bitrate_estimator/include/sequence_number_window.h"
 
 namespace webrtc {
 
@@ -52,6 +52,7 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
 
   static const int kDefaultProcessIntervalMs;
   static const int kBackWindowMs;
+  static const size_t kMaxArrivalWindowSize;
 
  private:
   void OnPacketArrival(uint16_t sequence_number, int64_t arrival_time)
@@ -68,8 +69,8 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
   uint8_t feedback_sequence_ GUARDED_BY(&lock_);
   SequenceNumberUnwrapper unwrapper_ GUARDED_BY(&lock_);
   int64_t window_start_seq_ GUARDED_BY(&lock_);
-  // Map unwrapped seq -> time.
-  std::map<int64_t, int64_t> packet_arrival_times_ GUARDED_BY(&lock_);
+  // Arrival time indexed by unwrapped seq.
+  SequenceNumberWindow<int64_t> packet_arrival_times_ GUARDED_BY(&lock_);
 };
 
 }  // namespace webrtc
@@ -8,22 +8,20 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-#include <assert.h>
-
 #include "webrtc/modules/remote_bitrate_estimator/include/send_time_history.h"
 
+#include "webrtc/base/checks.h"
+
 namespace webrtc {
 
 SendTimeHistory::SendTimeHistory(Clock* clock, int64_t packet_age_limit)
-    : clock_(clock),
-      packet_age_limit_(packet_age_limit),
-      oldest_sequence_number_(0) {}
+    : clock_(clock), packet_age_limit_(packet_age_limit), history_(1 << 15) {}
 
 SendTimeHistory::~SendTimeHistory() {
 }
 
 void SendTimeHistory::Clear() {
-  history_.clear();
+  history_.Clear();
 }
 
 void SendTimeHistory::AddAndRemoveOld(uint16_t sequence_number,
@@ -31,71 +29,79 @@ void SendTimeHistory::AddAndRemoveOld(uint16_t sequence_number,
                                       bool was_paced) {
   EraseOld();
 
-  if (history_.empty())
-    oldest_sequence_number_ = sequence_number;
-
-  history_.insert(std::pair<uint16_t, PacketInfo>(
-      sequence_number, PacketInfo(clock_->TimeInMilliseconds(), 0, -1,
-                                  sequence_number, length, was_paced)));
+  int64_t seq = seq_unwrapper_.Unwrap(sequence_number);
+  history_.Insert(seq,
+                  SentPacket(clock_->TimeInMilliseconds(), length, was_paced));
 }
 
 bool SendTimeHistory::OnSentPacket(uint16_t sequence_number,
                                    int64_t send_time_ms) {
-  auto it = history_.find(sequence_number);
-  if (it == history_.end())
+  SentPacket* packet =
+      history_.Find(seq_unwrapper_.UnwrapWithoutUpdate(sequence_number));
+  if (!packet)
     return false;
-  it->second.send_time_ms = send_time_ms;
+  packet->send_time_ms = send_time_ms;
   return true;
 }
 
 void SendTimeHistory::EraseOld() {
+  const int64_t now_ms = clock_->TimeInMilliseconds();
   while (!history_.empty()) {
-    auto it = history_.find(oldest_sequence_number_);
-    assert(it != history_.end());
-
-    if (clock_->TimeInMilliseconds() - it->second.creation_time_ms <=
-        packet_age_limit_) {
+    if (now_ms - history_.front().creation_time_ms <= packet_age_limit_)
       return;  // Oldest packet within age limit, return.
-    }
 
     // TODO(sprang): Warn if erasing (too many) old items?
-    history_.erase(it);
-    UpdateOldestSequenceNumber();
+    history_.PopFront();
   }
 }
 
-void SendTimeHistory::UpdateOldestSequenceNumber() {
-  // After removing an element from the map, update oldest_sequence_number_ to
-  // the element with the lowest sequence number higher than the previous
-  // value (there might be gaps).
-  if (history_.empty())
-    return;
-  auto it = history_.upper_bound(oldest_sequence_number_);
-  if (it == history_.end()) {
-    // No element with higher sequence number than oldest_sequence_number_
-    // found, check wrap around. Note that history_.upper_bound(0) will not
-    // find 0 even if it is there, need to explicitly check for 0.
-    it = history_.find(0);
-    if (it == history_.end())
-      it = history_.upper_bound(0);
-  }
-  assert(it != history_.end());
-  oldest_sequence_number_ = it->first;
-}
-
 bool SendTimeHistory::GetInfo(PacketInfo* packet, bool remove) {
-  auto it = history_.find(packet->sequence_number);
-  if (it == history_.end())
+  int64_t seq = seq_unwrapper_.UnwrapWithoutUpdate(packet->sequence_number);
+  const SentPacket* sent_packet = history_.Find(seq);
+  if (!sent_packet)
     return false;
-  int64_t receive_time = packet->arrival_time_ms;
-  *packet = it->second;
-  packet->arrival_time_ms = receive_time;
-  if (remove) {
-    history_.erase(it);
-    if (packet->sequence_number == oldest_sequence_number_)
-      UpdateOldestSequenceNumber();
-  }
+  packet->creation_time_ms = sent_packet->creation_time_ms;
+  packet->send_time_ms = sent_packet->send_time_ms;
+  packet->payload_size = sent_packet->payload_size;
+  packet->was_paced = sent_packet->was_paced;
+  if (remove)
+    history_.Erase(seq);
   return true;
 }
 
+size_t SendTimeHistory::GetInfos(std::vector<PacketInfo>* packets,
+                                 bool remove) {
+  if (packets->empty())
+    return 0;
+  int64_t seq =
+      seq_unwrapper_.UnwrapWithoutUpdate((*packets)[0].sequence_number);
+  uint16_t last_sequence_number = (*packets)[0].sequence_number;
+  size_t num_found = 0;
+  for (size_t i = 0; i < packets->size(); ++i) {
+    PacketInfo& packet = (*packets)[i];
+    seq += static_cast<uint16_t>(packet.sequence_number - last_sequence_number);
+    last_sequence_number = packet.sequence_number;
+    SentPacket sent_packet;
+    if (remove) {
+      if (!history_.Take(seq, &sent_packet))
+        continue;
+    } else {
+      const SentPacket* found = history_.Find(seq);
+      if (!found)
+        continue;
+      sent_packet = *found;
+    }
+    packet.creation_time_ms = sent_packet.creation_time_ms;
+    packet.send_time_ms = sent_packet.send_time_ms;
+    packet.payload_size = sent_packet.payload_size;
+    packet.was_paced = sent_packet.was_paced;
+    if (num_found != i)
+      (*packets)[num_found] = packet;
+    ++num_found;
+  }
+  const size_t num_missing = packets->size() - num_found;
+  packets->erase(packets->begin() + num_found, packets->end());
+  return num_missing;
+}
+
 }  // namespace webrtc
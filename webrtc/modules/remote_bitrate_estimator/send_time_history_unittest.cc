@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/arraysize.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/send_time_history.h"
 #include "webrtc/system_wrappers/include/clock.h"
 
@@ -230,5 +231,77 @@ TEST_F(SendTimeHistoryTest, InterlievedGetAndRemove) {
   EXPECT_EQ(packets[2], info3);
 }
 
+TEST_F(SendTimeHistoryTest, GetInfosDropsUnknownPackets) {
+  const uint16_t kMaxSeqNo = std::numeric_limits<uint16_t>::max();
+  AddPacketWithSendTime(kMaxSeqNo - 1, 100, false, 10);
+  AddPacketWithSendTime(kMaxSeqNo, 200, true, 11);
+  AddPacketWithSendTime(1, 300, false, 13);
+
+  std::vector<webrtc::PacketInfo> packets;
+  packets.push_back(PacketInfo(20, kMaxSeqNo - 1));
+  packets.push_back(PacketInfo(21, kMaxSeqNo));
+  packets.push_back(PacketInfo(22, 0));
+  packets.push_back(PacketInfo(23, 1));
+  EXPECT_EQ(1u, history_.GetInfos(&packets, true));
+
+  const PacketInfo kExpected[] = {PacketInfo(20, 10, kMaxSeqNo - 1, 100, false),
+                                  PacketInfo(21, 11, kMaxSeqNo, 200, true),
+                                  PacketInfo(23, 13, 1, 300, false)};
+  ASSERT_EQ(arraysize(kExpected), packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    EXPECT_EQ(kExpected[i].arrival_time_ms, packets[i].arrival_time_ms);
+    EXPECT_EQ(kExpected[i].send_time_ms, packets[i].send_time_ms);
+    EXPECT_EQ(kExpected[i].sequence_number, packets[i].sequence_number);
+    EXPECT_EQ(kExpected[i].payload_size, packets[i].payload_size);
+    EXPECT_EQ(kExpected[i].was_paced, packets[i].was_paced);
+  }
+
+  // Removed from the history.
+  PacketInfo info(0, kMaxSeqNo);
+  EXPECT_FALSE(history_.GetInfo(&info, false));
+  EXPECT_EQ(3u, history_.GetInfos(&packets, false));
+  EXPECT_TRUE(packets.empty());
+}
+
+// Keeps history for ten seconds of 10k packets per second where feedback
+// arrives every 10 ms and one in ten feedback messages is lost. The packets
+// of the lost feedback are never looked up; they are dropped once the history
+// spans more than 1 << 15 sequence numbers, long before they are ten seconds
+// old.
+TEST(SendTimeHistoryLoadTest, TenThousandPacketsPerSecondWithFeedbackLoss) {
+  const int kPacketsPerSecond = 10000;
+  const int kDurationSeconds = 10;
+  const int kPacketsPerFeedback = 100;
+  const int kFeedbackLossInterval = 10;
+  const int64_t kHistoryLengthMs = 10000;
+  SimulatedClock clock(0);
+  SendTimeHistory history(&clock, kHistoryLengthMs);
+
+  uint16_t sequence_number = 0;
+  int feedback_count = 0;
+  int found = 0;
+  for (int i = 0; i < kPacketsPerSecond * kDurationSeconds /
+                          kPacketsPerFeedback;
+       ++i) {
+    uint16_t first_in_feedback = sequence_number;
+    for (int j = 0; j < kPacketsPerFeedback; ++j) {
+      history.AddAndRemoveOld(sequence_number, 1200, true);
+      history.OnSentPacket(sequence_number, clock.TimeInMilliseconds());
+      ++sequence_number;
+    }
+    clock.AdvanceTimeMilliseconds(1000 * kPacketsPerFeedback /
+                                  kPacketsPerSecond);
+    if (++feedback_count % kFeedbackLossInterval == 0)
+      continue;
+    for (uint16_t seq = first_in_feedback; seq != sequence_number; ++seq) {
+      PacketInfo info(clock.TimeInMilliseconds(), seq);
+      if (history.GetInfo(&info, true))
+        ++found;
+    }
+  }
+
+  EXPECT_EQ(kPacketsPerSecond * kDurationSeconds * 9 / 10, found);
+}
+
 }  // namespace test
 }  // namespace webrtc
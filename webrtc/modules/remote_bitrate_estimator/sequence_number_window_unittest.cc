@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/remote_bitrate_estimator/include/sequence_number_window.h"
+
+namespace webrtc {
+
+TEST(SequenceNumberWindowTest, InsertAndFind) {
+  SequenceNumberWindow<int> window(100);
+  EXPECT_TRUE(window.empty());
+  EXPECT_TRUE(window.Find(1) == nullptr);
+
+  EXPECT_TRUE(window.Insert(10, 100));
+  EXPECT_TRUE(window.Insert(12, 120));
+  EXPECT_FALSE(window.Insert(12, 121));
+  EXPECT_FALSE(window.empty());
+  EXPECT_EQ(10, window.begin_seq());
+  EXPECT_EQ(13, window.end_seq());
+  EXPECT_EQ(100, window.front());
+
+  ASSERT_TRUE(window.Find(10) != nullptr);
+  EXPECT_EQ(100, *window.Find(10));
+  EXPECT_TRUE(window.Find(11) == nullptr);
+  ASSERT_TRUE(window.Find(12) != nullptr);
+  EXPECT_EQ(120, *window.Find(12));
+  EXPECT_TRUE(window.Find(13) == nullptr);
+}
+
+TEST(SequenceNumberWindowTest, TakeCopiesAndErases) {
+  SequenceNumberWindow<int> window(100);
+  EXPECT_TRUE(window.Insert(10, 100));
+  EXPECT_TRUE(window.Insert(11, 110));
+  EXPECT_TRUE(window.Insert(13, 130));
+
+  int value = 0;
+  EXPECT_FALSE(window.Take(12, &value));
+  EXPECT_TRUE(window.Take(11, &value));
+  EXPECT_EQ(110, value);
+  EXPECT_FALSE(window.Take(11, &value));
+  EXPECT_EQ(10, window.begin_seq());
+
+  EXPECT_TRUE(window.Take(10, &value));
+  EXPECT_EQ(100, value);
+  EXPECT_EQ(13, window.begin_seq());
+  EXPECT_TRUE(window.Take(13, &value));
+  EXPECT_EQ(130, value);
+  EXPECT_TRUE(window.empty());
+}
+
+TEST(SequenceNumberWindowTest, InsertOlderExtendsWindowBackwards) {
+  SequenceNumberWindow<int> window(100);
+  EXPECT_TRUE(window.Insert(50, 500));
+  EXPECT_TRUE(window.Insert(40, 400));
+  EXPECT_EQ(40, window.begin_seq());
+  EXPECT_EQ(51, window.end_seq());
+  EXPECT_EQ(400, *window.Find(40));
+  EXPECT_EQ(500, *window.Find(50));
+
+  // Too old to fit in the window.
+  EXPECT_FALSE(window.Insert(-50, 0));
+  EXPECT_EQ(40, window.begin_seq());
+}
+
+TEST(SequenceNumberWindowTest, InsertNewerDropsOldest) {
+  SequenceNumberWindow<int> window(100);
+  for (int i = 0; i < 100; ++i)
+    EXPECT_TRUE(window.Insert(i, i));
+  EXPECT_EQ(0, window.begin_seq());
+
+  EXPECT_TRUE(window.Insert(101, 101));
+  EXPECT_EQ(2, window.begin_seq());
+  EXPECT_TRUE(window.Find(1) == nullptr);
+  EXPECT_EQ(2, *window.Find(2));
+  EXPECT_EQ(101, *window.Find(101));
+
+  // A jump past the whole window leaves only the new value.
+  EXPECT_TRUE(window.Insert(1000, 1000));
+  EXPECT_EQ(1000, window.begin_seq());
+  EXPECT_EQ(1001, window.end_seq());
+}
+
+TEST(SequenceNumberWindowTest, EraseTrimsWindow) {
+  SequenceNumberWindow<int> window(100);
+  for (int i = 0; i < 5; ++i)
+    EXPECT_TRUE(window.Insert(i, i));
+
+  window.Erase(2);
+  EXPECT_TRUE(window.Find(2) == nullptr);
+  EXPECT_EQ(0, window.begin_seq());
+  EXPECT_EQ(5, window.end_seq());
+
+  window.Erase(1);
+  window.Erase(0);
+  EXPECT_EQ(3, window.begin_seq());
+
+  window.Erase(4);
+  EXPECT_EQ(4, window.end_seq());
+
+  window.PopFront();
+  EXPECT_TRUE(window.empty());
+}
+
+TEST(SequenceNumberWindowTest, GrowsAndWrapsAroundStorage) {
+  SequenceNumberWindow<int> window(1000);
+  // Slide a window of 300 values over the buffer several times, crossing the
+  // end of the underlying storage repeatedly.
+  for (int i = 0; i < 5000; ++i) {
+    EXPECT_TRUE(window.Insert(i, i));
+    if (i >= 300)
+      window.Erase(i - 300);
+    EXPECT_EQ(std::max(0, i - 299), window.begin_seq());
+  }
+  for (int i = 4700; i < 5000; ++i) {
+    ASSERT_TRUE(window.Find(i) != nullptr);
+    EXPECT_EQ(i, *window.Find(i));
+  }
+
+  window.Clear();
+  EXPECT_TRUE(window.empty());
+  EXPECT_TRUE(window.Find(4999) == nullptr);
+}
+
+}  // namespace webrtc
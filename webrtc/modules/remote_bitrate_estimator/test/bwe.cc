@@ -68,6 +68,7 @@ class NullBweSender : public BweSender {
     return std::numeric_limits<int64_t>::max();
   }
   int Process() override { return 0; }
+  int64_t IdleTimeMs() override { return kAlwaysIdleMs; }
 
  private:
   RTC_DISALLOW_COPY_AND_ASSIGN(NullBweSender);
@@ -11,6 +11,7 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_H_
 
+#include <algorithm>
 #include <list>
 #include <map>
 #include <sstream>
@@ -121,6 +122,12 @@ class BweSender : public Module {
   virtual void GiveFeedback(const FeedbackPacket& feedback) = 0;
   virtual void OnPacketsSent(const Packets& packets) = 0;
 
+  // Returns for how many milliseconds Process() can be called without any
+  // effect, as long as no packets are sent and no feedback is given.
+  virtual int64_t IdleTimeMs() {
+    return std::max<int64_t>(TimeUntilNextProcess() - 1, 0);
+  }
+
  protected:
   int bitrate_kbps_;
 
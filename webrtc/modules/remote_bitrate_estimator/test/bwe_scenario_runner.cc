@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_scenario_runner.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_test_logging.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+
+namespace {
+
+// Quotes |str| if it contains a comma, a quote or a line break, as in
+// RFC 4180.
+std::string CsvField(const std::string& str) {
+  if (str.find_first_of(",\"\r\n") == std::string::npos)
+    return str;
+  std::string quoted = "\"";
+  for (char c : str) {
+    if (c == '"')
+      quoted += '"';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+std::string JsonString(const std::string& str) {
+  std::string quoted = "\"";
+  for (char c : str) {
+    if (c == '"' || c == '\\')
+      quoted += '\\';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+}  // namespace
+
+BweScenarioRunner::BweScenarioRunner(int num_threads)
+    : num_threads_(num_threads > 0
+                       ? num_threads
+                       : static_cast<int>(CpuInfo::DetectNumberOfCores())),
+      next_scenario_(0) {
+  RTC_DCHECK_GT(num_threads_, 0);
+}
+
+BweScenarioRunner::~BweScenarioRunner() {}
+
+void BweScenarioRunner::AddScenario(const std::string& name,
+                                    const Scenario& scenario) {
+  ScenarioEntry entry;
+  entry.name = name;
+  entry.scenario = scenario;
+  scenarios_.push_back(entry);
+}
+
+void BweScenarioRunner::Run() {
+  next_scenario_ = 0;
+  for (ScenarioEntry& entry : scenarios_)
+    entry.metric_summaries.clear();
+
+  const int num_threads =
+      std::min(num_threads_, static_cast<int>(scenarios_.size()));
+  std::vector<rtc::scoped_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(rtc::scoped_ptr<rtc::PlatformThread>(
+        new rtc::PlatformThread(&RunScenarios, this, "BweScenario")));
+    threads.back()->Start();
+  }
+  // Worker threads return once there are no scenarios left, Stop() joins
+  // them.
+  for (auto& thread : threads)
+    thread->Stop();
+}
+
+bool BweScenarioRunner::RunScenarios(void* obj) {
+  BweScenarioRunner* runner = static_cast<BweScenarioRunner*>(obj);
+  const int num_scenarios = static_cast<int>(runner->scenarios_.size());
+  int index;
+  while ((index = rtc::AtomicOps::Increment(&runner->next_scenario_) - 1) <
+         num_scenarios) {
+    // Each scenario only touches its own entry, so no locking is needed.
+    ScenarioEntry* entry = &runner->scenarios_[index];
+    BWE_TEST_LOGGING_GLOBAL_CONTEXT(entry->name);
+    BWE_TEST_LOGGING_GLOBAL_ENABLE(false);
+    BweTest test(false);
+    test.set_name(entry->name);
+    entry->scenario(&test);
+    entry->metric_summaries = test.metric_summaries();
+  }
+  // Done, don't call again.
+  return false;
+}
+
+std::vector<MetricSummary> BweScenarioRunner::GetMetricSummaries() const {
+  std::vector<MetricSummary> summaries;
+  for (const ScenarioEntry& entry : scenarios_) {
+    summaries.insert(summaries.end(), entry.metric_summaries.begin(),
+                     entry.metric_summaries.end());
+  }
+  return summaries;
+}
+
+std::string BweScenarioRunner::ToCsv(
+    const std::vector<MetricSummary>& summaries) {
+  std::stringstream ss;
+  ss << "scenario,algorithm,flow_id,num_packets,average_bitrate_kbps,"
+        "optimal_bitrate_kbps,average_delay_ms,delay_5th_percentile_ms,"
+        "delay_95th_percentile_ms,loss_ratio,objective\n";
+  for (const MetricSummary& summary : summaries) {
+    ss << CsvField(summary.scenario) << ","
+       << CsvField(summary.algorithm_name) << ","
+       << summary.flow_id << "," << summary.num_packets << ","
+       << summary.average_bitrate_kbps << "," << summary.optimal_bitrate_kbps
+       << "," << summary.average_delay_ms << ","
+       << summary.delay_5th_percentile_ms << ","
+       << summary.delay_95th_percentile_ms << "," << summary.loss_ratio << ","
+       << summary.objective << "\n";
+  }
+  return ss.str();
+}
+
+std::string BweScenarioRunner::ToJson(
+    const std::vector<MetricSummary>& summaries) {
+  std::stringstream ss;
+  ss << "[";
+  for (size_t i = 0; i < summaries.size(); ++i) {
+    const MetricSummary& summary = summaries[i];
+    ss << (i == 0 ? "\n" : ",\n");
+    ss << "  {\"scenario\": " << JsonString(summary.scenario)
+       << ", \"algorithm\": " << JsonString(summary.algorithm_name)
+       << ", \"flow_id\": " << summary.flow_id
+       << ", \"num_packets\": " << summary.num_packets
+       << ", \"average_bitrate_kbps\": " << summary.average_bitrate_kbps
+       << ", \"optimal_bitrate_kbps\": " << summary.optimal_bitrate_kbps
+       << ", \"average_delay_ms\": " << summary.average_delay_ms
+       << ", \"delay_5th_percentile_ms\": " << summary.delay_5th_percentile_ms
+       << ", \"delay_95th_percentile_ms\": "
+       << summary.delay_95th_percentile_ms
+       << ", \"loss_ratio\": " << summary.loss_ratio
+       << ", \"objective\": " << summary.objective << "}";
+  }
+  ss << "\n]\n";
+  return ss.str();
+}
+
+bool BweScenarioRunner::WriteToFile(const std::string& file_name,
+                                    const std::string& contents) {
+  FILE* file = fopen(file_name.c_str(), "w");
+  if (!file)
+    return false;
+  bool success = fwrite(contents.data(), 1, contents.size(), file) ==
+                 contents.size();
+  return fclose(file) == 0 && success;
+}
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_SCENARIO_RUNNER_H_
+#define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_SCENARIO_RUNNER_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_test.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/metric_recorder.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+
+// Runs independent simulation scenarios, e.g. one per estimator and network
+// trace, in parallel on a pool of threads. Every scenario gets a BweTest of
+// its own with plotting and logging disabled, and the metric summaries they
+// record are collected so that they can be written out as CSV or JSON.
+class BweScenarioRunner {
+ public:
+  typedef std::function<void(BweTest* test)> Scenario;
+
+  // Uses one thread per core if |num_threads| is 0.
+  explicit BweScenarioRunner(int num_threads);
+  ~BweScenarioRunner();
+
+  void AddScenario(const std::string& name, const Scenario& scenario);
+
+  // Runs all scenarios added so far and blocks until they have finished.
+  void Run();
+
+  int num_threads() const { return num_threads_; }
+
+  // Summaries recorded by the scenarios, in the order the scenarios were
+  // added.
+  std::vector<MetricSummary> GetMetricSummaries() const;
+
+  static std::string ToCsv(const std::vector<MetricSummary>& summaries);
+  static std::string ToJson(const std::vector<MetricSummary>& summaries);
+  static bool WriteToFile(const std::string& file_name,
+                          const std::string& contents);
+
+ private:
+  struct ScenarioEntry {
+    std::string name;
+    Scenario scenario;
+    std::vector<MetricSummary> metric_summaries;
+  };
+
+  static bool RunScenarios(void* obj);
+
+  const int num_threads_;
+  std::vector<ScenarioEntry> scenarios_;
+  // Index of the next scenario to be picked up by a worker thread.
+  volatile int next_scenario_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(BweScenarioRunner);
+};
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_SCENARIO_RUNNER_H_
@@ -0,0 +1,204 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_scenario_runner.h"
+
+#include <sstream>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_test_framework.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/packet_receiver.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/packet_sender.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+
+namespace {
+
+const int kFlowId = 0;
+
+void RunShortChoke(BandwidthEstimatorType bwe_type,
+                   uint32_t capacity_kbps,
+                   BweTest* test) {
+  AdaptiveVideoSource source(kFlowId, 30, 300, 0, 0);
+  VideoSender sender(test->uplink(), &source, bwe_type);
+  ChokeFilter choke(test->uplink(), kFlowId);
+  choke.set_capacity_kbps(capacity_kbps);
+  LinkShare link_share(&choke);
+  MetricRecorder metric_recorder(bwe_names[bwe_type], kFlowId, &sender,
+                                 &link_share);
+  PacketReceiver receiver(test->uplink(), kFlowId, bwe_type, false, false,
+                          &metric_recorder);
+  test->RunFor(5000);
+  test->RecordMetrics(metric_recorder, 0);
+}
+
+void RunDelayedTcpFlow(int64_t offset_ms, BweTest* test) {
+  TcpSender sender(test->uplink(), kFlowId, offset_ms);
+  ChokeFilter choke(test->uplink(), kFlowId);
+  choke.set_capacity_kbps(500);
+  LinkShare link_share(&choke);
+  MetricRecorder metric_recorder(bwe_names[kTcpEstimator], kFlowId, &sender,
+                                 &link_share);
+  PacketReceiver receiver(test->uplink(), kFlowId, kTcpEstimator, false, false,
+                          &metric_recorder);
+  DelayFilter delay(test->downlink(), kFlowId);
+  delay.SetOneWayDelayMs(25);
+  test->RunFor(offset_ms + 2000);
+  test->RecordMetrics(metric_recorder, 0);
+}
+
+// Counts how often the simulation runs it.
+class RunCounter : public PacketProcessor {
+ public:
+  RunCounter(PacketProcessorListener* listener, int flow_id, bool idle)
+      : PacketProcessor(listener, flow_id, kRegular), idle_(idle), runs_(0) {}
+
+  void RunFor(int64_t time_ms, Packets* in_out) override { ++runs_; }
+  int64_t IdleTimeMs() override { return idle_ ? kAlwaysIdleMs : 0; }
+
+  int runs() const { return runs_; }
+
+ private:
+  const bool idle_;
+  int runs_;
+};
+
+// Runs a video flow whose first frame is sent after |offset_ms|. Unless
+// |skip_idle_time| is false, the time before that can be skipped.
+void RunDelayedVideoFlow(int64_t offset_ms,
+                         bool skip_idle_time,
+                         BweTest* test,
+                         int* runs) {
+  VideoSource source(kFlowId, 30, 300, 0, offset_ms);
+  VideoSender sender(test->uplink(), &source, kNullEstimator);
+  RunCounter counter(test->uplink(), kFlowId, skip_idle_time);
+  ChokeFilter choke(test->uplink(), kFlowId);
+  choke.set_capacity_kbps(500);
+  LinkShare link_share(&choke);
+  MetricRecorder metric_recorder(bwe_names[kNullEstimator], kFlowId, &sender,
+                                 &link_share);
+  PacketReceiver receiver(test->uplink(), kFlowId, kNullEstimator, false,
+                          false, &metric_recorder);
+  test->RunFor(offset_ms + 2000);
+  test->RecordMetrics(metric_recorder, 0);
+  *runs = counter.runs();
+}
+
+void AddChokeScenarios(BweScenarioRunner* runner) {
+  const uint32_t kCapacitiesKbps[] = {200, 500, 1000, 2000};
+  for (uint32_t capacity_kbps : kCapacitiesKbps) {
+    std::stringstream name;
+    name << "Choke_" << capacity_kbps;
+    runner->AddScenario(name.str(), [capacity_kbps](BweTest* test) {
+      RunShortChoke(kRembEstimator, capacity_kbps, test);
+    });
+  }
+}
+
+}  // namespace
+
+TEST(BweScenarioRunnerTest, ParallelRunMatchesSerialRun) {
+  BweScenarioRunner serial_runner(1);
+  AddChokeScenarios(&serial_runner);
+  serial_runner.Run();
+
+  BweScenarioRunner parallel_runner(4);
+  AddChokeScenarios(&parallel_runner);
+  parallel_runner.Run();
+
+  std::vector<MetricSummary> summaries = serial_runner.GetMetricSummaries();
+  ASSERT_EQ(4u, summaries.size());
+  EXPECT_EQ("Choke_200", summaries[0].scenario);
+  EXPECT_EQ("Choke_2000", summaries[3].scenario);
+  for (const MetricSummary& summary : summaries)
+    EXPECT_GT(summary.num_packets, 0u);
+  EXPECT_EQ(BweScenarioRunner::ToCsv(summaries),
+            BweScenarioRunner::ToCsv(parallel_runner.GetMetricSummaries()));
+}
+
+// The time before the TCP flow starts is skipped rather than stepped
+// through, which must not change what happens once it has started.
+TEST(BweScenarioRunnerTest, SkipsIdleTimeBeforeFlowStarts) {
+  BweScenarioRunner runner(1);
+  runner.AddScenario("Tcp", [](BweTest* test) { RunDelayedTcpFlow(0, test); });
+  runner.AddScenario("DelayedTcp", [](BweTest* test) {
+    RunDelayedTcpFlow(60 * 1000, test);
+  });
+  runner.Run();
+
+  std::vector<MetricSummary> summaries = runner.GetMetricSummaries();
+  ASSERT_EQ(2u, summaries.size());
+  EXPECT_GT(summaries[0].num_packets, 0u);
+  EXPECT_EQ(summaries[0].num_packets, summaries[1].num_packets);
+  EXPECT_EQ(summaries[0].average_delay_ms, summaries[1].average_delay_ms);
+  EXPECT_EQ(summaries[0].delay_95th_percentile_ms,
+            summaries[1].delay_95th_percentile_ms);
+}
+
+// A video sender is idle until its first frame, so the simulation skips the
+// time before it without changing the outcome.
+TEST(BweScenarioRunnerTest, SkipsIdleTimeBeforeFirstVideoFrame) {
+  const int64_t kOffsetMs = 60 * 1000;
+  int skipping_runs = 0;
+  int stepping_runs = 0;
+  BweScenarioRunner runner(1);
+  runner.AddScenario("Skipping", [&skipping_runs](BweTest* test) {
+    RunDelayedVideoFlow(kOffsetMs, true, test, &skipping_runs);
+  });
+  runner.AddScenario("Stepping", [&stepping_runs](BweTest* test) {
+    RunDelayedVideoFlow(kOffsetMs, false, test, &stepping_runs);
+  });
+  runner.Run();
+
+  std::vector<MetricSummary> summaries = runner.GetMetricSummaries();
+  ASSERT_EQ(2u, summaries.size());
+  EXPECT_GT(summaries[0].num_packets, 0u);
+  EXPECT_EQ(summaries[0].num_packets, summaries[1].num_packets);
+  EXPECT_EQ(summaries[0].average_bitrate_kbps,
+            summaries[1].average_bitrate_kbps);
+  EXPECT_EQ(summaries[0].average_delay_ms, summaries[1].average_delay_ms);
+  EXPECT_EQ(summaries[0].delay_95th_percentile_ms,
+            summaries[1].delay_95th_percentile_ms);
+  // The null estimator's feedback interval of one second is the step size,
+  // so stepping runs about once per simulated second.
+  EXPECT_GE(stepping_runs, 60);
+  EXPECT_LT(skipping_runs, 10);
+}
+
+TEST(BweScenarioRunnerTest, WritesCsvAndJson) {
+  std::vector<MetricSummary> summaries(2);
+  summaries[0].scenario = "Trace \"A\"";
+  summaries[0].algorithm_name = "GCC";
+  summaries[0].flow_id = 1;
+  summaries[0].num_packets = 10;
+  summaries[0].average_bitrate_kbps = 250;
+  summaries[1].scenario = "B";
+  summaries[1].algorithm_name = "x,y";
+
+  std::string csv = BweScenarioRunner::ToCsv(summaries);
+  EXPECT_EQ(0u, csv.find("scenario,algorithm,flow_id,num_packets,"));
+  EXPECT_NE(std::string::npos,
+            csv.find("\n\"Trace \"\"A\"\"\",GCC,1,10,250,"));
+  EXPECT_NE(std::string::npos, csv.find("\nB,\"x,y\",0,0,0,"));
+
+  std::string json = BweScenarioRunner::ToJson(summaries);
+  EXPECT_EQ('[', json[0]);
+  EXPECT_NE(std::string::npos, json.find("\"scenario\": \"Trace \\\"A\\\"\""));
+  EXPECT_NE(std::string::npos, json.find("\"average_bitrate_kbps\": 250"));
+  EXPECT_NE(std::string::npos, json.find("},\n  {\"scenario\": \"B\""));
+  EXPECT_EQ("[\n]\n",
+            BweScenarioRunner::ToJson(std::vector<MetricSummary>()));
+}
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
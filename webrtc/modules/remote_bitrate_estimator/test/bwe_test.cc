@@ -57,6 +57,12 @@ void PacketProcessorRunner::RunFor(int64_t time_ms,
   in_out->merge(to_process, DereferencingComparator<Packet>);
 }
 
+int64_t PacketProcessorRunner::IdleTimeMs() const {
+  if (!queue_.empty())
+    return 0;
+  return processor_->IdleTimeMs();
+}
+
 void PacketProcessorRunner::FindPacketsToProcess(const FlowIds& flow_ids,
                                                  Packets* in,
                                                  Packets* out) {
@@ -154,6 +160,13 @@ void Link::Run(int64_t run_for_ms, int64_t now_ms, Packets* packets) {
   }
 }
 
+int64_t Link::IdleTimeMs() const {
+  int64_t idle_time_ms = kAlwaysIdleMs;
+  for (const auto& processor : processors_)
+    idle_time_ms = std::min(idle_time_ms, processor.IdleTimeMs());
+  return idle_time_ms;
+}
+
 void BweTest::VerboseLogging(bool enable) {
   BWE_TEST_LOGGING_GLOBAL_ENABLE(enable);
 }
@@ -170,24 +183,46 @@ void BweTest::RunFor(int64_t time_ms) {
   if (time_now_ms_ == -1) {
     time_now_ms_ = simulation_interval_ms_;
   }
-  for (run_time_ms_ += time_ms;
-       time_now_ms_ <= run_time_ms_ - simulation_interval_ms_;
-       time_now_ms_ += simulation_interval_ms_) {
+  run_time_ms_ += time_ms;
+  while (time_now_ms_ <= run_time_ms_ - simulation_interval_ms_) {
+    // While no packets are in flight and all processors are idle, nothing
+    // would happen in the coming steps, so run them as one.
+    int64_t num_steps = 1;
+    if (packets_.empty()) {
+      int64_t idle_time_ms = kAlwaysIdleMs;
+      for (Link* link : links_)
+        idle_time_ms = std::min(idle_time_ms, link->IdleTimeMs());
+      int64_t steps_left =
+          (run_time_ms_ - time_now_ms_) / simulation_interval_ms_;
+      num_steps = std::max<int64_t>(
+          std::min(idle_time_ms / simulation_interval_ms_, steps_left), 1);
+    }
+    int64_t step_ms = num_steps * simulation_interval_ms_;
+    time_now_ms_ += step_ms - simulation_interval_ms_;
     // Packets are first generated on the first link, passed through all the
     // PacketProcessors and PacketReceivers. The PacketReceivers produces
     // FeedbackPackets which are then processed by the next link, where they
     // at some point will be consumed by a PacketSender.
     for (Link* link : links_)
-      link->Run(simulation_interval_ms_, time_now_ms_, &packets_);
+      link->Run(step_ms, time_now_ms_, &packets_);
+    time_now_ms_ += simulation_interval_ms_;
   }
 }
 
 string BweTest::GetTestName() const {
+  if (!name_.empty())
+    return name_;
   const ::testing::TestInfo* const test_info =
       ::testing::UnitTest::GetInstance()->current_test_info();
   return string(test_info->name());
 }
 
+void BweTest::RecordMetrics(const MetricRecorder& metric_recorder,
+                            int64_t extra_offset_ms) {
+  metric_summaries_.push_back(metric_recorder.GetSummary(extra_offset_ms));
+  metric_summaries_.back().scenario = GetTestName();
+}
+
 void BweTest::PrintResults(double max_throughput_kbps,
                            Stats<double> throughput_kbps,
                            int flow_id,
@@ -372,6 +407,7 @@ void BweTest::RunFairnessTest(BandwidthEstimatorType bwe_type,
                flow_delay_ms, flow_throughput_kbps);
 
   for (int i : all_flow_ids) {
+    RecordMetrics(*metric_recorders[i], 0);
     metric_recorders[i]->PlotThroughputHistogram(
         title, flow_name, static_cast<int>(num_media_flows), 0);
 
@@ -427,6 +463,7 @@ void BweTest::RunChoke(BandwidthEstimatorType bwe_type,
   }
 
   title << "_kbps,_" << (kRunTimeMs / 1000) << "s_each";
+  RecordMetrics(metric_recorder, 0);
   metric_recorder.PlotThroughputHistogram(title.str(), bwe_names[bwe_type], 1,
                                           0);
   metric_recorder.PlotDelayHistogram(title.str(), bwe_names[bwe_type], 1, 0);
@@ -467,6 +504,7 @@ void BweTest::RunVariableCapacity1SingleFlow(BandwidthEstimatorType bwe_type) {
   RunFor(20 * 1000);  // 80-100s.
 
   std::string title("5.1_Variable_capacity_single_flow");
+  RecordMetrics(metric_recorder, 0);
   metric_recorder.PlotThroughputHistogram(title, bwe_names[bwe_type], 1, 0);
   metric_recorder.PlotDelayHistogram(title, bwe_names[bwe_type], 1,
                                      kOneWayDelayMs);
@@ -531,6 +569,7 @@ void BweTest::RunVariableCapacity2MultipleFlows(BandwidthEstimatorType bwe_type,
 
   std::string title("5.2_Variable_capacity_two_flows");
   for (size_t i = 0; i < num_flows; ++i) {
+    RecordMetrics(*metric_recorders[i], 0);
     metric_recorders[i]->PlotThroughputHistogram(title, bwe_names[bwe_type],
                                                  num_flows, 0);
     metric_recorders[i]->PlotDelayHistogram(title, bwe_names[bwe_type],
@@ -618,6 +657,7 @@ void BweTest::RunBidirectionalFlow(BandwidthEstimatorType bwe_type) {
 
   std::string title("5.3_Bidirectional_flows");
   for (size_t i = 0; i < kNumFlows; ++i) {
+    RecordMetrics(*metric_recorders[i], 0);
     metric_recorders[i].get()->PlotThroughputHistogram(
         title, bwe_names[bwe_type], kNumFlows, 0);
     metric_recorders[i].get()->PlotDelayHistogram(title, bwe_names[bwe_type],
@@ -727,6 +767,7 @@ void BweTest::RunRoundTripTimeFairness(BandwidthEstimatorType bwe_type) {
 
   std::string title("5.5_Round_Trip_Time_Fairness");
   for (size_t i = 0; i < kNumFlows; ++i) {
+    RecordMetrics(*metric_recorders[i], 0);
     metric_recorders[i].get()->PlotThroughputHistogram(
         title, bwe_names[bwe_type], kNumFlows, 0);
     metric_recorders[i].get()->PlotDelayHistogram(title, bwe_names[bwe_type],
@@ -855,6 +896,7 @@ void BweTest::RunMultipleShortTcpFairness(
 
   std::string title("5.7_Multiple_short_TCP_flows");
   for (size_t id : kAllRmcatFlowIds) {
+    RecordMetrics(*metric_recorders[id], 0);
     metric_recorders[id].get()->PlotThroughputHistogram(
         title, bwe_names[bwe_type], kNumRmcatFlows, 0);
     metric_recorders[id].get()->PlotDelayHistogram(
@@ -927,6 +969,7 @@ void BweTest::RunPauseResumeFlows(BandwidthEstimatorType bwe_type) {
 
   std::string title("5.8_Pause_and_resume_media_flow");
   for (size_t i = 0; i < kNumFlows; ++i) {
+    RecordMetrics(*metric_recorders[i], paused[i]);
     metric_recorders[i].get()->PlotThroughputHistogram(
         title, bwe_names[bwe_type], kNumFlows, paused[i], optima_lines[i]);
     metric_recorders[i].get()->PlotDelayHistogram(title, bwe_names[bwe_type],
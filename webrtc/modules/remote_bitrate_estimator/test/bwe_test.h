@@ -19,6 +19,7 @@
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
 #include "webrtc/modules/remote_bitrate_estimator/test/bwe.h"
 #include "webrtc/modules/remote_bitrate_estimator/test/bwe_test_framework.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/metric_recorder.h"
 
 namespace webrtc {
 
@@ -36,6 +37,8 @@ class PacketProcessorRunner {
 
   bool RunsProcessor(const PacketProcessor* processor) const;
   void RunFor(int64_t time_ms, int64_t time_now_ms, Packets* in_out);
+  // Returns 0 if packets are queued, otherwise the processor's idle time.
+  int64_t IdleTimeMs() const;
 
  private:
   void FindPacketsToProcess(const FlowIds& flow_ids, Packets* in, Packets* out);
@@ -54,6 +57,8 @@ class Link : public PacketProcessorListener {
   virtual void RemovePacketProcessor(PacketProcessor* processor);
 
   void Run(int64_t run_for_ms, int64_t now_ms, Packets* packets);
+  // Minimum idle time of the processors on this link.
+  int64_t IdleTimeMs() const;
 
   const std::vector<PacketSender*>& senders() { return senders_; }
   const std::vector<PacketProcessorRunner>& processors() { return processors_; }
@@ -110,11 +115,28 @@ class BweTest {
   static std::vector<int> GetFileSizesBytes(int num_files);
   static std::vector<int64_t> GetStartingTimesMs(int num_files);
 
+  void RunFor(int64_t time_ms);
+  // Adds the summary of |metric_recorder| to metric_summaries().
+  void RecordMetrics(const MetricRecorder& metric_recorder,
+                     int64_t extra_offset_ms);
+
+  Link* uplink() { return &uplink_; }
+  Link* downlink() { return &downlink_; }
+
+  // Name used when printing results. Defaults to the name of the running
+  // gtest test, which isn't available when running scenarios outside of one.
+  void set_name(const std::string& name) { name_ = name; }
+
+  // Summaries of the metrics recorded for each flow by the Run*() methods
+  // above.
+  const std::vector<MetricSummary>& metric_summaries() const {
+    return metric_summaries_;
+  }
+
  protected:
   void SetUp();
 
   void VerboseLogging(bool enable);
-  void RunFor(int64_t time_ms);
   std::string GetTestName() const;
 
   void PrintResults(double max_throughput_kbps,
@@ -136,6 +158,8 @@ class BweTest {
                             Packets* out);
   void GiveFeedbackToAffectedSenders(PacketReceiver* receiver);
 
+  std::string name_;
+  std::vector<MetricSummary> metric_summaries_;
   int64_t run_time_ms_;
   int64_t time_now_ms_;
   int64_t simulation_interval_ms_;
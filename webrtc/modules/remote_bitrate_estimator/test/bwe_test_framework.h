@@ -15,6 +15,7 @@
 #include <math.h>
 
 #include <algorithm>
+#include <limits>
 #include <list>
 #include <numeric>
 #include <set>
@@ -181,6 +182,10 @@ class PacketProcessor;
 
 enum ProcessorType { kSender, kReceiver, kRegular };
 
+// Returned by PacketProcessor::IdleTimeMs() for processors which only ever
+// act on the packets they are given.
+const int64_t kAlwaysIdleMs = std::numeric_limits<int64_t>::max();
+
 class PacketProcessorListener {
  public:
   virtual ~PacketProcessorListener() {}
@@ -209,6 +214,13 @@ class PacketProcessor {
   // |send_time_us_|. The simulation time |time_ms| is optional to use.
   virtual void RunFor(int64_t time_ms, Packets* in_out) = 0;
 
+  // Returns for how many milliseconds RunFor() can be called without any
+  // effect, as long as it isn't given any packets. The simulation skips ahead
+  // when every processor is idle and no packets are in flight. Processors
+  // which generate packets or sample statistics every run are never idle,
+  // which is the default.
+  virtual int64_t IdleTimeMs() { return 0; }
+
   const FlowIds& flow_ids() const { return flow_ids_; }
 
   uint32_t packets_per_second() const;
@@ -265,6 +277,7 @@ class LossFilter : public PacketProcessor {
 
   void SetLoss(float loss_percent);
   virtual void RunFor(int64_t time_ms, Packets* in_out);
+  int64_t IdleTimeMs() override { return kAlwaysIdleMs; }
 
  private:
   Random random_;
@@ -281,6 +294,7 @@ class DelayFilter : public PacketProcessor {
 
   void SetOneWayDelayMs(int64_t one_way_delay_ms);
   virtual void RunFor(int64_t time_ms, Packets* in_out);
+  int64_t IdleTimeMs() override { return kAlwaysIdleMs; }
 
  private:
   int64_t one_way_delay_us_;
@@ -297,6 +311,7 @@ class JitterFilter : public PacketProcessor {
 
   void SetMaxJitter(int64_t stddev_jitter_ms);
   virtual void RunFor(int64_t time_ms, Packets* in_out);
+  int64_t IdleTimeMs() override { return kAlwaysIdleMs; }
   void set_reorderdering(bool reordering) { reordering_ = reordering; }
   int64_t MeanUs();
 
@@ -318,6 +333,7 @@ class ReorderFilter : public PacketProcessor {
 
   void SetReorder(float reorder_percent);
   virtual void RunFor(int64_t time_ms, Packets* in_out);
+  int64_t IdleTimeMs() override { return kAlwaysIdleMs; }
 
  private:
   Random random_;
@@ -339,6 +355,7 @@ class ChokeFilter : public PacketProcessor {
   uint32_t capacity_kbps();
 
   virtual void RunFor(int64_t time_ms, Packets* in_out);
+  int64_t IdleTimeMs() override { return kAlwaysIdleMs; }
 
   Stats<double> GetDelayStats() const;
 
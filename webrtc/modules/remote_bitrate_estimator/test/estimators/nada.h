@@ -72,6 +72,7 @@ class NadaBweSender : public BweSender {
   void OnPacketsSent(const Packets& packets) override {}
   int64_t TimeUntilNextProcess() override;
   int Process() override;
+  int64_t IdleTimeMs() override { return kAlwaysIdleMs; }
   void AcceleratedRampUp(const NadaFeedback& fb);
   void AcceleratedRampDown(const NadaFeedback& fb);
   void GradualRateUpdate(const NadaFeedback& fb,
@@ -10,6 +10,8 @@
 
 #include "webrtc/modules/remote_bitrate_estimator/test/estimators/send_side.h"
 
+#include <algorithm>
+
 #include "webrtc/base/logging.h"
 #include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_abs_send_time.h"
 #include "webrtc/modules/remote_bitrate_estimator/test/bwe_test_logging.h"
@@ -116,6 +118,14 @@ int FullBweSender::Process() {
   return bitrate_controller_->Process();
 }
 
+int64_t FullBweSender::IdleTimeMs() {
+  // Process() also runs the estimator, which updates on its own interval.
+  return std::max<int64_t>(std::min(bitrate_controller_->TimeUntilNextProcess(),
+                                    rbe_->TimeUntilNextProcess()) -
+                               1,
+                           0);
+}
+
 SendSideBweReceiver::SendSideBweReceiver(int flow_id)
     : BweReceiver(flow_id), last_feedback_ms_(0) {
 }
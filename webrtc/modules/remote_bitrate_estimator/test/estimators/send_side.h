@@ -32,6 +32,7 @@ class FullBweSender : public BweSender, public RemoteBitrateObserver {
                                unsigned int bitrate) override;
   int64_t TimeUntilNextProcess() override;
   int Process() override;
+  int64_t IdleTimeMs() override;
 
  protected:
   rtc::scoped_ptr<BitrateController> bitrate_controller_;
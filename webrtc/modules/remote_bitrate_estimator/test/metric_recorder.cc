@@ -351,6 +351,28 @@ void MetricRecorder::PlotObjectiveHistogram(const std::string& title,
   BWE_TEST_LOGGING_BAR(7, bwe_name, ObjectiveFunction(), flow_id_);
 }
 
+MetricSummary MetricRecorder::GetSummary(int64_t extra_offset_ms) const {
+  MetricSummary summary;
+  summary.algorithm_name = algorithm_name_;
+  summary.flow_id = flow_id_;
+  summary.num_packets = num_packets_received_;
+  summary.average_bitrate_kbps = AverageBitrateKbps(extra_offset_ms);
+  int64_t duration_ms = RunDurationMs(extra_offset_ms);
+  if (duration_ms > 0) {
+    summary.optimal_bitrate_kbps =
+        static_cast<double>(optimal_throughput_bits_ / duration_ms);
+  }
+  if (num_packets_received_ > 0) {
+    summary.average_delay_ms =
+        static_cast<double>(sum_delays_ms_) / num_packets_received_;
+    summary.delay_5th_percentile_ms = NthDelayPercentile(5);
+    summary.delay_95th_percentile_ms = NthDelayPercentile(95);
+  }
+  summary.loss_ratio = plot_information_[kLoss].value;
+  summary.objective = ObjectiveFunction();
+  return summary;
+}
+
 void MetricRecorder::PlotZero() {
   for (int i = kThroughput; i <= kLoss; ++i) {
     if (plot_information_[i].plot) {
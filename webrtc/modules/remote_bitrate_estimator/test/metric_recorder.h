@@ -62,6 +62,32 @@ struct PlotInformation {
   int64_t plot_interval_ms;
 };
 
+// End of run metrics for one flow, as computed by MetricRecorder.
+struct MetricSummary {
+  MetricSummary()
+      : flow_id(0),
+        num_packets(0),
+        average_bitrate_kbps(0.0),
+        optimal_bitrate_kbps(0.0),
+        average_delay_ms(0.0),
+        delay_5th_percentile_ms(0),
+        delay_95th_percentile_ms(0),
+        loss_ratio(0.0),
+        objective(0.0) {}
+
+  std::string scenario;
+  std::string algorithm_name;
+  int flow_id;
+  size_t num_packets;
+  double average_bitrate_kbps;
+  double optimal_bitrate_kbps;
+  double average_delay_ms;
+  int64_t delay_5th_percentile_ms;
+  int64_t delay_95th_percentile_ms;
+  double loss_ratio;
+  double objective;
+};
+
 class MetricRecorder {
  public:
   MetricRecorder(const std::string algorithm_name,
@@ -122,6 +148,10 @@ class MetricRecorder {
     plot_information_[kTotalAvailable].plot = plot;
   }
 
+  // |extra_offset_ms| is excluded from the run time, as for
+  // PlotThroughputHistogram().
+  MetricSummary GetSummary(int64_t extra_offset_ms) const;
+
   void PauseFlow();                         // Plot zero.
   void ResumeFlow(int64_t paused_time_ms);  // Plot zero.
   void PlotZero();
@@ -40,6 +40,7 @@ class PacketReceiver : public PacketProcessor {
 
   // Implements PacketProcessor.
   void RunFor(int64_t time_ms, Packets* in_out) override;
+  int64_t IdleTimeMs() override { return kAlwaysIdleMs; }
 
   void LogStats();
 
@@ -138,6 +138,14 @@ void VideoSender::ProcessFeedbackAndGeneratePackets(
   assert(feedbacks->empty());
 }
 
+int64_t VideoSender::IdleTimeMs() {
+  // Without feedback, RunFor() only has an effect once the next frame is due
+  // or the estimator has something to do.
+  return std::max<int64_t>(
+      std::min(source_->GetTimeUntilNextFrameMs() - 1, bwe_->IdleTimeMs()),
+      0);
+}
+
 int VideoSender::GetFeedbackIntervalMs() const {
   return bwe_->GetFeedbackIntervalMs();
 }
@@ -236,6 +244,15 @@ void PacedVideoSender::RunFor(int64_t time_ms, Packets* in_out) {
   QueuePackets(in_out, end_time_ms * 1000);
 }
 
+int64_t PacedVideoSender::IdleTimeMs() {
+  // Packets waiting to be paced out are sent on the coming runs.
+  if (!pacer_queue_.empty() || !queue_.empty())
+    return 0;
+  return std::max<int64_t>(
+      std::min(VideoSender::IdleTimeMs(), pacer_.TimeUntilNextProcess() - 1),
+      0);
+}
+
 int64_t PacedVideoSender::TimeUntilNextProcess(
     const std::list<Module*>& modules) {
   int64_t time_until_next_process_ms = 10;
@@ -384,6 +401,14 @@ void TcpSender::RunFor(int64_t time_ms, Packets* in_out) {
   SendPackets(in_out);
 }
 
+int64_t TcpSender::IdleTimeMs() {
+  // Before the offset RunFor() only moves the clock forward, once the flow
+  // has been paused.
+  if (running_ || clock_.TimeInMilliseconds() >= offset_ms_)
+    return 0;
+  return offset_ms_ - clock_.TimeInMilliseconds() - 1;
+}
+
 void TcpSender::SendPackets(Packets* in_out) {
   int cwnd = ceil(cwnd_);
   int packets_to_send = std::max(cwnd - static_cast<int>(in_flight_.size()), 0);
@@ -72,6 +72,7 @@ class VideoSender : public PacketSender, public BitrateObserver {
 
   int GetFeedbackIntervalMs() const override;
   void RunFor(int64_t time_ms, Packets* in_out) override;
+  int64_t IdleTimeMs() override;
 
   virtual VideoSource* source() const { return source_; }
 
@@ -108,6 +109,7 @@ class PacedVideoSender : public VideoSender, public PacedSender::Callback {
   virtual ~PacedVideoSender();
 
   void RunFor(int64_t time_ms, Packets* in_out) override;
+  int64_t IdleTimeMs() override;
 
   // Implements PacedSender::Callback.
   bool TimeToSendPacket(uint32_t ssrc,
@@ -143,6 +145,7 @@ class TcpSender : public PacketSender {
   virtual ~TcpSender() {}
 
   void RunFor(int64_t time_ms, Packets* in_out) override;
+  int64_t IdleTimeMs() override;
   int GetFeedbackIntervalMs() const override { return 10; }
 
   uint32_t TargetBitrateKbps() override;
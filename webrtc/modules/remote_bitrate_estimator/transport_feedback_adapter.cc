@@ -10,6 +10,7 @@
 
 #include "webrtc/modules/remote_bitrate_estimator/transport_feedback_adapter.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "webrtc/base/checks.h"
@@ -85,31 +86,28 @@ void TransportFeedbackAdapter::OnTransportFeedback(
   }
   last_timestamp_us_ = timestamp_us;
 
-  uint16_t sequence_number = feedback.GetBaseSequence();
-  std::vector<int64_t> delta_vec = feedback.GetReceiveDeltasUs();
-  auto delta_it = delta_vec.begin();
-  std::vector<PacketInfo> packet_feedback_vector;
-  packet_feedback_vector.reserve(delta_vec.size());
+  // Unpack the received packets and their arrival times into the reused
+  // feedback vector, then join them with their send times in one pass over the
+  // history.
+  feedback.GetReceivedPackets(&received_packets_);
+  packet_feedback_vector_.clear();
+  int64_t offset_us = 0;
+  for (const rtcp::TransportFeedback::ReceivedPacket& packet :
+       received_packets_) {
+    offset_us += packet.delta_us;
+    packet_feedback_vector_.push_back(PacketInfo(
+        current_offset_ms_ + (offset_us / 1000), packet.sequence_number));
+  }
 
   {
     rtc::CritScope cs(&lock_);
-    size_t failed_lookups = 0;
-    int64_t offset_us = 0;
-    for (auto symbol : feedback.GetStatusVector()) {
-      if (symbol != rtcp::TransportFeedback::StatusSymbol::kNotReceived) {
-        RTC_DCHECK(delta_it != delta_vec.end());
-        offset_us += *(delta_it++);
-        int64_t timestamp_ms = current_offset_ms_ + (offset_us / 1000);
-        PacketInfo info(timestamp_ms, sequence_number);
-        if (send_time_history_.GetInfo(&info, true) && info.send_time_ms >= 0) {
-          packet_feedback_vector.push_back(info);
-        } else {
-          ++failed_lookups;
-        }
-      }
-      ++sequence_number;
-    }
-    RTC_DCHECK(delta_it == delta_vec.end());
+    size_t failed_lookups =
+        send_time_history_.GetInfos(&packet_feedback_vector_, true);
+    auto unsent = std::remove_if(
+        packet_feedback_vector_.begin(), packet_feedback_vector_.end(),
+        [](const PacketInfo& info) { return info.send_time_ms < 0; });
+    failed_lookups += packet_feedback_vector_.end() - unsent;
+    packet_feedback_vector_.erase(unsent, packet_feedback_vector_.end());
     if (failed_lookups > 0) {
       LOG(LS_WARNING) << "Failed to lookup send time for " << failed_lookups
                       << " packet" << (failed_lookups > 1 ? "s" : "")
@@ -118,7 +116,7 @@ void TransportFeedbackAdapter::OnTransportFeedback(
   }
 
   RTC_DCHECK(bitrate_estimator_.get() != nullptr);
-  bitrate_estimator_->IncomingPacketFeedbackVector(packet_feedback_vector);
+  bitrate_estimator_->IncomingPacketFeedbackVector(packet_feedback_vector_);
 }
 
 void TransportFeedbackAdapter::OnReceiveBitrateChanged(
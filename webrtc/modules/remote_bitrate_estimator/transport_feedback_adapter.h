@@ -19,6 +19,7 @@
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/send_time_history.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 
 namespace webrtc {
 
@@ -60,6 +61,10 @@ class TransportFeedbackAdapter : public TransportFeedbackObserver,
   Clock* const clock_;
   int64_t current_offset_ms_;
   int64_t last_timestamp_us_;
+  // Scratch storage for OnTransportFeedback(), kept to avoid reallocating it
+  // for every feedback message.
+  std::vector<rtcp::TransportFeedback::ReceivedPacket> received_packets_;
+  std::vector<PacketInfo> packet_feedback_vector_;
 };
 
 }  // namespace webrtc
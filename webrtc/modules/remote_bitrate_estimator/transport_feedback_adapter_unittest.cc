@@ -15,7 +15,9 @@
 #include "testing/gtest/include/gtest/gtest.h"
 
 #include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/mock/mock_remote_bitrate_estimator.h"
 #include "webrtc/modules/remote_bitrate_estimator/transport_feedback_adapter.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
@@ -321,5 +323,114 @@ TEST_F(TransportFeedbackAdapterTest, TimestampDeltas) {
   ComparePacketVectors(sent_packets, received_feedback);
 }
 
+class NullRtcpBandwidthObserver : public RtcpBandwidthObserver {
+ public:
+  void OnReceivedEstimatedBitrate(uint32_t bitrate) override {}
+  void OnReceivedRtcpReceiverReport(const ReportBlockList& report_blocks,
+                                    int64_t rtt,
+                                    int64_t now_ms) override {}
+};
+
+// Counts the packets fed to it, so that the benchmark below only measures the
+// adapter.
+class CountingBitrateEstimator : public RemoteBitrateEstimator {
+ public:
+  CountingBitrateEstimator() : num_packets_(0) {}
+
+  void IncomingPacketFeedbackVector(
+      const std::vector<PacketInfo>& packet_feedback_vector) override {
+    num_packets_ += packet_feedback_vector.size();
+  }
+  void IncomingPacket(int64_t arrival_time_ms,
+                      size_t payload_size,
+                      const RTPHeader& header,
+                      bool was_paced) override {}
+  void RemoveStream(unsigned int ssrc) override {}
+  bool LatestEstimate(std::vector<unsigned int>* ssrcs,
+                      unsigned int* bitrate_bps) const override {
+    return false;
+  }
+  bool GetStats(ReceiveBandwidthEstimatorStats* output) const override {
+    return false;
+  }
+  void SetMinBitrate(int min_bitrate_bps) override {}
+  void OnRttUpdate(int64_t avg_rtt_ms, int64_t max_rtt_ms) override {}
+  int64_t TimeUntilNextProcess() override { return 1000; }
+  int32_t Process() override { return 0; }
+
+  size_t num_packets_;
+};
+
+const int kPacketsPerFeedback = 100;
+const int kLossInterval = 10;
+
+// Sends |num_feedbacks| feedback messages through a TransportFeedbackAdapter,
+// each covering kPacketsPerFeedback packets with one in kLossInterval of them
+// lost. Returns the time spent in OnTransportFeedback(), and the number of
+// packets that reached the estimator in |num_packets|.
+int64_t ProcessLossyFeedback(int num_feedbacks, size_t* num_packets) {
+  SimulatedClock clock(0);
+  ::testing::NiceMock<MockProcessThread> process_thread;
+  TransportFeedbackAdapter adapter(new NullRtcpBandwidthObserver(), &clock,
+                                   &process_thread);
+  CountingBitrateEstimator* estimator = new CountingBitrateEstimator();
+  adapter.SetBitrateEstimator(estimator);
+
+  // Build the feedback messages up front, as received from the network.
+  std::vector<rtc::scoped_ptr<rtcp::TransportFeedback>> feedbacks;
+  uint16_t sequence_number = 0;
+  for (int i = 0; i < num_feedbacks; ++i) {
+    rtc::scoped_ptr<rtcp::TransportFeedback> feedback(
+        new rtcp::TransportFeedback());
+    int64_t arrival_time_us = clock.TimeInMicroseconds();
+    feedback->WithBase(sequence_number, arrival_time_us);
+    for (int j = 0; j < kPacketsPerFeedback; ++j, ++sequence_number) {
+      arrival_time_us += 100;
+      if (j % kLossInterval != kLossInterval - 1)
+        feedback->WithReceivedPacket(sequence_number, arrival_time_us);
+    }
+    rtc::scoped_ptr<rtcp::RawPacket> raw_packet = feedback->Build();
+    feedbacks.push_back(rtcp::TransportFeedback::ParseFrom(
+        raw_packet->Buffer(), raw_packet->Length()));
+    clock.AdvanceTimeMilliseconds(10);
+  }
+
+  int64_t elapsed_us = 0;
+  sequence_number = 0;
+  for (const auto& feedback : feedbacks) {
+    for (int j = 0; j < kPacketsPerFeedback; ++j, ++sequence_number) {
+      adapter.AddPacket(sequence_number, 1200, true);
+      adapter.OnSentPacket(sequence_number, clock.TimeInMilliseconds());
+    }
+    int64_t start_us = rtc::TimeMicros();
+    adapter.OnTransportFeedback(*feedback);
+    elapsed_us += rtc::TimeMicros() - start_us;
+  }
+  *num_packets = estimator->num_packets_;
+  return elapsed_us;
+}
+
+// Only the received packets of lossy feedback are passed on to the estimator.
+TEST(TransportFeedbackAdapterLossTest, OnlyReceivedPacketsReachEstimator) {
+  const int kNumFeedbacks = 20;
+  size_t num_packets = 0;
+  ProcessLossyFeedback(kNumFeedbacks, &num_packets);
+  EXPECT_EQ(static_cast<size_t>(kNumFeedbacks * kPacketsPerFeedback *
+                                (kLossInterval - 1) / kLossInterval),
+            num_packets);
+}
+
+// Logs the cost of processing one feedback message covering 100 packets, one
+// in ten of them lost. It only measures time, so it is disabled by default.
+TEST(TransportFeedbackAdapterPerformanceTest,
+     DISABLED_FeedbackProcessingCost) {
+  const int kNumFeedbacks = 2000;
+  size_t num_packets = 0;
+  int64_t elapsed_us = ProcessLossyFeedback(kNumFeedbacks, &num_packets);
+  LOG(LS_INFO) << "Processed " << kNumFeedbacks << " feedback messages of "
+               << kPacketsPerFeedback << " packets in " << elapsed_us
+               << " us.";
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_RTP_RTCP_INCLUDE_RTCP_COALESCING_TRANSPORT_H_
+#define WEBRTC_MODULES_RTP_RTCP_INCLUDE_RTCP_COALESCING_TRANSPORT_H_
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/modules/include/module.h"
+#include "webrtc/transport.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Transport that merges the RTCP packets of several RtpRtcp modules sharing
+// the same underlying transport into fewer, larger compound packets. RTP
+// packets are passed straight through. RTCP packets are buffered until
+// Flush() is called or the next one would not fit in |max_packet_size| bytes;
+// since each of them is already a valid compound packet, the concatenation is
+// one as well (RFC 3550, section 6.1).
+//
+// Typical use is to set it as the RtpRtcp::Configuration::rtcp_report_transport
+// of all modules sharing a transport, so that only their periodic reports are
+// coalesced, and to register it on the modules' ProcessThread after them. It
+// then asks the thread to process it as soon as a report is buffered, which
+// flushes the reports of all modules handled in the same pass at once.
+// Without a ProcessThread, Flush() has to be called explicitly.
+class RtcpCoalescingTransport : public Transport, public Module {
+ public:
+  explicit RtcpCoalescingTransport(Transport* transport);
+  RtcpCoalescingTransport(Transport* transport, size_t max_packet_size);
+  // Sends anything still pending.
+  virtual ~RtcpCoalescingTransport();
+
+  bool SendRtp(const uint8_t* packet,
+               size_t length,
+               const PacketOptions& options) override;
+  // Always succeeds unless |packet| has to be sent right away, since the
+  // outcome of a buffered send is only known when it is flushed.
+  bool SendRtcp(const uint8_t* packet, size_t length) override;
+
+  // Sends the buffered RTCP packets, if any, as one packet. Returns false if
+  // the underlying transport failed to send it.
+  bool Flush();
+
+  // Number of RTCP bytes waiting to be flushed.
+  size_t pending_bytes() const;
+
+  // Module implementation. Process() flushes.
+  int64_t TimeUntilNextProcess() override;
+  int32_t Process() override;
+  void ProcessThreadAttached(ProcessThread* process_thread) override;
+
+ private:
+  bool FlushLocked() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  Transport* const transport_;
+  const size_t max_packet_size_;
+
+  mutable rtc::CriticalSection crit_;
+  rtc::scoped_ptr<uint8_t[]> buffer_ GUARDED_BY(crit_);
+  size_t pending_bytes_ GUARDED_BY(crit_);
+  ProcessThread* process_thread_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtcpCoalescingTransport);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_RTP_RTCP_INCLUDE_RTCP_COALESCING_TRANSPORT_H_
@@ -46,6 +46,10 @@ class RtpRtcp : public Module {
     *                         will do nothing.
     *  outgoing_transport   - Transport object that will be called when packets
     *                         are ready to be sent out on the network
+    *  rtcp_report_transport - If set, the periodic RTCP reports are sent
+    *                          through it instead of outgoing_transport, e.g.
+    *                          an RtcpCoalescingTransport shared by several
+    *                          modules. Other RTCP packets are not affected.
     *  intra_frame_callback - Called when the receiver request a intra frame.
     *  bandwidth_callback   - Called when we receive a changed estimate from
     *                         the receiver of out stream.
@@ -61,6 +65,7 @@ class RtpRtcp : public Module {
     Clock* clock;
     ReceiveStatistics* receive_statistics;
     Transport* outgoing_transport;
+    Transport* rtcp_report_transport;
     RtcpIntraFrameObserver* intra_frame_callback;
     RtcpBandwidthObserver* bandwidth_callback;
     TransportFeedbackObserver* transport_feedback_callback;
@@ -54,13 +54,15 @@ StreamStatisticianImpl::StreamStatisticianImpl(
 void StreamStatisticianImpl::IncomingPacket(const RTPHeader& header,
                                             size_t packet_length,
                                             bool retransmitted) {
-  UpdateCounters(header, packet_length, retransmitted);
-  NotifyRtpCallback();
+  StreamDataCounters counters =
+      UpdateCounters(header, packet_length, retransmitted);
+  rtp_callback_->DataCountersUpdated(counters, header.ssrc);
 }
 
-void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
-                                            size_t packet_length,
-                                            bool retransmitted) {
+StreamDataCounters StreamStatisticianImpl::UpdateCounters(
+    const RTPHeader& header,
+    size_t packet_length,
+    bool retransmitted) {
   CriticalSectionScoped cs(stream_lock_.get());
   bool in_order = InOrderPacketInternal(header.sequenceNumber);
   ssrc_ = header.ssrc;
@@ -110,6 +112,7 @@ void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
   // Our measured overhead. Filter from RFC 5104 4.2.1.2:
   // avg_OH (new) = 15/16*avg_OH (old) + 1/16*pckt_OH,
   received_packet_overhead_ = (15 * received_packet_overhead_ + packet_oh) >> 4;
+  return receive_counters_;
 }
 
 void StreamStatisticianImpl::UpdateJitter(const RTPHeader& header,
@@ -384,43 +387,44 @@ ReceiveStatistics* ReceiveStatistics::Create(Clock* clock) {
 
 ReceiveStatisticsImpl::ReceiveStatisticsImpl(Clock* clock)
     : clock_(clock),
+      statisticians_lock_(RWLockWrapper::CreateRWLock()),
       receive_statistics_lock_(CriticalSectionWrapper::CreateCriticalSection()),
       last_rate_update_ms_(0),
       rtcp_stats_callback_(NULL),
       rtp_stats_callback_(NULL) {}
 
 ReceiveStatisticsImpl::~ReceiveStatisticsImpl() {
-  while (!statisticians_.empty()) {
-    delete statisticians_.begin()->second;
-    statisticians_.erase(statisticians_.begin());
-  }
+  for (auto& kv : statisticians_)
+    delete kv.second;
 }
 
 void ReceiveStatisticsImpl::IncomingPacket(const RTPHeader& header,
                                            size_t packet_length,
                                            bool retransmitted) {
-  StreamStatisticianImpl* impl;
+  StreamStatisticianImpl* impl = nullptr;
   {
-    CriticalSectionScoped cs(receive_statistics_lock_.get());
-    StatisticianImplMap::iterator it = statisticians_.find(header.ssrc);
-    if (it != statisticians_.end()) {
+    ReadLockScoped rls(*statisticians_lock_);
+    StatisticianImplMap::const_iterator it = statisticians_.find(header.ssrc);
+    if (it != statisticians_.end())
       impl = it->second;
-    } else {
-      impl = new StreamStatisticianImpl(clock_, this, this);
-      statisticians_[header.ssrc] = impl;
-    }
+  }
+  if (!impl) {
+    WriteLockScoped wls(*statisticians_lock_);
+    StreamStatisticianImpl*& new_impl = statisticians_[header.ssrc];
+    if (!new_impl)
+      new_impl = new StreamStatisticianImpl(clock_, this, this);
+    impl = new_impl;
   }
   // StreamStatisticianImpl instance is created once and only destroyed when
   // this whole ReceiveStatisticsImpl is destroyed. StreamStatisticianImpl has
-  // it's own locking so don't hold receive_statistics_lock_ (potential
-  // deadlock).
+  // it's own locking so don't hold statisticians_lock_ (potential deadlock).
   impl->IncomingPacket(header, packet_length, retransmitted);
 }
 
 void ReceiveStatisticsImpl::FecPacketReceived(const RTPHeader& header,
                                               size_t packet_length) {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
-  StatisticianImplMap::iterator it = statisticians_.find(header.ssrc);
+  ReadLockScoped rls(*statisticians_lock_);
+  StatisticianImplMap::const_iterator it = statisticians_.find(header.ssrc);
   // Ignore FEC if it is the first packet.
   if (it != statisticians_.end()) {
     it->second->FecPacketReceived(header, packet_length);
@@ -428,15 +432,15 @@ void ReceiveStatisticsImpl::FecPacketReceived(const RTPHeader& header,
 }
 
 StatisticianMap ReceiveStatisticsImpl::GetActiveStatisticians() const {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
+  ReadLockScoped rls(*statisticians_lock_);
   StatisticianMap active_statisticians;
+  const int64_t now_ntp_ms = clock_->CurrentNtpInMilliseconds();
   for (StatisticianImplMap::const_iterator it = statisticians_.begin();
        it != statisticians_.end(); ++it) {
     uint32_t secs;
     uint32_t frac;
     it->second->LastReceiveTimeNtp(&secs, &frac);
-    if (clock_->CurrentNtpInMilliseconds() -
-        Clock::NtpToMs(secs, frac) < kStatisticsTimeoutMs) {
+    if (now_ntp_ms - Clock::NtpToMs(secs, frac) < kStatisticsTimeoutMs) {
       active_statisticians[it->first] = it->second;
     }
   }
@@ -445,7 +449,7 @@ StatisticianMap ReceiveStatisticsImpl::GetActiveStatisticians() const {
 
 StreamStatistician* ReceiveStatisticsImpl::GetStatistician(
     uint32_t ssrc) const {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
+  ReadLockScoped rls(*statisticians_lock_);
   StatisticianImplMap::const_iterator it = statisticians_.find(ssrc);
   if (it == statisticians_.end())
     return NULL;
@@ -454,7 +458,7 @@ StreamStatistician* ReceiveStatisticsImpl::GetStatistician(
 
 void ReceiveStatisticsImpl::SetMaxReorderingThreshold(
     int max_reordering_threshold) {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
+  ReadLockScoped rls(*statisticians_lock_);
   for (StatisticianImplMap::iterator it = statisticians_.begin();
        it != statisticians_.end(); ++it) {
     it->second->SetMaxReorderingThreshold(max_reordering_threshold);
@@ -462,11 +466,14 @@ void ReceiveStatisticsImpl::SetMaxReorderingThreshold(
 }
 
 int32_t ReceiveStatisticsImpl::Process() {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
-  for (StatisticianImplMap::iterator it = statisticians_.begin();
-       it != statisticians_.end(); ++it) {
-    it->second->ProcessBitrate();
+  {
+    ReadLockScoped rls(*statisticians_lock_);
+    for (StatisticianImplMap::iterator it = statisticians_.begin();
+         it != statisticians_.end(); ++it) {
+      it->second->ProcessBitrate();
+    }
   }
+  CriticalSectionScoped cs(receive_statistics_lock_.get());
   last_rate_update_ms_ = clock_->TimeInMilliseconds();
   return 0;
 }
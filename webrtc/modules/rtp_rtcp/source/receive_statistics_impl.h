@@ -14,11 +14,13 @@
 #include "webrtc/modules/rtp_rtcp/include/receive_statistics.h"
 
 #include <algorithm>
-#include <map>
+#include <unordered_map>
 
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread_annotations.h"
 #include "webrtc/modules/rtp_rtcp/source/bitrate.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/include/rw_lock_wrapper.h"
 
 namespace webrtc {
 
@@ -55,9 +57,11 @@ class StreamStatisticianImpl : public StreamStatistician {
   void UpdateJitter(const RTPHeader& header,
                     uint32_t receive_time_secs,
                     uint32_t receive_time_frac);
-  void UpdateCounters(const RTPHeader& rtp_header,
-                      size_t packet_length,
-                      bool retransmitted);
+  // Returns the updated counters, so that the RTP callback can be notified
+  // without taking |stream_lock_| a second time.
+  StreamDataCounters UpdateCounters(const RTPHeader& rtp_header,
+                                    size_t packet_length,
+                                    bool retransmitted);
   void NotifyRtpCallback() LOCKS_EXCLUDED(stream_lock_.get());
   void NotifyRtcpCallback() LOCKS_EXCLUDED(stream_lock_.get());
 
@@ -130,15 +134,23 @@ class ReceiveStatisticsImpl : public ReceiveStatistics,
   void DataCountersUpdated(const StreamDataCounters& counters,
                            uint32_t ssrc) override;
 
-  typedef std::map<uint32_t, StreamStatisticianImpl*> StatisticianImplMap;
+  typedef std::unordered_map<uint32_t, StreamStatisticianImpl*>
+      StatisticianImplMap;
 
   Clock* clock_;
-  rtc::scoped_ptr<CriticalSectionWrapper> receive_statistics_lock_;
-  int64_t last_rate_update_ms_;
-  StatisticianImplMap statisticians_;
+  // Looking up the statistician of an incoming packet only needs shared
+  // access. Exclusive access is needed once per new SSRC, so the network
+  // thread does not contend with Process() or RTCP generation walking a
+  // large number of streams.
+  rtc::scoped_ptr<RWLockWrapper> statisticians_lock_;
+  StatisticianImplMap statisticians_ GUARDED_BY(statisticians_lock_);
 
-  RtcpStatisticsCallback* rtcp_stats_callback_;
-  StreamDataCountersCallback* rtp_stats_callback_;
+  rtc::scoped_ptr<CriticalSectionWrapper> receive_statistics_lock_;
+  int64_t last_rate_update_ms_ GUARDED_BY(receive_statistics_lock_);
+  RtcpStatisticsCallback* rtcp_stats_callback_
+      GUARDED_BY(receive_statistics_lock_);
+  StreamDataCountersCallback* rtp_stats_callback_
+      GUARDED_BY(receive_statistics_lock_);
 };
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_RECEIVE_STATISTICS_IMPL_H_
@@ -10,6 +10,8 @@
 
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/rtp_rtcp/include/receive_statistics.h"
 #include "webrtc/system_wrappers/include/clock.h"
@@ -378,4 +380,73 @@ TEST_F(ReceiveStatisticsTest, RtpCallbacksFecFirst) {
   expected.fec.packets = 1;
   callback.Matches(2, kSsrc1, expected);
 }
+
+class RtcpReportThread {
+ public:
+  explicit RtcpReportThread(ReceiveStatistics* receive_statistics)
+      : receive_statistics_(receive_statistics),
+        done_(0),
+        thread_(&Run, this, "RtcpReportThread") {}
+
+  void Start() { thread_.Start(); }
+  void Stop() {
+    rtc::AtomicOps::ReleaseStore(&done_, 1);
+    thread_.Stop();
+  }
+
+ private:
+  static bool Run(void* obj) {
+    RtcpReportThread* self = static_cast<RtcpReportThread*>(obj);
+    if (rtc::AtomicOps::AcquireLoad(&self->done_))
+      return false;
+    // Mimics what the RTCP sender does for each report it builds.
+    StatisticianMap statisticians =
+        self->receive_statistics_->GetActiveStatisticians();
+    for (const auto& kv : statisticians) {
+      RtcpStatistics statistics;
+      kv.second->GetStatistics(&statistics, true);
+    }
+    self->receive_statistics_->Process();
+    return true;
+  }
+
+  ReceiveStatistics* const receive_statistics_;
+  volatile int done_;
+  rtc::PlatformThread thread_;
+};
+
+// Checks that packets from many streams are all accounted for while another
+// thread keeps generating RTCP reports.
+TEST_F(ReceiveStatisticsTest, ManySsrcsWithConcurrentReports) {
+  const uint32_t kNumSsrcs = 500;
+  const int kPacketsPerSsrc = 400;
+  RTPHeader header;
+  memset(&header, 0, sizeof(header));
+  for (uint32_t ssrc = 0; ssrc < kNumSsrcs; ++ssrc) {
+    header.ssrc = ssrc + 1;
+    receive_statistics_->IncomingPacket(header, kPacketSize1, false);
+  }
+
+  RtcpReportThread report_thread(receive_statistics_.get());
+  report_thread.Start();
+  for (int i = 1; i <= kPacketsPerSsrc; ++i) {
+    header.sequenceNumber = static_cast<uint16_t>(i);
+    for (uint32_t ssrc = 0; ssrc < kNumSsrcs; ++ssrc) {
+      header.ssrc = ssrc + 1;
+      receive_statistics_->IncomingPacket(header, kPacketSize1, false);
+    }
+  }
+  report_thread.Stop();
+
+  EXPECT_EQ(kNumSsrcs, receive_statistics_->GetActiveStatisticians().size());
+  for (uint32_t ssrc = 0; ssrc < kNumSsrcs; ++ssrc) {
+    StreamStatistician* statistician =
+        receive_statistics_->GetStatistician(ssrc + 1);
+    ASSERT_TRUE(statistician != NULL);
+    size_t bytes_received = 0;
+    uint32_t packets_received = 0;
+    statistician->GetDataCounters(&bytes_received, &packets_received);
+    EXPECT_EQ(kPacketsPerSsrc + 1u, packets_received);
+  }
+}
 }  // namespace webrtc
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/include/rtcp_coalescing_transport.h"
+
+#include <string.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "webrtc/modules/utility/include/process_thread.h"
+
+namespace webrtc {
+
+namespace {
+// Reports normally trigger a flush through ProcessThread::WakeUp(); this is
+// only a fallback.
+const int64_t kMaxFlushIntervalMs = 100;
+}  // namespace
+
+RtcpCoalescingTransport::RtcpCoalescingTransport(Transport* transport)
+    : RtcpCoalescingTransport(transport, IP_PACKET_SIZE) {}
+
+RtcpCoalescingTransport::RtcpCoalescingTransport(Transport* transport,
+                                                 size_t max_packet_size)
+    : transport_(transport),
+      max_packet_size_(max_packet_size),
+      buffer_(new uint8_t[max_packet_size]),
+      pending_bytes_(0),
+      process_thread_(nullptr) {
+  RTC_DCHECK(transport_ != nullptr);
+  RTC_DCHECK_GT(max_packet_size_, 0u);
+}
+
+RtcpCoalescingTransport::~RtcpCoalescingTransport() {
+  Flush();
+}
+
+bool RtcpCoalescingTransport::SendRtp(const uint8_t* packet,
+                                      size_t length,
+                                      const PacketOptions& options) {
+  return transport_->SendRtp(packet, length, options);
+}
+
+bool RtcpCoalescingTransport::SendRtcp(const uint8_t* packet, size_t length) {
+  ProcessThread* process_thread = nullptr;
+  {
+    rtc::CritScope cs(&crit_);
+    if (pending_bytes_ + length > max_packet_size_) {
+      // Send what is pending first so that packets keep their order.
+      FlushLocked();
+      if (length > max_packet_size_)
+        return transport_->SendRtcp(packet, length);
+    }
+    if (pending_bytes_ == 0)
+      process_thread = process_thread_;
+    memcpy(&buffer_[pending_bytes_], packet, length);
+    pending_bytes_ += length;
+  }
+  // Not done under |crit_| since the process thread holds its own lock while
+  // attaching and detaching modules.
+  if (process_thread)
+    process_thread->WakeUp(this);
+  return true;
+}
+
+bool RtcpCoalescingTransport::Flush() {
+  rtc::CritScope cs(&crit_);
+  return FlushLocked();
+}
+
+size_t RtcpCoalescingTransport::pending_bytes() const {
+  rtc::CritScope cs(&crit_);
+  return pending_bytes_;
+}
+
+int64_t RtcpCoalescingTransport::TimeUntilNextProcess() {
+  rtc::CritScope cs(&crit_);
+  return pending_bytes_ > 0 ? 0 : kMaxFlushIntervalMs;
+}
+
+int32_t RtcpCoalescingTransport::Process() {
+  Flush();
+  return 0;
+}
+
+void RtcpCoalescingTransport::ProcessThreadAttached(
+    ProcessThread* process_thread) {
+  rtc::CritScope cs(&crit_);
+  process_thread_ = process_thread;
+}
+
+bool RtcpCoalescingTransport::FlushLocked() {
+  if (pending_bytes_ == 0)
+    return true;
+  // Send while holding the lock so that concurrent flushes can't reorder
+  // packets.
+  bool sent = transport_->SendRtcp(buffer_.get(), pending_bytes_);
+  pending_bytes_ = 0;
+  return sent;
+}
+
+}  // namespace webrtc
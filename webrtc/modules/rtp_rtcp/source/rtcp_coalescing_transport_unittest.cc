@@ -0,0 +1,203 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/rtp_rtcp/include/receive_statistics.h"
+#include "webrtc/modules/rtp_rtcp/include/rtcp_coalescing_transport.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_sender.h"
+#include "webrtc/modules/utility/include/mock/mock_process_thread.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/rtcp_packet_parser.h"
+
+namespace webrtc {
+namespace {
+
+const uint32_t kSsrc = 0x11111111;
+
+class RecordingTransport : public Transport {
+ public:
+  RecordingTransport() : num_rtp_packets_(0), fail_(false) {}
+
+  bool SendRtp(const uint8_t* packet,
+               size_t length,
+               const PacketOptions& options) override {
+    ++num_rtp_packets_;
+    return true;
+  }
+  bool SendRtcp(const uint8_t* packet, size_t length) override {
+    rtcp_packets_.push_back(std::vector<uint8_t>(packet, packet + length));
+    return !fail_;
+  }
+
+  int num_rtp_packets_;
+  bool fail_;
+  std::vector<std::vector<uint8_t>> rtcp_packets_;
+};
+
+rtc::scoped_ptr<rtcp::RawPacket> BuildReceiverReport(uint32_t ssrc) {
+  rtcp::ReceiverReport rr;
+  rr.From(ssrc);
+  return rr.Build();
+}
+
+}  // namespace
+
+TEST(RtcpCoalescingTransportTest, PassesRtpThrough) {
+  RecordingTransport transport;
+  RtcpCoalescingTransport coalescer(&transport);
+  const uint8_t kPacket[12] = {0x80};
+  EXPECT_TRUE(coalescer.SendRtp(kPacket, sizeof(kPacket), PacketOptions()));
+  EXPECT_EQ(1, transport.num_rtp_packets_);
+  EXPECT_EQ(0u, coalescer.pending_bytes());
+}
+
+TEST(RtcpCoalescingTransportTest, BuffersRtcpUntilFlushed) {
+  RecordingTransport transport;
+  RtcpCoalescingTransport coalescer(&transport);
+  rtc::scoped_ptr<rtcp::RawPacket> first = BuildReceiverReport(kSsrc);
+  rtc::scoped_ptr<rtcp::RawPacket> second = BuildReceiverReport(kSsrc + 1);
+
+  EXPECT_TRUE(coalescer.SendRtcp(first->Buffer(), first->Length()));
+  EXPECT_TRUE(coalescer.SendRtcp(second->Buffer(), second->Length()));
+  EXPECT_TRUE(transport.rtcp_packets_.empty());
+  EXPECT_EQ(first->Length() + second->Length(), coalescer.pending_bytes());
+
+  EXPECT_TRUE(coalescer.Flush());
+  ASSERT_EQ(1u, transport.rtcp_packets_.size());
+  EXPECT_EQ(0u, coalescer.pending_bytes());
+
+  test::RtcpPacketParser parser;
+  parser.Parse(transport.rtcp_packets_[0].data(),
+               transport.rtcp_packets_[0].size());
+  EXPECT_EQ(2, parser.receiver_report()->num_packets());
+  EXPECT_EQ(kSsrc + 1, parser.receiver_report()->Ssrc());
+
+  // Nothing left to send.
+  EXPECT_TRUE(coalescer.Flush());
+  EXPECT_EQ(1u, transport.rtcp_packets_.size());
+}
+
+TEST(RtcpCoalescingTransportTest, FlushesWhenNextPacketDoesNotFit) {
+  RecordingTransport transport;
+  rtc::scoped_ptr<rtcp::RawPacket> rr = BuildReceiverReport(kSsrc);
+  RtcpCoalescingTransport coalescer(&transport, 2 * rr->Length());
+
+  EXPECT_TRUE(coalescer.SendRtcp(rr->Buffer(), rr->Length()));
+  EXPECT_TRUE(coalescer.SendRtcp(rr->Buffer(), rr->Length()));
+  EXPECT_TRUE(transport.rtcp_packets_.empty());
+
+  EXPECT_TRUE(coalescer.SendRtcp(rr->Buffer(), rr->Length()));
+  ASSERT_EQ(1u, transport.rtcp_packets_.size());
+  EXPECT_EQ(2 * rr->Length(), transport.rtcp_packets_[0].size());
+  EXPECT_EQ(rr->Length(), coalescer.pending_bytes());
+}
+
+TEST(RtcpCoalescingTransportTest, SendsOversizedPacketDirectly) {
+  RecordingTransport transport;
+  rtc::scoped_ptr<rtcp::RawPacket> rr = BuildReceiverReport(kSsrc);
+  RtcpCoalescingTransport coalescer(&transport, rr->Length() - 1);
+
+  EXPECT_TRUE(coalescer.SendRtcp(rr->Buffer(), rr->Length()));
+  ASSERT_EQ(1u, transport.rtcp_packets_.size());
+  EXPECT_EQ(0u, coalescer.pending_bytes());
+
+  transport.fail_ = true;
+  EXPECT_FALSE(coalescer.SendRtcp(rr->Buffer(), rr->Length()));
+}
+
+TEST(RtcpCoalescingTransportTest, ReportsFailedFlush) {
+  RecordingTransport transport;
+  RtcpCoalescingTransport coalescer(&transport);
+  rtc::scoped_ptr<rtcp::RawPacket> rr = BuildReceiverReport(kSsrc);
+  transport.fail_ = true;
+  EXPECT_TRUE(coalescer.SendRtcp(rr->Buffer(), rr->Length()));
+  EXPECT_FALSE(coalescer.Flush());
+  EXPECT_EQ(0u, coalescer.pending_bytes());
+}
+
+TEST(RtcpCoalescingTransportTest, FlushesOnDestruction) {
+  RecordingTransport transport;
+  {
+    RtcpCoalescingTransport coalescer(&transport);
+    rtc::scoped_ptr<rtcp::RawPacket> rr = BuildReceiverReport(kSsrc);
+    EXPECT_TRUE(coalescer.SendRtcp(rr->Buffer(), rr->Length()));
+  }
+  EXPECT_EQ(1u, transport.rtcp_packets_.size());
+}
+
+TEST(RtcpCoalescingTransportTest, WakesUpProcessThreadWhenReportIsBuffered) {
+  RecordingTransport transport;
+  RtcpCoalescingTransport coalescer(&transport);
+  testing::StrictMock<MockProcessThread> process_thread;
+  coalescer.ProcessThreadAttached(&process_thread);
+  rtc::scoped_ptr<rtcp::RawPacket> rr = BuildReceiverReport(kSsrc);
+
+  EXPECT_GT(coalescer.TimeUntilNextProcess(), 0);
+  // Only the first packet of a batch needs to wake the thread up.
+  EXPECT_CALL(process_thread, WakeUp(&coalescer)).Times(1);
+  EXPECT_TRUE(coalescer.SendRtcp(rr->Buffer(), rr->Length()));
+  EXPECT_TRUE(coalescer.SendRtcp(rr->Buffer(), rr->Length()));
+  EXPECT_EQ(0, coalescer.TimeUntilNextProcess());
+
+  EXPECT_EQ(0, coalescer.Process());
+  ASSERT_EQ(1u, transport.rtcp_packets_.size());
+  EXPECT_EQ(2 * rr->Length(), transport.rtcp_packets_[0].size());
+  EXPECT_GT(coalescer.TimeUntilNextProcess(), 0);
+
+  coalescer.ProcessThreadAttached(nullptr);
+  EXPECT_TRUE(coalescer.SendRtcp(rr->Buffer(), rr->Length()));
+}
+
+TEST(RtcpCoalescingTransportTest, MergesReportsOfSeveralSenders) {
+  const size_t kNumSenders = 4;
+  SimulatedClock clock(1335900000);
+  RecordingTransport transport;
+  RtcpCoalescingTransport coalescer(&transport);
+  rtc::scoped_ptr<ReceiveStatistics> receive_statistics(
+      ReceiveStatistics::Create(&clock));
+  std::vector<RTCPSender*> senders;
+  for (size_t i = 0; i < kNumSenders; ++i) {
+    RTCPSender* sender = new RTCPSender(false, &clock, receive_statistics.get(),
+                                        nullptr, &transport);
+    sender->SetReportTransport(&coalescer);
+    sender->SetSSRC(kSsrc + i);
+    sender->SetCNAME("sfu");
+    sender->SetRTCPStatus(RtcpMode::kCompound);
+    senders.push_back(sender);
+  }
+
+  RTCPSender::FeedbackState feedback_state;
+  for (RTCPSender* sender : senders)
+    EXPECT_EQ(0, sender->SendRTCP(feedback_state, kRtcpReport));
+  EXPECT_TRUE(coalescer.Flush());
+
+  ASSERT_EQ(1u, transport.rtcp_packets_.size());
+  test::RtcpPacketParser parser;
+  parser.Parse(transport.rtcp_packets_[0].data(),
+               transport.rtcp_packets_[0].size());
+  EXPECT_EQ(static_cast<int>(kNumSenders),
+            parser.receiver_report()->num_packets());
+  EXPECT_EQ(static_cast<int>(kNumSenders), parser.sdes_chunk()->num_packets());
+
+  // Feedback is not held back.
+  const uint16_t kNackList[] = {17};
+  EXPECT_EQ(0, senders[0]->SendRTCP(feedback_state, kRtcpNack, 1, kNackList));
+  EXPECT_EQ(2u, transport.rtcp_packets_.size());
+  EXPECT_EQ(0u, coalescer.pending_bytes());
+
+  for (RTCPSender* sender : senders)
+    delete sender;
+}
+
+}  // namespace webrtc
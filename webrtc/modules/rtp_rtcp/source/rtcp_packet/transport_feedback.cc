@@ -10,6 +10,8 @@
 
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 
+#include <algorithm>
+
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
@@ -41,6 +43,12 @@ class PacketStatusChunk {
   virtual uint16_t NumSymbols() const = 0;
   virtual void AppendSymbolsTo(
       std::vector<TransportFeedback::StatusSymbol>* vec) const = 0;
+  // Writes the sequence numbers of up to |max_packets| received packets in
+  // this chunk, whose first symbol is for |first_seq|, and returns how many
+  // were written. Receive deltas are left unset.
+  virtual size_t WriteReceivedTo(uint16_t first_seq,
+                                 TransportFeedback::ReceivedPacket* packets,
+                                 size_t max_packets) const = 0;
   virtual void WriteTo(uint8_t* buffer) const = 0;
 };
 
@@ -128,6 +136,17 @@ class OneBitVectorChunk : public PacketStatusChunk {
     vec->insert(vec->end(), &symbols_[0], &symbols_[kCapacity]);
   }
 
+  size_t WriteReceivedTo(uint16_t first_seq,
+                         TransportFeedback::ReceivedPacket* packets,
+                         size_t max_packets) const override {
+    size_t num_packets = 0;
+    for (int i = 0; i < kCapacity && num_packets < max_packets; ++i) {
+      if (symbols_[i] != TransportFeedback::StatusSymbol::kNotReceived)
+        packets[num_packets++].sequence_number = first_seq + i;
+    }
+    return num_packets;
+  }
+
   void WriteTo(uint8_t* buffer) const override {
     const int kSymbolsInFirstByte = 6;
     const int kSymbolsInSecondByte = 8;
@@ -201,6 +220,17 @@ class TwoBitVectorChunk : public PacketStatusChunk {
     vec->insert(vec->end(), &symbols_[0], &symbols_[kCapacity]);
   }
 
+  size_t WriteReceivedTo(uint16_t first_seq,
+                         TransportFeedback::ReceivedPacket* packets,
+                         size_t max_packets) const override {
+    size_t num_packets = 0;
+    for (int i = 0; i < kCapacity && num_packets < max_packets; ++i) {
+      if (symbols_[i] != TransportFeedback::StatusSymbol::kNotReceived)
+        packets[num_packets++].sequence_number = first_seq + i;
+    }
+    return num_packets;
+  }
+
   void WriteTo(uint8_t* buffer) const override {
     buffer[0] = 0xC0;
     buffer[0] |= EncodeSymbol(symbols_[0]) << 4;
@@ -260,6 +290,17 @@ class RunLengthChunk : public PacketStatusChunk {
     vec->insert(vec->end(), size_, symbol_);
   }
 
+  size_t WriteReceivedTo(uint16_t first_seq,
+                         TransportFeedback::ReceivedPacket* packets,
+                         size_t max_packets) const override {
+    if (symbol_ == TransportFeedback::StatusSymbol::kNotReceived)
+      return 0;
+    size_t num_packets = std::min(size_, max_packets);
+    for (size_t i = 0; i < num_packets; ++i)
+      packets[i].sequence_number = first_seq + i;
+    return num_packets;
+  }
+
   void WriteTo(uint8_t* buffer) const override {
     buffer[0] = EncodeSymbol(symbol_) << 5;  // Write S (T = 0 implicitly)
     buffer[0] |= (size_ >> 8) & 0x1F;  // 5 most significant bits of run length.
@@ -565,6 +606,30 @@ std::vector<int64_t> TransportFeedback::GetReceiveDeltasUs() const {
   return us_deltas;
 }
 
+void TransportFeedback::GetReceivedPackets(
+    std::vector<ReceivedPacket>* packets) const {
+  // Every received packet has a receive delta, so their number is known up
+  // front. This also drops any received symbols in the padding of a trailing
+  // vector chunk, which come after all real ones.
+  packets->resize(receive_deltas_.size());
+  if (packets->empty())
+    return;
+  ReceivedPacket* const out = &(*packets)[0];
+  size_t num_packets = 0;
+  uint16_t seq = static_cast<uint16_t>(base_seq_);
+  for (PacketStatusChunk* chunk : status_chunks_) {
+    num_packets += chunk->WriteReceivedTo(seq, &out[num_packets],
+                                          packets->size() - num_packets);
+    seq += chunk->NumSymbols();
+  }
+  RTC_DCHECK_EQ(packets->size(), num_packets);
+  packets->resize(num_packets);
+  for (size_t i = 0; i < num_packets; ++i) {
+    out[i].delta_us =
+        static_cast<int64_t>(receive_deltas_[i]) * kDeltaScaleFactor;
+  }
+}
+
 // Serialize packet.
 bool TransportFeedback::Create(uint8_t* packet,
                                size_t* position,
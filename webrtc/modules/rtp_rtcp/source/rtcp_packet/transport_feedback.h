@@ -52,6 +52,17 @@ class TransportFeedback : public RtcpPacket {
   // is relative the base time.
   std::vector<int64_t> GetReceiveDeltasUs() const;
 
+  // A packet reported as received, with its receive delta in microseconds
+  // relative the previously received packet (or the base time, for the first).
+  struct ReceivedPacket {
+    uint16_t sequence_number;
+    int64_t delta_us;
+  };
+  // Replaces the contents of |packets| with all packets reported as received,
+  // in sequence number order. Unlike GetStatusVector() this does not expand
+  // runs of lost packets, and the storage of |packets| is reused.
+  void GetReceivedPackets(std::vector<ReceivedPacket>* packets) const;
+
   uint32_t GetPacketSenderSsrc() const;
   uint32_t GetMediaSourceSsrc() const;
   static const int kDeltaScaleFactor = 250;  // Convert to multiples of 0.25ms.
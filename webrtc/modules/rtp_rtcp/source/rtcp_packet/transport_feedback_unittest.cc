@@ -115,6 +115,14 @@ class FeedbackTester {
     ASSERT_EQ(expected_deltas_.size(), deltas.size());
     for (size_t i = 0; i < expected_deltas_.size(); ++i)
       EXPECT_EQ(expected_deltas_[i], deltas[i]) << "Delta mismatch @ " << i;
+
+    std::vector<TransportFeedback::ReceivedPacket> received;
+    feedback_->GetReceivedPackets(&received);
+    ASSERT_EQ(expected_seq_.size(), received.size());
+    for (size_t i = 0; i < expected_seq_.size(); ++i) {
+      EXPECT_EQ(expected_seq_[i], received[i].sequence_number);
+      EXPECT_EQ(deltas[i], received[i].delta_us);
+    }
   }
 
   void GenerateDeltas(const uint16_t seq[],
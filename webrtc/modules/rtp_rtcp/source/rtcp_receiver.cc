@@ -391,6 +391,56 @@ RTCPReceiver::IncomingRTCPPacket(RTCPPacketInformation& rtcpPacketInformation,
     return 0;
 }
 
+bool RTCPReceiver::IncomingTransportFeedback(
+    const uint8_t* packet,
+    size_t length,
+    RTCPPacketInformation* rtcpPacketInformation) {
+  // Only look at the common headers first; anything but a well formed
+  // sequence of transport feedback blocks takes the regular path. That
+  // includes compound packets where feedback is bundled with a report or
+  // any other block, so only packets made entirely of transport feedback
+  // skip RTCPParserV2.
+  RTCPUtility::RTCPPacketIterator it(packet, length);
+  const uint8_t* last_block = nullptr;
+  size_t last_block_size = 0;
+  size_t consumed = 0;
+  for (const RTCPUtility::RtcpCommonHeader* header = it.Begin();
+       header != nullptr; header = it.Iterate()) {
+    if (header->packet_type != rtcp::TransportFeedback::kPayloadType ||
+        header->count_or_format !=
+            rtcp::TransportFeedback::kFeedbackMessageType) {
+      return false;
+    }
+    last_block = it.CurrentBlock();
+    last_block_size = header->BlockSize();
+    consumed += last_block_size;
+  }
+  if (last_block == nullptr || consumed != length)
+    return false;
+
+  // As with the full parser, only the last feedback message is reported.
+  rtc::scoped_ptr<rtcp::TransportFeedback> feedback =
+      rtcp::TransportFeedback::ParseFrom(last_block, last_block_size);
+  if (!feedback)
+    return false;
+
+  {
+    CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
+    _lastReceived = _clock->TimeInMilliseconds();
+    if (packet_type_counter_.first_packet_time_ms == -1)
+      packet_type_counter_.first_packet_time_ms = _lastReceived;
+    // Report the counters for every packet, as IncomingRTCPPacket() does.
+    if (packet_type_counter_observer_ != NULL) {
+      packet_type_counter_observer_->RtcpPacketTypesCounterUpdated(
+          main_ssrc_, packet_type_counter_);
+    }
+  }
+
+  rtcpPacketInformation->rtcpPacketTypeFlags |= kRtcpTransportFeedback;
+  rtcpPacketInformation->transport_feedback_.reset(feedback.release());
+  return true;
+}
+
 void
 RTCPReceiver::HandleSenderReceiverReport(RTCPUtility::RTCPParserV2& rtcpParser,
                                          RTCPPacketInformation& rtcpPacketInformation)
@@ -1330,12 +1380,18 @@ void RTCPReceiver::TriggerCallbacksFromRTCPPacket(
     UpdateTMMBR();
   }
   uint32_t local_ssrc;
-  std::set<uint32_t> registered_ssrcs;
+  bool transport_feedback_for_us = false;
   {
     // We don't want to hold this critsect when triggering the callbacks below.
     CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
     local_ssrc = main_ssrc_;
-    registered_ssrcs = registered_ssrcs_;
+    if (rtcpPacketInformation.rtcpPacketTypeFlags & kRtcpTransportFeedback) {
+      uint32_t media_source_ssrc =
+          rtcpPacketInformation.transport_feedback_->GetMediaSourceSsrc();
+      transport_feedback_for_us =
+          media_source_ssrc == local_ssrc ||
+          registered_ssrcs_.find(media_source_ssrc) != registered_ssrcs_.end();
+    }
   }
   if (!receiver_only_ &&
       (rtcpPacketInformation.rtcpPacketTypeFlags & kRtcpSrReq)) {
@@ -1393,15 +1449,9 @@ void RTCPReceiver::TriggerCallbacksFromRTCPPacket(
             now);
       }
     }
-    if (_cbTransportFeedbackObserver &&
-        (rtcpPacketInformation.rtcpPacketTypeFlags & kRtcpTransportFeedback)) {
-      uint32_t media_source_ssrc =
-          rtcpPacketInformation.transport_feedback_->GetMediaSourceSsrc();
-      if (media_source_ssrc == local_ssrc ||
-          registered_ssrcs.find(media_source_ssrc) != registered_ssrcs.end()) {
-        _cbTransportFeedbackObserver->OnTransportFeedback(
-            *rtcpPacketInformation.transport_feedback_.get());
-      }
+    if (_cbTransportFeedbackObserver && transport_feedback_for_us) {
+      _cbTransportFeedbackObserver->OnTransportFeedback(
+          *rtcpPacketInformation.transport_feedback_.get());
     }
   }
 
@@ -56,6 +56,18 @@ public:
         RTCPHelp::RTCPPacketInformation& rtcpPacketInformation,
         RTCPUtility::RTCPParserV2 *rtcpParser);
 
+    // Handles |packet| without running the RTCPParserV2 state machine if it
+    // consists solely of transport-wide feedback blocks, which is what the
+    // remote end sends at high rate. Only those blocks are decoded and the
+    // receiver lock is held just long enough to update the receive time and
+    // the packet type counters.
+    // Returns false if the packet holds any other block type, in which case
+    // it has to go through IncomingRTCPPacket() instead.
+    bool IncomingTransportFeedback(
+        const uint8_t* packet,
+        size_t length,
+        RTCPHelp::RTCPPacketInformation* rtcpPacketInformation);
+
     void TriggerCallbacksFromRTCPPacket(
         RTCPHelp::RTCPPacketInformation& rtcpPacketInformation);
 
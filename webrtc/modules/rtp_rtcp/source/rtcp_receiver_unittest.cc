@@ -15,6 +15,8 @@
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/common_types.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/mock/mock_remote_bitrate_observer.h"
 #include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_single_stream.h"
@@ -1096,6 +1098,184 @@ TEST_F(RtcpReceiverTest, HandlesInvalidTransportFeedback) {
   EXPECT_EQ(kBitrateBps, rtcp_packet_info_.receiverEstimatedMaxBitrate);
 }
 
+TEST_F(RtcpReceiverTest, TransportFeedbackOnlyPacketTakesFastPath) {
+  const uint32_t kSenderSsrc = 0x10203;
+  const uint32_t kSourceSsrc = 0x123456;
+
+  std::set<uint32_t> ssrcs;
+  ssrcs.insert(kSourceSsrc);
+  rtcp_receiver_->SetSsrcs(kSourceSsrc, ssrcs);
+
+  rtcp::TransportFeedback packet;
+  packet.WithMediaSourceSsrc(kSourceSsrc);
+  packet.WithPacketSenderSsrc(kSenderSsrc);
+  packet.WithBase(1, 1000);
+  packet.WithReceivedPacket(1, 1000);
+  rtc::scoped_ptr<rtcp::RawPacket> built_packet = packet.Build();
+  ASSERT_TRUE(built_packet.get() != nullptr);
+
+  RTCPHelp::RTCPPacketInformation info;
+  EXPECT_TRUE(rtcp_receiver_->IncomingTransportFeedback(
+      built_packet->Buffer(), built_packet->Length(), &info));
+  EXPECT_EQ(static_cast<uint32_t>(kRtcpTransportFeedback),
+            info.rtcpPacketTypeFlags);
+  ASSERT_TRUE(info.transport_feedback_.get() != nullptr);
+  EXPECT_EQ(kSourceSsrc, info.transport_feedback_->GetMediaSourceSsrc());
+  EXPECT_EQ(1u, info.transport_feedback_->GetBaseSequence());
+  EXPECT_EQ(system_clock_.TimeInMilliseconds(),
+            rtcp_receiver_->LastReceived());
+
+  // Truncated packets are left to the full parser.
+  RTCPHelp::RTCPPacketInformation truncated_info;
+  EXPECT_FALSE(rtcp_receiver_->IncomingTransportFeedback(
+      built_packet->Buffer(), built_packet->Length() - 4, &truncated_info));
+  EXPECT_EQ(0u, truncated_info.rtcpPacketTypeFlags);
+}
+
+TEST_F(RtcpReceiverTest, CompoundPacketWithTransportFeedbackTakesFullPath) {
+  const uint32_t kSenderSsrc = 0x10203;
+  const uint32_t kSourceSsrc = 0x123456;
+
+  rtcp::TransportFeedback packet;
+  packet.WithMediaSourceSsrc(kSourceSsrc);
+  packet.WithPacketSenderSsrc(kSenderSsrc);
+  packet.WithBase(1, 1000);
+  packet.WithReceivedPacket(1, 1000);
+  rtcp::Remb remb;
+  remb.From(kSenderSsrc);
+  remb.WithBitrateBps(50000);
+  packet.Append(&remb);
+  rtc::scoped_ptr<rtcp::RawPacket> built_packet = packet.Build();
+  ASSERT_TRUE(built_packet.get() != nullptr);
+
+  RTCPHelp::RTCPPacketInformation info;
+  EXPECT_FALSE(rtcp_receiver_->IncomingTransportFeedback(
+      built_packet->Buffer(), built_packet->Length(), &info));
+  EXPECT_EQ(0u, info.rtcpPacketTypeFlags);
+  EXPECT_TRUE(info.transport_feedback_.get() == nullptr);
+}
+
+class PacketTypeCounterObserver : public RtcpPacketTypeCounterObserver {
+ public:
+  PacketTypeCounterObserver() : ssrc_(0), num_updates_(0) {}
+  void RtcpPacketTypesCounterUpdated(
+      uint32_t ssrc,
+      const RtcpPacketTypeCounter& packet_counter) override {
+    ssrc_ = ssrc;
+    counter_ = packet_counter;
+    ++num_updates_;
+  }
+
+  uint32_t ssrc_;
+  RtcpPacketTypeCounter counter_;
+  int num_updates_;
+};
+
+TEST_F(RtcpReceiverTest, TransportFeedbackFastPathUpdatesPacketTypeCounters) {
+  const uint32_t kSenderSsrc = 0x10203;
+  const uint32_t kSourceSsrc = 0x123456;
+
+  PacketTypeCounterObserver observer;
+  RTCPReceiver receiver(&system_clock_, false, &observer, nullptr, nullptr,
+                        nullptr, rtp_rtcp_impl_);
+  std::set<uint32_t> ssrcs;
+  ssrcs.insert(kSourceSsrc);
+  receiver.SetSsrcs(kSourceSsrc, ssrcs);
+
+  rtcp::TransportFeedback packet;
+  packet.WithMediaSourceSsrc(kSourceSsrc);
+  packet.WithPacketSenderSsrc(kSenderSsrc);
+  packet.WithBase(1, 1000);
+  packet.WithReceivedPacket(1, 1000);
+  rtc::scoped_ptr<rtcp::RawPacket> built_packet = packet.Build();
+  ASSERT_TRUE(built_packet.get() != nullptr);
+
+  RTCPHelp::RTCPPacketInformation info;
+  EXPECT_TRUE(receiver.IncomingTransportFeedback(
+      built_packet->Buffer(), built_packet->Length(), &info));
+  EXPECT_EQ(1, observer.num_updates_);
+  EXPECT_EQ(kSourceSsrc, observer.ssrc_);
+  EXPECT_EQ(system_clock_.TimeInMilliseconds(),
+            observer.counter_.first_packet_time_ms);
+
+  system_clock_.AdvanceTimeMilliseconds(10);
+  RTCPHelp::RTCPPacketInformation next_info;
+  EXPECT_TRUE(receiver.IncomingTransportFeedback(
+      built_packet->Buffer(), built_packet->Length(), &next_info));
+  EXPECT_EQ(2, observer.num_updates_);
+  EXPECT_EQ(system_clock_.TimeInMilliseconds() - 10,
+            observer.counter_.first_packet_time_ms);
+}
+
+// Logs the per-packet cost of a typical compound packet through
+// RTCPParserV2 next to a transport feedback packet on the fast path. It only
+// measures time, so it is disabled by default.
+TEST_F(RtcpReceiverTest, DISABLED_ParseCostOfCompoundAndFeedbackPackets) {
+  const uint32_t kSenderSsrc = 0x10203;
+  const uint32_t kSourceSsrc = 0x123456;
+  const int kNumPackets = 10000;
+
+  std::set<uint32_t> ssrcs;
+  ssrcs.insert(kSourceSsrc);
+  rtcp_receiver_->SetSsrcs(kSourceSsrc, ssrcs);
+
+  rtcp::ReportBlock rb;
+  rb.To(kSourceSsrc);
+  rtcp::SenderReport sr;
+  sr.From(kSenderSsrc);
+  sr.WithReportBlock(rb);
+  rtcp::ReceiverReport rr;
+  rr.From(kSenderSsrc);
+  rr.WithReportBlock(rb);
+  rtcp::Remb remb;
+  remb.From(kSenderSsrc);
+  remb.AppliesTo(kSourceSsrc);
+  remb.WithBitrateBps(500000);
+  rtcp::Nack nack;
+  nack.From(kSenderSsrc);
+  nack.To(kSourceSsrc);
+  const uint16_t kNackList[] = {1, 2, 3, 5, 18, 30, 31};
+  nack.WithList(kNackList, sizeof(kNackList) / sizeof(kNackList[0]));
+  rtcp::TransportFeedback feedback;
+  feedback.WithMediaSourceSsrc(kSourceSsrc);
+  feedback.WithPacketSenderSsrc(kSenderSsrc);
+  feedback.WithBase(0, 1000);
+  for (uint16_t i = 0; i < 100; ++i)
+    feedback.WithReceivedPacket(i, 1000 + i * 1000);
+  rtc::scoped_ptr<rtcp::RawPacket> feedback_packet = feedback.Build();
+  ASSERT_TRUE(feedback_packet.get() != nullptr);
+
+  sr.Append(&rr);
+  sr.Append(&remb);
+  sr.Append(&nack);
+  sr.Append(&feedback);
+  rtc::scoped_ptr<rtcp::RawPacket> compound_packet = sr.Build();
+  ASSERT_TRUE(compound_packet.get() != nullptr);
+
+  uint64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumPackets; ++i) {
+    RTCPUtility::RTCPParserV2 parser(compound_packet->Buffer(),
+                                     compound_packet->Length(), true);
+    RTCPHelp::RTCPPacketInformation info;
+    EXPECT_EQ(0, rtcp_receiver_->IncomingRTCPPacket(info, &parser));
+  }
+  uint64_t compound_us = rtc::TimeMicros() - start_us;
+
+  start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumPackets; ++i) {
+    RTCPHelp::RTCPPacketInformation info;
+    EXPECT_TRUE(rtcp_receiver_->IncomingTransportFeedback(
+        feedback_packet->Buffer(), feedback_packet->Length(), &info));
+  }
+  uint64_t feedback_us = rtc::TimeMicros() - start_us;
+
+  LOG(LS_INFO) << "Parsed " << kNumPackets << " compound packets ("
+               << compound_packet->Length() << " bytes) in " << compound_us
+               << " us and " << kNumPackets << " feedback packets ("
+               << feedback_packet->Length() << " bytes) in " << feedback_us
+               << " us.";
+}
+
 }  // Anonymous namespace
 
 }  // namespace webrtc
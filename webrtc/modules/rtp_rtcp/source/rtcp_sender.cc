@@ -90,6 +90,8 @@ class PacketContainer : public rtcp::Empty,
       bytes_sent_ += length;
   }
 
+  void set_transport(Transport* transport) { transport_ = transport; }
+
   size_t SendPackets() {
     rtcp::Empty::Build(this);
     return bytes_sent_;
@@ -100,6 +102,48 @@ class PacketContainer : public rtcp::Empty,
   size_t bytes_sent_;
 };
 
+// An RTCP packet that has already been serialized, used to reuse blocks whose
+// contents have not changed since the previous compound packet. Holds a
+// reference rather than a copy since the packet is sent after the sender's
+// lock, which guards the cached block, has been released.
+class SerializedBlock : public rtcp::RtcpPacket {
+ public:
+  explicit SerializedBlock(
+      const rtc::scoped_refptr<rtc::RefCountedObject<rtc::Buffer>>& block)
+      : block_(block) {}
+  virtual ~SerializedBlock() {}
+
+  size_t BlockLength() const override { return block_->size(); }
+
+ protected:
+  bool Create(uint8_t* packet,
+              size_t* index,
+              size_t max_length,
+              RtcpPacket::PacketReadyCallback* callback) const override {
+    while (*index + BlockLength() > max_length) {
+      if (!OnBufferFull(packet, index, callback))
+        return false;
+    }
+    memcpy(&packet[*index], block_->data(), block_->size());
+    *index += block_->size();
+    return true;
+  }
+
+ private:
+  const rtc::scoped_refptr<rtc::RefCountedObject<rtc::Buffer>> block_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SerializedBlock);
+};
+
+namespace {
+rtc::RefCountedObject<rtc::Buffer>* SerializeBlock(
+    const rtcp::RtcpPacket& packet) {
+  rtc::scoped_ptr<rtcp::RawPacket> raw_packet = packet.Build();
+  return new rtc::RefCountedObject<rtc::Buffer>(raw_packet->Buffer(),
+                                                raw_packet->Length());
+}
+}  // namespace
+
 class RTCPSender::RtcpContext {
  public:
   RtcpContext(const FeedbackState& feedback_state,
@@ -143,6 +187,7 @@ RTCPSender::RTCPSender(
       random_(clock_->TimeInMicroseconds()),
       method_(RtcpMode::kOff),
       transport_(outgoing_transport),
+      report_transport_(nullptr),
 
       critical_section_rtcp_sender_(
           CriticalSectionWrapper::CreateCriticalSection()),
@@ -202,6 +247,11 @@ RtcpMode RTCPSender::Status() const {
   return method_;
 }
 
+void RTCPSender::SetReportTransport(Transport* transport) {
+  CriticalSectionScoped lock(critical_section_rtcp_sender_.get());
+  report_transport_ = transport;
+}
+
 void RTCPSender::SetRTCPStatus(RtcpMode method) {
   CriticalSectionScoped lock(critical_section_rtcp_sender_.get());
   method_ = method;
@@ -252,6 +302,7 @@ void RTCPSender::SetREMBData(uint32_t bitrate,
   CriticalSectionScoped lock(critical_section_rtcp_sender_.get());
   remb_bitrate_ = bitrate;
   remb_ssrcs_ = ssrcs;
+  remb_block_ = nullptr;
 
   if (remb_enabled_)
     SetFlag(kRtcpRemb, false);
@@ -301,6 +352,8 @@ void RTCPSender::SetSSRC(uint32_t ssrc) {
     next_time_to_send_rtcp_ = clock_->TimeInMilliseconds() + 100;
   }
   ssrc_ = ssrc;
+  sdes_block_ = nullptr;
+  remb_block_ = nullptr;
 }
 
 void RTCPSender::SetRemoteSSRC(uint32_t ssrc) {
@@ -315,6 +368,7 @@ int32_t RTCPSender::SetCNAME(const char* c_name) {
   RTC_DCHECK_LT(strlen(c_name), static_cast<size_t>(RTCP_CNAME_SIZE));
   CriticalSectionScoped lock(critical_section_rtcp_sender_.get());
   cname_ = c_name;
+  sdes_block_ = nullptr;
   return 0;
 }
 
@@ -326,6 +380,7 @@ int32_t RTCPSender::AddMixedCNAME(uint32_t SSRC, const char* c_name) {
     return -1;
 
   csrc_cnames_[SSRC] = c_name;
+  sdes_block_ = nullptr;
   return 0;
 }
 
@@ -337,6 +392,7 @@ int32_t RTCPSender::RemoveMixedCNAME(uint32_t SSRC) {
     return -1;
 
   csrc_cnames_.erase(it);
+  sdes_block_ = nullptr;
   return 0;
 }
 
@@ -499,7 +555,7 @@ rtc::scoped_ptr<rtcp::RtcpPacket> RTCPSender::BuildSR(const RtcpContext& ctx) {
   report->WithPacketCount(ctx.feedback_state_.packets_sent);
   report->WithOctetCount(ctx.feedback_state_.media_bytes_sent);
 
-  for (auto it : report_blocks_)
+  for (const auto& it : report_blocks_)
     report->WithReportBlock(it.second);
 
   report_blocks_.clear();
@@ -509,22 +565,26 @@ rtc::scoped_ptr<rtcp::RtcpPacket> RTCPSender::BuildSR(const RtcpContext& ctx) {
 
 rtc::scoped_ptr<rtcp::RtcpPacket> RTCPSender::BuildSDES(
     const RtcpContext& ctx) {
-  size_t length_cname = cname_.length();
-  RTC_CHECK_LT(length_cname, static_cast<size_t>(RTCP_CNAME_SIZE));
+  if (!sdes_block_) {
+    size_t length_cname = cname_.length();
+    RTC_CHECK_LT(length_cname, static_cast<size_t>(RTCP_CNAME_SIZE));
 
-  rtcp::Sdes* sdes = new rtcp::Sdes();
-  sdes->WithCName(ssrc_, cname_);
+    rtcp::Sdes sdes;
+    sdes.WithCName(ssrc_, cname_);
 
-  for (const auto it : csrc_cnames_)
-    sdes->WithCName(it.first, it.second);
+    for (const auto& it : csrc_cnames_)
+      sdes.WithCName(it.first, it.second);
 
-  return rtc::scoped_ptr<rtcp::Sdes>(sdes);
+    sdes_block_ = SerializeBlock(sdes);
+  }
+
+  return rtc::scoped_ptr<SerializedBlock>(new SerializedBlock(sdes_block_));
 }
 
 rtc::scoped_ptr<rtcp::RtcpPacket> RTCPSender::BuildRR(const RtcpContext& ctx) {
   rtcp::ReceiverReport* report = new rtcp::ReceiverReport();
   report->From(ssrc_);
-  for (auto it : report_blocks_)
+  for (const auto& it : report_blocks_)
     report->WithReportBlock(it.second);
 
   report_blocks_.clear();
@@ -610,16 +670,20 @@ rtc::scoped_ptr<rtcp::RtcpPacket> RTCPSender::BuildRPSI(
 
 rtc::scoped_ptr<rtcp::RtcpPacket> RTCPSender::BuildREMB(
     const RtcpContext& ctx) {
-  rtcp::Remb* remb = new rtcp::Remb();
-  remb->From(ssrc_);
-  for (uint32_t ssrc : remb_ssrcs_)
-    remb->AppliesTo(ssrc);
-  remb->WithBitrateBps(remb_bitrate_);
+  if (!remb_block_) {
+    rtcp::Remb remb;
+    remb.From(ssrc_);
+    for (uint32_t ssrc : remb_ssrcs_)
+      remb.AppliesTo(ssrc);
+    remb.WithBitrateBps(remb_bitrate_);
+
+    remb_block_ = SerializeBlock(remb);
+  }
 
   TRACE_EVENT_INSTANT0(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"),
                        "RTCPSender::REMB");
 
-  return rtc::scoped_ptr<rtcp::Remb>(remb);
+  return rtc::scoped_ptr<SerializedBlock>(new SerializedBlock(remb_block_));
 }
 
 void RTCPSender::SetTargetBitrate(unsigned int target_bitrate) {
@@ -824,6 +888,10 @@ int32_t RTCPSender::SendCompoundRTCP(
       LOG(LS_WARNING) << "Can't send rtcp if it is disabled.";
       return -1;
     }
+    if (report_transport_ != nullptr && packet_types.size() == 1 &&
+        *packet_types.begin() == kRtcpReport) {
+      container.set_transport(report_transport_);
+    }
 
     // We need to send our NTP even if we haven't received any reports.
     uint32_t ntp_sec;
@@ -916,10 +984,15 @@ void RTCPSender::PrepareReport(const std::set<RTCPPacketType>& packetTypes,
     StatisticianMap statisticians =
         receive_statistics_->GetActiveStatisticians();
     if (!statisticians.empty()) {
+      // Read the clock once for all report blocks rather than once per
+      // stream; the blocks go out in the same packet anyway.
+      uint32_t ntp_secs;
+      uint32_t ntp_frac;
+      clock_->CurrentNtp(ntp_secs, ntp_frac);
       for (auto it = statisticians.begin(); it != statisticians.end(); ++it) {
         RTCPReportBlock report_block;
-        if (PrepareReportBlock(feedback_state, it->first, it->second,
-                               &report_block)) {
+        if (PrepareReportBlock(feedback_state, it->first, it->second, ntp_secs,
+                               ntp_frac, &report_block)) {
           // TODO(danilchap) AddReportBlock may fail (for 2 different reasons).
           // Probably it shouldn't be ignored.
           AddReportBlock(report_block);
@@ -932,6 +1005,8 @@ void RTCPSender::PrepareReport(const std::set<RTCPPacketType>& packetTypes,
 bool RTCPSender::PrepareReportBlock(const FeedbackState& feedback_state,
                                     uint32_t ssrc,
                                     StreamStatistician* statistician,
+                                    uint32_t ntp_secs,
+                                    uint32_t ntp_frac,
                                     RTCPReportBlock* report_block) {
   // Do we have receive statistics to send?
   RtcpStatistics stats;
@@ -943,12 +1018,6 @@ bool RTCPSender::PrepareReportBlock(const FeedbackState& feedback_state,
   report_block->jitter = stats.jitter;
   report_block->remoteSSRC = ssrc;
 
-  // TODO(sprang): Do we really need separate time stamps for each report?
-  // Get our NTP as late as possible to avoid a race.
-  uint32_t ntp_secs;
-  uint32_t ntp_frac;
-  clock_->CurrentNtp(ntp_secs, ntp_frac);
-
   // Delay since last received report.
   uint32_t delaySinceLastReceivedSR = 0;
   if ((feedback_state.last_rr_ntp_secs != 0) ||
@@ -17,8 +17,11 @@
 #include <string>
 #include <vector>
 
+#include "webrtc/base/buffer.h"
 #include "webrtc/base/random.h"
+#include "webrtc/base/refcount.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/bwe_defines.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
@@ -83,6 +86,12 @@ class RTCPSender {
   RtcpMode Status() const;
   void SetRTCPStatus(RtcpMode method);
 
+  // Sends the periodic reports, i.e. packets requested as just kRtcpReport,
+  // through |transport| instead of the outgoing transport, e.g. to have them
+  // merged with the reports of other modules. Feedback such as NACK or PLI
+  // still goes out directly. Null restores the default.
+  void SetReportTransport(Transport* transport);
+
   bool Sending() const;
   int32_t SetSendingStatus(const FeedbackState& feedback_state,
                            bool enabled);  // combine the functions
@@ -152,6 +161,8 @@ class RTCPSender {
 
  private:
   class RtcpContext;
+  // A block that has already been serialized.
+  typedef rtc::RefCountedObject<rtc::Buffer> SharedBlock;
 
   // Determine which RTCP messages should be sent and setup flags.
   void PrepareReport(const std::set<RTCPPacketType>& packetTypes,
@@ -164,6 +175,8 @@ class RTCPSender {
   bool PrepareReportBlock(const FeedbackState& feedback_state,
                           uint32_t ssrc,
                           StreamStatistician* statistician,
+                          uint32_t ntp_secs,
+                          uint32_t ntp_frac,
                           RTCPReportBlock* report_block);
 
   rtc::scoped_ptr<rtcp::RtcpPacket> BuildSR(const RtcpContext& context)
@@ -207,6 +220,7 @@ class RTCPSender {
   RtcpMode method_ GUARDED_BY(critical_section_rtcp_sender_);
 
   Transport* const transport_;
+  Transport* report_transport_ GUARDED_BY(critical_section_rtcp_sender_);
 
   rtc::scoped_ptr<CriticalSectionWrapper> critical_section_rtcp_sender_;
   bool using_nack_ GUARDED_BY(critical_section_rtcp_sender_);
@@ -229,6 +243,11 @@ class RTCPSender {
       GUARDED_BY(critical_section_rtcp_sender_);
   std::map<uint32_t, std::string> csrc_cnames_
       GUARDED_BY(critical_section_rtcp_sender_);
+  // Serialized SDES, reused until |ssrc_|, |cname_| or |csrc_cnames_| change.
+  // Null if it has to be rebuilt. Shared with the packets being sent, so it is
+  // replaced rather than modified.
+  rtc::scoped_refptr<SharedBlock> sdes_block_
+      GUARDED_BY(critical_section_rtcp_sender_);
 
   // Sent
   uint32_t last_send_report_[RTCP_NUMBER_OF_SR] GUARDED_BY(
@@ -250,6 +269,10 @@ class RTCPSender {
   // REMB
   uint32_t remb_bitrate_ GUARDED_BY(critical_section_rtcp_sender_);
   std::vector<uint32_t> remb_ssrcs_ GUARDED_BY(critical_section_rtcp_sender_);
+  // Serialized REMB, reused until |ssrc_| or the REMB data change. Null if it
+  // has to be rebuilt.
+  rtc::scoped_refptr<SharedBlock> remb_block_
+      GUARDED_BY(critical_section_rtcp_sender_);
 
   TMMBRHelp tmmbr_help_ GUARDED_BY(critical_section_rtcp_sender_);
   uint32_t tmmbr_send_ GUARDED_BY(critical_section_rtcp_sender_);
@@ -16,6 +16,8 @@
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/common_types.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_sender.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_impl.h"
@@ -352,6 +354,32 @@ TEST_F(RtcpSenderTest, SdesIncludedInCompoundPacket) {
   EXPECT_EQ(1, parser()->sdes_chunk()->num_packets());
 }
 
+TEST_F(RtcpSenderTest, SdesFollowsCnameAndSsrcChanges) {
+  rtcp_sender_->SetRTCPStatus(RtcpMode::kReducedSize);
+  EXPECT_EQ(0, rtcp_sender_->SetCNAME("alice@host"));
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpSdes));
+  EXPECT_EQ("alice@host", parser()->sdes_chunk()->Cname());
+
+  EXPECT_EQ(0, rtcp_sender_->SetCNAME("bob@host"));
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpSdes));
+  EXPECT_EQ(2, parser()->sdes()->num_packets());
+  EXPECT_EQ("bob@host", parser()->sdes_chunk()->Cname());
+
+  rtcp_sender_->SetSSRC(kSenderSsrc + 1);
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpSdes));
+  EXPECT_EQ(kSenderSsrc + 1, parser()->sdes_chunk()->Ssrc());
+
+  EXPECT_EQ(0, rtcp_sender_->AddMixedCNAME(kRemoteSsrc, "carol@host"));
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpSdes));
+  EXPECT_EQ(4, parser()->sdes()->num_packets());
+  EXPECT_EQ(5, parser()->sdes_chunk()->num_packets());
+
+  EXPECT_EQ(0, rtcp_sender_->RemoveMixedCNAME(kRemoteSsrc));
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpSdes));
+  EXPECT_EQ(6, parser()->sdes_chunk()->num_packets());
+  EXPECT_EQ("bob@host", parser()->sdes_chunk()->Cname());
+}
+
 TEST_F(RtcpSenderTest, SendBye) {
   rtcp_sender_->SetRTCPStatus(RtcpMode::kReducedSize);
   EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpBye));
@@ -522,6 +550,27 @@ TEST_F(RtcpSenderTest, RembIncludedInCompoundPacketIfEnabled) {
   EXPECT_EQ(2, parser()->remb_item()->num_packets());
 }
 
+TEST_F(RtcpSenderTest, RembFollowsRembDataChanges) {
+  std::vector<uint32_t> ssrcs;
+  ssrcs.push_back(kRemoteSsrc);
+  rtcp_sender_->SetRTCPStatus(RtcpMode::kReducedSize);
+  rtcp_sender_->SetREMBData(100000, ssrcs);
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpRemb));
+  EXPECT_EQ(100000, parser()->remb_item()->last_bitrate_bps());
+
+  ssrcs.push_back(kRemoteSsrc + 1);
+  rtcp_sender_->SetREMBData(200000, ssrcs);
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpRemb));
+  EXPECT_EQ(2, parser()->remb_item()->num_packets());
+  EXPECT_EQ(200000, parser()->remb_item()->last_bitrate_bps());
+  EXPECT_THAT(parser()->remb_item()->last_ssrc_list(),
+              ElementsAre(kRemoteSsrc, kRemoteSsrc + 1));
+
+  rtcp_sender_->SetSSRC(kSenderSsrc + 1);
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpRemb));
+  EXPECT_EQ(kSenderSsrc + 1, parser()->psfb_app()->Ssrc());
+}
+
 TEST_F(RtcpSenderTest, RembNotIncludedInCompoundPacketIfNotEnabled) {
   const int kBitrate = 261011;
   std::vector<uint32_t> ssrcs;
@@ -761,4 +810,80 @@ TEST_F(RtcpSenderTest, SendCompoundPliRemb) {
   EXPECT_EQ(1, parser()->pli()->num_packets());
 }
 
+class NullRtcpTransport : public Transport {
+ public:
+  bool SendRtp(const uint8_t* packet,
+               size_t length,
+               const PacketOptions& options) override {
+    return false;
+  }
+  bool SendRtcp(const uint8_t* packet, size_t length) override {
+    return true;
+  }
+};
+
+// Logs what it costs to generate the periodic compound packet (RR with one
+// report block, SDES and REMB) of a low bitrate audio stream, as seen by a
+// server relaying many of them. It only measures time, so it is disabled by
+// default.
+TEST(RtcpSenderPerformanceTest, DISABLED_CompoundReportCostPerStream) {
+  const int kNumStreams = 500;
+  const int kNumReports = 20;
+  SimulatedClock clock(1335900000);
+  NullRtcpTransport transport;
+  std::vector<ReceiveStatistics*> statistics;
+  std::vector<RTCPSender*> senders;
+  std::vector<uint32_t> remb_ssrcs;
+  for (int i = 0; i < kNumStreams; ++i) {
+    const uint32_t remote_ssrc = kRemoteSsrc + i;
+    ReceiveStatistics* receive_statistics = ReceiveStatistics::Create(&clock);
+    RTPHeader header;
+    header.ssrc = remote_ssrc;
+    header.headerLength = 12;
+    header.sequenceNumber = 0;
+    receive_statistics->IncomingPacket(header, 100, false);
+    statistics.push_back(receive_statistics);
+
+    RTCPSender* sender = new RTCPSender(true, &clock, receive_statistics,
+                                        nullptr, &transport);
+    sender->SetSSRC(kSenderSsrc + i);
+    sender->SetRemoteSSRC(remote_ssrc);
+    sender->SetCNAME("relay@example.com");
+    sender->SetRTCPStatus(RtcpMode::kCompound);
+    sender->SetREMBStatus(true);
+    remb_ssrcs.assign(1, remote_ssrc);
+    sender->SetREMBData(32000, remb_ssrcs);
+    senders.push_back(sender);
+  }
+
+  RTCPSender::FeedbackState feedback_state;
+  uint16_t sequence_number = 0;
+  int64_t elapsed_us = 0;
+  for (int report = 0; report < kNumReports; ++report) {
+    // 50 packets per stream between reports, as for 20 ms audio frames.
+    for (int packet = 0; packet < 50; ++packet) {
+      RTPHeader header;
+      header.headerLength = 12;
+      header.sequenceNumber = ++sequence_number;
+      for (int i = 0; i < kNumStreams; ++i) {
+        header.ssrc = kRemoteSsrc + i;
+        statistics[i]->IncomingPacket(header, 100, false);
+      }
+      clock.AdvanceTimeMilliseconds(20);
+    }
+    uint64_t start_us = rtc::TimeMicros();
+    for (RTCPSender* sender : senders)
+      EXPECT_EQ(0, sender->SendRTCP(feedback_state, kRtcpReport));
+    elapsed_us += rtc::TimeMicros() - start_us;
+  }
+  LOG(LS_INFO) << "RTCP compound report: "
+               << static_cast<double>(elapsed_us) / (kNumStreams * kNumReports)
+               << " us per stream.";
+
+  for (RTCPSender* sender : senders)
+    delete sender;
+  for (ReceiveStatistics* receive_statistics : statistics)
+    delete receive_statistics;
+}
+
 }  // namespace webrtc
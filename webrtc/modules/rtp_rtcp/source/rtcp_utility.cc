@@ -1665,11 +1665,12 @@ size_t RTCPUtility::RTCPParserV2::NumSkippedBlocks() const {
   return num_skipped_blocks_;
 }
 
-RTCPUtility::RTCPPacketIterator::RTCPPacketIterator(uint8_t* rtcpData,
+RTCPUtility::RTCPPacketIterator::RTCPPacketIterator(const uint8_t* rtcpData,
                                                     size_t rtcpDataLength)
     : _ptrBegin(rtcpData),
       _ptrEnd(rtcpData + rtcpDataLength),
-      _ptrBlock(NULL) {
+      _ptrBlock(NULL),
+      _ptrCurrentBlock(NULL) {
   memset(&_header, 0, sizeof(_header));
 }
 
@@ -1687,12 +1688,15 @@ RTCPUtility::RTCPPacketIterator::Iterate() {
   if ((_ptrEnd <= _ptrBlock) ||
       !RtcpParseCommonHeader(_ptrBlock, _ptrEnd - _ptrBlock, &_header)) {
     _ptrBlock = nullptr;
+    _ptrCurrentBlock = nullptr;
     return nullptr;
   }
+  _ptrCurrentBlock = _ptrBlock;
   _ptrBlock += _header.BlockSize();
 
   if (_ptrBlock > _ptrEnd) {
     _ptrBlock = nullptr;
+    _ptrCurrentBlock = nullptr;
     return nullptr;
   }
 
@@ -1708,4 +1712,8 @@ RTCPUtility::RTCPPacketIterator::Current() {
 
     return &_header;
 }
+
+const uint8_t* RTCPUtility::RTCPPacketIterator::CurrentBlock() const {
+  return _ptrBlock ? _ptrCurrentBlock : nullptr;
+}
 }  // namespace webrtc
@@ -470,20 +470,27 @@ class RTCPParserV2 {
   rtc::scoped_ptr<webrtc::rtcp::RtcpPacket> rtcp_packet_;
 };
 
+// Walks the top level blocks of a compound RTCP packet, parsing only the
+// common header of each block. Useful when the caller only wants to decode
+// a few block types with the typed rtcp_packet/ classes.
 class RTCPPacketIterator {
  public:
-  RTCPPacketIterator(uint8_t* rtcpData, size_t rtcpDataLength);
+  RTCPPacketIterator(const uint8_t* rtcpData, size_t rtcpDataLength);
   ~RTCPPacketIterator();
 
   const RtcpCommonHeader* Begin();
   const RtcpCommonHeader* Iterate();
   const RtcpCommonHeader* Current();
+  // Start of the block (including its common header) described by Current(),
+  // or nullptr if there is no current block.
+  const uint8_t* CurrentBlock() const;
 
  private:
-  uint8_t* const _ptrBegin;
-  uint8_t* const _ptrEnd;
+  const uint8_t* const _ptrBegin;
+  const uint8_t* const _ptrEnd;
 
-  uint8_t* _ptrBlock;
+  const uint8_t* _ptrBlock;
+  const uint8_t* _ptrCurrentBlock;
 
   RtcpCommonHeader _header;
 };
@@ -156,6 +156,42 @@ TEST_F(RtcpParseCommonHeaderTest, FormatAndPayloadType) {
   EXPECT_EQ(kPacketType, header.packet_type);
 }
 
+TEST(RtcpPacketIteratorTest, IteratesTopLevelBlocks) {
+  // RR with no report blocks followed by a PLI.
+  const uint8_t kPacket[] = {0x80, 201, 0x00, 0x01, 0x01, 0x02, 0x03, 0x04,
+                             0x81, 206, 0x00, 0x02, 0x01, 0x02, 0x03, 0x04,
+                             0x05, 0x06, 0x07, 0x08};
+  RTCPUtility::RTCPPacketIterator it(kPacket, sizeof(kPacket));
+
+  const RtcpCommonHeader* header = it.Begin();
+  ASSERT_TRUE(header != nullptr);
+  EXPECT_EQ(201u, header->packet_type);
+  EXPECT_EQ(4u, header->payload_size_bytes);
+  EXPECT_EQ(kPacket, it.CurrentBlock());
+
+  header = it.Iterate();
+  ASSERT_TRUE(header != nullptr);
+  EXPECT_EQ(206u, header->packet_type);
+  EXPECT_EQ(1u, header->count_or_format);
+  EXPECT_EQ(8u, header->payload_size_bytes);
+  EXPECT_EQ(kPacket + 8, it.CurrentBlock());
+
+  EXPECT_TRUE(it.Iterate() == nullptr);
+  EXPECT_TRUE(it.CurrentBlock() == nullptr);
+}
+
+TEST(RtcpPacketIteratorTest, StopsAtTruncatedBlock) {
+  // Second block claims more payload than is present.
+  const uint8_t kPacket[] = {0x80, 201, 0x00, 0x01, 0x01, 0x02, 0x03, 0x04,
+                             0x81, 206, 0x00, 0x04, 0x01, 0x02, 0x03, 0x04};
+  RTCPUtility::RTCPPacketIterator it(kPacket, sizeof(kPacket));
+
+  ASSERT_TRUE(it.Begin() != nullptr);
+  EXPECT_TRUE(it.Iterate() == nullptr);
+  EXPECT_TRUE(it.Current() == nullptr);
+  EXPECT_TRUE(it.CurrentBlock() == nullptr);
+}
+
 }  // namespace rtcp
 }  // namespace webrtc
 
@@ -17,6 +17,8 @@
 namespace webrtc {
 
 RtpHeaderExtensionMap::RtpHeaderExtensionMap() {
+  for (RTPExtensionType& type : types_by_id_)
+    type = kRtpExtensionNone;
 }
 
 RtpHeaderExtensionMap::~RtpHeaderExtensionMap() {
@@ -27,6 +29,7 @@ void RtpHeaderExtensionMap::Erase() {
   while (!extensionMap_.empty()) {
     std::map<uint8_t, HeaderExtension*>::iterator it =
         extensionMap_.begin();
+    types_by_id_[it->first] = kRtpExtensionNone;
     delete it->second;
     extensionMap_.erase(it);
   }
@@ -45,7 +48,7 @@ int32_t RtpHeaderExtensionMap::RegisterInactive(const RTPExtensionType type,
 int32_t RtpHeaderExtensionMap::Register(const RTPExtensionType type,
                                         const uint8_t id,
                                         bool active) {
-  if (id < 1 || id > 14) {
+  if (id < kMinId || id > kMaxId) {
     return -1;
   }
   std::map<uint8_t, HeaderExtension*>::iterator it =
@@ -62,6 +65,7 @@ int32_t RtpHeaderExtensionMap::Register(const RTPExtensionType type,
     return 0;
   }
   extensionMap_[id] = new HeaderExtension(type, active);
+  types_by_id_[id] = type;
   return 0;
 }
 
@@ -84,6 +88,7 @@ int32_t RtpHeaderExtensionMap::Deregister(const RTPExtensionType type) {
   std::map<uint8_t, HeaderExtension*>::iterator it =
       extensionMap_.find(id);
   assert(it != extensionMap_.end());
+  types_by_id_[id] = kRtpExtensionNone;
   delete it->second;
   extensionMap_.erase(it);
   return 0;
@@ -102,13 +107,10 @@ bool RtpHeaderExtensionMap::IsRegistered(RTPExtensionType type) const {
 int32_t RtpHeaderExtensionMap::GetType(const uint8_t id,
                                        RTPExtensionType* type) const {
   assert(type);
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.find(id);
-  if (it == extensionMap_.end()) {
+  if (id > kMaxId || types_by_id_[id] == kRtpExtensionNone) {
     return -1;
   }
-  HeaderExtension* extension = it->second;
-  *type = extension->type;
+  *type = types_by_id_[id];
   return 0;
 }
 
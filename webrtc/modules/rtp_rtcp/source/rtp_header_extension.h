@@ -70,6 +70,10 @@ struct HeaderExtension {
 
 class RtpHeaderExtensionMap {
  public:
+  // One-byte header extension ids are 1-14, 15 is reserved and 0 is padding.
+  static const uint8_t kMinId = 1;
+  static const uint8_t kMaxId = 14;
+
   RtpHeaderExtensionMap();
   ~RtpHeaderExtensionMap();
 
@@ -111,6 +115,10 @@ class RtpHeaderExtensionMap {
  private:
   int32_t Register(const RTPExtensionType type, const uint8_t id, bool active);
   std::map<uint8_t, HeaderExtension*> extensionMap_;
+  // Flat copy of the id -> type part of |extensionMap_|, indexed by id. Used
+  // by GetType(), which runs for every extension element of every received
+  // packet.
+  RTPExtensionType types_by_id_[kMaxId + 1];
 };
 }  // namespace webrtc
 
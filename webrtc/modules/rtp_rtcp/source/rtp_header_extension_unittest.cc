@@ -66,6 +66,28 @@ TEST_F(RtpHeaderExtensionTest, NonUniqueId) {
   EXPECT_EQ(-1, map_.RegisterInactive(kRtpExtensionAudioLevel, kId));
 }
 
+TEST_F(RtpHeaderExtensionTest, GetTypeTracksRegistration) {
+  RTPExtensionType typeOut;
+  EXPECT_EQ(-1, map_.GetType(kId, &typeOut));
+  EXPECT_EQ(-1, map_.GetType(0, &typeOut));
+  EXPECT_EQ(-1, map_.GetType(15, &typeOut));
+
+  EXPECT_EQ(0, map_.Register(kRtpExtensionTransmissionTimeOffset, kId));
+  EXPECT_EQ(0, map_.GetType(kId, &typeOut));
+  EXPECT_EQ(kRtpExtensionTransmissionTimeOffset, typeOut);
+
+  // Inactive extensions can still be looked up by id.
+  EXPECT_EQ(0, map_.RegisterInactive(kRtpExtensionAudioLevel, kId + 1));
+  EXPECT_EQ(0, map_.GetType(kId + 1, &typeOut));
+  EXPECT_EQ(kRtpExtensionAudioLevel, typeOut);
+
+  EXPECT_EQ(0, map_.Deregister(kRtpExtensionTransmissionTimeOffset));
+  EXPECT_EQ(-1, map_.GetType(kId, &typeOut));
+
+  map_.Erase();
+  EXPECT_EQ(-1, map_.GetType(kId + 1, &typeOut));
+}
+
 TEST_F(RtpHeaderExtensionTest, GetTotalLength) {
   EXPECT_EQ(0u, map_.GetTotalLengthInBytes());
   EXPECT_EQ(0, map_.RegisterInactive(kRtpExtensionTransmissionTimeOffset, kId));
@@ -52,13 +52,12 @@ bool RtpHeaderParserImpl::Parse(const uint8_t* packet,
   RtpUtility::RtpHeaderParser rtp_parser(packet, length);
   memset(header, 0, sizeof(*header));
 
-  RtpHeaderExtensionMap map;
-  {
-    CriticalSectionScoped cs(critical_section_.get());
-    rtp_header_extension_map_.GetCopy(&map);
-  }
-
-  const bool valid_rtpheader = rtp_parser.Parse(*header, &map);
+  // Parse against the registered extensions directly rather than copying
+  // the map (one heap allocation per extension) for every packet; the
+  // parse itself is cheaper than the copy was.
+  CriticalSectionScoped cs(critical_section_.get());
+  const bool valid_rtpheader =
+      rtp_parser.Parse(*header, &rtp_header_extension_map_);
   if (!valid_rtpheader) {
     return false;
   }
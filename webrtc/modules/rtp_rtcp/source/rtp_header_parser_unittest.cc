@@ -0,0 +1,119 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include "webrtc/base/logging.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_header_parser.h"
+
+namespace webrtc {
+namespace {
+
+const uint8_t kTransmissionTimeOffsetId = 1;
+const uint8_t kAudioLevelId = 2;
+const uint8_t kAbsoluteSendTimeId = 3;
+const uint8_t kTransportSequenceNumberId = 5;
+
+// RTP header with a one-byte header extension block carrying a transmission
+// time offset, an absolute send time, a transport sequence number and an
+// audio level, followed by a four byte payload.
+const uint8_t kPacket[] = {
+    0x90, 0x6f, 0x12, 0x34,  // V=2, X=1, M=0, PT=111, seq=0x1234.
+    0x00, 0x01, 0x02, 0x03,  // Timestamp.
+    0x11, 0x22, 0x33, 0x44,  // SSRC.
+    0xbe, 0xde, 0x00, 0x04,  // One-byte extensions, 4 words.
+    0x12, 0x00, 0x01, 0x00,  // Transmission time offset = 256.
+    0x32, 0x12, 0x34, 0x56,  // Absolute send time.
+    0x51, 0xab, 0xcd,        // Transport sequence number.
+    0x20, 0x85,              // Voice activity, audio level = 5.
+    0x00, 0x00, 0x00,        // Padding.
+    0xde, 0xad, 0xbe, 0xef,  // Payload.
+};
+
+class RtpHeaderParserTest : public ::testing::Test {
+ protected:
+  RtpHeaderParserTest() : parser_(RtpHeaderParser::Create()) {}
+
+  void RegisterExtensions() {
+    EXPECT_TRUE(parser_->RegisterRtpHeaderExtension(
+        kRtpExtensionTransmissionTimeOffset, kTransmissionTimeOffsetId));
+    EXPECT_TRUE(parser_->RegisterRtpHeaderExtension(kRtpExtensionAudioLevel,
+                                                    kAudioLevelId));
+    EXPECT_TRUE(parser_->RegisterRtpHeaderExtension(
+        kRtpExtensionAbsoluteSendTime, kAbsoluteSendTimeId));
+    EXPECT_TRUE(parser_->RegisterRtpHeaderExtension(
+        kRtpExtensionTransportSequenceNumber, kTransportSequenceNumberId));
+  }
+
+  rtc::scoped_ptr<RtpHeaderParser> parser_;
+};
+
+TEST_F(RtpHeaderParserTest, ParsesRegisteredExtensions) {
+  RegisterExtensions();
+
+  RTPHeader header;
+  ASSERT_TRUE(parser_->Parse(kPacket, sizeof(kPacket), &header));
+  EXPECT_EQ(111, header.payloadType);
+  EXPECT_EQ(0x1234, header.sequenceNumber);
+  EXPECT_EQ(0x00010203u, header.timestamp);
+  EXPECT_EQ(0x11223344u, header.ssrc);
+  EXPECT_EQ(sizeof(kPacket) - 4, header.headerLength);
+
+  EXPECT_TRUE(header.extension.hasTransmissionTimeOffset);
+  EXPECT_EQ(256, header.extension.transmissionTimeOffset);
+  EXPECT_TRUE(header.extension.hasAbsoluteSendTime);
+  EXPECT_EQ(0x123456u, header.extension.absoluteSendTime);
+  EXPECT_TRUE(header.extension.hasTransportSequenceNumber);
+  EXPECT_EQ(0xabcd, header.extension.transportSequenceNumber);
+  EXPECT_TRUE(header.extension.hasAudioLevel);
+  EXPECT_TRUE(header.extension.voiceActivity);
+  EXPECT_EQ(5, header.extension.audioLevel);
+}
+
+TEST_F(RtpHeaderParserTest, SkipsUnregisteredExtensions) {
+  EXPECT_TRUE(parser_->RegisterRtpHeaderExtension(
+      kRtpExtensionAbsoluteSendTime, kAbsoluteSendTimeId));
+
+  RTPHeader header;
+  ASSERT_TRUE(parser_->Parse(kPacket, sizeof(kPacket), &header));
+  EXPECT_FALSE(header.extension.hasTransmissionTimeOffset);
+  EXPECT_TRUE(header.extension.hasAbsoluteSendTime);
+  EXPECT_EQ(0x123456u, header.extension.absoluteSendTime);
+  EXPECT_FALSE(header.extension.hasTransportSequenceNumber);
+  EXPECT_FALSE(header.extension.hasAudioLevel);
+
+  EXPECT_TRUE(parser_->DeregisterRtpHeaderExtension(
+      kRtpExtensionAbsoluteSendTime));
+  ASSERT_TRUE(parser_->Parse(kPacket, sizeof(kPacket), &header));
+  EXPECT_FALSE(header.extension.hasAbsoluteSendTime);
+}
+
+// Logs the parse throughput for a packet with four registered extensions. It
+// only measures time, so it is disabled by default.
+TEST_F(RtpHeaderParserTest, DISABLED_ParseThroughput) {
+  const int kNumPackets = 100000;
+  RegisterExtensions();
+
+  RTPHeader header;
+  uint64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumPackets; ++i)
+    ASSERT_TRUE(parser_->Parse(kPacket, sizeof(kPacket), &header));
+  uint64_t elapsed_us = rtc::TimeMicros() - start_us;
+
+  LOG(LS_INFO) << "Parsed " << kNumPackets << " RTP headers in " << elapsed_us
+               << " us ("
+               << (elapsed_us > 0 ? kNumPackets * 1000 / elapsed_us : 0)
+               << " packets/ms).";
+}
+
+}  // namespace
+}  // namespace webrtc
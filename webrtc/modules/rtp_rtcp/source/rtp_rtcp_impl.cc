@@ -32,6 +32,7 @@ RtpRtcp::Configuration::Configuration()
       clock(nullptr),
       receive_statistics(NullObjectReceiveStatistics()),
       outgoing_transport(nullptr),
+      rtcp_report_transport(nullptr),
       intra_frame_callback(nullptr),
       bandwidth_callback(nullptr),
       transport_feedback_callback(nullptr),
@@ -104,6 +105,9 @@ ModuleRtpRtcpImpl::ModuleRtpRtcpImpl(const Configuration& configuration)
   uint32_t SSRC = rtp_sender_.SSRC();
   rtcp_sender_.SetSSRC(SSRC);
   SetRtcpReceiverSsrcs(SSRC);
+
+  if (configuration.rtcp_report_transport)
+    rtcp_sender_.SetReportTransport(configuration.rtcp_report_transport);
 }
 
 // Returns the number of milliseconds until the module want a worker thread
@@ -222,6 +226,16 @@ std::pair<int, int> ModuleRtpRtcpImpl::RtxSendPayloadType() const {
 int32_t ModuleRtpRtcpImpl::IncomingRtcpPacket(
     const uint8_t* rtcp_packet,
     const size_t length) {
+  RTCPHelp::RTCPPacketInformation rtcp_packet_information;
+  // Transport feedback is sent on its own at a high rate; decode it directly
+  // rather than running the full parser over it. Compound packets that also
+  // carry any other block type still take the full parser below.
+  if (rtcp_receiver_.IncomingTransportFeedback(rtcp_packet, length,
+                                               &rtcp_packet_information)) {
+    rtcp_receiver_.TriggerCallbacksFromRTCPPacket(rtcp_packet_information);
+    return 0;
+  }
+
   // Allow receive of non-compound RTCP packets.
   RTCPUtility::RTCPParserV2 rtcp_parser(rtcp_packet, length, true);
 
@@ -230,7 +244,6 @@ int32_t ModuleRtpRtcpImpl::IncomingRtcpPacket(
     LOG(LS_WARNING) << "Incoming invalid RTCP packet";
     return -1;
   }
-  RTCPHelp::RTCPPacketInformation rtcp_packet_information;
   int32_t ret_val = rtcp_receiver_.IncomingRTCPPacket(
       rtcp_packet_information, &rtcp_parser);
   if (ret_val == 0) {
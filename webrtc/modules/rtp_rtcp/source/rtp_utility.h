@@ -79,7 +79,7 @@ namespace RtpUtility {
         bool RTCP() const;
         bool ParseRtcp(RTPHeader* header) const;
         bool Parse(RTPHeader& parsedPacket,
-                   RtpHeaderExtensionMap* ptrExtensionMap = NULL) const;
+                   const RtpHeaderExtensionMap* ptrExtensionMap = NULL) const;
 
     private:
         void ParseOneByteExtensionHeader(
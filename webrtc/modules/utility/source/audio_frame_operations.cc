@@ -8,20 +8,137 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/utility/include/audio_frame_operations.h"
+#include "webrtc/modules/utility/source/audio_frame_operations_sse2.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
 
-void AudioFrameOperations::MonoToStereo(const int16_t* src_audio,
-                                        size_t samples_per_channel,
-                                        int16_t* dst_audio) {
+namespace {
+
+void MonoToStereo_C(const int16_t* src_audio,
+                    size_t samples_per_channel,
+                    int16_t* dst_audio) {
   for (size_t i = 0; i < samples_per_channel; i++) {
     dst_audio[2 * i] = src_audio[i];
     dst_audio[2 * i + 1] = src_audio[i];
   }
 }
 
+void StereoToMono_C(const int16_t* src_audio,
+                    size_t samples_per_channel,
+                    int16_t* dst_audio) {
+  for (size_t i = 0; i < samples_per_channel; i++) {
+    dst_audio[i] = (src_audio[2 * i] + src_audio[2 * i + 1]) >> 1;
+  }
+}
+
+void SwapStereoChannels_C(int16_t* audio, size_t samples_per_channel) {
+  for (size_t i = 0; i < samples_per_channel * 2; i += 2) {
+    int16_t temp_data = audio[i];
+    audio[i] = audio[i + 1];
+    audio[i + 1] = temp_data;
+  }
+}
+
+// Scales |sample|, saturating the result to [-32768, +32767].
+int16_t ScaleSampleWithSat(float scale, int16_t sample) {
+  const int32_t temp_data = static_cast<int32_t>(scale * sample);
+  if (temp_data < -32768)
+    return -32768;
+  if (temp_data > 32767)
+    return 32767;
+  return static_cast<int16_t>(temp_data);
+}
+
+void Scale_C(float left, float right, int16_t* audio,
+             size_t samples_per_channel) {
+  for (size_t i = 0; i < samples_per_channel; i++) {
+    audio[2 * i] = ScaleSampleWithSat(left, audio[2 * i]);
+    audio[2 * i + 1] = ScaleSampleWithSat(right, audio[2 * i + 1]);
+  }
+}
+
+void ScaleWithSat_C(float scale, int16_t* audio, size_t size) {
+  int32_t temp_data = 0;
+
+  // Ensure that the output result is saturated [-32768, +32767].
+  for (size_t i = 0; i < size; i++) {
+    temp_data = static_cast<int32_t>(scale * audio[i]);
+    if (temp_data < -32768) {
+      audio[i] = -32768;
+    } else if (temp_data > 32767) {
+      audio[i] = 32767;
+    } else {
+      audio[i] = static_cast<int16_t>(temp_data);
+    }
+  }
+}
+
+// The loops that have SIMD versions, for one instruction set.
+struct Kernels {
+  void (*mono_to_stereo)(const int16_t*, size_t, int16_t*);
+  void (*stereo_to_mono)(const int16_t*, size_t, int16_t*);
+  void (*swap_stereo_channels)(int16_t*, size_t);
+  void (*scale)(float, float, int16_t*, size_t);
+  void (*scale_with_sat)(float, int16_t*, size_t);
+};
+
+const Kernels kKernelsC = {
+    MonoToStereo_C,
+    StereoToMono_C,
+    SwapStereoChannels_C,
+    Scale_C,
+    ScaleWithSat_C,
+};
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+const Kernels kKernelsSSE2 = {
+    MonoToStereo_SSE2,
+    StereoToMono_SSE2,
+    SwapStereoChannels_SSE2,
+    Scale_SSE2,
+    ScaleWithSat_SSE2,
+};
+#endif
+
+const Kernels* DetectKernels() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+  return &kKernelsSSE2;
+#else
+  return WebRtc_GetCPUInfo(kSSE2) ? &kKernelsSSE2 : &kKernelsC;
+#endif
+#else
+  // There are no NEON kernels yet, since none could be run on ARM.
+  return &kKernelsC;
+#endif
+}
+
+const Kernels* volatile g_kernels = nullptr;
+
+// Detects the CPU on the first call only.
+const Kernels* GetKernels() {
+  const Kernels* kernels = rtc::AtomicOps::AtomicLoadPtr(&g_kernels);
+  if (!kernels) {
+    // Threads racing here all detect the same kernels.
+    kernels = DetectKernels();
+    rtc::AtomicOps::CompareAndSwapPtr(
+        &g_kernels, static_cast<const Kernels*>(nullptr), kernels);
+  }
+  return kernels;
+}
+
+}  // namespace
+
+void AudioFrameOperations::MonoToStereo(const int16_t* src_audio,
+                                        size_t samples_per_channel,
+                                        int16_t* dst_audio) {
+  GetKernels()->mono_to_stereo(src_audio, samples_per_channel, dst_audio);
+}
+
 int AudioFrameOperations::MonoToStereo(AudioFrame* frame) {
   if (frame->num_channels_ != 1) {
     return -1;
@@ -43,9 +160,7 @@ int AudioFrameOperations::MonoToStereo(AudioFrame* frame) {
 void AudioFrameOperations::StereoToMono(const int16_t* src_audio,
                                         size_t samples_per_channel,
                                         int16_t* dst_audio) {
-  for (size_t i = 0; i < samples_per_channel; i++) {
-    dst_audio[i] = (src_audio[2 * i] + src_audio[2 * i + 1]) >> 1;
-  }
+  GetKernels()->stereo_to_mono(src_audio, samples_per_channel, dst_audio);
 }
 
 int AudioFrameOperations::StereoToMono(AudioFrame* frame) {
@@ -62,11 +177,8 @@ int AudioFrameOperations::StereoToMono(AudioFrame* frame) {
 void AudioFrameOperations::SwapStereoChannels(AudioFrame* frame) {
   if (frame->num_channels_ != 2) return;
 
-  for (size_t i = 0; i < frame->samples_per_channel_ * 2; i += 2) {
-    int16_t temp_data = frame->data_[i];
-    frame->data_[i] = frame->data_[i + 1];
-    frame->data_[i + 1] = temp_data;
-  }
+  GetKernels()->swap_stereo_channels(frame->data_,
+                                     frame->samples_per_channel_);
 }
 
 void AudioFrameOperations::Mute(AudioFrame& frame) {
@@ -79,30 +191,13 @@ int AudioFrameOperations::Scale(float left, float right, AudioFrame& frame) {
     return -1;
   }
 
-  for (size_t i = 0; i < frame.samples_per_channel_; i++) {
-    frame.data_[2 * i] =
-        static_cast<int16_t>(left * frame.data_[2 * i]);
-    frame.data_[2 * i + 1] =
-        static_cast<int16_t>(right * frame.data_[2 * i + 1]);
-  }
+  GetKernels()->scale(left, right, frame.data_, frame.samples_per_channel_);
   return 0;
 }
 
 int AudioFrameOperations::ScaleWithSat(float scale, AudioFrame& frame) {
-  int32_t temp_data = 0;
-
-  // Ensure that the output result is saturated [-32768, +32767].
-  for (size_t i = 0; i < frame.samples_per_channel_ * frame.num_channels_;
-       i++) {
-    temp_data = static_cast<int32_t>(scale * frame.data_[i]);
-    if (temp_data < -32768) {
-      frame.data_[i] = -32768;
-    } else if (temp_data > 32767) {
-      frame.data_[i] = 32767;
-    } else {
-      frame.data_[i] = static_cast<int16_t>(temp_data);
-    }
-  }
+  GetKernels()->scale_with_sat(
+      scale, frame.data_, frame.samples_per_channel_ * frame.num_channels_);
   return 0;
 }
 
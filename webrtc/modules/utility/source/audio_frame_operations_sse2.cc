@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/utility/source/audio_frame_operations_sse2.h"
+
+#include <emmintrin.h>
+
+namespace webrtc {
+
+namespace {
+
+inline __m128i Load(const int16_t* src) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+inline void Store(int16_t* dest, __m128i v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), v);
+}
+
+// Multiplies the eight samples of |v| by |scale| and truncates the products
+// back to int16_t, saturating.
+inline __m128i ScaleS16(__m128i v, __m128 scale) {
+  const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+  const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+  return _mm_packs_epi32(
+      _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(low), scale)),
+      _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(high), scale)));
+}
+
+}  // namespace
+
+void MonoToStereo_SSE2(const int16_t* src_audio,
+                       size_t samples_per_channel,
+                       int16_t* dst_audio) {
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    const __m128i v = Load(src_audio + i);
+    Store(dst_audio + 2 * i, _mm_unpacklo_epi16(v, v));
+    Store(dst_audio + 2 * i + 8, _mm_unpackhi_epi16(v, v));
+  }
+  for (; i < samples_per_channel; ++i) {
+    dst_audio[2 * i] = src_audio[i];
+    dst_audio[2 * i + 1] = src_audio[i];
+  }
+}
+
+void StereoToMono_SSE2(const int16_t* src_audio,
+                       size_t samples_per_channel,
+                       int16_t* dst_audio) {
+  // Multiplying by one and adding pairs sums each frame into 32 bits. The
+  // writes never get ahead of the reads, so this also works in place.
+  const __m128i kOnes = _mm_set1_epi16(1);
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    const __m128i a = _mm_madd_epi16(Load(src_audio + 2 * i), kOnes);
+    const __m128i b = _mm_madd_epi16(Load(src_audio + 2 * i + 8), kOnes);
+    Store(dst_audio + i,
+          _mm_packs_epi32(_mm_srai_epi32(a, 1), _mm_srai_epi32(b, 1)));
+  }
+  for (; i < samples_per_channel; ++i)
+    dst_audio[i] = (src_audio[2 * i] + src_audio[2 * i + 1]) >> 1;
+}
+
+void SwapStereoChannels_SSE2(int16_t* audio, size_t samples_per_channel) {
+  size_t i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4) {
+    const __m128i v = Load(audio + 2 * i);
+    Store(audio + 2 * i,
+          _mm_or_si128(_mm_slli_epi32(v, 16), _mm_srli_epi32(v, 16)));
+  }
+  for (; i < samples_per_channel; ++i) {
+    const int16_t temp = audio[2 * i];
+    audio[2 * i] = audio[2 * i + 1];
+    audio[2 * i + 1] = temp;
+  }
+}
+
+void Scale_SSE2(float left,
+                float right,
+                int16_t* audio,
+                size_t samples_per_channel) {
+  const __m128 scale = _mm_setr_ps(left, right, left, right);
+  size_t i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4)
+    Store(audio + 2 * i, ScaleS16(Load(audio + 2 * i), scale));
+  for (; i < samples_per_channel; ++i) {
+    const int32_t temp_left = static_cast<int32_t>(left * audio[2 * i]);
+    const int32_t temp_right = static_cast<int32_t>(right * audio[2 * i + 1]);
+    audio[2 * i] = static_cast<int16_t>(
+        temp_left < -32768 ? -32768 : (temp_left > 32767 ? 32767 : temp_left));
+    audio[2 * i + 1] = static_cast<int16_t>(
+        temp_right < -32768 ? -32768
+                            : (temp_right > 32767 ? 32767 : temp_right));
+  }
+}
+
+void ScaleWithSat_SSE2(float scale, int16_t* audio, size_t size) {
+  const __m128 scale_v = _mm_set1_ps(scale);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+    Store(audio + i, ScaleS16(Load(audio + i), scale_v));
+  for (; i < size; ++i) {
+    const int32_t temp = static_cast<int32_t>(scale * audio[i]);
+    audio[i] = static_cast<int16_t>(
+        temp < -32768 ? -32768 : (temp > 32767 ? 32767 : temp));
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,39 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_UTILITY_SOURCE_AUDIO_FRAME_OPERATIONS_SSE2_H_
+#define WEBRTC_MODULES_UTILITY_SOURCE_AUDIO_FRAME_OPERATIONS_SSE2_H_
+
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// SSE2 versions of the AudioFrameOperations loops. They give the same output
+// as the scalar versions, for any length, except that the scaling saturates
+// where the scalar versions' float to int casts are undefined.
+void MonoToStereo_SSE2(const int16_t* src_audio,
+                       size_t samples_per_channel,
+                       int16_t* dst_audio);
+// |src_audio| and |dst_audio| may point to the same buffer.
+void StereoToMono_SSE2(const int16_t* src_audio,
+                       size_t samples_per_channel,
+                       int16_t* dst_audio);
+void SwapStereoChannels_SSE2(int16_t* audio, size_t samples_per_channel);
+void Scale_SSE2(float left,
+                float right,
+                int16_t* audio,
+                size_t samples_per_channel);
+void ScaleWithSat_SSE2(float scale, int16_t* audio, size_t size);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_UTILITY_SOURCE_AUDIO_FRAME_OPERATIONS_SSE2_H_
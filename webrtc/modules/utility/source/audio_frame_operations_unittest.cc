@@ -8,10 +8,13 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+
 #include "testing/gtest/include/gtest/gtest.h"
 
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/utility/include/audio_frame_operations.h"
+#include "webrtc/system_wrappers/include/tick_util.h"
 
 namespace webrtc {
 namespace {
@@ -164,8 +167,7 @@ TEST_F(AudioFrameOperationsTest, DISABLED_ScaleFailsWithBadParameters) {
   EXPECT_EQ(-1, AudioFrameOperations::Scale(1.0, -1.0, frame_));
 }
 
-// TODO(andrew): fix the wraparound bug. We should always saturate.
-TEST_F(AudioFrameOperationsTest, DISABLED_ScaleDoesNotWrapAround) {
+TEST_F(AudioFrameOperationsTest, ScaleDoesNotWrapAround) {
   SetFrameData(&frame_, 4000, -4000);
   EXPECT_EQ(0, AudioFrameOperations::Scale(10.0, 10.0, frame_));
 
@@ -221,5 +223,223 @@ TEST_F(AudioFrameOperationsTest, ScaleWithSatSucceeds) {
   VerifyFramesAreEqual(scaled_frame, frame_);
 }
 
+
+// Lengths around the SIMD widths, and 10 ms at 8 to 96 kHz.
+const size_t kSamplesPerChannel[] = {1,   3,   4,   7,   8,   9,   15,  16,
+                                     17,  80,  160, 320, 441, 480, 960};
+
+// Samples spanning the whole int16_t range, in a scrambled order.
+void SetScrambledFrameData(AudioFrame* frame) {
+  for (size_t i = 0; i < frame->samples_per_channel_ * frame->num_channels_;
+       i++) {
+    frame->data_[i] = static_cast<int16_t>(
+        static_cast<int>((i * 7919 + 12345) % 65536) - 32768);
+  }
+}
+
+// The scalar loops the SIMD versions must match.
+void MonoToStereoScalar(AudioFrame* frame) {
+  for (size_t i = frame->samples_per_channel_; i-- > 0;) {
+    frame->data_[2 * i + 1] = frame->data_[i];
+    frame->data_[2 * i] = frame->data_[i];
+  }
+  frame->num_channels_ = 2;
+}
+
+void StereoToMonoScalar(AudioFrame* frame) {
+  for (size_t i = 0; i < frame->samples_per_channel_; i++) {
+    frame->data_[i] = (frame->data_[2 * i] + frame->data_[2 * i + 1]) >> 1;
+  }
+  frame->num_channels_ = 1;
+}
+
+void SwapStereoChannelsScalar(AudioFrame* frame) {
+  for (size_t i = 0; i < frame->samples_per_channel_ * 2; i += 2) {
+    int16_t temp_data = frame->data_[i];
+    frame->data_[i] = frame->data_[i + 1];
+    frame->data_[i + 1] = temp_data;
+  }
+}
+
+int16_t ScaleSampleWithSatScalar(float scale, int16_t sample) {
+  int32_t temp_data = static_cast<int32_t>(scale * sample);
+  if (temp_data < -32768)
+    return -32768;
+  if (temp_data > 32767)
+    return 32767;
+  return static_cast<int16_t>(temp_data);
+}
+
+void ScaleScalar(float left, float right, AudioFrame* frame) {
+  for (size_t i = 0; i < frame->samples_per_channel_; i++) {
+    frame->data_[2 * i] = ScaleSampleWithSatScalar(left, frame->data_[2 * i]);
+    frame->data_[2 * i + 1] =
+        ScaleSampleWithSatScalar(right, frame->data_[2 * i + 1]);
+  }
+}
+
+void ScaleWithSatScalar(float scale, AudioFrame* frame) {
+  for (size_t i = 0; i < frame->samples_per_channel_ * frame->num_channels_;
+       i++) {
+    int32_t temp_data = static_cast<int32_t>(scale * frame->data_[i]);
+    if (temp_data < -32768) {
+      frame->data_[i] = -32768;
+    } else if (temp_data > 32767) {
+      frame->data_[i] = 32767;
+    } else {
+      frame->data_[i] = static_cast<int16_t>(temp_data);
+    }
+  }
+}
+
+TEST_F(AudioFrameOperationsTest, MatchesScalarForAllLengths) {
+  AudioFrame reference_frame;
+  for (size_t samples_per_channel : kSamplesPerChannel) {
+    SCOPED_TRACE(samples_per_channel);
+    frame_.samples_per_channel_ = samples_per_channel;
+
+    frame_.num_channels_ = 1;
+    SetScrambledFrameData(&frame_);
+    reference_frame.CopyFrom(frame_);
+    EXPECT_EQ(0, AudioFrameOperations::MonoToStereo(&frame_));
+    MonoToStereoScalar(&reference_frame);
+    VerifyFramesAreEqual(reference_frame, frame_);
+
+    SetScrambledFrameData(&frame_);
+    reference_frame.CopyFrom(frame_);
+    AudioFrameOperations::SwapStereoChannels(&frame_);
+    SwapStereoChannelsScalar(&reference_frame);
+    VerifyFramesAreEqual(reference_frame, frame_);
+
+    EXPECT_EQ(0, AudioFrameOperations::Scale(0.7f, -0.9f, frame_));
+    ScaleScalar(0.7f, -0.9f, &reference_frame);
+    VerifyFramesAreEqual(reference_frame, frame_);
+
+    // Scaled up so that both channels saturate.
+    EXPECT_EQ(0, AudioFrameOperations::Scale(2.5f, -3.1f, frame_));
+    ScaleScalar(2.5f, -3.1f, &reference_frame);
+    VerifyFramesAreEqual(reference_frame, frame_);
+
+    EXPECT_EQ(0, AudioFrameOperations::ScaleWithSat(1.7f, frame_));
+    ScaleWithSatScalar(1.7f, &reference_frame);
+    VerifyFramesAreEqual(reference_frame, frame_);
+
+    SetScrambledFrameData(&frame_);
+    reference_frame.CopyFrom(frame_);
+    EXPECT_EQ(0, AudioFrameOperations::StereoToMono(&frame_));
+    StereoToMonoScalar(&reference_frame);
+    VerifyFramesAreEqual(reference_frame, frame_);
+
+    EXPECT_EQ(0, AudioFrameOperations::ScaleWithSat(-0.3f, frame_));
+    ScaleWithSatScalar(-0.3f, &reference_frame);
+    VerifyFramesAreEqual(reference_frame, frame_);
+  }
+}
+
+void MonoToStereoOperation(AudioFrame* frame) {
+  frame->num_channels_ = 1;
+  AudioFrameOperations::MonoToStereo(frame);
+}
+
+void MonoToStereoScalarOperation(AudioFrame* frame) {
+  frame->num_channels_ = 1;
+  MonoToStereoScalar(frame);
+}
+
+void StereoToMonoOperation(AudioFrame* frame) {
+  frame->num_channels_ = 2;
+  AudioFrameOperations::StereoToMono(frame);
+}
+
+void StereoToMonoScalarOperation(AudioFrame* frame) {
+  frame->num_channels_ = 2;
+  StereoToMonoScalar(frame);
+}
+
+void SwapStereoChannelsOperation(AudioFrame* frame) {
+  AudioFrameOperations::SwapStereoChannels(frame);
+}
+
+void ScaleOperation(AudioFrame* frame) {
+  AudioFrameOperations::Scale(0.5f, 0.5f, *frame);
+}
+
+void ScaleScalarOperation(AudioFrame* frame) {
+  ScaleScalar(0.5f, 0.5f, frame);
+}
+
+void ScaleWithSatOperation(AudioFrame* frame) {
+  AudioFrameOperations::ScaleWithSat(1.5f, *frame);
+}
+
+void ScaleWithSatScalarOperation(AudioFrame* frame) {
+  ScaleWithSatScalar(1.5f, frame);
+}
+
+void MuteOperation(AudioFrame* frame) {
+  AudioFrameOperations::Mute(*frame);
+}
+
+struct BenchmarkedOperation {
+  const char* name;
+  // Channels of the frames the operation takes: 1, 2 or 0 for both.
+  int num_channels;
+  void (*scalar)(AudioFrame*);
+  void (*dispatched)(AudioFrame*);
+};
+
+double MicrosecondsPerCall(void (*operation)(AudioFrame*),
+                           AudioFrame* frame,
+                           int iterations) {
+  const size_t num_channels = frame->num_channels_;
+  const TickTime start = TickTime::Now();
+  for (int i = 0; i < iterations; ++i) {
+    frame->num_channels_ = num_channels;
+    operation(frame);
+  }
+  return static_cast<double>((TickTime::Now() - start).Microseconds()) /
+         iterations;
+}
+
+// Times the operations against the scalar loops on 10 ms frames at every
+// sample rate, for the channel counts they take.
+TEST_F(AudioFrameOperationsTest, DISABLED_Benchmark) {
+  const int kIterations = 2000;
+  const size_t kSamplesPer10Ms[] = {80, 160, 320, 441, 480};
+  const BenchmarkedOperation kOperations[] = {
+      {"MonoToStereo", 1, MonoToStereoScalarOperation, MonoToStereoOperation},
+      {"StereoToMono", 2, StereoToMonoScalarOperation, StereoToMonoOperation},
+      {"SwapStereoChannels", 2, SwapStereoChannelsScalar,
+       SwapStereoChannelsOperation},
+      {"Scale", 2, ScaleScalarOperation, ScaleOperation},
+      {"ScaleWithSat", 0, ScaleWithSatScalarOperation, ScaleWithSatOperation},
+      // Mute() has no scalar loop; it is a memset().
+      {"Mute", 0, MuteOperation, MuteOperation},
+  };
+
+  printf("Benchmarking %d iterations:\n", kIterations);
+  for (const BenchmarkedOperation& operation : kOperations) {
+    for (size_t samples_per_channel : kSamplesPer10Ms) {
+      for (size_t num_channels = 1; num_channels <= 2; ++num_channels) {
+        if (operation.num_channels != 0 &&
+            static_cast<size_t>(operation.num_channels) != num_channels) {
+          continue;
+        }
+        frame_.samples_per_channel_ = samples_per_channel;
+        frame_.num_channels_ = num_channels;
+        SetScrambledFrameData(&frame_);
+        const double scalar_us =
+            MicrosecondsPerCall(operation.scalar, &frame_, kIterations);
+        const double dispatched_us =
+            MicrosecondsPerCall(operation.dispatched, &frame_, kIterations);
+        printf("%s %3d x %d: scalar %.3f us, dispatched %.3f us (%.2fx)\n",
+               operation.name, static_cast<int>(samples_per_channel),
+               static_cast<int>(num_channels), scalar_us, dispatched_us,
+               dispatched_us > 0 ? scalar_us / dispatched_us : 0.0);
+      }
+    }
+  }
+}
+
 }  // namespace
 }  // namespace webrtc
@@ -11,6 +11,7 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 #include "webrtc/system_wrappers/include/tick_util.h"
@@ -19,11 +20,14 @@ namespace webrtc {
 
 VPMContentAnalysis::VPMContentAnalysis(bool runtime_cpu_detection)
     : orig_frame_(NULL),
-      prev_frame_(NULL),
+      prev_samples_(NULL),
       width_(0),
       height_(0),
       skip_num_(1),
       border_(8),
+      sample_width_(0),
+      num_sample_rows_(0),
+      compute_time_us_(0),
       motion_magnitude_(0.0f),
       spatial_pred_err_(0.0f),
       spatial_pred_err_h_(0.0f),
@@ -36,7 +40,10 @@ VPMContentAnalysis::VPMContentAnalysis(bool runtime_cpu_detection)
 
   if (runtime_cpu_detection) {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
-    if (WebRtc_GetCPUInfo(kSSE2)) {
+    if (WebRtc_GetCPUInfo(kAVX2)) {
+      ComputeSpatialMetrics = &VPMContentAnalysis::ComputeSpatialMetrics_AVX2;
+      TemporalDiffMetric = &VPMContentAnalysis::TemporalDiffMetric_AVX2;
+    } else if (WebRtc_GetCPUInfo(kSSE2)) {
       ComputeSpatialMetrics = &VPMContentAnalysis::ComputeSpatialMetrics_SSE2;
       TemporalDiffMetric = &VPMContentAnalysis::TemporalDiffMetric_SSE2;
     }
@@ -54,6 +61,8 @@ VideoContentMetrics* VPMContentAnalysis::ComputeContentMetrics(
   if (inputFrame.IsZeroSize())
     return NULL;
 
+  const TickTime time_start = TickTime::Now();
+
   // Init if needed (native dimension change).
   if (width_ != inputFrame.width() || height_ != inputFrame.height()) {
     if (VPM_OK != Initialize(inputFrame.width(), inputFrame.height()))
@@ -65,15 +74,16 @@ VideoContentMetrics* VPMContentAnalysis::ComputeContentMetrics(
   // Compute spatial metrics: 3 spatial prediction errors.
   (this->*ComputeSpatialMetrics)();
 
-  // Compute motion metrics
+  // Compute motion metrics. This also saves the samples of the current frame
+  // it needs for the next one.
   if (first_frame_ == false)
     ComputeMotionMetrics();
-
-  // Saving current frame as previous one: Y only.
-  memcpy(prev_frame_, orig_frame_, width_ * height_);
+  else
+    SaveSamples();
 
   first_frame_ = false;
   ca_Init_ = true;
+  compute_time_us_ = (TickTime::Now() - time_start).Microseconds();
 
   return ContentMetrics();
 }
@@ -84,9 +94,9 @@ int32_t VPMContentAnalysis::Release() {
     content_metrics_ = NULL;
   }
 
-  if (prev_frame_ != NULL) {
-    delete[] prev_frame_;
-    prev_frame_ = NULL;
+  if (prev_samples_ != NULL) {
+    delete[] prev_samples_;
+    prev_samples_ = NULL;
   }
 
   width_ = 0;
@@ -118,8 +128,9 @@ int32_t VPMContentAnalysis::Initialize(int width, int height) {
     delete content_metrics_;
   }
 
-  if (prev_frame_ != NULL) {
-    delete[] prev_frame_;
+  if (prev_samples_ != NULL) {
+    delete[] prev_samples_;
+    prev_samples_ = NULL;
   }
 
   // Spatial Metrics don't work on a border of 8. Minimum processing
@@ -134,13 +145,26 @@ int32_t VPMContentAnalysis::Initialize(int width, int height) {
     return VPM_MEMORY;
   }
 
-  prev_frame_ = new uint8_t[width_ * height_];  // Y only.
-  if (prev_frame_ == NULL)
+  // Only the Y pixels the temporal metric looks at are kept.
+  sample_width_ = (width_ - 2 * border_) & -16;
+  num_sample_rows_ = (height_ - 2 * border_ + skip_num_ - 1) / skip_num_;
+  prev_samples_ = new uint8_t[sample_width_ * num_sample_rows_];
+  if (prev_samples_ == NULL)
     return VPM_MEMORY;
 
   return VPM_OK;
 }
 
+void VPMContentAnalysis::SaveSamples() {
+  const uint8_t* line = orig_frame_ + border_ * width_ + border_;
+  uint8_t* samples = prev_samples_;
+  for (int i = 0; i < num_sample_rows_; ++i) {
+    memcpy(samples, line, sample_width_);
+    line += width_ * skip_num_;
+    samples += sample_width_;
+  }
+}
+
 // Compute motion metrics: magnitude over non-zero motion vectors,
 //  and size of zero cluster
 int32_t VPMContentAnalysis::ComputeMotionMetrics() {
@@ -164,6 +188,7 @@ int32_t VPMContentAnalysis::TemporalDiffMetric_C() {
 
   uint32_t num_pixels = 0;  // Counter for # of pixels.
   const int width_end = ((width_ - 2 * border_) & -16) + border_;
+  uint8_t* prev_sample = prev_samples_;
 
   for (int i = border_; i < sizei - border_; i += skip_num_) {
     for (int j = border_; j < width_end; j++) {
@@ -171,7 +196,9 @@ int32_t VPMContentAnalysis::TemporalDiffMetric_C() {
       int ssn = i * sizej + j;
 
       uint8_t currPixel = orig_frame_[ssn];
-      uint8_t prevPixel = prev_frame_[ssn];
+      uint8_t prevPixel = *prev_sample;
+      // Keep the current pixel for the next frame.
+      *prev_sample++ = currPixel;
 
       tempDiffSum +=
           static_cast<uint32_t>(abs((int16_t)(currPixel - prevPixel)));
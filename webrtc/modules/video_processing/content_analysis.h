@@ -41,6 +41,9 @@ class VPMContentAnalysis {
   // Output: 0 if OK, negative value upon error
   int32_t Release();
 
+  // Time spent in the last ComputeContentMetrics() call, in microseconds.
+  int64_t compute_time_us() const { return compute_time_us_; }
+
  private:
   // return motion metrics
   VideoContentMetrics* ContentMetrics();
@@ -62,14 +65,26 @@ class VPMContentAnalysis {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
   int32_t ComputeSpatialMetrics_SSE2();
   int32_t TemporalDiffMetric_SSE2();
+  int32_t ComputeSpatialMetrics_AVX2();
+  int32_t TemporalDiffMetric_AVX2();
 #endif
 
+  // Copies the pixels the temporal metric looks at to |prev_samples_|. The
+  // TemporalDiffMetric functions do the same while they read them.
+  void SaveSamples();
+
   const uint8_t* orig_frame_;
-  uint8_t* prev_frame_;
+  // The pixels of the previous frame the temporal metric is computed on:
+  // every |skip_num_|-th row inside the border, |sample_width_| pixels each,
+  // packed one row after the other.
+  uint8_t* prev_samples_;
   int width_;
   int height_;
   int skip_num_;
   int border_;
+  int sample_width_;
+  int num_sample_rows_;
+  int64_t compute_time_us_;
 
   // Content Metrics: Stores the local average of the metrics.
   float motion_magnitude_;    // motion class
@@ -0,0 +1,203 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_processing/content_analysis.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#include <math.h>
+
+namespace webrtc {
+
+namespace {
+
+// Sums the 64 bit lanes of |v|.
+uint64_t SumLanes64(__m256i v) {
+  uint64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), v);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+// Sums the 32 bit lanes of |v|, wrapping around like a uint32_t sum.
+uint32_t SumLanes32(__m256i v) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+  return static_cast<uint32_t>(_mm_cvtsi128_si32(sum));
+}
+
+// Loads 16 pixels widened to 16 bits.
+__m256i LoadWidened(const uint8_t* pixels) {
+  return _mm256_cvtepu8_epi16(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels)));
+}
+
+}  // namespace
+
+int32_t VPMContentAnalysis::TemporalDiffMetric_AVX2() {
+  const uint8_t* imgBufO = orig_frame_ + border_ * width_ + border_;
+  uint8_t* imgBufP = prev_samples_;
+
+  __m256i sad_64 = _mm256_setzero_si256();
+  __m256i sum_64 = _mm256_setzero_si256();
+  __m256i sqsum_64 = _mm256_setzero_si256();
+  const __m256i z = _mm256_setzero_si256();
+
+  for (int i = 0; i < num_sample_rows_; ++i) {
+    __m256i sqsum_32 = _mm256_setzero_si256();
+
+    // Work on 32 pixels at a time, and on the last 16 if the row isn't a
+    // multiple of 32, with the upper lane left zero. As in the SSE2 version
+    // the squares fit a 32 bit accumulator for a row of HD content.
+    for (int j = 0; j < sample_width_; j += 32) {
+      __m256i o;
+      __m256i p;
+      if (j + 32 <= sample_width_) {
+        o = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(imgBufO + j));
+        p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(imgBufP + j));
+        // Keep the current pixels for the next frame.
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(imgBufP + j), o);
+      } else {
+        const __m128i o_128 =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(imgBufO + j));
+        const __m128i p_128 =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(imgBufP + j));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(imgBufP + j), o_128);
+        o = _mm256_inserti128_si256(z, o_128, 0);
+        p = _mm256_inserti128_si256(z, p_128, 0);
+      }
+
+      // Abs pixel difference between frames.
+      sad_64 = _mm256_add_epi64(sad_64, _mm256_sad_epu8(o, p));
+
+      // sum of all pixels in frame
+      sum_64 = _mm256_add_epi64(sum_64, _mm256_sad_epu8(o, z));
+
+      // Squared sum of all pixels in frame.
+      const __m256i olo = _mm256_unpacklo_epi8(o, z);
+      const __m256i ohi = _mm256_unpackhi_epi8(o, z);
+      sqsum_32 = _mm256_add_epi32(sqsum_32, _mm256_madd_epi16(olo, olo));
+      sqsum_32 = _mm256_add_epi32(sqsum_32, _mm256_madd_epi16(ohi, ohi));
+    }
+
+    // Add to 64 bit running sum as to not roll over.
+    sqsum_64 = _mm256_add_epi64(
+        sqsum_64, _mm256_add_epi64(_mm256_unpackhi_epi32(sqsum_32, z),
+                                   _mm256_unpacklo_epi32(sqsum_32, z)));
+
+    imgBufO += width_ * skip_num_;
+    imgBufP += sample_width_;
+  }
+
+  const uint32_t num_pixels = sample_width_ * num_sample_rows_;
+  const uint32_t pixelSum = static_cast<uint32_t>(SumLanes64(sum_64));
+  const uint64_t pixelSqSum = SumLanes64(sqsum_64);
+  const uint32_t tempDiffSum = static_cast<uint32_t>(SumLanes64(sad_64));
+
+  // Default.
+  motion_magnitude_ = 0.0f;
+
+  if (tempDiffSum == 0)
+    return VPM_OK;
+
+  // Normalize over all pixels.
+  const float tempDiffAvg =
+      static_cast<float>(tempDiffSum) / static_cast<float>(num_pixels);
+  const float pixelSumAvg =
+      static_cast<float>(pixelSum) / static_cast<float>(num_pixels);
+  const float pixelSqSumAvg =
+      static_cast<float>(pixelSqSum) / static_cast<float>(num_pixels);
+  float contrast = pixelSqSumAvg - (pixelSumAvg * pixelSumAvg);
+
+  if (contrast > 0.0) {
+    contrast = sqrt(contrast);
+    motion_magnitude_ = tempDiffAvg / contrast;
+  }
+
+  return VPM_OK;
+}
+
+int32_t VPMContentAnalysis::ComputeSpatialMetrics_AVX2() {
+  const uint8_t* imgBuf = orig_frame_ + border_ * width_;
+  const __m256i ones = _mm256_set1_epi16(1);
+
+  // The errors of each 16 pixels are widened to 32 bits right away, so
+  // unlike the 16 bit row sums of the SSE2 version they can't roll over and
+  // the sums always match the C version.
+  __m256i se_32 = _mm256_setzero_si256();
+  __m256i sev_32 = _mm256_setzero_si256();
+  __m256i seh_32 = _mm256_setzero_si256();
+  __m256i msa_32 = _mm256_setzero_si256();
+
+  // skip_num_ is also used to reduce the number of rows
+  for (int32_t i = 0; i < (height_ - 2 * border_); i += skip_num_) {
+    const uint8_t* lineTop = imgBuf - width_ + border_;
+    const uint8_t* lineCen = imgBuf + border_;
+    const uint8_t* lineBot = imgBuf + width_ + border_;
+
+    for (int32_t j = 0; j < sample_width_; j += 16) {
+      const __m256i t = LoadWidened(lineTop);
+      const __m256i l = LoadWidened(lineCen - 1);
+      const __m256i c = LoadWidened(lineCen);
+      const __m256i r = LoadWidened(lineCen + 1);
+      const __m256i b = LoadWidened(lineBot);
+
+      lineTop += 16;
+      lineCen += 16;
+      lineBot += 16;
+
+      const __m256i lr = _mm256_add_epi16(l, r);
+      const __m256i tb = _mm256_add_epi16(t, b);
+      const __m256i c2 = _mm256_slli_epi16(c, 1);
+      const __m256i c4 = _mm256_slli_epi16(c, 2);
+
+      const __m256i se =
+          _mm256_abs_epi16(_mm256_sub_epi16(c4, _mm256_add_epi16(lr, tb)));
+      const __m256i sev = _mm256_abs_epi16(_mm256_sub_epi16(c2, tb));
+      const __m256i seh = _mm256_abs_epi16(_mm256_sub_epi16(c2, lr));
+
+      se_32 = _mm256_add_epi32(se_32, _mm256_madd_epi16(se, ones));
+      sev_32 = _mm256_add_epi32(sev_32, _mm256_madd_epi16(sev, ones));
+      seh_32 = _mm256_add_epi32(seh_32, _mm256_madd_epi16(seh, ones));
+      // running sum of all pixels
+      msa_32 = _mm256_add_epi32(msa_32, _mm256_madd_epi16(c, ones));
+    }
+
+    imgBuf += width_ * skip_num_;
+  }
+
+  const uint32_t spatialErrSum = SumLanes32(se_32);
+  const uint32_t spatialErrVSum = SumLanes32(sev_32);
+  const uint32_t spatialErrHSum = SumLanes32(seh_32);
+  const uint32_t pixelMSA = SumLanes32(msa_32);
+
+  // Normalize over all pixels.
+  const float spatialErr = static_cast<float>(spatialErrSum >> 2);
+  const float spatialErrH = static_cast<float>(spatialErrHSum >> 1);
+  const float spatialErrV = static_cast<float>(spatialErrVSum >> 1);
+  const float norm = static_cast<float>(pixelMSA);
+
+  // 2X2:
+  spatial_pred_err_ = spatialErr / norm;
+
+  // 1X2:
+  spatial_pred_err_h_ = spatialErrH / norm;
+
+  // 2X1:
+  spatial_pred_err_v_ = spatialErrV / norm;
+
+  return VPM_OK;
+}
+
+}  // namespace webrtc
@@ -18,7 +18,7 @@ namespace webrtc {
 int32_t VPMContentAnalysis::TemporalDiffMetric_SSE2() {
   uint32_t num_pixels = 0;  // counter for # of pixels
   const uint8_t* imgBufO = orig_frame_ + border_ * width_ + border_;
-  const uint8_t* imgBufP = prev_frame_ + border_ * width_ + border_;
+  uint8_t* imgBufP = prev_samples_;
 
   const int32_t width_end = ((width_ - 2 * border_) & -16) + border_;
 
@@ -31,7 +31,7 @@ int32_t VPMContentAnalysis::TemporalDiffMetric_SSE2() {
     __m128i sqsum_32 = _mm_setzero_si128();
 
     const uint8_t* lineO = imgBufO;
-    const uint8_t* lineP = imgBufP;
+    uint8_t* lineP = imgBufP;
 
     // Work on 16 pixels at a time.  For HD content with a width of 1920
     // this loop will run ~67 times (depending on border).  Maximum for
@@ -44,6 +44,8 @@ int32_t VPMContentAnalysis::TemporalDiffMetric_SSE2() {
     for (uint16_t j = 0; j < width_end - border_; j += 16) {
       const __m128i o = _mm_loadu_si128((__m128i*)(lineO));
       const __m128i p = _mm_loadu_si128((__m128i*)(lineP));
+      // Keep the current pixels for the next frame.
+      _mm_storeu_si128((__m128i*)(lineP), o);
 
       lineO += 16;
       lineP += 16;
@@ -71,7 +73,7 @@ int32_t VPMContentAnalysis::TemporalDiffMetric_SSE2() {
                                               _mm_unpacklo_epi32(sqsum_32, z)));
 
     imgBufO += width_ * skip_num_;
-    imgBufP += width_ * skip_num_;
+    imgBufP += sample_width_;
     num_pixels += (width_end - border_);
   }
 
@@ -10,13 +10,68 @@
 
 #include "webrtc/modules/video_processing/spatial_resampler.h"
 
+#include <algorithm>
+
+#include "libyuv/scale.h"  // NOLINT
+
+#include "webrtc/system_wrappers/include/cpu_info.h"
+
 namespace webrtc {
 
+namespace {
+
+int GreatestCommonDivisor(int a, int b) {
+  while (b != 0) {
+    int t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+int ScalingThreads(int max_threads) {
+  if (max_threads > 0)
+    return max_threads;
+  return std::min(static_cast<int>(CpuInfo::DetectNumberOfCores()),
+                  VPMSimpleSpatialResampler::kMaxThreads);
+}
+
+}  // namespace
+
+const int VPMSimpleSpatialResampler::kMinPixelsForBands;
+const int VPMSimpleSpatialResampler::kMaxThreads;
+
+// The planes of a cropped source and a destination frame, split in bands of
+// whole destination rows. Band boundaries are placed where a destination row
+// starts exactly on a source row, both even so the chroma planes split too.
+// See ResampleFrame() for when this matches scaling the whole frame.
+struct VPMSimpleSpatialResampler::ScaleJob {
+  const uint8_t* src[kNumOfPlanes];
+  int src_stride[kNumOfPlanes];
+  int src_width;
+  int src_height;
+  uint8_t* dst[kNumOfPlanes];
+  int dst_stride[kNumOfPlanes];
+  int dst_width;
+  int dst_height;
+  // Destination and source rows per unit the bands are made of.
+  int dst_rows_per_unit;
+  int src_rows_per_unit;
+  int num_units;
+  int num_bands;
+};
+
 VPMSimpleSpatialResampler::VPMSimpleSpatialResampler()
     : resampling_mode_(kFastRescaling),
       target_width_(0),
       target_height_(0),
-      scaler_() {}
+      max_threads_(ScalingThreads(0)) {}
+
+VPMSimpleSpatialResampler::VPMSimpleSpatialResampler(int max_threads)
+    : resampling_mode_(kFastRescaling),
+      target_width_(0),
+      target_height_(0),
+      max_threads_(ScalingThreads(max_threads)) {}
 
 VPMSimpleSpatialResampler::~VPMSimpleSpatialResampler() {}
 
@@ -56,26 +111,110 @@ int32_t VPMSimpleSpatialResampler::ResampleFrame(const VideoFrame& inFrame,
     return VPM_OK;
   }
 
-  // Setting scaler
-  // TODO(mikhal/marpan): Should we allow for setting the filter mode in
-  // _scale.Set() with |resampling_mode_|?
-  int ret_val = 0;
-  ret_val = scaler_.Set(inFrame.width(), inFrame.height(), target_width_,
-                        target_height_, kI420, kI420, kScaleBox);
-  if (ret_val < 0)
-    return ret_val;
+  // TODO(mikhal/marpan): Should we allow for setting the filter mode with
+  // |resampling_mode_|?
+  const int src_width = inFrame.width();
+  const int src_height = inFrame.height();
+  if (inFrame.IsZeroSize() || target_width_ < 1 || target_height_ < 1)
+    return VPM_PARAMETER_ERROR;
 
-  ret_val = scaler_.Scale(inFrame, outFrame);
+  // Making sure that destination frame is of sufficient size. The buffer
+  // comes from the pool, so the previous output stays intact for as long as
+  // someone holds a reference to it.
+  outFrame->set_video_frame_buffer(
+      buffer_pool_.CreateBuffer(target_width_, target_height_));
+
+  // We want to preserve aspect ratio instead of stretching the frame.
+  // Therefore, we need to crop the source frame. Calculate the largest center
+  // aligned region of the source frame that can be used.
+  ScaleJob job;
+  job.src_width =
+      std::min(src_width, target_width_ * src_height / target_height_);
+  job.src_height =
+      std::min(src_height, target_height_ * src_width / target_width_);
+  // Make sure the offsets are even to avoid rounding errors for the U/V planes.
+  const int src_offset_x = ((src_width - job.src_width) / 2) & ~1;
+  const int src_offset_y = ((src_height - job.src_height) / 2) & ~1;
+  for (int i = 0; i < kNumOfPlanes; ++i) {
+    const PlaneType plane = static_cast<PlaneType>(i);
+    const int shift = plane == kYPlane ? 0 : 1;
+    job.src_stride[i] = inFrame.stride(plane);
+    job.src[i] = inFrame.buffer(plane) +
+                 (src_offset_y >> shift) * job.src_stride[i] +
+                 (src_offset_x >> shift);
+    job.dst_stride[i] = outFrame->stride(plane);
+    job.dst[i] = outFrame->buffer(plane);
+  }
+  job.dst_width = target_width_;
+  job.dst_height = target_height_;
+
+  const int gcd = GreatestCommonDivisor(job.dst_height, job.src_height);
+  job.dst_rows_per_unit = job.dst_height / gcd;
+  job.src_rows_per_unit = job.src_height / gcd;
+  if ((job.dst_rows_per_unit | job.src_rows_per_unit) & 1) {
+    job.dst_rows_per_unit *= 2;
+    job.src_rows_per_unit *= 2;
+  }
+  job.num_units = job.dst_height / job.dst_rows_per_unit;
+  job.num_bands = 1;
+  // libyuv steps through the source rows in 16.16 fixed point, so a band only
+  // starts on the same source position as in the whole frame if the step is
+  // exact, i.e. a unit's source rows are a whole number of 1/65536ths of its
+  // destination rows. The chroma planes only have the luma ratio when both
+  // heights are even. Upscaling filters read past the source rows of a band,
+  // so only downscaling is split.
+  const bool exact_step =
+      (static_cast<int64_t>(job.src_rows_per_unit) << 16) %
+          job.dst_rows_per_unit == 0;
+  if (max_threads_ > 1 && src_width * src_height >= kMinPixelsForBands &&
+      job.dst_height <= job.src_height && exact_step &&
+      job.dst_height % 2 == 0 && job.src_height % 2 == 0) {
+    job.num_bands = std::max(1, std::min(max_threads_, job.num_units));
+  }
+
+  if (job.num_bands > 1) {
+    if (!workers_) {
+      // Same priority as the encoder thread, which does the preprocessing.
+      workers_.reset(new RowBandWorkers(max_threads_, "ResamplerWorker",
+                                        rtc::kHighPriority));
+    }
+    workers_->Run(&ScaleBand, &job, job.num_bands);
+  } else {
+    ScaleBand(&job, 0);
+  }
 
   // Setting time parameters to the output frame.
-  // Timestamp will be reset in Scale call above, so we should set it after.
   outFrame->set_timestamp(inFrame.timestamp());
   outFrame->set_render_time_ms(inFrame.render_time_ms());
+  return VPM_OK;
+}
 
-  if (ret_val == 0)
-    return VPM_OK;
-  else
-    return VPM_SCALE_ERROR;
+void VPMSimpleSpatialResampler::ScaleBand(void* obj, int band) {
+  const ScaleJob* job = static_cast<const ScaleJob*>(obj);
+  const int first_unit = band * job->num_units / job->num_bands;
+  const int dst_row = first_unit * job->dst_rows_per_unit;
+  const int src_row = first_unit * job->src_rows_per_unit;
+  int dst_rows = job->dst_height - dst_row;
+  int src_rows = job->src_height - src_row;
+  if (band + 1 < job->num_bands) {
+    const int end_unit = (band + 1) * job->num_units / job->num_bands;
+    dst_rows = (end_unit - first_unit) * job->dst_rows_per_unit;
+    src_rows = (end_unit - first_unit) * job->src_rows_per_unit;
+  }
+  const uint8_t* src[kNumOfPlanes];
+  uint8_t* dst[kNumOfPlanes];
+  for (int i = 0; i < kNumOfPlanes; ++i) {
+    const int shift = i == kYPlane ? 0 : 1;
+    src[i] = job->src[i] + (src_row >> shift) * job->src_stride[i];
+    dst[i] = job->dst[i] + (dst_row >> shift) * job->dst_stride[i];
+  }
+  libyuv::I420Scale(src[kYPlane], job->src_stride[kYPlane], src[kUPlane],
+                    job->src_stride[kUPlane], src[kVPlane],
+                    job->src_stride[kVPlane], job->src_width, src_rows,
+                    dst[kYPlane], job->dst_stride[kYPlane], dst[kUPlane],
+                    job->dst_stride[kUPlane], dst[kVPlane],
+                    job->dst_stride[kVPlane], job->dst_width, dst_rows,
+                    libyuv::kFilterBox);
 }
 
 int32_t VPMSimpleSpatialResampler::TargetHeight() {
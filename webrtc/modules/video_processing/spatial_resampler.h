@@ -13,9 +13,12 @@
 
 #include "webrtc/typedefs.h"
 
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/video_processing/include/video_processing_defines.h"
+#include "webrtc/system_wrappers/include/row_band_workers.h"
 
+#include "webrtc/common_video/include/i420_buffer_pool.h"
 #include "webrtc/common_video/libyuv/include/scaler.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 
@@ -35,9 +38,16 @@ class VPMSpatialResampler {
   virtual bool ApplyResample(int32_t width, int32_t height) = 0;
 };
 
+// Output frames come from a buffer pool, so a buffer is only reused once
+// nothing else holds on to it. Large frames are scaled in horizontal bands on
+// several threads when the bands give the same output as scaling the whole
+// frame, e.g. when halving or quartering it.
 class VPMSimpleSpatialResampler : public VPMSpatialResampler {
  public:
   VPMSimpleSpatialResampler();
+  // |max_threads| caps the threads used for scaling, the calling one
+  // included; 0 picks one per core, up to |kMaxThreads|.
+  explicit VPMSimpleSpatialResampler(int max_threads);
   ~VPMSimpleSpatialResampler();
   virtual int32_t SetTargetFrameSize(int32_t width, int32_t height);
   virtual void SetInputFrameResampleMode(VideoFrameResampling resampling_mode);
@@ -48,11 +58,21 @@ class VPMSimpleSpatialResampler : public VPMSpatialResampler {
   virtual int32_t TargetHeight();
   virtual bool ApplyResample(int32_t width, int32_t height);
 
+  // Frames with fewer input pixels are not worth splitting.
+  static const int kMinPixelsForBands = 640 * 480;
+  static const int kMaxThreads = 4;
+
  private:
+  struct ScaleJob;
+  static void ScaleBand(void* obj, int band);
+
   VideoFrameResampling resampling_mode_;
   int32_t target_width_;
   int32_t target_height_;
-  Scaler scaler_;
+  int max_threads_;
+  I420BufferPool buffer_pool_;
+  // Created for the first frame large enough to be split.
+  rtc::scoped_ptr<RowBandWorkers> workers_;
 };
 
 }  // namespace webrtc
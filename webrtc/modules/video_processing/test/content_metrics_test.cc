@@ -9,13 +9,63 @@
  */
 
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include <math.h>
+#include <stdlib.h>
+
 #include "webrtc/modules/video_processing/include/video_processing.h"
 #include "webrtc/modules/video_processing/content_analysis.h"
+#include "webrtc/modules/video_processing/spatial_resampler.h"
 #include "webrtc/modules/video_processing/test/video_processing_unittest.h"
 #include "webrtc/test/testsupport/gtest_disable.h"
 
 namespace webrtc {
 
+namespace {
+
+// The motion metric computed the way VPMContentAnalysis did when it kept a
+// full copy of the previous frame.
+float FullFrameMotionMagnitude(const VideoFrame& prev_frame,
+                               const VideoFrame& frame) {
+  const int kBorder = 8;
+  const int width = frame.width();
+  const int height = frame.height();
+  int skip_num = 1;
+  if (height >= 576 && width >= 704)
+    skip_num = 2;
+  if (height >= 1080 && width >= 1920)
+    skip_num = 4;
+  const int width_end = ((width - 2 * kBorder) & -16) + kBorder;
+  uint32_t temp_diff_sum = 0;
+  uint32_t pixel_sum = 0;
+  uint64_t pixel_sq_sum = 0;
+  uint32_t num_pixels = 0;
+  for (int i = kBorder; i < height - kBorder; i += skip_num) {
+    const uint8_t* curr = frame.buffer(kYPlane) + i * frame.stride(kYPlane);
+    const uint8_t* prev =
+        prev_frame.buffer(kYPlane) + i * prev_frame.stride(kYPlane);
+    for (int j = kBorder; j < width_end; ++j) {
+      ++num_pixels;
+      temp_diff_sum += abs(curr[j] - prev[j]);
+      pixel_sum += curr[j];
+      pixel_sq_sum += curr[j] * curr[j];
+    }
+  }
+  if (temp_diff_sum == 0)
+    return 0.0f;
+  const float temp_diff_avg =
+      static_cast<float>(temp_diff_sum) / static_cast<float>(num_pixels);
+  const float pixel_sum_avg =
+      static_cast<float>(pixel_sum) / static_cast<float>(num_pixels);
+  const float pixel_sq_sum_avg =
+      static_cast<float>(pixel_sq_sum) / static_cast<float>(num_pixels);
+  float contrast = pixel_sq_sum_avg - (pixel_sum_avg * pixel_sum_avg);
+  if (contrast <= 0.0)
+    return 0.0f;
+  return temp_diff_avg / static_cast<float>(sqrt(contrast));
+}
+
+}  // namespace
+
 TEST_F(VideoProcessingTest, DISABLED_ON_IOS(ContentAnalysis)) {
   VPMContentAnalysis ca__c(false);
   VPMContentAnalysis ca__sse(true);
@@ -42,4 +92,89 @@ TEST_F(VideoProcessingTest, DISABLED_ON_IOS(ContentAnalysis)) {
   ASSERT_NE(0, feof(source_file_)) << "Error reading source file";
 }
 
+// Runs the C and the optimized analysis on foreman_cif and on a 1080p upscale
+// of it, where only every 4th row is looked at. Both are checked against
+// the motion metric computed from full frames.
+TEST_F(VideoProcessingTest, DISABLED_ON_IOS(ContentAnalysisSampledRows)) {
+  enum { kNumFrames = 30 };
+  const int kSizes[][2] = {{352, 288}, {1920, 1080}};
+  rtc::scoped_ptr<uint8_t[]> video_buffer(new uint8_t[frame_length_]);
+  for (const auto& size : kSizes) {
+    rewind(source_file_);
+    VPMSimpleSpatialResampler upscaler(1);
+    upscaler.SetInputFrameResampleMode(kBox);
+    ASSERT_EQ(VPM_OK, upscaler.SetTargetFrameSize(size[0], size[1]));
+    VPMContentAnalysis ca_c(false);
+    VPMContentAnalysis ca_simd(true);
+    VideoFrame frames[2];
+    for (int frame = 0; frame < kNumFrames; ++frame) {
+      ASSERT_EQ(frame_length_,
+                fread(video_buffer.get(), 1, frame_length_, source_file_));
+      EXPECT_EQ(0, ConvertToI420(kI420, video_buffer.get(), 0, 0, width_,
+                                 height_, 0, kVideoRotation_0, &video_frame_));
+      VideoFrame& current = frames[frame % 2];
+      const VideoFrame& previous = frames[(frame + 1) % 2];
+      if (size[0] != width_ || size[1] != height_) {
+        ASSERT_EQ(VPM_OK, upscaler.ResampleFrame(video_frame_, &current));
+      } else {
+        ASSERT_EQ(0, current.CopyFrame(video_frame_));
+      }
+      VideoContentMetrics* metrics_c = ca_c.ComputeContentMetrics(current);
+      VideoContentMetrics* metrics_simd =
+          ca_simd.ComputeContentMetrics(current);
+      ASSERT_TRUE(metrics_c != NULL);
+      ASSERT_TRUE(metrics_simd != NULL);
+
+      ASSERT_EQ(metrics_c->spatial_pred_err, metrics_simd->spatial_pred_err);
+      ASSERT_EQ(metrics_c->spatial_pred_err_v,
+                metrics_simd->spatial_pred_err_v);
+      ASSERT_EQ(metrics_c->spatial_pred_err_h,
+                metrics_simd->spatial_pred_err_h);
+      ASSERT_EQ(metrics_c->motion_magnitude, metrics_simd->motion_magnitude);
+      if (frame > 0) {
+        ASSERT_EQ(FullFrameMotionMagnitude(previous, current),
+                  metrics_c->motion_magnitude);
+      }
+    }
+  }
+}
+
+// Prints the time per frame of the C and the optimized analysis on
+// foreman_cif and on a 1080p upscale of it. It only measures time, so it is
+// disabled by default.
+TEST_F(VideoProcessingTest, DISABLED_ContentAnalysisCost) {
+  enum { kNumFrames = 30 };
+  const int kSizes[][2] = {{352, 288}, {1920, 1080}};
+  rtc::scoped_ptr<uint8_t[]> video_buffer(new uint8_t[frame_length_]);
+  for (const auto& size : kSizes) {
+    rewind(source_file_);
+    VPMSimpleSpatialResampler upscaler(1);
+    upscaler.SetInputFrameResampleMode(kBox);
+    ASSERT_EQ(VPM_OK, upscaler.SetTargetFrameSize(size[0], size[1]));
+    VPMContentAnalysis ca_c(false);
+    VPMContentAnalysis ca_simd(true);
+    VideoFrame frame;
+    int64_t runtime_us[2] = {0, 0};
+    for (int i = 0; i < kNumFrames; ++i) {
+      ASSERT_EQ(frame_length_,
+                fread(video_buffer.get(), 1, frame_length_, source_file_));
+      EXPECT_EQ(0, ConvertToI420(kI420, video_buffer.get(), 0, 0, width_,
+                                 height_, 0, kVideoRotation_0, &video_frame_));
+      if (size[0] != width_ || size[1] != height_) {
+        ASSERT_EQ(VPM_OK, upscaler.ResampleFrame(video_frame_, &frame));
+      } else {
+        ASSERT_EQ(0, frame.CopyFrame(video_frame_));
+      }
+      ASSERT_TRUE(ca_c.ComputeContentMetrics(frame) != NULL);
+      runtime_us[0] += ca_c.compute_time_us();
+      ASSERT_TRUE(ca_simd.ComputeContentMetrics(frame) != NULL);
+      runtime_us[1] += ca_simd.compute_time_us();
+    }
+    printf("Content analysis of %dx%d: %d us / frame in C, %d us / frame "
+           "optimized\n",
+           size[0], size[1], static_cast<int>(runtime_us[0] / kNumFrames),
+           static_cast<int>(runtime_us[1] / kNumFrames));
+  }
+}
+
 }  // namespace webrtc
@@ -0,0 +1,201 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/base/random.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/video_processing/spatial_resampler.h"
+#include "webrtc/modules/video_processing/test/video_processing_unittest.h"
+#include "webrtc/modules/video_processing/video_denoiser.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/include/tick_util.h"
+#include "webrtc/test/testsupport/gtest_disable.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "webrtc/modules/video_processing/util/denoiser_filter_avx2.h"
+#include "webrtc/modules/video_processing/util/denoiser_filter_sse2.h"
+#endif
+
+namespace webrtc {
+
+namespace {
+
+bool PlanesEqual(const VideoFrame& frame1, const VideoFrame& frame2) {
+  for (int i = 0; i < kNumOfPlanes; ++i) {
+    const PlaneType plane = static_cast<PlaneType>(i);
+    const int shift = plane == kYPlane ? 0 : 1;
+    const int width = (frame1.width() + shift) >> shift;
+    const int height = (frame1.height() + shift) >> shift;
+    for (int row = 0; row < height; ++row) {
+      if (memcmp(frame1.buffer(plane) + row * frame1.stride(plane),
+                 frame2.buffer(plane) + row * frame2.stride(plane),
+                 width) != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(DenoiserFilterTest, AVX2MatchesSSE2) {
+  if (!WebRtc_GetCPUInfo(kAVX2))
+    return;
+  DenoiserFilterSSE2 filter_sse2;
+  DenoiserFilterAVX2 filter_avx2;
+  const int kStride = 32;
+  uint8_t src[16 * kStride];
+  uint8_t prev[16 * kStride];
+  uint8_t out_sse2[16 * 16];
+  uint8_t out_avx2[16 * 16];
+  Random random(1234);
+  // Noise levels from what is always filtered to what is always copied, to
+  // hit the adjustment pass in between as well.
+  const int kNoiseLevels[] = {2, 6, 12, 20, 40, 255};
+  for (int noise : kNoiseLevels) {
+    for (int run = 0; run < 200; ++run) {
+      for (int i = 0; i < 16 * kStride; ++i) {
+        src[i] = random.Rand<uint8_t>();
+        const int value = src[i] + random.Rand(-noise, noise);
+        prev[i] = static_cast<uint8_t>(std::max(0, std::min(255, value)));
+      }
+      const int increase_denoising = run & 1;
+      const uint8_t motion_magnitude = run & 2 ? 0 : kMotionMagnitudeThreshold;
+      ASSERT_EQ(filter_sse2.MbDenoise(prev, kStride, out_sse2, 16, src,
+                                      kStride, motion_magnitude,
+                                      increase_denoising),
+                filter_avx2.MbDenoise(prev, kStride, out_avx2, 16, src,
+                                      kStride, motion_magnitude,
+                                      increase_denoising));
+      ASSERT_EQ(0, memcmp(out_sse2, out_avx2, sizeof(out_sse2)));
+
+      unsigned int sse_sse2 = 0;
+      unsigned int sse_avx2 = 0;
+      ASSERT_EQ(filter_sse2.Variance16x8(prev, kStride, src, kStride,
+                                         &sse_sse2),
+                filter_avx2.Variance16x8(prev, kStride, src, kStride,
+                                         &sse_avx2));
+      ASSERT_EQ(sse_sse2, sse_avx2);
+
+      filter_sse2.CopyMem16x16(src, kStride, out_sse2, 16);
+      filter_avx2.CopyMem16x16(src, kStride, out_avx2, 16);
+      ASSERT_EQ(0, memcmp(out_sse2, out_avx2, sizeof(out_sse2)));
+      filter_avx2.CopyMem8x8(prev, kStride, out_avx2, 16);
+      for (int row = 0; row < 8; ++row)
+        ASSERT_EQ(0, memcmp(prev + row * kStride, out_avx2 + row * 16, 8));
+    }
+  }
+}
+#endif
+
+TEST_F(VideoProcessingTest, DISABLED_ON_IOS(DenoiserKeepsFramesInUse)) {
+  VideoDenoiser denoiser(1);
+  rtc::scoped_ptr<uint8_t[]> video_buffer(new uint8_t[frame_length_]);
+  VideoFrame denoised_frame;
+  VideoFrame held_frame;
+  VideoFrame held_copy;
+  for (int frame = 0; frame < 3; ++frame) {
+    ASSERT_EQ(frame_length_,
+              fread(video_buffer.get(), 1, frame_length_, source_file_));
+    EXPECT_EQ(0, ConvertToI420(kI420, video_buffer.get(), 0, 0, width_,
+                               height_, 0, kVideoRotation_0, &video_frame_));
+    denoiser.DenoiseFrame(video_frame_, &denoised_frame);
+    // The output a copy still holds on to is left intact.
+    if (frame > 0)
+      EXPECT_TRUE(PlanesEqual(held_frame, held_copy));
+    held_frame.ShallowCopy(denoised_frame);
+    ASSERT_EQ(0, held_copy.CopyFrame(denoised_frame));
+  }
+}
+
+// Denoises foreman_cif and a 1080p upscale of it on one and on several
+// threads. The results are expected to match.
+TEST_F(VideoProcessingTest, DISABLED_ON_IOS(DenoiserBands)) {
+  enum { kNumFrames = 30 };
+  const int kSizes[][2] = {{352, 288}, {1920, 1080}};
+  const int kThreads[2] = {1, VideoDenoiser::kMaxThreads};
+  rtc::scoped_ptr<uint8_t[]> video_buffer(new uint8_t[frame_length_]);
+  for (const auto& size : kSizes) {
+    rewind(source_file_);
+    VPMSimpleSpatialResampler upscaler(1);
+    upscaler.SetInputFrameResampleMode(kBox);
+    ASSERT_EQ(VPM_OK, upscaler.SetTargetFrameSize(size[0], size[1]));
+    VideoDenoiser single_thread_denoiser(kThreads[0]);
+    VideoDenoiser band_denoiser(kThreads[1]);
+    VideoDenoiser* denoisers[2] = {&single_thread_denoiser, &band_denoiser};
+    VideoFrame source_frame;
+    VideoFrame out_frames[2];
+    for (int frame = 0; frame < kNumFrames; ++frame) {
+      ASSERT_EQ(frame_length_,
+                fread(video_buffer.get(), 1, frame_length_, source_file_));
+      EXPECT_EQ(0, ConvertToI420(kI420, video_buffer.get(), 0, 0, width_,
+                                 height_, 0, kVideoRotation_0, &video_frame_));
+      const VideoFrame* input = &video_frame_;
+      if (size[0] != width_ || size[1] != height_) {
+        ASSERT_EQ(VPM_OK, upscaler.ResampleFrame(video_frame_, &source_frame));
+        input = &source_frame;
+      }
+      for (int i = 0; i < 2; ++i)
+        denoisers[i]->DenoiseFrame(*input, &out_frames[i]);
+      ASSERT_TRUE(PlanesEqual(out_frames[0], out_frames[1]));
+    }
+    EXPECT_EQ(size[0], out_frames[1].width());
+    EXPECT_EQ(size[1], out_frames[1].height());
+  }
+}
+
+// Prints the cost per frame of denoising foreman_cif and a 1080p upscale of it
+// on one thread and in bands on several threads. It only measures time, so it
+// is disabled by default.
+TEST_F(VideoProcessingTest, DISABLED_DenoiserCost) {
+  enum { kNumFrames = 30 };
+  const int kSizes[][2] = {{352, 288}, {1920, 1080}};
+  const int kThreads[2] = {1, VideoDenoiser::kMaxThreads};
+  rtc::scoped_ptr<uint8_t[]> video_buffer(new uint8_t[frame_length_]);
+  for (const auto& size : kSizes) {
+    rewind(source_file_);
+    VPMSimpleSpatialResampler upscaler(1);
+    upscaler.SetInputFrameResampleMode(kBox);
+    ASSERT_EQ(VPM_OK, upscaler.SetTargetFrameSize(size[0], size[1]));
+    VideoDenoiser single_thread_denoiser(kThreads[0]);
+    VideoDenoiser band_denoiser(kThreads[1]);
+    VideoDenoiser* denoisers[2] = {&single_thread_denoiser, &band_denoiser};
+    VideoFrame source_frame;
+    VideoFrame out_frame;
+    int64_t runtime_us[2] = {0, 0};
+    for (int frame = 0; frame < kNumFrames; ++frame) {
+      ASSERT_EQ(frame_length_,
+                fread(video_buffer.get(), 1, frame_length_, source_file_));
+      EXPECT_EQ(0, ConvertToI420(kI420, video_buffer.get(), 0, 0, width_,
+                                 height_, 0, kVideoRotation_0, &video_frame_));
+      const VideoFrame* input = &video_frame_;
+      if (size[0] != width_ || size[1] != height_) {
+        ASSERT_EQ(VPM_OK, upscaler.ResampleFrame(video_frame_, &source_frame));
+        input = &source_frame;
+      }
+      for (int i = 0; i < 2; ++i) {
+        const TickTime time_start = TickTime::Now();
+        denoisers[i]->DenoiseFrame(*input, &out_frame);
+        runtime_us[i] += (TickTime::Now() - time_start).Microseconds();
+      }
+    }
+    printf("Denoising %dx%d: %d us / frame on 1 thread, %d us / frame on %d "
+           "threads\n",
+           size[0], size[1], static_cast<int>(runtime_us[0] / kNumFrames),
+           static_cast<int>(runtime_us[1] / kNumFrames), kThreads[1]);
+  }
+}
+
+}  // namespace webrtc
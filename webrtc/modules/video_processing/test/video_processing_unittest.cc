@@ -15,6 +15,7 @@
 #include <string>
 
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/video_processing/spatial_resampler.h"
 #include "webrtc/system_wrappers/include/tick_util.h"
 #include "webrtc/test/testsupport/fileutils.h"
 #include "webrtc/test/testsupport/gtest_disable.h"
@@ -283,6 +284,102 @@ TEST_F(VideoProcessingTest, DISABLED_ON_IOS(Resampler)) {
   printf("Min run time = %d us / frame\n\n", static_cast<int>(min_runtime));
 }
 
+TEST_F(VideoProcessingTest, DISABLED_ON_IOS(ResamplerKeepsFramesInUse)) {
+  VPMSimpleSpatialResampler resampler(1);
+  resampler.SetInputFrameResampleMode(kBox);
+  ASSERT_EQ(VPM_OK, resampler.SetTargetFrameSize(width_ / 2, height_ / 2));
+
+  VideoFrame out_frame;
+  ASSERT_EQ(VPM_OK, resampler.ResampleFrame(video_frame_, &out_frame));
+  const uint8_t* first_buffer = out_frame.buffer(kYPlane);
+  // While a copy holds on to the output, the next frame gets another buffer.
+  VideoFrame held_frame;
+  held_frame.ShallowCopy(out_frame);
+  ASSERT_EQ(VPM_OK, resampler.ResampleFrame(video_frame_, &out_frame));
+  EXPECT_NE(first_buffer, out_frame.buffer(kYPlane));
+  EXPECT_EQ(first_buffer, held_frame.buffer(kYPlane));
+
+  // Once released, buffers are reused rather than allocated per frame.
+  held_frame.Reset();
+  const uint8_t* second_buffer = out_frame.buffer(kYPlane);
+  ASSERT_EQ(VPM_OK, resampler.ResampleFrame(video_frame_, &out_frame));
+  ASSERT_EQ(VPM_OK, resampler.ResampleFrame(video_frame_, &out_frame));
+  EXPECT_TRUE(out_frame.buffer(kYPlane) == first_buffer ||
+              out_frame.buffer(kYPlane) == second_buffer);
+}
+
+// Scales a 720p frame on one and on several threads. The results are
+// expected to match; the cost per frame is printed for both.
+TEST_F(VideoProcessingTest, DISABLED_ON_IOS(ResamplerBands)) {
+  rtc::scoped_ptr<uint8_t[]> video_buffer(new uint8_t[frame_length_]);
+  ASSERT_EQ(frame_length_,
+            fread(video_buffer.get(), 1, frame_length_, source_file_));
+  EXPECT_EQ(0, ConvertToI420(kI420, video_buffer.get(), 0, 0, width_, height_,
+                             0, kVideoRotation_0, &video_frame_));
+  VPMSimpleSpatialResampler upscaler(1);
+  upscaler.SetInputFrameResampleMode(kBox);
+  ASSERT_EQ(VPM_OK, upscaler.SetTargetFrameSize(1280, 720));
+  VideoFrame source_frame;
+  ASSERT_EQ(VPM_OK, upscaler.ResampleFrame(video_frame_, &source_frame));
+
+  // Ratios that are split in bands, with odd chroma heights among them, and
+  // ones that are not, with odd heights.
+  const int kTargetSizes[][2] = {{640, 360}, {320, 180}, {853, 480},
+                                 {160, 90},  {960, 540}, {427, 241},
+                                 {640, 359}};
+  for (const auto& target_size : kTargetSizes) {
+    VideoFrame out_frames[2];
+    const int kThreads[2] = {1, VPMSimpleSpatialResampler::kMaxThreads};
+    for (int i = 0; i < 2; ++i) {
+      VPMSimpleSpatialResampler resampler(kThreads[i]);
+      resampler.SetInputFrameResampleMode(kBox);
+      ASSERT_EQ(VPM_OK,
+                resampler.SetTargetFrameSize(target_size[0], target_size[1]));
+      ASSERT_EQ(VPM_OK, resampler.ResampleFrame(source_frame, &out_frames[i]));
+    }
+    EXPECT_EQ(target_size[0], out_frames[1].width());
+    EXPECT_EQ(target_size[1], out_frames[1].height());
+    EXPECT_TRUE(CompareFrames(out_frames[0], out_frames[1]))
+        << "Scaling to " << target_size[0] << "x" << target_size[1];
+  }
+}
+
+TEST_F(VideoProcessingTest, DISABLED_ResamplerBandsTime) {
+  enum { kNumFrames = 50 };
+  rtc::scoped_ptr<uint8_t[]> video_buffer(new uint8_t[frame_length_]);
+  ASSERT_EQ(frame_length_,
+            fread(video_buffer.get(), 1, frame_length_, source_file_));
+  EXPECT_EQ(0, ConvertToI420(kI420, video_buffer.get(), 0, 0, width_, height_,
+                             0, kVideoRotation_0, &video_frame_));
+  VPMSimpleSpatialResampler upscaler(1);
+  upscaler.SetInputFrameResampleMode(kBox);
+  ASSERT_EQ(VPM_OK, upscaler.SetTargetFrameSize(1280, 720));
+  VideoFrame source_frame;
+  ASSERT_EQ(VPM_OK, upscaler.ResampleFrame(video_frame_, &source_frame));
+
+  const int kTargetSizes[][2] = {{640, 360}, {320, 180}, {853, 480}};
+  for (const auto& target_size : kTargetSizes) {
+    VideoFrame out_frame;
+    int64_t runtime_us[2];
+    const int kThreads[2] = {1, VPMSimpleSpatialResampler::kMaxThreads};
+    for (int i = 0; i < 2; ++i) {
+      VPMSimpleSpatialResampler resampler(kThreads[i]);
+      resampler.SetInputFrameResampleMode(kBox);
+      ASSERT_EQ(VPM_OK,
+                resampler.SetTargetFrameSize(target_size[0], target_size[1]));
+      const TickTime time_start = TickTime::Now();
+      for (int frame = 0; frame < kNumFrames; ++frame)
+        ASSERT_EQ(VPM_OK, resampler.ResampleFrame(source_frame, &out_frame));
+      runtime_us[i] = (TickTime::Now() - time_start).Microseconds();
+    }
+    printf("Scaling 1280x720 to %dx%d: %d us / frame on 1 thread, %d us / "
+           "frame on %d threads\n",
+           target_size[0], target_size[1],
+           static_cast<int>(runtime_us[0] / kNumFrames),
+           static_cast<int>(runtime_us[1] / kNumFrames), kThreads[1]);
+  }
+}
+
 void PreprocessFrameAndVerify(const VideoFrame& source,
                               int target_width,
                               int target_height,
@@ -9,6 +9,7 @@
  */
 
 #include "webrtc/modules/video_processing/util/denoiser_filter.h"
+#include "webrtc/modules/video_processing/util/denoiser_filter_avx2.h"
 #include "webrtc/modules/video_processing/util/denoiser_filter_c.h"
 #include "webrtc/modules/video_processing/util/denoiser_filter_neon.h"
 #include "webrtc/modules/video_processing/util/denoiser_filter_sse2.h"
@@ -26,7 +27,9 @@ DenoiserFilter* DenoiserFilter::Create() {
 // If we know the minimum architecture at compile time, avoid CPU detection.
 #if defined(WEBRTC_ARCH_X86_FAMILY)
   // x86 CPU detection required.
-  if (WebRtc_GetCPUInfo(kSSE2)) {
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    filter = new DenoiserFilterAVX2();
+  } else if (WebRtc_GetCPUInfo(kSSE2)) {
     filter = new DenoiserFilterSSE2();
   } else {
     filter = new DenoiserFilterC();
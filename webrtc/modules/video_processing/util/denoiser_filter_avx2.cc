@@ -0,0 +1,272 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+#include "webrtc/modules/video_processing/util/denoiser_filter_avx2.h"
+
+namespace webrtc {
+
+// The results are bit-exact with DenoiserFilterSSE2, which is what the
+// denoiser falls back to on CPUs without AVX2.
+
+// Loads 16 pixels of |row0| into the low lane and 16 of |row1| into the high
+// lane.
+static __m256i LoadRows(const uint8_t* row0, const uint8_t* row1) {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0))),
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1)), 1);
+}
+
+// Compute the sum of all pixel differences of this MB.
+static uint32_t AbsSumDiff16x1(__m128i acc_diff) {
+  const __m128i k_1 = _mm_set1_epi16(1);
+  const __m128i acc_diff_lo =
+      _mm_srai_epi16(_mm_unpacklo_epi8(acc_diff, acc_diff), 8);
+  const __m128i acc_diff_hi =
+      _mm_srai_epi16(_mm_unpackhi_epi8(acc_diff, acc_diff), 8);
+  const __m128i acc_diff_16 = _mm_add_epi16(acc_diff_lo, acc_diff_hi);
+  const __m128i hg_fe_dc_ba = _mm_madd_epi16(acc_diff_16, k_1);
+  const __m128i hgfe_dcba =
+      _mm_add_epi32(hg_fe_dc_ba, _mm_srli_si128(hg_fe_dc_ba, 8));
+  const __m128i hgfedcba =
+      _mm_add_epi32(hgfe_dcba, _mm_srli_si128(hgfe_dcba, 4));
+  unsigned int sum_diff = abs(_mm_cvtsi128_si32(hgfedcba));
+
+  return sum_diff;
+}
+
+// Sums the 16 bit differences of one 8 pixel wide half of the MB the way
+// Get8x8varSse2() does, keeping the low 16 bits.
+static uint32_t SumDiff8x8(__m128i vsum) {
+  vsum = _mm_add_epi16(vsum, _mm_srli_si128(vsum, 8));
+  vsum = _mm_add_epi16(vsum, _mm_srli_si128(vsum, 4));
+  vsum = _mm_add_epi16(vsum, _mm_srli_si128(vsum, 2));
+  return static_cast<uint32_t>(_mm_extract_epi16(vsum, 0));
+}
+
+void DenoiserFilterAVX2::CopyMem16x16(const uint8_t* src,
+                                      int src_stride,
+                                      uint8_t* dst,
+                                      int dst_stride) {
+  for (int i = 0; i < 16; i++) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    src += src_stride;
+    dst += dst_stride;
+  }
+}
+
+void DenoiserFilterAVX2::CopyMem8x8(const uint8_t* src,
+                                    int src_stride,
+                                    uint8_t* dst,
+                                    int dst_stride) {
+  for (int i = 0; i < 8; i++) {
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst),
+                     _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+    src += src_stride;
+    dst += dst_stride;
+  }
+}
+
+uint32_t DenoiserFilterAVX2::Variance16x8(const uint8_t* src,
+                                          int src_stride,
+                                          const uint8_t* ref,
+                                          int ref_stride,
+                                          unsigned int* sse) {
+  // Each row is widened to 16 bits, so the low lane holds the left 8x8 block
+  // and the high lane the right one.
+  __m256i vsum = _mm256_setzero_si256();
+  __m256i vsse = _mm256_setzero_si256();
+  for (int i = 0; i < 8; ++i) {
+    const __m256i src0 = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    const __m256i ref0 = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(ref)));
+    const __m256i diff = _mm256_sub_epi16(src0, ref0);
+    vsum = _mm256_add_epi16(vsum, diff);
+    vsse = _mm256_add_epi32(vsse, _mm256_madd_epi16(diff, diff));
+    src += src_stride;
+    ref += ref_stride;
+  }
+
+  const uint32_t sum = SumDiff8x8(_mm256_castsi256_si128(vsum)) +
+                       SumDiff8x8(_mm256_extracti128_si256(vsum, 1));
+  __m128i vsse_128 = _mm_add_epi32(_mm256_castsi256_si128(vsse),
+                                   _mm256_extracti128_si256(vsse, 1));
+  vsse_128 = _mm_add_epi32(vsse_128, _mm_srli_si128(vsse_128, 8));
+  vsse_128 = _mm_add_epi32(vsse_128, _mm_srli_si128(vsse_128, 4));
+  *sse = _mm_cvtsi128_si32(vsse_128);
+  return *sse - ((sum * sum) >> 7);
+}
+
+DenoiserDecision DenoiserFilterAVX2::MbDenoise(uint8_t* mc_running_avg_y,
+                                               int mc_avg_y_stride,
+                                               uint8_t* running_avg_y,
+                                               int avg_y_stride,
+                                               const uint8_t* sig,
+                                               int sig_stride,
+                                               uint8_t motion_magnitude,
+                                               int increase_denoising) {
+  int shift_inc =
+      (increase_denoising && motion_magnitude <= kMotionMagnitudeThreshold) ? 1
+                                                                            : 0;
+  __m256i acc_diff_2 = _mm256_setzero_si256();
+  const __m256i k_0 = _mm256_setzero_si256();
+  const __m256i k_4 = _mm256_set1_epi8(4 + shift_inc);
+  const __m256i k_8 = _mm256_set1_epi8(8);
+  const __m256i k_16 = _mm256_set1_epi8(16);
+  // Modify each level's adjustment according to motion_magnitude.
+  const __m256i l3 = _mm256_set1_epi8(
+      (motion_magnitude <= kMotionMagnitudeThreshold) ? 7 + shift_inc : 6);
+  // Difference between level 3 and level 2 is 2.
+  const __m256i l32 = _mm256_set1_epi8(2);
+  // Difference between level 2 and level 1 is 1.
+  const __m256i l21 = _mm256_set1_epi8(1);
+
+  // Two rows at a time, the even one in the low lane.
+  for (int r = 0; r < 16; r += 2) {
+    // Calculate differences.
+    const __m256i v_sig = LoadRows(sig, sig + sig_stride);
+    const __m256i v_mc_running_avg_y =
+        LoadRows(mc_running_avg_y, mc_running_avg_y + mc_avg_y_stride);
+    __m256i v_running_avg_y;
+    const __m256i pdiff = _mm256_subs_epu8(v_mc_running_avg_y, v_sig);
+    const __m256i ndiff = _mm256_subs_epu8(v_sig, v_mc_running_avg_y);
+    // Obtain the sign. FF if diff is negative.
+    const __m256i diff_sign = _mm256_cmpeq_epi8(pdiff, k_0);
+    // Clamp absolute difference to 16 to be used to get mask. Doing this
+    // allows us to use _mm256_cmpgt_epi8, which operates on signed byte.
+    const __m256i clamped_absdiff =
+        _mm256_min_epu8(_mm256_or_si256(pdiff, ndiff), k_16);
+    // Get masks for l2 l1 and l0 adjustments.
+    const __m256i mask2 = _mm256_cmpgt_epi8(k_16, clamped_absdiff);
+    const __m256i mask1 = _mm256_cmpgt_epi8(k_8, clamped_absdiff);
+    const __m256i mask0 = _mm256_cmpgt_epi8(k_4, clamped_absdiff);
+    // Get adjustments for l2, l1, and l0.
+    __m256i adj2 = _mm256_and_si256(mask2, l32);
+    const __m256i adj1 = _mm256_and_si256(mask1, l21);
+    const __m256i adj0 = _mm256_and_si256(mask0, clamped_absdiff);
+    __m256i adj, padj, nadj;
+
+    // Combine the adjustments and get absolute adjustments.
+    adj2 = _mm256_add_epi8(adj2, adj1);
+    adj = _mm256_sub_epi8(l3, adj2);
+    adj = _mm256_andnot_si256(mask0, adj);
+    adj = _mm256_or_si256(adj, adj0);
+
+    // Restore the sign and get positive and negative adjustments.
+    padj = _mm256_andnot_si256(diff_sign, adj);
+    nadj = _mm256_and_si256(diff_sign, adj);
+
+    // Calculate filtered value.
+    v_running_avg_y = _mm256_adds_epu8(v_sig, padj);
+    v_running_avg_y = _mm256_subs_epu8(v_running_avg_y, nadj);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(running_avg_y),
+                     _mm256_castsi256_si128(v_running_avg_y));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(running_avg_y + avg_y_stride),
+                     _mm256_extracti128_si256(v_running_avg_y, 1));
+
+    // Adjustments are at most 8, so each lane sums up to 8 rows without
+    // saturating.
+    acc_diff_2 = _mm256_add_epi8(acc_diff_2, padj);
+    acc_diff_2 = _mm256_sub_epi8(acc_diff_2, nadj);
+
+    // Update pointers for next iteration.
+    sig += 2 * sig_stride;
+    mc_running_avg_y += 2 * mc_avg_y_stride;
+    running_avg_y += 2 * avg_y_stride;
+  }
+
+  // Only the total of all 16 rows can reach 128, so saturating once here
+  // matches saturating after every row.
+  __m128i acc_diff = _mm_adds_epi8(_mm256_castsi256_si128(acc_diff_2),
+                                   _mm256_extracti128_si256(acc_diff_2, 1));
+
+  {
+    // Compute the sum of all pixel differences of this MB.
+    unsigned int abs_sum_diff = AbsSumDiff16x1(acc_diff);
+    unsigned int sum_diff_thresh = kSumDiffThreshold;
+    if (increase_denoising)
+      sum_diff_thresh = kSumDiffThresholdHigh;
+    if (abs_sum_diff > sum_diff_thresh) {
+      // Before returning to copy the block (i.e., apply no denoising),
+      // check if we can still apply some (weaker) temporal filtering to
+      // this block, that would otherwise not be denoised at all. Simplest
+      // is to apply an additional adjustment to running_avg_y to bring it
+      // closer to sig. The adjustment is capped by a maximum delta, and
+      // chosen such that in most cases the resulting sum_diff will be
+      // within the acceptable range given by sum_diff_thresh.
+
+      // The delta is set by the excess of absolute pixel diff over the
+      // threshold.
+      int delta = ((abs_sum_diff - sum_diff_thresh) >> 8) + 1;
+      // Only apply the adjustment for max delta up to 3.
+      if (delta < 4) {
+        // The accumulator may saturate at any row here, so this rarely taken
+        // pass goes row by row like the SSE2 version.
+        const __m128i k_0_128 = _mm_setzero_si128();
+        const __m128i k_delta = _mm_set1_epi8(delta);
+        sig -= sig_stride * 16;
+        mc_running_avg_y -= mc_avg_y_stride * 16;
+        running_avg_y -= avg_y_stride * 16;
+        for (int r = 0; r < 16; ++r) {
+          __m128i v_running_avg_y =
+              _mm_loadu_si128(reinterpret_cast<__m128i*>(&running_avg_y[0]));
+          // Calculate differences.
+          const __m128i v_sig =
+              _mm_loadu_si128(reinterpret_cast<const __m128i*>(&sig[0]));
+          const __m128i v_mc_running_avg_y =
+              _mm_loadu_si128(reinterpret_cast<__m128i*>(&mc_running_avg_y[0]));
+          const __m128i pdiff = _mm_subs_epu8(v_mc_running_avg_y, v_sig);
+          const __m128i ndiff = _mm_subs_epu8(v_sig, v_mc_running_avg_y);
+          // Obtain the sign. FF if diff is negative.
+          const __m128i diff_sign = _mm_cmpeq_epi8(pdiff, k_0_128);
+          // Clamp absolute difference to delta to get the adjustment.
+          const __m128i adj = _mm_min_epu8(_mm_or_si128(pdiff, ndiff), k_delta);
+          // Restore the sign and get positive and negative adjustments.
+          __m128i padj, nadj;
+          padj = _mm_andnot_si128(diff_sign, adj);
+          nadj = _mm_and_si128(diff_sign, adj);
+          // Calculate filtered value.
+          v_running_avg_y = _mm_subs_epu8(v_running_avg_y, padj);
+          v_running_avg_y = _mm_adds_epu8(v_running_avg_y, nadj);
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(running_avg_y),
+                           v_running_avg_y);
+
+          // Accumulate the adjustments.
+          acc_diff = _mm_subs_epi8(acc_diff, padj);
+          acc_diff = _mm_adds_epi8(acc_diff, nadj);
+
+          // Update pointers for next iteration.
+          sig += sig_stride;
+          mc_running_avg_y += mc_avg_y_stride;
+          running_avg_y += avg_y_stride;
+        }
+        abs_sum_diff = AbsSumDiff16x1(acc_diff);
+        if (abs_sum_diff > sum_diff_thresh) {
+          return COPY_BLOCK;
+        }
+      } else {
+        return COPY_BLOCK;
+      }
+    }
+  }
+  return FILTER_BLOCK;
+}
+
+}  // namespace webrtc
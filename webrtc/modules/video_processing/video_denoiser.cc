@@ -7,24 +7,90 @@
  *  in the file PATENTS.  All contributing project authors may
  *  be found in the AUTHORS file in the root of the source tree.
  */
-#include "webrtc/common_video/libyuv/include/scaler.h"
-#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/video_processing/video_denoiser.h"
 
+#include <string.h>
+
+#include <algorithm>
+
+#include "libyuv/convert.h"  // NOLINT
+
+#include "webrtc/system_wrappers/include/cpu_info.h"
+
 namespace webrtc {
 
+namespace {
+
+int DenoisingThreads(int max_threads) {
+  if (max_threads > 0)
+    return max_threads;
+  return std::min(static_cast<int>(CpuInfo::DetectNumberOfCores()),
+                  VideoDenoiser::kMaxThreads);
+}
+
+void CopyRows(const uint8_t* src,
+              int src_stride,
+              uint8_t* dst,
+              int dst_stride,
+              int width,
+              int first_row,
+              int end_row) {
+  src += first_row * src_stride;
+  dst += first_row * dst_stride;
+  for (int row = first_row; row < end_row; ++row) {
+    memcpy(dst, src, width);
+    src += src_stride;
+    dst += dst_stride;
+  }
+}
+
+}  // namespace
+
+const int VideoDenoiser::kMinPixelsForBands;
+const int VideoDenoiser::kMaxThreads;
+
+// The planes of the frame to denoise, the Y plane of the previous denoised
+// frame and the planes of the output, split in bands of whole macroblock rows.
+// Macroblocks only read their own pixels in the first pass, so the bands don't
+// depend on each other.
+struct VideoDenoiser::DenoiseJob {
+  VideoDenoiser* denoiser;
+  const uint8_t* src[kNumOfPlanes];
+  int src_stride[kNumOfPlanes];
+  const uint8_t* prev_y;
+  int prev_stride_y;
+  uint8_t* dst[kNumOfPlanes];
+  int dst_stride[kNumOfPlanes];
+  int width;
+  int mb_rows;
+  int mb_cols;
+  int num_bands;
+};
+
 VideoDenoiser::VideoDenoiser()
-    : width_(0), height_(0), filter_(DenoiserFilter::Create()) {}
+    : width_(0),
+      height_(0),
+      filter_(DenoiserFilter::Create()),
+      max_threads_(DenoisingThreads(0)) {}
+
+VideoDenoiser::VideoDenoiser(int max_threads)
+    : width_(0),
+      height_(0),
+      filter_(DenoiserFilter::Create()),
+      max_threads_(DenoisingThreads(max_threads)) {}
+
+VideoDenoiser::~VideoDenoiser() {}
 
 void VideoDenoiser::TrailingReduction(int mb_rows,
                                       int mb_cols,
                                       const uint8_t* y_src,
                                       int stride_y,
-                                      uint8_t* y_dst) {
+                                      uint8_t* y_dst,
+                                      int stride_y_dst) {
   for (int mb_row = 1; mb_row < mb_rows - 1; ++mb_row) {
     for (int mb_col = 1; mb_col < mb_cols - 1; ++mb_col) {
       int mb_index = mb_row * mb_cols + mb_col;
-      uint8_t* mb_dst = y_dst + (mb_row << 4) * stride_y + (mb_col << 4);
+      uint8_t* mb_dst = y_dst + (mb_row << 4) * stride_y_dst + (mb_col << 4);
       const uint8_t* mb_src = y_src + (mb_row << 4) * stride_y + (mb_col << 4);
       // If the number of denoised neighbors is less than a threshold,
       // do NOT denoise for the block. Set different threshold for skin MB.
@@ -38,7 +104,7 @@ void VideoDenoiser::TrailingReduction(int mb_rows,
                     metrics_[mb_index - mb_cols].denoise <=
                 2) {
           metrics_[mb_index].denoise = 0;
-          filter_->CopyMem16x16(mb_src, stride_y, mb_dst, stride_y);
+          filter_->CopyMem16x16(mb_src, stride_y, mb_dst, stride_y_dst);
         }
       } else if (metrics_[mb_index].denoise &&
                  metrics_[mb_index + 1].denoise +
@@ -50,57 +116,48 @@ void VideoDenoiser::TrailingReduction(int mb_rows,
                          metrics_[mb_index + mb_cols].denoise +
                          metrics_[mb_index - mb_cols].denoise <=
                      7) {
-        filter_->CopyMem16x16(mb_src, stride_y, mb_dst, stride_y);
+        filter_->CopyMem16x16(mb_src, stride_y, mb_dst, stride_y_dst);
       }
     }
   }
 }
 
-void VideoDenoiser::DenoiseFrame(const VideoFrame& frame,
-                                 VideoFrame* denoised_frame) {
-  int stride_y = frame.stride(kYPlane);
-  int stride_u = frame.stride(kUPlane);
-  int stride_v = frame.stride(kVPlane);
-  // If previous width and height are different from current frame's, then no
-  // denoising for the current frame.
-  if (width_ != frame.width() || height_ != frame.height()) {
-    width_ = frame.width();
-    height_ = frame.height();
-    denoised_frame->CreateFrame(frame.buffer(kYPlane), frame.buffer(kUPlane),
-                                frame.buffer(kVPlane), width_, height_,
-                                stride_y, stride_u, stride_v);
-    // Setting time parameters to the output frame.
-    denoised_frame->set_timestamp(frame.timestamp());
-    denoised_frame->set_render_time_ms(frame.render_time_ms());
-    return;
-  }
-  // For 16x16 block.
-  int mb_cols = width_ >> 4;
-  int mb_rows = height_ >> 4;
-  if (metrics_.get() == nullptr)
-    metrics_.reset(new DenoiseMetrics[mb_cols * mb_rows]);
-  // Denoise on Y plane.
-  uint8_t* y_dst = denoised_frame->buffer(kYPlane);
-  uint8_t* u_dst = denoised_frame->buffer(kUPlane);
-  uint8_t* v_dst = denoised_frame->buffer(kVPlane);
-  const uint8_t* y_src = frame.buffer(kYPlane);
-  const uint8_t* u_src = frame.buffer(kUPlane);
-  const uint8_t* v_src = frame.buffer(kVPlane);
+void VideoDenoiser::DenoiseBand(void* obj, int band) {
+  const DenoiseJob* job = static_cast<const DenoiseJob*>(obj);
+  job->denoiser->DenoiseMbRows(*job, band * job->mb_rows / job->num_bands,
+                               (band + 1) * job->mb_rows / job->num_bands);
+}
+
+void VideoDenoiser::DenoiseMbRows(const DenoiseJob& job,
+                                  int first_mb_row,
+                                  int end_mb_row) {
+  const uint8_t* y_src = job.src[kYPlane];
+  const uint8_t* u_src = job.src[kUPlane];
+  const uint8_t* v_src = job.src[kVPlane];
+  const int stride_y = job.src_stride[kYPlane];
+  const int stride_u = job.src_stride[kUPlane];
+  const int stride_v = job.src_stride[kVPlane];
+  uint8_t* y_dst = job.dst[kYPlane];
+  const int stride_y_dst = job.dst_stride[kYPlane];
+  // The filter only reads the previous frame.
+  uint8_t* y_prev = const_cast<uint8_t*>(job.prev_y);
   // Temporary buffer to store denoising result.
   uint8_t y_tmp[16 * 16] = {0};
-  for (int mb_row = 0; mb_row < mb_rows; ++mb_row) {
-    for (int mb_col = 0; mb_col < mb_cols; ++mb_col) {
+  for (int mb_row = first_mb_row; mb_row < end_mb_row; ++mb_row) {
+    for (int mb_col = 0; mb_col < job.mb_cols; ++mb_col) {
       const uint8_t* mb_src = y_src + (mb_row << 4) * stride_y + (mb_col << 4);
-      uint8_t* mb_dst = y_dst + (mb_row << 4) * stride_y + (mb_col << 4);
-      int mb_index = mb_row * mb_cols + mb_col;
+      uint8_t* mb_prev =
+          y_prev + (mb_row << 4) * job.prev_stride_y + (mb_col << 4);
+      uint8_t* mb_dst = y_dst + (mb_row << 4) * stride_y_dst + (mb_col << 4);
+      int mb_index = mb_row * job.mb_cols + mb_col;
       // Denoise each MB at the very start and save the result to a temporary
       // buffer.
-      if (filter_->MbDenoise(mb_dst, stride_y, y_tmp, 16, mb_src, stride_y, 0,
-                             1) == FILTER_BLOCK) {
+      if (filter_->MbDenoise(mb_prev, job.prev_stride_y, y_tmp, 16, mb_src,
+                             stride_y, 0, 1) == FILTER_BLOCK) {
         uint32_t thr_var = 0;
         // Save var and sad to the buffer.
         metrics_[mb_index].var = filter_->Variance16x8(
-            mb_dst, stride_y, y_tmp, 16, &metrics_[mb_index].sad);
+            mb_prev, job.prev_stride_y, y_tmp, 16, &metrics_[mb_index].sad);
         // Get skin map.
         metrics_[mb_index].is_skin = MbHasSkinColor(
             y_src, u_src, v_src, stride_y, stride_u, stride_v, mb_row, mb_col);
@@ -110,31 +167,105 @@ void VideoDenoiser::DenoiseFrame(const VideoFrame& frame,
         if (metrics_[mb_index].var > thr_var) {
           metrics_[mb_index].denoise = 0;
           // Use the source MB.
-          filter_->CopyMem16x16(mb_src, stride_y, mb_dst, stride_y);
+          filter_->CopyMem16x16(mb_src, stride_y, mb_dst, stride_y_dst);
         } else {
           metrics_[mb_index].denoise = 1;
           // Use the denoised MB.
-          filter_->CopyMem16x16(y_tmp, 16, mb_dst, stride_y);
+          filter_->CopyMem16x16(y_tmp, 16, mb_dst, stride_y_dst);
         }
       } else {
         metrics_[mb_index].denoise = 0;
-        filter_->CopyMem16x16(mb_src, stride_y, mb_dst, stride_y);
+        filter_->CopyMem16x16(mb_src, stride_y, mb_dst, stride_y_dst);
       }
-      // Copy source U/V plane.
-      const uint8_t* mb_src_u =
-          u_src + (mb_row << 3) * stride_u + (mb_col << 3);
-      const uint8_t* mb_src_v =
-          v_src + (mb_row << 3) * stride_v + (mb_col << 3);
-      uint8_t* mb_dst_u = u_dst + (mb_row << 3) * stride_u + (mb_col << 3);
-      uint8_t* mb_dst_v = v_dst + (mb_row << 3) * stride_v + (mb_col << 3);
-      filter_->CopyMem8x8(mb_src_u, stride_u, mb_dst_u, stride_u);
-      filter_->CopyMem8x8(mb_src_v, stride_v, mb_dst_v, stride_v);
     }
+    // Copy the source pixels right of the last MB.
+    const int mb_width = job.mb_cols << 4;
+    CopyRows(y_src + mb_width, stride_y, y_dst + mb_width, stride_y_dst,
+             job.width - mb_width, mb_row << 4, (mb_row + 1) << 4);
   }
+  // Copy source U/V plane.
+  const int half_width = (job.width + 1) / 2;
+  for (int i = kUPlane; i < kNumOfPlanes; ++i) {
+    CopyRows(job.src[i], job.src_stride[i], job.dst[i], job.dst_stride[i],
+             half_width, first_mb_row << 3, end_mb_row << 3);
+  }
+}
+
+void VideoDenoiser::DenoiseFrame(const VideoFrame& frame,
+                                 VideoFrame* denoised_frame) {
+  // The previous output is what the new frame is filtered against. Holding
+  // on to it keeps the pool from handing it out again for the new output.
+  rtc::scoped_refptr<VideoFrameBuffer> prev_buffer =
+      denoised_frame->video_frame_buffer();
+  denoised_frame->set_video_frame_buffer(
+      buffer_pool_.CreateBuffer(frame.width(), frame.height()));
+  // If previous width and height are different from current frame's, then no
+  // denoising for the current frame.
+  if (width_ != frame.width() || height_ != frame.height() || !prev_buffer ||
+      prev_buffer->width() != width_ || prev_buffer->height() != height_) {
+    width_ = frame.width();
+    height_ = frame.height();
+    metrics_.reset(new DenoiseMetrics[(width_ >> 4) * (height_ >> 4)]);
+    libyuv::I420Copy(frame.buffer(kYPlane), frame.stride(kYPlane),
+                     frame.buffer(kUPlane), frame.stride(kUPlane),
+                     frame.buffer(kVPlane), frame.stride(kVPlane),
+                     denoised_frame->buffer(kYPlane),
+                     denoised_frame->stride(kYPlane),
+                     denoised_frame->buffer(kUPlane),
+                     denoised_frame->stride(kUPlane),
+                     denoised_frame->buffer(kVPlane),
+                     denoised_frame->stride(kVPlane), width_, height_);
+    // Setting time parameters to the output frame.
+    denoised_frame->set_timestamp(frame.timestamp());
+    denoised_frame->set_render_time_ms(frame.render_time_ms());
+    return;
+  }
+
+  DenoiseJob job;
+  job.denoiser = this;
+  for (int i = 0; i < kNumOfPlanes; ++i) {
+    const PlaneType plane = static_cast<PlaneType>(i);
+    job.src[i] = frame.buffer(plane);
+    job.src_stride[i] = frame.stride(plane);
+    job.dst[i] = denoised_frame->buffer(plane);
+    job.dst_stride[i] = denoised_frame->stride(plane);
+  }
+  job.prev_y = prev_buffer->data(kYPlane);
+  job.prev_stride_y = prev_buffer->stride(kYPlane);
+  job.width = width_;
+  // For 16x16 block.
+  job.mb_cols = width_ >> 4;
+  job.mb_rows = height_ >> 4;
+  job.num_bands = 1;
+  if (max_threads_ > 1 && width_ * height_ >= kMinPixelsForBands)
+    job.num_bands = std::max(1, std::min(max_threads_, job.mb_rows));
+
+  // Denoise on Y plane.
+  if (job.num_bands > 1) {
+    if (!workers_) {
+      // Same priority as the encoder thread, which does the preprocessing.
+      workers_.reset(new RowBandWorkers(max_threads_, "DenoiserWorker",
+                                        rtc::kHighPriority));
+    }
+    workers_->Run(&DenoiseBand, &job, job.num_bands);
+  } else {
+    DenoiseBand(&job, 0);
+  }
+  // Copy the source rows below the last MB row.
+  for (int i = 0; i < kNumOfPlanes; ++i) {
+    const int shift = i == kYPlane ? 0 : 1;
+    CopyRows(job.src[i], job.src_stride[i], job.dst[i], job.dst_stride[i],
+             (width_ + shift) >> shift, (job.mb_rows << 4) >> shift,
+             (height_ + shift) >> shift);
+  }
+
   // Second round.
   // This is to reduce the trailing artifact and blockiness by referring
-  // neighbors' denoising status.
-  TrailingReduction(mb_rows, mb_cols, y_src, stride_y, y_dst);
+  // neighbors' denoising status. It looks at the final status of the MBs
+  // above and to the left, so it runs once all bands are done.
+  TrailingReduction(job.mb_rows, job.mb_cols, job.src[kYPlane],
+                    job.src_stride[kYPlane], job.dst[kYPlane],
+                    job.dst_stride[kYPlane]);
 
   // Setting time parameters to the output frame.
   denoised_frame->set_timestamp(frame.timestamp());
@@ -11,26 +11,49 @@
 #ifndef WEBRTC_MODULES_VIDEO_PROCESSING_VIDEO_DENOISER_H_
 #define WEBRTC_MODULES_VIDEO_PROCESSING_VIDEO_DENOISER_H_
 
+#include "webrtc/common_video/include/i420_buffer_pool.h"
 #include "webrtc/modules/video_processing/util/denoiser_filter.h"
 #include "webrtc/modules/video_processing/util/skin_detection.h"
+#include "webrtc/system_wrappers/include/row_band_workers.h"
+#include "webrtc/video_frame.h"
 
 namespace webrtc {
 
+// Denoised frames come from a buffer pool, so the previous output, which the
+// next frame is filtered against, is never overwritten while someone holds on
+// to it. Large frames are denoised in bands of macroblock rows on several
+// threads.
 class VideoDenoiser {
  public:
   VideoDenoiser();
+  // |max_threads| caps the threads used for denoising, the calling one
+  // included; 0 picks one per core, up to |kMaxThreads|.
+  explicit VideoDenoiser(int max_threads);
+  ~VideoDenoiser();
   void DenoiseFrame(const VideoFrame& frame, VideoFrame* denoised_frame);
 
+  // Frames with fewer pixels are not worth splitting.
+  static const int kMinPixelsForBands = 640 * 480;
+  static const int kMaxThreads = 4;
+
  private:
+  struct DenoiseJob;
+  static void DenoiseBand(void* obj, int band);
+  void DenoiseMbRows(const DenoiseJob& job, int first_mb_row, int end_mb_row);
   void TrailingReduction(int mb_rows,
                          int mb_cols,
                          const uint8_t* y_src,
                          int stride_y,
-                         uint8_t* y_dst);
+                         uint8_t* y_dst,
+                         int stride_y_dst);
   int width_;
   int height_;
   rtc::scoped_ptr<DenoiseMetrics[]> metrics_;
   rtc::scoped_ptr<DenoiserFilter> filter_;
+  int max_threads_;
+  I420BufferPool buffer_pool_;
+  // Created for the first frame large enough to be split.
+  rtc::scoped_ptr<RowBandWorkers> workers_;
 };
 
 }  // namespace webrtc
@@ -11,6 +11,7 @@
 #include "webrtc/p2p/base/p2ptransportchannel.h"
 
 #include <algorithm>
+#include <map>
 #include <set>
 #include "webrtc/p2p/base/common.h"
 #include "webrtc/p2p/base/relayport.h"  // For RELAY_PORT_TYPE.
@@ -260,6 +261,7 @@ void P2PTransportChannel::AddAllocatorSession(PortAllocatorSession* session) {
 
 void P2PTransportChannel::AddConnection(Connection* connection) {
   connections_.push_back(connection);
+  connection_set_.insert(connection);
   connection->set_remote_ice_mode(remote_ice_mode_);
   connection->set_receiving_timeout(receiving_timeout_);
   connection->SignalReadPacket.connect(
@@ -781,9 +783,7 @@ bool P2PTransportChannel::CreateConnection(PortInterface* port,
 
 bool P2PTransportChannel::FindConnection(
     cricket::Connection* connection) const {
-  std::vector<Connection*>::const_iterator citer =
-      std::find(connections_.begin(), connections_.end(), connection);
-  return citer != connections_.end();
+  return connection_set_.find(connection) != connection_set_.end();
 }
 
 uint32_t P2PTransportChannel::GetRemoteCandidateGeneration(
@@ -982,8 +982,13 @@ void P2PTransportChannel::SortConnections() {
   // that amongst equal preference, writable connections, this will choose the
   // one whose estimated latency is lowest.  So it is the only one that we
   // need to consider switching to.
+  // Between two sorts usually only a handful of connections change state, so
+  // skip the O(n log n) sort entirely when the order is still valid. Since the
+  // sort is stable, this yields exactly the same ordering.
   ConnectionCompare cmp;
-  std::stable_sort(connections_.begin(), connections_.end(), cmp);
+  if (!std::is_sorted(connections_.begin(), connections_.end(), cmp)) {
+    std::stable_sort(connections_.begin(), connections_.end(), cmp);
+  }
   LOG(LS_VERBOSE) << "Sorting " << connections_.size()
                   << " available connections:";
   for (size_t i = 0; i < connections_.size(); ++i) {
@@ -1044,24 +1049,26 @@ void P2PTransportChannel::PruneConnections() {
   // reconnecting a TCP connection and temporarily do not prune connections in
   // this network. See the big comment in CompareConnections.
 
-  // Get a list of the networks that we are using.
-  std::set<rtc::Network*> networks;
-  for (const Connection* conn : connections_) {
-    networks.insert(conn->port()->Network());
+  // Find the premier connection of each network in a single pass. The best
+  // connection wins on its own network; otherwise it is the top-most one in
+  // sorted order.
+  std::map<rtc::Network*, Connection*> premiers;
+  if (best_connection_) {
+    premiers[best_connection_->port()->Network()] = best_connection_;
   }
-  for (rtc::Network* network : networks) {
-    Connection* premier = GetBestConnectionOnNetwork(network);
+  for (Connection* conn : connections_) {
+    premiers.insert(std::make_pair(conn->port()->Network(), conn));
+  }
+
+  for (Connection* conn : connections_) {
+    Connection* premier = premiers[conn->port()->Network()];
     // Do not prune connections if the current best connection is weak on this
     // network. Otherwise, it may delete connections prematurely.
-    if (!premier || premier->weak()) {
+    if (premier->weak()) {
       continue;
     }
-
-    for (Connection* conn : connections_) {
-      if ((conn != premier) && (conn->port()->Network() == network) &&
-          (CompareConnectionCandidates(premier, conn) >= 0)) {
-        conn->Prune();
-      }
+    if ((conn != premier) && (CompareConnectionCandidates(premier, conn) >= 0)) {
+      conn->Prune();
     }
   }
 }
@@ -1137,23 +1144,6 @@ bool P2PTransportChannel::weak() const {
   return !best_connection_ || best_connection_->weak();
 }
 
-// If we have a best connection, return it, otherwise return top one in the
-// list (later we will mark it best).
-Connection* P2PTransportChannel::GetBestConnectionOnNetwork(
-    rtc::Network* network) const {
-  // If the best connection is on this network, then it wins.
-  if (best_connection_ && (best_connection_->port()->Network() == network))
-    return best_connection_;
-
-  // Otherwise, we return the top-most in sorted order.
-  for (size_t i = 0; i < connections_.size(); ++i) {
-    if (connections_[i]->port()->Network() == network)
-      return connections_[i];
-  }
-
-  return NULL;
-}
-
 // Handle any queued up requests
 void P2PTransportChannel::OnMessage(rtc::Message *pmsg) {
   switch (pmsg->message_id) {
@@ -1347,6 +1337,7 @@ void P2PTransportChannel::OnConnectionDestroyed(Connection* connection) {
       std::find(connections_.begin(), connections_.end(), connection);
   ASSERT(iter != connections_.end());
   connections_.erase(iter);
+  connection_set_.erase(connection);
 
   LOG_J(LS_INFO, this) << "Removed connection ("
     << static_cast<int>(connections_.size()) << " remaining)";
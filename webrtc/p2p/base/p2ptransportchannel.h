@@ -22,6 +22,7 @@
 
 #include <map>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include "webrtc/p2p/base/candidate.h"
 #include "webrtc/p2p/base/p2ptransport.h"
@@ -194,7 +195,6 @@ class P2PTransportChannel : public TransportChannelImpl,
   void MaybeStopPortAllocatorSessions();
   TransportChannelState ComputeState() const;
 
-  Connection* GetBestConnectionOnNetwork(rtc::Network* network) const;
   bool CreateConnections(const Candidate& remote_candidate,
                          PortInterface* origin_port);
   bool CreateConnection(PortInterface* port,
@@ -262,7 +262,11 @@ class P2PTransportChannel : public TransportChannelImpl,
   int error_;
   std::vector<PortAllocatorSession*> allocator_sessions_;
   std::vector<PortInterface *> ports_;
+  // Kept in sorted order; see SortConnections().
   std::vector<Connection *> connections_;
+  // Index over |connections_| so that per-packet membership checks do not
+  // scale with the number of candidate pairs.
+  std::unordered_set<Connection*> connection_set_;
   Connection* best_connection_;
   // Connection selected by the controlling agent. This should be used only
   // at controlled side when protocol type is RFC5245.
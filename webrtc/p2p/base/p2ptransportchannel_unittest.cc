@@ -26,6 +26,7 @@
 #include "webrtc/base/proxyserver.h"
 #include "webrtc/base/socketaddress.h"
 #include "webrtc/base/ssladapter.h"
+#include "webrtc/base/stringencode.h"
 #include "webrtc/base/thread.h"
 #include "webrtc/base/virtualsocketserver.h"
 
@@ -2333,3 +2334,39 @@ TEST_F(P2PTransportChannelPingTest, TestStopPortAllocatorSessions) {
   conn2->ReceivedPingResponse();  // Becomes writable and receiving
   EXPECT_TRUE(!ch.allocator_session()->IsGettingPorts());
 }
+
+// Test that a channel with many candidate pairs still finds each connection by
+// address, sorts the highest priority one to the top and selects ping targets.
+TEST_F(P2PTransportChannelPingTest, TestManyConnections) {
+  const int kNumCandidates = 500;
+  const int kNumPingChecks = 1000;
+  cricket::FakePortAllocator pa(rtc::Thread::Current(), nullptr);
+  cricket::P2PTransportChannel ch("many connections", 1, nullptr, &pa);
+  PrepareChannel(&ch);
+  ch.Connect();
+  ch.MaybeStartGathering();
+
+  std::vector<std::string> ips;
+  for (int i = 0; i < kNumCandidates; ++i) {
+    ips.push_back("10.0." + rtc::ToString(i / 250) + "." +
+                  rtc::ToString(i % 250 + 1));
+    ch.AddRemoteCandidate(CreateCandidate(ips.back(), i + 1, i + 1));
+  }
+  EXPECT_EQ_WAIT(static_cast<size_t>(kNumCandidates), ch.connections().size(),
+                 3000);
+
+  for (int i = 0; i < kNumCandidates; ++i) {
+    EXPECT_TRUE(GetConnectionTo(&ch, ips[i], i + 1) != nullptr);
+  }
+
+  // The highest priority connection is sorted to the top and selected.
+  cricket::Connection* top =
+      GetConnectionTo(&ch, ips[kNumCandidates - 1], kNumCandidates);
+  ASSERT_TRUE(top != nullptr);
+  EXPECT_EQ_WAIT(top, ch.best_connection(), 1000);
+  EXPECT_EQ(top, ch.connections()[0]);
+
+  for (int i = 0; i < kNumPingChecks; ++i) {
+    EXPECT_TRUE(ch.FindNextPingableConnection() != nullptr);
+  }
+}
@@ -14,6 +14,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "webrtc/p2p/base/candidate.h"
@@ -35,6 +36,13 @@ namespace cricket {
 class Connection;
 class ConnectionRequest;
 
+// Hash functor allowing rtc::SocketAddress to key unordered containers.
+struct SocketAddressHash {
+  size_t operator()(const rtc::SocketAddress& address) const {
+    return address.Hash();
+  }
+};
+
 extern const char LOCAL_PORT_TYPE[];
 extern const char STUN_PORT_TYPE[];
 extern const char PRFLX_PORT_TYPE[];
@@ -211,8 +219,11 @@ class Port : public PortInterface, public rtc::MessageHandler,
   sigslot::signal1<Port*> SignalPortError;
 
   // Returns a map containing all of the connections of this port, keyed by the
-  // remote address.
-  typedef std::map<rtc::SocketAddress, Connection*> AddressMap;
+  // remote address. The map is hashed since it is consulted for every packet
+  // received on the port; iteration order is unspecified.
+  typedef std::unordered_map<rtc::SocketAddress,
+                             Connection*,
+                             SocketAddressHash> AddressMap;
   const AddressMap& connections() { return connections_; }
 
   // Returns the connection to the given address or NULL if none exists.
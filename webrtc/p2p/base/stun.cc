@@ -357,8 +357,40 @@ bool StunMessage::Read(ByteBuffer* buf) {
 }
 
 bool StunMessage::Write(ByteBuffer* buf) const {
+  return WriteInternal(buf, 0);
+}
+
+bool StunMessage::WriteWithByteStringAttribute(ByteBuffer* buf,
+                                               int type,
+                                               const char* data,
+                                               size_t size) const {
+  if (GetAttributeValueType(type) != STUN_VALUE_BYTE_STRING) {
+    return false;
+  }
+  size_t padded_size = size;
+  if (padded_size % 4 != 0) {
+    padded_size += (4 - (padded_size % 4));
+  }
+  size_t extra_length = padded_size + 4;
+  if (size > 0xFFFF || length_ + extra_length > 0xFFFF) {
+    return false;
+  }
+
+  if (!WriteInternal(buf, extra_length))
+    return false;
+  buf->WriteUInt16(static_cast<uint16_t>(type));
+  buf->WriteUInt16(static_cast<uint16_t>(size));
+  buf->WriteBytes(data, size);
+  if (padded_size > size) {
+    char zeroes[4] = {0};
+    buf->WriteBytes(zeroes, padded_size - size);
+  }
+  return true;
+}
+
+bool StunMessage::WriteInternal(ByteBuffer* buf, size_t extra_length) const {
   buf->WriteUInt16(type_);
-  buf->WriteUInt16(length_);
+  buf->WriteUInt16(static_cast<uint16_t>(length_ + extra_length));
   if (!IsLegacy())
     buf->WriteUInt32(kStunMagicCookie);
   buf->WriteString(transaction_id_);
@@ -186,6 +186,18 @@ class StunMessage {
   // this was successful.
   bool Write(rtc::ByteBuffer* buf) const;
 
+  // Writes this object into a STUN packet followed by one more byte string
+  // attribute of the given |type| holding |data|. The result is the same as
+  // adding a StunByteStringAttribute and calling Write(), but |data| is copied
+  // only once, straight into |buf|. Meant for large payloads such as the DATA
+  // attribute of TURN send indications. No attribute may need to follow the
+  // trailing one, so this can't be combined with MESSAGE-INTEGRITY or
+  // FINGERPRINT.
+  bool WriteWithByteStringAttribute(rtc::ByteBuffer* buf,
+                                    int type,
+                                    const char* data,
+                                    size_t size) const;
+
   // Creates an empty message. Overridable by derived classes.
   virtual StunMessage* CreateNew() const { return new StunMessage(); }
 
@@ -197,6 +209,9 @@ class StunMessage {
   StunAttribute* CreateAttribute(int type, size_t length) /* const*/;
   const StunAttribute* GetAttribute(int type) const;
   static bool IsValidTransactionId(const std::string& transaction_id);
+  // Writes the header, with |extra_length| added to the message length, and
+  // all attributes.
+  bool WriteInternal(rtc::ByteBuffer* buf, size_t extra_length) const;
 
   uint16_t type_;
   uint16_t length_;
@@ -18,6 +18,7 @@
 #include "webrtc/base/messagedigest.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/socketaddress.h"
+#include "webrtc/base/timeutils.h"
 
 namespace cricket {
 
@@ -1444,4 +1445,84 @@ TEST_F(StunTest, ReadRelayMessage) {
   EXPECT_EQ(0, memcmp(outstring2.c_str(), input, len2));
 }
 
+// Test that writing a trailing byte string attribute directly gives the same
+// bytes as adding it to the message first, for every amount of padding.
+TEST_F(StunTest, WriteWithByteStringAttribute) {
+  const rtc::SocketAddress peer_addr("1.2.3.4", 5678);
+  const std::string payload(1200, 'x');
+  for (size_t size : {0, 1, 2, 3, 4, 5, 1200}) {
+    TurnMessage msg;
+    msg.SetType(TURN_SEND_INDICATION);
+    msg.SetTransactionID("0123456789ab");
+    EXPECT_TRUE(msg.AddAttribute(
+        new StunXorAddressAttribute(STUN_ATTR_XOR_PEER_ADDRESS, peer_addr)));
+    rtc::ByteBuffer direct;
+    EXPECT_TRUE(msg.WriteWithByteStringAttribute(&direct, STUN_ATTR_DATA,
+                                                 payload.data(), size));
+
+    EXPECT_TRUE(msg.AddAttribute(
+        new StunByteStringAttribute(STUN_ATTR_DATA, payload.data(), size)));
+    rtc::ByteBuffer expected;
+    EXPECT_TRUE(msg.Write(&expected));
+    ASSERT_EQ(expected.Length(), direct.Length()) << "size=" << size;
+    EXPECT_EQ(0, memcmp(expected.Data(), direct.Data(), expected.Length()));
+
+    TurnMessage parsed;
+    EXPECT_TRUE(parsed.Read(&direct));
+    const StunByteStringAttribute* data = parsed.GetByteString(STUN_ATTR_DATA);
+    ASSERT_TRUE(data != NULL);
+    EXPECT_EQ(payload.substr(0, size), data->GetString());
+  }
+
+  // Attributes that are not byte strings are rejected.
+  TurnMessage msg;
+  msg.SetType(TURN_SEND_INDICATION);
+  rtc::ByteBuffer buf;
+  EXPECT_FALSE(msg.WriteWithByteStringAttribute(&buf, STUN_ATTR_LIFETIME,
+                                                payload.data(), 4));
+}
+
+// Compares serializing TURN send indications by adding the DATA attribute
+// with writing it directly into a reused buffer. The timings are logged, so
+// this is disabled by default.
+TEST_F(StunTest, DISABLED_SendIndicationSerializationPerf) {
+  const int kNumMessages = 10000;
+  const rtc::SocketAddress peer_addr("1.2.3.4", 5678);
+  const std::string payload(1200, 'x');
+  size_t total_bytes = 0;
+
+  uint32_t start = rtc::Time();
+  for (int i = 0; i < kNumMessages; ++i) {
+    TurnMessage msg;
+    msg.SetType(TURN_SEND_INDICATION);
+    msg.SetTransactionID("0123456789ab");
+    msg.AddAttribute(
+        new StunXorAddressAttribute(STUN_ATTR_XOR_PEER_ADDRESS, peer_addr));
+    msg.AddAttribute(new StunByteStringAttribute(
+        STUN_ATTR_DATA, payload.data(), payload.size()));
+    rtc::ByteBuffer buf;
+    msg.Write(&buf);
+    total_bytes += buf.Length();
+  }
+  LOG(LS_INFO) << "Write with attribute copy: " << rtc::TimeSince(start)
+               << " ms for " << kNumMessages << " messages";
+
+  rtc::ByteBuffer reused;
+  start = rtc::Time();
+  for (int i = 0; i < kNumMessages; ++i) {
+    TurnMessage msg;
+    msg.SetType(TURN_SEND_INDICATION);
+    msg.SetTransactionID("0123456789ab");
+    msg.AddAttribute(
+        new StunXorAddressAttribute(STUN_ATTR_XOR_PEER_ADDRESS, peer_addr));
+    reused.Clear();
+    msg.WriteWithByteStringAttribute(&reused, STUN_ATTR_DATA, payload.data(),
+                                     payload.size());
+    total_bytes -= reused.Length();
+  }
+  LOG(LS_INFO) << "Direct write into reused buffer: " << rtc::TimeSince(start)
+               << " ms for " << kNumMessages << " messages";
+  EXPECT_EQ(0U, total_bytes);
+}
+
 }  // namespace cricket
@@ -1396,18 +1396,19 @@ void TurnEntry::SendChannelBindRequest(int delay) {
 
 int TurnEntry::Send(const void* data, size_t size, bool payload,
                     const rtc::PacketOptions& options) {
-  rtc::ByteBuffer buf;
+  rtc::ByteBuffer* buf = &port_->send_buffer_;
+  buf->Clear();
   if (state_ != STATE_BOUND) {
     // If we haven't bound the channel yet, we have to use a Send Indication.
+    // The payload is written straight into |buf| as the DATA attribute.
     TurnMessage msg;
     msg.SetType(TURN_SEND_INDICATION);
     msg.SetTransactionID(
         rtc::CreateRandomString(kStunTransactionIdLength));
     VERIFY(msg.AddAttribute(new StunXorAddressAttribute(
         STUN_ATTR_XOR_PEER_ADDRESS, ext_addr_)));
-    VERIFY(msg.AddAttribute(new StunByteStringAttribute(
-        STUN_ATTR_DATA, data, size)));
-    VERIFY(msg.Write(&buf));
+    VERIFY(msg.WriteWithByteStringAttribute(
+        buf, STUN_ATTR_DATA, reinterpret_cast<const char*>(data), size));
 
     // If we're sending real data, request a channel bind that we can use later.
     if (state_ == STATE_UNBOUND && payload) {
@@ -1416,11 +1417,11 @@ int TurnEntry::Send(const void* data, size_t size, bool payload,
     }
   } else {
     // If the channel is bound, we can send the data as a Channel Message.
-    buf.WriteUInt16(channel_id_);
-    buf.WriteUInt16(static_cast<uint16_t>(size));
-    buf.WriteBytes(reinterpret_cast<const char*>(data), size);
+    buf->WriteUInt16(channel_id_);
+    buf->WriteUInt16(static_cast<uint16_t>(size));
+    buf->WriteBytes(reinterpret_cast<const char*>(data), size);
   }
-  return port_->Send(buf.Data(), buf.Length(), options);
+  return port_->Send(buf->Data(), buf->Length(), options);
 }
 
 void TurnEntry::OnCreatePermissionSuccess() {
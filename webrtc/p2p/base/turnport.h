@@ -18,6 +18,7 @@
 
 #include "webrtc/base/asyncinvoker.h"
 #include "webrtc/base/asyncpacketsocket.h"
+#include "webrtc/base/bytebuffer.h"
 #include "webrtc/p2p/base/port.h"
 #include "webrtc/p2p/client/basicportallocator.h"
 
@@ -262,6 +263,9 @@ class TurnPort : public Port {
 
   int next_channel_number_;
   EntryList entries_;
+  // Reused by all entries to frame outgoing data, so that sending does not
+  // allocate once the buffer has grown to the largest packet size.
+  rtc::ByteBuffer send_buffer_;
 
   PortState state_;
   // By default the value will be set to 0. This value will be used in
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INCLUDE_ROW_BAND_WORKERS_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INCLUDE_ROW_BAND_WORKERS_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/scoped_ptr.h"
+
+namespace webrtc {
+
+// A fixed set of threads that process the bands of a frame in parallel. The
+// threads are started once and wait between frames, so splitting the work of
+// each frame costs a few wake-ups rather than thread creation. Not thread
+// safe; Run() must be called from one thread at a time.
+class RowBandWorkers {
+ public:
+  typedef void (*BandFunction)(void* obj, int band);
+
+  // |num_threads| includes the thread calling Run(), so a single thread
+  // starts no workers and runs everything inline. The workers are named
+  // |thread_name| and run at |priority|, which should match the priority of
+  // the thread calling Run() since that thread waits for them.
+  RowBandWorkers(int num_threads,
+                 const char* thread_name,
+                 rtc::ThreadPriority priority);
+  ~RowBandWorkers();
+
+  int num_threads() const { return static_cast<int>(workers_.size()) + 1; }
+
+  // Calls |func(obj, band)| for every band in [0, num_bands) and returns when
+  // all calls are done. Bands are handed out in order to whichever thread is
+  // free, the calling thread included.
+  void Run(BandFunction func, void* obj, int num_bands);
+
+ private:
+  struct Worker {
+    explicit Worker(RowBandWorkers* parent);
+    RowBandWorkers* const parent;
+    rtc::Event start;
+    rtc::scoped_ptr<rtc::PlatformThread> thread;
+  };
+
+  static bool WorkerThread(void* obj);
+  // Processes bands until none are left.
+  void RunBands();
+
+  std::vector<Worker*> workers_;
+  bool stopping_;
+  rtc::Event done_;
+
+  // Current job, valid while Run() is running.
+  BandFunction func_;
+  void* obj_;
+  int num_bands_;
+  volatile int next_band_;
+  volatile int pending_workers_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RowBandWorkers);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_INCLUDE_ROW_BAND_WORKERS_H_
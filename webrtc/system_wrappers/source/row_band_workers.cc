@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/include/row_band_workers.h"
+
+#include <algorithm>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+
+RowBandWorkers::Worker::Worker(RowBandWorkers* parent)
+    : parent(parent), start(false, false) {}
+
+RowBandWorkers::RowBandWorkers(int num_threads,
+                               const char* thread_name,
+                               rtc::ThreadPriority priority)
+    : stopping_(false),
+      done_(false, false),
+      func_(nullptr),
+      obj_(nullptr),
+      num_bands_(0),
+      next_band_(0),
+      pending_workers_(0) {
+  RTC_DCHECK_GT(num_threads, 0);
+  for (int i = 1; i < num_threads; ++i) {
+    Worker* worker = new Worker(this);
+    worker->thread.reset(
+        new rtc::PlatformThread(&WorkerThread, worker, thread_name));
+    worker->thread->Start();
+    worker->thread->SetPriority(priority);
+    workers_.push_back(worker);
+  }
+}
+
+RowBandWorkers::~RowBandWorkers() {
+  stopping_ = true;
+  for (Worker* worker : workers_) {
+    worker->start.Set();
+    worker->thread->Stop();
+    delete worker;
+  }
+}
+
+void RowBandWorkers::Run(BandFunction func, void* obj, int num_bands) {
+  func_ = func;
+  obj_ = obj;
+  num_bands_ = num_bands;
+  next_band_ = 0;
+  // No point in waking up more workers than there are bands to share.
+  const int num_workers =
+      std::min(static_cast<int>(workers_.size()), num_bands - 1);
+  if (num_workers > 0) {
+    pending_workers_ = num_workers;
+    for (int i = 0; i < num_workers; ++i)
+      workers_[i]->start.Set();
+  }
+  RunBands();
+  if (num_workers > 0)
+    done_.Wait(rtc::Event::kForever);
+}
+
+bool RowBandWorkers::WorkerThread(void* obj) {
+  Worker* worker = static_cast<Worker*>(obj);
+  RowBandWorkers* parent = worker->parent;
+  worker->start.Wait(rtc::Event::kForever);
+  if (parent->stopping_)
+    return false;
+  parent->RunBands();
+  if (rtc::AtomicOps::Decrement(&parent->pending_workers_) == 0)
+    parent->done_.Set();
+  return true;
+}
+
+void RowBandWorkers::RunBands() {
+  int band;
+  while ((band = rtc::AtomicOps::Increment(&next_band_) - 1) < num_bands_)
+    func_(obj_, band);
+}
+
+}  // namespace webrtc
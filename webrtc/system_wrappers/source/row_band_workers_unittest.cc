@@ -0,0 +1,41 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include "webrtc/system_wrappers/include/row_band_workers.h"
+
+namespace webrtc {
+namespace {
+
+const int kMaxBands = 16;
+
+void CountBand(void* obj, int band) {
+  ++static_cast<int*>(obj)[band];
+}
+
+TEST(RowBandWorkersTest, RunsEveryBandOnce) {
+  for (int num_threads = 1; num_threads <= 4; ++num_threads) {
+    RowBandWorkers workers(num_threads, "RowBandWorkersTest",
+                           rtc::kNormalPriority);
+    EXPECT_EQ(num_threads, workers.num_threads());
+    // Workers are reused from one run to the next, with more or fewer bands
+    // than threads.
+    for (int num_bands = 1; num_bands <= kMaxBands; ++num_bands) {
+      int counts[kMaxBands] = {0};
+      workers.Run(&CountBand, counts, num_bands);
+      for (int band = 0; band < kMaxBands; ++band)
+        EXPECT_EQ(band < num_bands ? 1 : 0, counts[band]);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -37,6 +37,7 @@
         'include/metrics.h',
         'include/ntp_time.h',
         'include/ref_count.h',
+        'include/row_band_workers.h',
         'include/rtp_to_ntp.h',
         'include/rw_lock_wrapper.h',
         'include/scoped_vector.h',
@@ -81,6 +82,7 @@
         'source/logcat_trace_context.cc',
         'source/logging.cc',
         'source/rtp_to_ntp.cc',
+        'source/row_band_workers.cc',
         'source/rw_lock.cc',
         'source/rw_lock_generic.cc',
         'source/rw_lock_generic.h',
@@ -31,6 +31,7 @@
         'source/data_log_c_helpers_unittest.h',
         'source/ntp_time_unittest.cc',
         'source/rtp_to_ntp_unittest.cc',
+        'source/row_band_workers_unittest.cc',
         'source/scoped_vector_unittest.cc',
         'source/stringize_macros_unittest.cc',
         'source/stl_util_unittest.cc',
@@ -118,6 +118,7 @@ class MockVoiceEngine : public VoiceEngineImpl {
   MOCK_METHOD0(audio_transport, AudioTransport*());
   MOCK_METHOD2(AssociateSendChannel,
                int(int channel, int accociate_send_channel));
+  MOCK_METHOD0(CaptureDeadlineMisses, int());
 
   // VoECodec
   MOCK_METHOD0(NumOfCodecs, int());
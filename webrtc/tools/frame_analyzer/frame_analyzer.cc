@@ -37,7 +37,7 @@
  * Usage:
  * frame_analyzer --label=<test_label> --reference_file=<name_of_file>
  * --test_file=<name_of_file> --stats_file=<name_of_file> --width=<frame_width>
- * --height=<frame_height>
+ * --height=<frame_height> [--threads=<number_of_threads>]
  */
 int main(int argc, char** argv) {
   std::string program_name = argv[0];
@@ -55,7 +55,9 @@ int main(int argc, char** argv) {
       "  - reference_file(string): The reference YUV file to compare against."
       " Default: ref.yuv\n"
       "  - test_file(string): The test YUV file to run the analysis for."
-      " Default: test_file.yuv\n";
+      " Default: test_file.yuv\n"
+      "  - threads(int): The number of threads comparing frames, or 0 for one"
+      " per core. Default: 0\n";
 
   webrtc::test::CommandLineParser parser;
 
@@ -69,6 +71,7 @@ int main(int argc, char** argv) {
   parser.SetFlag("stats_file", "stats.txt");
   parser.SetFlag("reference_file", "ref.yuv");
   parser.SetFlag("test_file", "test.yuv");
+  parser.SetFlag("threads", "0");
   parser.SetFlag("help", "false");
 
   parser.ProcessFlags();
@@ -91,6 +94,7 @@ int main(int argc, char** argv) {
   webrtc::test::RunAnalysis(parser.GetFlag("reference_file").c_str(),
                             parser.GetFlag("test_file").c_str(),
                             parser.GetFlag("stats_file").c_str(), width, height,
+                            strtol(parser.GetFlag("threads").c_str(), NULL, 10),
                             &results);
 
   std::string label = parser.GetFlag("label");
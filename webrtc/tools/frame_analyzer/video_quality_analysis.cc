@@ -13,13 +13,29 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
-
+#include <string.h>
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
 #include <string>
 
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
+
 #define STATS_LINE_LENGTH 32
 #define Y4M_FILE_HEADER_MAX_SIZE 200
 #define Y4M_FRAME_DELIMITER "FRAME"
 #define Y4M_FRAME_HEADER_SIZE 6
+#define Y4M_FILE_MAGIC "YUV4MPEG2"
 
 namespace webrtc {
 namespace test {
@@ -222,24 +238,220 @@ double CalculateMetrics(VideoAnalysisMetricsType video_metrics_type,
   return result;
 }
 
+I420FileMapping::I420FileMapping()
+    : data_(nullptr),
+      size_(0)
+#if defined(WEBRTC_WIN)
+      ,
+      file_handle_(INVALID_HANDLE_VALUE),
+      mapping_handle_(nullptr)
+#endif
+{
+}
+
+I420FileMapping::~I420FileMapping() {
+  Close();
+}
+
+bool I420FileMapping::Open(const char* file_name, int width, int height) {
+  Close();
+  if (width <= 0 || height <= 0)
+    return false;
+
+#if defined(WEBRTC_WIN)
+  file_handle_ = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  LARGE_INTEGER file_size;
+  if (file_handle_ == INVALID_HANDLE_VALUE ||
+      !GetFileSizeEx(file_handle_, &file_size)) {
+    fprintf(stderr, "Couldn't open input file for reading: %s\n", file_name);
+    Close();
+    return false;
+  }
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  if (size_ > 0) {
+    mapping_handle_ = CreateFileMapping(file_handle_, nullptr, PAGE_READONLY, 0,
+                                        0, nullptr);
+    if (mapping_handle_) {
+      data_ = static_cast<const uint8_t*>(
+          MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+    }
+  }
+#else
+  int fd = open(file_name, O_RDONLY);
+  struct stat file_stat;
+  if (fd < 0 || fstat(fd, &file_stat) != 0) {
+    fprintf(stderr, "Couldn't open input file for reading: %s\n", file_name);
+    if (fd >= 0)
+      close(fd);
+    return false;
+  }
+  size_ = static_cast<size_t>(file_stat.st_size);
+  if (size_ > 0) {
+    void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED)
+      data_ = static_cast<const uint8_t*>(data);
+  }
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+#endif
+  if (size_ > 0 && !data_) {
+    fprintf(stderr, "Couldn't map input file: %s\n", file_name);
+    Close();
+    return false;
+  }
+
+  const size_t frame_size = GetI420FrameSize(width, height);
+  const size_t magic_length = strlen(Y4M_FILE_MAGIC);
+  if (size_ >= magic_length && memcmp(data_, Y4M_FILE_MAGIC, magic_length) == 0)
+    return FindY4mFrames(frame_size);
+
+  // A trailing partial frame is ignored, as when reading frame by frame.
+  for (size_t offset = 0; offset + frame_size <= size_; offset += frame_size)
+    frames_.push_back(data_ + offset);
+  return true;
+}
+
+// YUV4MPEG2, a.k.a. Y4M File format has a file header and a frame header. The
+// file header has the aspect: "YUV4MPEG2 C420 W640 H360 Ip F30:1 A1:1". Each
+// frame is preceded by a "FRAME" header, which may carry parameters of its
+// own, ended by a newline.
+bool I420FileMapping::FindY4mFrames(size_t frame_size) {
+  const uint8_t* end = data_ + size_;
+  const uint8_t* pos =
+      static_cast<const uint8_t*>(memchr(data_, '\n', size_));
+  const size_t delimiter_length = strlen(Y4M_FRAME_DELIMITER);
+  while (pos && ++pos < end) {
+    if (static_cast<size_t>(end - pos) < delimiter_length ||
+        memcmp(pos, Y4M_FRAME_DELIMITER, delimiter_length) != 0) {
+      fprintf(stderr, "Corrupted Y4M file, could not find \"FRAME\" at offset "
+              "%u\n", static_cast<unsigned int>(pos - data_));
+      Close();
+      return false;
+    }
+    pos = static_cast<const uint8_t*>(memchr(pos, '\n', end - pos));
+    if (!pos || static_cast<size_t>(end - pos - 1) < frame_size)
+      break;
+    frames_.push_back(pos + 1);
+    pos += frame_size;
+  }
+  return true;
+}
+
+void I420FileMapping::Close() {
+  frames_.clear();
+#if defined(WEBRTC_WIN)
+  if (data_)
+    UnmapViewOfFile(data_);
+  if (mapping_handle_)
+    CloseHandle(mapping_handle_);
+  if (file_handle_ != INVALID_HANDLE_VALUE)
+    CloseHandle(file_handle_);
+  mapping_handle_ = nullptr;
+  file_handle_ = INVALID_HANDLE_VALUE;
+#else
+  if (data_)
+    munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+  data_ = nullptr;
+  size_ = 0;
+}
+
+const uint8_t* I420FileMapping::GetFrame(int frame_number) const {
+  if (frame_number < 0 || frame_number >= number_of_frames())
+    return nullptr;
+  return frames_[frame_number];
+}
+
+namespace {
+
+// Shared by the threads of AnalyzeFrames(). Each thread claims the next frame
+// that nobody has started on and writes its result to the matching slot, so
+// the output does not depend on how the work was spread.
+struct AnalysisJob {
+  const std::vector<FrameToAnalyze>* frames;
+  int width;
+  int height;
+  volatile int next_frame;
+  AnalysisResult* results;
+};
+
+// Runs until all frames have been claimed, so a single call does all the
+// thread's work.
+bool AnalyzeFramesThread(void* obj) {
+  AnalysisJob* job = static_cast<AnalysisJob*>(obj);
+  const int num_frames = static_cast<int>(job->frames->size());
+  int i;
+  while ((i = rtc::AtomicOps::Increment(&job->next_frame) - 1) < num_frames) {
+    const FrameToAnalyze& frame = (*job->frames)[i];
+    job->results[i] = AnalysisResult(
+        frame.frame_number,
+        CalculateMetrics(kPSNR, frame.reference_frame, frame.test_frame,
+                         job->width, job->height),
+        CalculateMetrics(kSSIM, frame.reference_frame, frame.test_frame,
+                         job->width, job->height));
+  }
+  return false;
+}
+
+}  // namespace
+
+void AnalyzeFrames(const std::vector<FrameToAnalyze>& frames,
+                   int width,
+                   int height,
+                   int num_threads,
+                   ResultsContainer* results) {
+  if (frames.empty())
+    return;
+  if (num_threads <= 0)
+    num_threads = CpuInfo::DetectNumberOfCores();
+  num_threads = std::max(1, std::min(num_threads,
+                                     static_cast<int>(frames.size())));
+
+  const size_t first_result = results->frames.size();
+  results->frames.resize(first_result + frames.size());
+  AnalysisJob job;
+  job.frames = &frames;
+  job.width = width;
+  job.height = height;
+  job.next_frame = 0;
+  job.results = &results->frames[first_result];
+
+  // The calling thread takes a share of the frames as well.
+  std::vector<rtc::PlatformThread*> threads;
+  for (int i = 1; i < num_threads; ++i) {
+    threads.push_back(new rtc::PlatformThread(&AnalyzeFramesThread, &job,
+                                              "FrameAnalyzer"));
+    threads.back()->Start();
+  }
+  AnalyzeFramesThread(&job);
+  for (rtc::PlatformThread* thread : threads) {
+    thread->Stop();
+    delete thread;
+  }
+}
+
 void RunAnalysis(const char* reference_file_name, const char* test_file_name,
                  const char* stats_file_name, int width, int height,
-                 ResultsContainer* results) {
-  // Check if the reference_file_name ends with "y4m".
-  bool y4m_mode = false;
-  if (std::string(reference_file_name).find("y4m") != std::string::npos) {
-    y4m_mode = true;
+                 int num_threads, ResultsContainer* results) {
+  I420FileMapping reference_file;
+  I420FileMapping test_file;
+  if (!reference_file.Open(reference_file_name, width, height) ||
+      !test_file.Open(test_file_name, width, height)) {
+    return;
   }
 
-  int size = GetI420FrameSize(width, height);
   FILE* stats_file = fopen(stats_file_name, "r");
+  if (stats_file == NULL) {
+    fprintf(stderr, "Couldn't open stats file for reading: %s\n",
+            stats_file_name);
+    return;
+  }
 
   // String buffer for the lines in the stats file.
   char line[STATS_LINE_LENGTH];
 
-  // Allocate buffers for test and reference frames.
-  uint8_t* test_frame = new uint8_t[size];
-  uint8_t* reference_frame = new uint8_t[size];
+  std::vector<FrameToAnalyze> frames;
   int previous_frame_number = -1;
 
   // While there are entries in the stats file.
@@ -257,37 +469,25 @@ void RunAnalysis(const char* reference_file_name, const char* test_file_name,
     assert(extracted_test_frame != -1);
     assert(decoded_frame_number != -1);
 
-    ExtractFrameFromYuvFile(test_file_name, width, height, extracted_test_frame,
-                            test_frame);
-    if (y4m_mode) {
-      ExtractFrameFromY4mFile(reference_file_name, width, height,
-                              decoded_frame_number, reference_frame);
-    } else {
-      ExtractFrameFromYuvFile(reference_file_name, width, height,
-                              decoded_frame_number, reference_frame);
+    const uint8_t* test_frame = test_file.GetFrame(extracted_test_frame);
+    const uint8_t* reference_frame =
+        reference_file.GetFrame(decoded_frame_number);
+    if (!test_frame || !reference_frame) {
+      fprintf(stdout, "Missing frame %d in %s or frame %d in %s\n",
+              extracted_test_frame, test_file_name, decoded_frame_number,
+              reference_file_name);
+      continue;
     }
-
-    // Calculate the PSNR and SSIM.
-    double result_psnr = CalculateMetrics(kPSNR, reference_frame, test_frame,
-                                          width, height);
-    double result_ssim = CalculateMetrics(kSSIM, reference_frame, test_frame,
-                                          width, height);
-
     previous_frame_number = decoded_frame_number;
 
-    // Fill in the result struct.
-    AnalysisResult result;
-    result.frame_number = decoded_frame_number;
-    result.psnr_value = result_psnr;
-    result.ssim_value = result_ssim;
-
-    results->frames.push_back(result);
+    // Comparing is left until all frames are known, so it can be spread over
+    // several threads.
+    frames.push_back(
+        FrameToAnalyze(decoded_frame_number, reference_frame, test_frame));
   }
-
-  // Cleanup.
   fclose(stats_file);
-  delete[] test_frame;
-  delete[] reference_frame;
+
+  AnalyzeFrames(frames, width, height, num_threads, results);
 }
 
 void PrintMaxRepeatedAndSkippedFrames(const std::string& label,
@@ -16,6 +16,7 @@
 
 #include "libyuv/compare.h"  // NOLINT
 #include "libyuv/convert.h"  // NOLINT
+#include "webrtc/base/constructormagic.h"
 
 namespace webrtc {
 namespace test {
@@ -40,6 +41,60 @@ struct ResultsContainer {
 
 enum VideoAnalysisMetricsType {kPSNR, kSSIM};
 
+// Read-only access to the I420 frames of a raw YUV or a Y4M file. The file is
+// memory mapped rather than read, so frames can be handed to several threads
+// at once without copying them.
+class I420FileMapping {
+ public:
+  I420FileMapping();
+  ~I420FileMapping();
+
+  // Maps |file_name|, holding frames of |width| x |height|. Y4M files are
+  // recognized by their header. Returns false if the file can't be mapped or
+  // is not a valid Y4M file.
+  bool Open(const char* file_name, int width, int height);
+  void Close();
+
+  int number_of_frames() const { return static_cast<int>(frames_.size()); }
+  // Returns frame |frame_number|, or null if there is no such frame.
+  const uint8_t* GetFrame(int frame_number) const;
+
+ private:
+  bool FindY4mFrames(size_t frame_size);
+
+  const uint8_t* data_;
+  size_t size_;
+  std::vector<const uint8_t*> frames_;
+#if defined(WEBRTC_WIN)
+  void* file_handle_;
+  void* mapping_handle_;
+#endif
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(I420FileMapping);
+};
+
+// A reference and a test frame to compute PSNR and SSIM for. |frame_number|
+// is what the result is reported as.
+struct FrameToAnalyze {
+  FrameToAnalyze(int frame_number,
+                 const uint8_t* reference_frame,
+                 const uint8_t* test_frame)
+      : frame_number(frame_number),
+        reference_frame(reference_frame),
+        test_frame(test_frame) {}
+  int frame_number;
+  const uint8_t* reference_frame;
+  const uint8_t* test_frame;
+};
+
+// Computes PSNR and SSIM for all of |frames|, spread over |num_threads|
+// threads (all cores if 0), and appends the results in the order of |frames|.
+void AnalyzeFrames(const std::vector<FrameToAnalyze>& frames,
+                   int width,
+                   int height,
+                   int num_threads,
+                   ResultsContainer* results);
+
 // A function to run the PSNR and SSIM analysis on the test file. The test file
 // comprises the frames that were captured during the quality measurement test.
 // There may be missing or duplicate frames. Also the frames start at a random
@@ -53,9 +108,10 @@ enum VideoAnalysisMetricsType {kPSNR, kSSIM};
 // tools/barcode_tools/barcode_decoder.py. This script decodes the barcodes
 // integrated in every video and generates the stats file. If three was some
 // problem with the decoding there would be 'Barcode error' instead of yyyy.
+// The frames are compared on |num_threads| threads, or all cores if 0.
 void RunAnalysis(const char* reference_file_name, const char* test_file_name,
                  const char* stats_file_name, int width, int height,
-                 ResultsContainer* results);
+                 int num_threads, ResultsContainer* results);
 
 // Compute PSNR or SSIM for an I420 frame (all planes). When we are calculating
 // PSNR values, the max return value (in the case where the test and reference
@@ -11,10 +11,15 @@
 // This test doesn't actually verify the output since it's just printed
 // to stdout by void functions, but it's still useful as it executes the code.
 
+#include <stdlib.h>
+
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/test/testsupport/fileutils.h"
 #include "webrtc/tools/frame_analyzer/video_quality_analysis.h"
 
@@ -86,6 +91,180 @@ TEST_F(VideoQualityAnalysisTest, PrintMaxRepeatedAndSkippedFramesNormalFile) {
   PrintMaxRepeatedAndSkippedFrames(logfile_, "NormalStatsFile", stats_filename);
 }
 
+TEST_F(VideoQualityAnalysisTest, MapYuvFile) {
+  const int kWidth = 5;
+  const int kHeight = 3;
+  const int kFrameSize = GetI420FrameSize(kWidth, kHeight);
+  std::string filename = OutputPath() + "mapped.yuv";
+  std::ofstream file(filename.c_str(), std::ios::binary);
+  for (int i = 0; i < 3; ++i)
+    file << std::string(kFrameSize, static_cast<char>(i));
+  // A partial frame at the end is not returned.
+  file << std::string(kFrameSize / 2, 'x');
+  file.close();
+
+  I420FileMapping mapping;
+  ASSERT_TRUE(mapping.Open(filename.c_str(), kWidth, kHeight));
+  ASSERT_EQ(3, mapping.number_of_frames());
+  for (int i = 0; i < 3; ++i) {
+    const uint8_t* frame = mapping.GetFrame(i);
+    ASSERT_TRUE(frame != nullptr);
+    EXPECT_EQ(i, frame[0]);
+    EXPECT_EQ(i, frame[kFrameSize - 1]);
+  }
+  EXPECT_TRUE(mapping.GetFrame(3) == nullptr);
+  EXPECT_TRUE(mapping.GetFrame(-1) == nullptr);
+  remove(filename.c_str());
+}
+
+TEST_F(VideoQualityAnalysisTest, MapY4mFile) {
+  const int kWidth = 4;
+  const int kHeight = 2;
+  const int kFrameSize = GetI420FrameSize(kWidth, kHeight);
+  std::string filename = OutputPath() + "mapped.y4m";
+  std::ofstream file(filename.c_str(), std::ios::binary);
+  file << "YUV4MPEG2 W4 H2 F30:1 C420\n";
+  file << "FRAME\n" << std::string(kFrameSize, 'a');
+  // Frame headers may have parameters.
+  file << "FRAME Ip\n" << std::string(kFrameSize, 'b');
+  file << "FRAME\n" << std::string(kFrameSize, 'c');
+  file.close();
+
+  I420FileMapping mapping;
+  ASSERT_TRUE(mapping.Open(filename.c_str(), kWidth, kHeight));
+  ASSERT_EQ(3, mapping.number_of_frames());
+  EXPECT_EQ(std::string(kFrameSize, 'a'),
+            std::string(reinterpret_cast<const char*>(mapping.GetFrame(0)),
+                        kFrameSize));
+  EXPECT_EQ(std::string(kFrameSize, 'b'),
+            std::string(reinterpret_cast<const char*>(mapping.GetFrame(1)),
+                        kFrameSize));
+  EXPECT_EQ(std::string(kFrameSize, 'c'),
+            std::string(reinterpret_cast<const char*>(mapping.GetFrame(2)),
+                        kFrameSize));
+  remove(filename.c_str());
+}
+
+TEST_F(VideoQualityAnalysisTest, MapNonExistingFile) {
+  I420FileMapping mapping;
+  EXPECT_FALSE(mapping.Open((OutputPath() + "non-existing.yuv").c_str(), 4, 2));
+  EXPECT_EQ(0, mapping.number_of_frames());
+}
+
+TEST_F(VideoQualityAnalysisTest, AnalyzeFramesInParallelKeepsOrder) {
+  const int kWidth = 32;
+  const int kHeight = 16;
+  const int kNumFrames = 20;
+  const int kFrameSize = GetI420FrameSize(kWidth, kHeight);
+  std::vector<uint8_t> reference(kNumFrames * kFrameSize);
+  std::vector<uint8_t> test(kNumFrames * kFrameSize);
+  srand(1234);
+  for (size_t i = 0; i < reference.size(); ++i) {
+    reference[i] = static_cast<uint8_t>(rand());
+    test[i] = static_cast<uint8_t>(reference[i] + rand() % 8);
+  }
+  std::vector<FrameToAnalyze> frames;
+  for (int i = 0; i < kNumFrames; ++i) {
+    frames.push_back(FrameToAnalyze(100 + i, &reference[i * kFrameSize],
+                                    &test[i * kFrameSize]));
+  }
+
+  ResultsContainer results;
+  AnalyzeFrames(frames, kWidth, kHeight, 4, &results);
+  ASSERT_EQ(static_cast<size_t>(kNumFrames), results.frames.size());
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(100 + i, results.frames[i].frame_number);
+    EXPECT_EQ(CalculateMetrics(kPSNR, frames[i].reference_frame,
+                               frames[i].test_frame, kWidth, kHeight),
+              results.frames[i].psnr_value);
+    EXPECT_EQ(CalculateMetrics(kSSIM, frames[i].reference_frame,
+                               frames[i].test_frame, kWidth, kHeight),
+              results.frames[i].ssim_value);
+  }
+}
+
+TEST_F(VideoQualityAnalysisTest, RunAnalysisSkipsMissingFrames) {
+  const int kWidth = 4;
+  const int kHeight = 2;
+  const int kFrameSize = GetI420FrameSize(kWidth, kHeight);
+  std::string reference_filename = OutputPath() + "missing_reference.yuv";
+  std::string test_filename = OutputPath() + "missing_test.yuv";
+  std::string stats_filename = OutputPath() + "missing_stats.txt";
+  std::ofstream reference_file(reference_filename.c_str(), std::ios::binary);
+  std::ofstream test_file(test_filename.c_str(), std::ios::binary);
+  for (int i = 0; i < 3; ++i) {
+    reference_file << std::string(kFrameSize, static_cast<char>(i));
+    test_file << std::string(kFrameSize, static_cast<char>(i));
+  }
+  reference_file.close();
+  test_file.close();
+  std::ofstream stats_file(stats_filename.c_str());
+  stats_file << "frame_0000 0000\n";
+  // Neither file has a frame 5.
+  stats_file << "frame_0001 0005\n";
+  stats_file << "frame_0005 0001\n";
+  stats_file << "frame_0002 0002\n";
+  stats_file.close();
+
+  ResultsContainer results;
+  RunAnalysis(reference_filename.c_str(), test_filename.c_str(),
+              stats_filename.c_str(), kWidth, kHeight, 1, &results);
+  ASSERT_EQ(2u, results.frames.size());
+  EXPECT_EQ(0, results.frames[0].frame_number);
+  EXPECT_EQ(2, results.frames[1].frame_number);
+  remove(reference_filename.c_str());
+  remove(test_filename.c_str());
+  remove(stats_filename.c_str());
+}
+
+// Not a strict test; logs the time taken to compare a clip with itself,
+// reading it frame by frame and from a mapping compared on all cores.
+TEST_F(VideoQualityAnalysisTest, DISABLED_CompareClipWithItselfTime) {
+  const int kWidth = 352;
+  const int kHeight = 288;
+  const std::string filename = ResourcePath("foreman_cif", "yuv");
+  I420FileMapping mapping;
+  ASSERT_TRUE(mapping.Open(filename.c_str(), kWidth, kHeight));
+  const int num_frames = mapping.number_of_frames();
+
+  int64_t start_us = rtc::TimeMicros();
+  std::vector<uint8_t> reference_frame(GetI420FrameSize(kWidth, kHeight));
+  std::vector<uint8_t> test_frame(reference_frame.size());
+  ResultsContainer read_results;
+  for (int i = 0; i < num_frames; ++i) {
+    ASSERT_TRUE(ExtractFrameFromYuvFile(filename.c_str(), kWidth, kHeight, i,
+                                        &reference_frame[0]));
+    ASSERT_TRUE(ExtractFrameFromYuvFile(filename.c_str(), kWidth, kHeight, i,
+                                        &test_frame[0]));
+    read_results.frames.push_back(AnalysisResult(
+        i, CalculateMetrics(kPSNR, &reference_frame[0], &test_frame[0], kWidth,
+                            kHeight),
+        CalculateMetrics(kSSIM, &reference_frame[0], &test_frame[0], kWidth,
+                         kHeight)));
+  }
+  int64_t read_time_us = rtc::TimeMicros() - start_us;
+
+  start_us = rtc::TimeMicros();
+  std::vector<FrameToAnalyze> frames;
+  for (int i = 0; i < num_frames; ++i) {
+    frames.push_back(
+        FrameToAnalyze(i, mapping.GetFrame(i), mapping.GetFrame(i)));
+  }
+  ResultsContainer mapped_results;
+  AnalyzeFrames(frames, kWidth, kHeight, 0, &mapped_results);
+  int64_t mapped_time_us = rtc::TimeMicros() - start_us;
+
+  ASSERT_EQ(read_results.frames.size(), mapped_results.frames.size());
+  for (size_t i = 0; i < read_results.frames.size(); ++i) {
+    EXPECT_EQ(read_results.frames[i].psnr_value,
+              mapped_results.frames[i].psnr_value);
+    EXPECT_EQ(read_results.frames[i].ssim_value,
+              mapped_results.frames[i].ssim_value);
+  }
+  LOG(LS_INFO) << "Compared " << num_frames << " frames in " << read_time_us
+               << " us reading the file, " << mapped_time_us
+               << " us mapped and in parallel.";
+}
 
 }  // namespace test
 }  // namespace webrtc
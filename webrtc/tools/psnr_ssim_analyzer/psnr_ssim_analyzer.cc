@@ -8,10 +8,10 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
@@ -19,48 +19,34 @@
 #include "webrtc/tools/frame_analyzer/video_quality_analysis.h"
 #include "webrtc/tools/simple_command_line_parser.h"
 
-#define MAX_NUM_FRAMES_PER_FILE INT_MAX
-
 void CompareFiles(const char* reference_file_name, const char* test_file_name,
-                  const char* results_file_name, int width, int height) {
-  // Check if the reference_file_name ends with "y4m".
-  bool y4m_mode = false;
-  if (std::string(reference_file_name).find("y4m") != std::string::npos) {
-    y4m_mode = true;
+                  const char* results_file_name, int width, int height,
+                  int num_threads) {
+  webrtc::test::I420FileMapping reference_file;
+  webrtc::test::I420FileMapping test_file;
+  if (!reference_file.Open(reference_file_name, width, height) ||
+      !test_file.Open(test_file_name, width, height)) {
+    return;
   }
 
-  FILE* results_file = fopen(results_file_name, "w");
-
-  int size = webrtc::test::GetI420FrameSize(width, height);
-
-  // Allocate buffers for test and reference frames.
-  uint8_t* test_frame = new uint8_t[size];
-  uint8_t* ref_frame = new uint8_t[size];
-
-  bool read_result = true;
-  for (int frame_counter = 0; frame_counter < MAX_NUM_FRAMES_PER_FILE;
-      ++frame_counter) {
-    read_result &= (y4m_mode) ? webrtc::test::ExtractFrameFromY4mFile(
-        reference_file_name, width, height, frame_counter, ref_frame):
-        webrtc::test::ExtractFrameFromYuvFile(reference_file_name, width,
-                                              height, frame_counter, ref_frame);
-    read_result &=  webrtc::test::ExtractFrameFromYuvFile(test_file_name, width,
-        height, frame_counter, test_frame);
+  std::vector<webrtc::test::FrameToAnalyze> frames;
+  int num_frames =
+      std::min(reference_file.number_of_frames(), test_file.number_of_frames());
+  for (int frame_counter = 0; frame_counter < num_frames; ++frame_counter) {
+    frames.push_back(webrtc::test::FrameToAnalyze(
+        frame_counter, reference_file.GetFrame(frame_counter),
+        test_file.GetFrame(frame_counter)));
+  }
 
-    if (!read_result)
-      break;
+  // Calculate the PSNR and SSIM.
+  webrtc::test::ResultsContainer results;
+  webrtc::test::AnalyzeFrames(frames, width, height, num_threads, &results);
 
-    // Calculate the PSNR and SSIM.
-    double result_psnr = webrtc::test::CalculateMetrics(
-        webrtc::test::kPSNR, ref_frame, test_frame, width, height);
-    double result_ssim = webrtc::test::CalculateMetrics(
-        webrtc::test::kSSIM, ref_frame, test_frame, width, height);
-    fprintf(results_file, "Frame: %d, PSNR: %f, SSIM: %f\n", frame_counter,
-            result_psnr, result_ssim);
+  FILE* results_file = fopen(results_file_name, "w");
+  for (const webrtc::test::AnalysisResult& result : results.frames) {
+    fprintf(results_file, "Frame: %d, PSNR: %f, SSIM: %f\n",
+            result.frame_number, result.psnr_value, result.ssim_value);
   }
-  delete[] test_frame;
-  delete[] ref_frame;
-
   fclose(results_file);
 }
 
@@ -78,7 +64,7 @@ void CompareFiles(const char* reference_file_name, const char* test_file_name,
  * Usage:
  * psnr_ssim_analyzer --reference_file=<name_of_file> --test_file=<name_of_file>
  * --results_file=<name_of_file> --width=<width_of_frames>
- * --height=<height_of_frames>
+ * --height=<height_of_frames> [--threads=<number_of_threads>]
  */
 int main(int argc, char** argv) {
   std::string program_name = argv[0];
@@ -96,7 +82,9 @@ int main(int argc, char** argv) {
       "  - test_file(string): The test YUV file to run the analysis for."
       " Default: test_file.yuv\n"
       "  - results_file(string): The full name of the file where the results "
-      "will be written. Default: results.txt\n";
+      "will be written. Default: results.txt\n"
+      "  - threads(int): The number of threads comparing frames, or 0 for one"
+      " per core. Default: 0\n";
 
   webrtc::test::CommandLineParser parser;
 
@@ -110,6 +98,7 @@ int main(int argc, char** argv) {
   parser.SetFlag("reference_file", "ref.yuv");
   parser.SetFlag("test_file", "test.yuv");
   parser.SetFlag("results_file", "results.txt");
+  parser.SetFlag("threads", "0");
   parser.SetFlag("help", "false");
 
   parser.ProcessFlags();
@@ -129,5 +118,6 @@ int main(int argc, char** argv) {
 
   CompareFiles(parser.GetFlag("reference_file").c_str(),
                parser.GetFlag("test_file").c_str(),
-               parser.GetFlag("results_file").c_str(), width, height);
+               parser.GetFlag("results_file").c_str(), width, height,
+               strtol(parser.GetFlag("threads").c_str(), NULL, 10));
 }
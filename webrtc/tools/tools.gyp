@@ -16,6 +16,7 @@
       'type': 'static_library',
       'dependencies': [
         '<(webrtc_root)/common_video/common_video.gyp:common_video',
+        '<(webrtc_root)/system_wrappers/system_wrappers.gyp:system_wrappers',
       ],
       'export_dependent_settings': [
         '<(webrtc_root)/common_video/common_video.gyp:common_video',
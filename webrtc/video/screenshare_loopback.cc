@@ -94,6 +94,14 @@ std::string GraphTitle() {
   return static_cast<std::string>(FLAGS_graph_title);
 }
 
+DEFINE_int32(analyzer_threads,
+             0,
+             "Number of threads comparing frames. If 0, picked from the number "
+             "of cores.");
+int AnalyzerThreads() {
+  return static_cast<int>(FLAGS_analyzer_threads);
+}
+
 DEFINE_int32(loss_percent, 0, "Percentage of packets randomly lost.");
 int LossPercent() {
   return static_cast<int>(FLAGS_loss_percent);
@@ -228,7 +236,7 @@ void Loopback() {
       {},  // Video specific.
       {true, flags::SlideChangeInterval(), flags::ScrollDuration()},
       {"screenshare", 0.0, 0.0, flags::DurationSecs(), flags::OutputFilename(),
-       flags::GraphTitle()},
+       flags::GraphTitle(), flags::AnalyzerThreads()},
       pipe_config,
       flags::FLAGS_logs};
 
@@ -96,6 +96,14 @@ std::string GraphTitle() {
   return static_cast<std::string>(FLAGS_graph_title);
 }
 
+DEFINE_int32(analyzer_threads,
+             0,
+             "Number of threads comparing frames. If 0, picked from the number "
+             "of cores.");
+int AnalyzerThreads() {
+  return static_cast<int>(FLAGS_analyzer_threads);
+}
+
 DEFINE_int32(loss_percent, 0, "Percentage of packets randomly lost.");
 int LossPercent() {
   return static_cast<int>(FLAGS_loss_percent);
@@ -217,7 +225,7 @@ void Loopback() {
       {flags::Clip()},
       {},  // Screenshare specific.
       {"video", 0.0, 0.0, flags::DurationSecs(), flags::OutputFilename(),
-       flags::GraphTitle()},
+       flags::GraphTitle(), flags::AnalyzerThreads()},
       pipe_config,
       flags::FLAGS_logs};
 
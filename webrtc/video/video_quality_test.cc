@@ -22,6 +22,7 @@
 #include "webrtc/base/event.h"
 #include "webrtc/base/format_macros.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/call.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_header_parser.h"
@@ -39,6 +40,13 @@ namespace webrtc {
 static const int kSendStatsPollingIntervalMs = 1000;
 static const int kPayloadTypeVP8 = 123;
 static const int kPayloadTypeVP9 = 124;
+// Upper bound on comparisons waiting for an analyzer thread. Frames rendered
+// while the queue is full are still used for the timing stats, but are not
+// copied and compared, so a slow analyzer can't back up into the call.
+static const size_t kMaxComparisons = 10;
+// Share of the comparisons that may be skipped for the PSNR and SSIM results
+// to still count.
+static const int kMaxSkippedComparisonsPercent = 25;
 
 class VideoAnalyzer : public PacketReceiver,
                       public Transport,
@@ -54,7 +62,8 @@ class VideoAnalyzer : public PacketReceiver,
                 int duration_frames,
                 FILE* graph_data_output_file,
                 const std::string& graph_title,
-                uint32_t ssrc_to_analyze)
+                uint32_t ssrc_to_analyze,
+                int num_comparison_threads)
       : input_(nullptr),
         transport_(transport),
         receiver_(nullptr),
@@ -67,6 +76,7 @@ class VideoAnalyzer : public PacketReceiver,
         frames_recorded_(0),
         frames_processed_(0),
         dropped_frames_(0),
+        skipped_comparisons_(0),
         last_render_time_(0),
         rtp_timestamp_delta_(0),
         avg_psnr_threshold_(avg_psnr_threshold),
@@ -76,24 +86,27 @@ class VideoAnalyzer : public PacketReceiver,
         done_(false, false) {
     // Create thread pool for CPU-expensive PSNR/SSIM calculations.
 
-    // Try to use about as many threads as cores, but leave kMinCoresLeft alone,
-    // so that we don't accidentally starve "real" worker threads (codec etc).
-    // Also, don't allocate more than kMaxComparisonThreads, even if there are
-    // spare cores.
+    // Unless told otherwise, try to use about as many threads as cores, but
+    // leave kMinCoresLeft alone, so that we don't accidentally starve "real"
+    // worker threads (codec etc). Also, don't allocate more than
+    // kMaxComparisonThreads, even if there are spare cores.
 
-    uint32_t num_cores = CpuInfo::DetectNumberOfCores();
-    RTC_DCHECK_GE(num_cores, 1u);
-    static const uint32_t kMinCoresLeft = 4;
-    static const uint32_t kMaxComparisonThreads = 8;
+    uint32_t num_threads = static_cast<uint32_t>(num_comparison_threads);
+    if (num_comparison_threads <= 0) {
+      num_threads = CpuInfo::DetectNumberOfCores();
+      RTC_DCHECK_GE(num_threads, 1u);
+      static const uint32_t kMinCoresLeft = 4;
+      static const uint32_t kMaxComparisonThreads = 8;
 
-    if (num_cores <= kMinCoresLeft) {
-      num_cores = 1;
-    } else {
-      num_cores -= kMinCoresLeft;
-      num_cores = std::min(num_cores, kMaxComparisonThreads);
+      if (num_threads <= kMinCoresLeft) {
+        num_threads = 1;
+      } else {
+        num_threads -= kMinCoresLeft;
+        num_threads = std::min(num_threads, kMaxComparisonThreads);
+      }
     }
 
-    for (uint32_t i = 0; i < num_cores; ++i) {
+    for (uint32_t i = 0; i < num_threads; ++i) {
       rtc::PlatformThread* thread =
           new rtc::PlatformThread(&FrameComparisonThread, this, "Analyzer");
       thread->Start();
@@ -266,34 +279,27 @@ class VideoAnalyzer : public PacketReceiver,
  private:
   struct FrameComparison {
     FrameComparison()
-        : dropped(false),
+        : has_frames(false),
+          dropped(false),
+          input_time_ms(0),
           send_time_ms(0),
           recv_time_ms(0),
           render_time_ms(0),
-          encoded_frame_size(0) {}
-
-    FrameComparison(const VideoFrame& reference,
-                    const VideoFrame& render,
-                    bool dropped,
-                    int64_t send_time_ms,
-                    int64_t recv_time_ms,
-                    int64_t render_time_ms,
-                    size_t encoded_frame_size)
-        : reference(reference),
-          render(render),
-          dropped(dropped),
-          send_time_ms(send_time_ms),
-          recv_time_ms(recv_time_ms),
-          render_time_ms(render_time_ms),
-          encoded_frame_size(encoded_frame_size) {}
+          encoded_frame_size(0),
+          queued_time_us(0) {}
 
+    // If |has_frames| is false, the frames were not copied because the queue
+    // was full, and only the timing stats are updated for this comparison.
     VideoFrame reference;
     VideoFrame render;
+    bool has_frames;
     bool dropped;
+    int64_t input_time_ms;
     int64_t send_time_ms;
     int64_t recv_time_ms;
     int64_t render_time_ms;
     size_t encoded_frame_size;
+    int64_t queued_time_us;
   };
 
   struct Sample {
@@ -342,18 +348,69 @@ class VideoAnalyzer : public PacketReceiver,
     if (it != encoded_frame_sizes_.end())
       encoded_frame_sizes_.erase(it);
 
-    VideoFrame reference_copy;
-    VideoFrame render_copy;
-    reference_copy.CopyFrame(reference);
-    render_copy.CopyFrame(render);
+    FrameComparison comparison;
+    comparison.dropped = dropped;
+    comparison.input_time_ms = reference.ntp_time_ms();
+    comparison.send_time_ms = send_time_ms;
+    comparison.recv_time_ms = recv_time_ms;
+    comparison.render_time_ms = render_time_ms;
+    comparison.encoded_frame_size = encoded_size;
+
+    {
+      rtc::CritScope crit(&comparison_lock_);
+      comparison.has_frames = comparisons_.size() < kMaxComparisons;
+      if (comparison.has_frames) {
+        TakePooledFrame(&comparison.reference);
+        TakePooledFrame(&comparison.render);
+      }
+    }
+
+    // Copy into frames from the pool, so that the copies normally reuse
+    // buffers of earlier comparisons instead of allocating.
+    if (comparison.has_frames) {
+      int64_t copy_start_us = rtc::TimeMicros();
+      comparison.reference.CopyFrame(reference);
+      comparison.render.CopyFrame(render);
+      comparison.queued_time_us = rtc::TimeMicros();
+      rtc::CritScope crit(&comparison_lock_);
+      frame_copy_time_us_.AddSample(comparison.queued_time_us - copy_start_us);
+    } else {
+      comparison.queued_time_us = rtc::TimeMicros();
+    }
 
     rtc::CritScope crit(&comparison_lock_);
-    comparisons_.push_back(FrameComparison(reference_copy, render_copy, dropped,
-                                           send_time_ms, recv_time_ms,
-                                           render_time_ms, encoded_size));
+    comparisons_.push_back(comparison);
     comparison_available_event_.Set();
   }
 
+  void TakePooledFrame(VideoFrame* frame)
+      EXCLUSIVE_LOCKS_REQUIRED(comparison_lock_) {
+    if (frame_pool_.empty())
+      return;
+    frame->ShallowCopy(frame_pool_.back());
+    frame_pool_.pop_back();
+  }
+
+  // Gives the frames of a finished comparison back to the pool. The pool never
+  // needs to hold more frames than can be in flight at once.
+  void ReturnFramesToPool(const FrameComparison& comparison) {
+    if (!comparison.has_frames)
+      return;
+    rtc::CritScope crit(&comparison_lock_);
+    ReturnFrameToPool(comparison.reference);
+    ReturnFrameToPool(comparison.render);
+  }
+
+  void ReturnFrameToPool(const VideoFrame& frame)
+      EXCLUSIVE_LOCKS_REQUIRED(comparison_lock_) {
+    const size_t max_pool_size =
+        2 * (kMaxComparisons + comparison_thread_pool_.size());
+    if (frame.IsZeroSize() || frame_pool_.size() >= max_pool_size)
+      return;
+    frame_pool_.push_back(VideoFrame());
+    frame_pool_.back().ShallowCopy(frame);
+  }
+
   static bool PollStatsThread(void* obj) {
     return static_cast<VideoAnalyzer*>(obj)->PollStats();
   }
@@ -401,6 +458,7 @@ class VideoAnalyzer : public PacketReceiver,
     }
 
     PerformFrameComparison(comparison);
+    ReturnFramesToPool(comparison);
 
     if (FrameProcessed()) {
       PrintResults();
@@ -468,27 +526,52 @@ class VideoAnalyzer : public PacketReceiver,
     PrintResult("encode_time", encode_time_ms, " ms");
     PrintResult("encode_usage_percent", encode_usage_percent, " percent");
     PrintResult("media_bitrate", media_bitrate_bps, " bps");
+    // Cost of the analyzer itself, to tell if it is distorting the results.
+    PrintResult("analyzer_frame_copy_time", frame_copy_time_us_, " us");
+    PrintResult("analyzer_queue_time", queue_time_us_, " us");
+    PrintResult("analyzer_compare_time", compare_time_us_, " us");
+    printf("RESULT analyzer_skipped_comparisons: %s = %d frames\n",
+           test_label_.c_str(), skipped_comparisons_);
 
     EXPECT_GT(psnr_.Mean(), avg_psnr_threshold_);
     EXPECT_GT(ssim_.Mean(), avg_ssim_threshold_);
+    // The means only describe the call if most of its frames were compared.
+    EXPECT_LE(100 * skipped_comparisons_,
+              kMaxSkippedComparisonsPercent * frames_processed_)
+        << "The analyzer fell behind and skipped " << skipped_comparisons_
+        << " of " << frames_processed_ << " comparisons.";
   }
 
   void PerformFrameComparison(const FrameComparison& comparison) {
+    int64_t start_us = rtc::TimeMicros();
     // Perform expensive psnr and ssim calculations while not holding lock.
-    double psnr = I420PSNR(&comparison.reference, &comparison.render);
-    double ssim = I420SSIM(&comparison.reference, &comparison.render);
+    double psnr = -1.0;
+    double ssim = -1.0;
+    if (comparison.has_frames) {
+      psnr = I420PSNR(&comparison.reference, &comparison.render);
+      ssim = I420SSIM(&comparison.reference, &comparison.render);
+    }
+    int64_t compare_time_us = rtc::TimeMicros() - start_us;
 
-    int64_t input_time_ms = comparison.reference.ntp_time_ms();
+    int64_t input_time_ms = comparison.input_time_ms;
 
     rtc::CritScope crit(&comparison_lock_);
-    if (graph_data_output_file_) {
+    queue_time_us_.AddSample(start_us - comparison.queued_time_us);
+    // Skipped comparisons have no PSNR or SSIM, so they are left out of the
+    // graph data rather than plotted as values.
+    if (graph_data_output_file_ && comparison.has_frames) {
       samples_.push_back(
           Sample(comparison.dropped, input_time_ms, comparison.send_time_ms,
                  comparison.recv_time_ms, comparison.render_time_ms,
                  comparison.encoded_frame_size, psnr, ssim));
     }
-    psnr_.AddSample(psnr);
-    ssim_.AddSample(ssim);
+    if (comparison.has_frames) {
+      compare_time_us_.AddSample(compare_time_us);
+      psnr_.AddSample(psnr);
+      ssim_.AddSample(ssim);
+    } else {
+      ++skipped_comparisons_;
+    }
 
     if (comparison.dropped) {
       ++dropped_frames_;
@@ -577,11 +660,15 @@ class VideoAnalyzer : public PacketReceiver,
   test::Statistics encode_time_ms GUARDED_BY(comparison_lock_);
   test::Statistics encode_usage_percent GUARDED_BY(comparison_lock_);
   test::Statistics media_bitrate_bps GUARDED_BY(comparison_lock_);
+  test::Statistics frame_copy_time_us_ GUARDED_BY(comparison_lock_);
+  test::Statistics queue_time_us_ GUARDED_BY(comparison_lock_);
+  test::Statistics compare_time_us_ GUARDED_BY(comparison_lock_);
 
   const int frames_to_process_;
   int frames_recorded_;
   int frames_processed_;
   int dropped_frames_;
+  int skipped_comparisons_;
   int64_t last_render_time_;
   uint32_t rtp_timestamp_delta_;
 
@@ -600,6 +687,7 @@ class VideoAnalyzer : public PacketReceiver,
   rtc::PlatformThread stats_polling_thread_;
   rtc::Event comparison_available_event_;
   std::deque<FrameComparison> comparisons_ GUARDED_BY(comparison_lock_);
+  std::vector<VideoFrame> frame_pool_ GUARDED_BY(comparison_lock_);
   rtc::Event done_;
 };
 
@@ -962,7 +1050,8 @@ void VideoQualityTest::RunWithAnalyzer(const Params& params) {
       disable_quality_check ? -1.1 : params_.analyzer.avg_ssim_threshold,
       params_.analyzer.test_durations_secs * params_.common.fps,
       graph_data_output_file, graph_title,
-      kSendSsrcs[params_.ss.selected_stream]);
+      kSendSsrcs[params_.ss.selected_stream],
+      params_.analyzer.num_comparison_threads);
 
   analyzer.SetReceiver(receiver_call_->Receiver());
   send_transport.SetReceiver(&analyzer);
@@ -56,6 +56,7 @@ class VideoQualityTest : public test::CallTest {
       int test_durations_secs;
       std::string graph_data_output_filename;
       std::string graph_title;
+      int num_comparison_threads;  // If 0, picked from the number of cores.
     } analyzer;
     FakeNetworkPipe::Config pipe;
     bool logs;
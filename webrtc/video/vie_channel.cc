@@ -120,10 +120,12 @@ ViEChannel::ViEChannel(uint32_t number_of_cores,
       rtt_sum_ms_(0),
       last_rtt_ms_(0),
       num_rtts_(0),
+      rtcp_report_coalescer_(transport),
       rtp_rtcp_modules_(
           CreateRtpRtcpModules(!sender,
                                vie_receiver_.GetReceiveStatistics(),
                                transport,
+                               &rtcp_report_coalescer_,
                                intra_frame_observer_,
                                bandwidth_observer_.get(),
                                transport_feedback_observer_,
@@ -147,6 +149,9 @@ int32_t ViEChannel::Init() {
 
   // RTP/RTCP initialization.
   module_process_thread_->RegisterModule(rtp_rtcp_modules_[0]);
+  // Registered after the first module so that its reports usually go out in
+  // the same pass of the process thread.
+  module_process_thread_->RegisterModule(&rtcp_report_coalescer_);
 
   rtp_rtcp_modules_[0]->SetKeyFrameRequestMethod(kKeyFrameReqPliRtcp);
   if (paced_sender_) {
@@ -187,6 +192,7 @@ ViEChannel::~ViEChannel() {
     module_process_thread_->DeRegisterModule(rtp_rtcp);
     delete rtp_rtcp;
   }
+  module_process_thread_->DeRegisterModule(&rtcp_report_coalescer_);
   if (!sender_)
     StopDecodeThread();
   // Release modules.
@@ -1079,6 +1085,7 @@ std::vector<RtpRtcp*> ViEChannel::CreateRtpRtcpModules(
     bool receiver_only,
     ReceiveStatistics* receive_statistics,
     Transport* outgoing_transport,
+    Transport* rtcp_report_transport,
     RtcpIntraFrameObserver* intra_frame_callback,
     RtcpBandwidthObserver* bandwidth_callback,
     TransportFeedbackObserver* transport_feedback_callback,
@@ -1098,6 +1105,7 @@ std::vector<RtpRtcp*> ViEChannel::CreateRtpRtcpModules(
   configuration.receiver_only = receiver_only;
   configuration.receive_statistics = receive_statistics;
   configuration.outgoing_transport = outgoing_transport;
+  configuration.rtcp_report_transport = rtcp_report_transport;
   configuration.intra_frame_callback = intra_frame_callback;
   configuration.rtt_stats = rtt_stats;
   configuration.rtcp_packet_type_counter_observer =
@@ -19,6 +19,7 @@
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
+#include "webrtc/modules/rtp_rtcp/include/rtcp_coalescing_transport.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/video_coding/include/video_coding_defines.h"
@@ -289,6 +290,7 @@ class ViEChannel : public VCMFrameTypeCallback,
       bool receiver_only,
       ReceiveStatistics* receive_statistics,
       Transport* outgoing_transport,
+      Transport* rtcp_report_transport,
       RtcpIntraFrameObserver* intra_frame_callback,
       RtcpBandwidthObserver* bandwidth_callback,
       TransportFeedbackObserver* transport_feedback_callback,
@@ -443,6 +445,9 @@ class ViEChannel : public VCMFrameTypeCallback,
   int64_t last_rtt_ms_ GUARDED_BY(crit_);
   size_t num_rtts_ GUARDED_BY(crit_);
 
+  // Merges the periodic RTCP reports of the simulcast modules into one packet.
+  RtcpCoalescingTransport rtcp_report_coalescer_;
+
   // RtpRtcp modules, declared last as they use other members on construction.
   const std::vector<RtpRtcp*> rtp_rtcp_modules_;
   size_t num_active_rtp_rtcp_modules_ GUARDED_BY(crit_);
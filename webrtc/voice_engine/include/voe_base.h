@@ -185,6 +185,10 @@ class WEBRTC_DLLEXPORT VoEBase {
   // 1 <- 2 <- 1.
   virtual int AssociateSendChannel(int channel, int accociate_send_channel) = 0;
 
+  // Gets the number of captured 10 ms frames that took longer than 10 ms to
+  // process and encode for all sending channels.
+  virtual int CaptureDeadlineMisses() = 0;
+
  protected:
   VoEBase() {}
   virtual ~VoEBase() {}
@@ -57,6 +57,9 @@ class WEBRTC_DLLEXPORT VoENetwork {
 
   // Installs and enables a user-defined external transport protocol for a
   // specified |channel|. Returns -1 in case of an error, 0 otherwise.
+  // With VoiceParallelEncode set to more than one thread, the transports of
+  // different channels are called from several threads at once, so a
+  // transport shared by channels must be thread safe.
   virtual int RegisterExternalTransport(int channel, Transport& transport) = 0;
 
   // Removes and disables a user-defined external transport protocol for a
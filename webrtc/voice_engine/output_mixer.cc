@@ -225,6 +225,11 @@ OutputMixer::SetAnonymousMixabilityStatus(MixerParticipant& participant,
     return _mixerModule.SetAnonymousMixabilityStatus(&participant, mixable);
 }
 
+void OutputMixer::SetNativeRateMixing(bool enable)
+{
+    _mixerModule.SetNativeRateMixing(enable);
+}
+
 int32_t
 OutputMixer::MixActiveChannels()
 {
@@ -63,6 +63,10 @@ public:
     int32_t SetAnonymousMixabilityStatus(MixerParticipant& participant,
                                          bool mixable);
 
+    // Fetches the channels' audio at its decoded rate and resamples only the
+    // channels that are mixed. See AudioConferenceMixer::SetNativeRateMixing.
+    void SetNativeRateMixing(bool enable);
+
     int GetMixedAudio(int sample_rate_hz, int num_channels,
                       AudioFrame* audioFrame);
 
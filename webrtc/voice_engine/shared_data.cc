@@ -10,6 +10,8 @@
 
 #include "webrtc/voice_engine/shared_data.h"
 
+#include "webrtc/common.h"
+#include "webrtc/config.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/include/trace.h"
@@ -34,12 +36,16 @@ SharedData::SharedData(const Config& config)
     if (OutputMixer::Create(_outputMixerPtr, _gInstanceCounter) == 0)
     {
         _outputMixerPtr->SetEngineInformation(_engineStatistics);
+        _outputMixerPtr->SetNativeRateMixing(
+            config.Get<VoiceNativeRateMixing>().enabled);
     }
     if (TransmitMixer::Create(_transmitMixerPtr, _gInstanceCounter) == 0)
     {
         _transmitMixerPtr->SetEngineInformation(*_moduleProcessThreadPtr,
                                                 _engineStatistics,
                                                 _channelManager);
+        _transmitMixerPtr->SetEncodeThreads(
+            config.Get<VoiceParallelEncode>().num_threads);
     }
     _audioDeviceLayer = AudioDeviceModule::kPlatformDefaultAudio;
 }
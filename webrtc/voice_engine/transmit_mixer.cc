@@ -10,11 +10,13 @@
 
 #include "webrtc/voice_engine/transmit_mixer.h"
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/format_macros.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/modules/utility/include/audio_frame_operations.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/include/event_wrapper.h"
+#include "webrtc/system_wrappers/include/tick_util.h"
 #include "webrtc/system_wrappers/include/trace.h"
 #include "webrtc/voice_engine/channel.h"
 #include "webrtc/voice_engine/channel_manager.h"
@@ -208,7 +210,10 @@ TransmitMixer::TransmitMixer(uint32_t instanceId) :
     _mute(false),
     _remainingMuteMicTimeMs(0),
     stereo_codec_(false),
-    swap_stereo_channels_(false)
+    swap_stereo_channels_(false),
+    encode_threads_(1),
+    capture_start_ms_(0),
+    capture_deadline_misses_(0)
 {
     WEBRTC_TRACE(kTraceMemory, kTraceVoice, VoEId(_instanceId, -1),
                  "TransmitMixer::TransmitMixer() - ctor");
@@ -300,6 +305,11 @@ TransmitMixer::SetAudioProcessingModule(AudioProcessing* audioProcessingModule)
     return 0;
 }
 
+void TransmitMixer::SetEncodeThreads(int num_threads) {
+  encode_threads_ = std::max(1, num_threads);
+  encode_workers_.reset();
+}
+
 void TransmitMixer::GetSendCodecInfo(int* max_sample_rate, int* max_channels) {
   *max_sample_rate = 8000;
   *max_channels = 1;
@@ -332,6 +342,8 @@ TransmitMixer::PrepareDemux(const void* audioSamples,
                  nSamples, nChannels, samplesPerSec, totalDelayMS, clockDrift,
                  currentMicLevel);
 
+    capture_start_ms_ = TickTime::MillisecondTimestamp();
+
     // --- Resample input audio and create/store the initial audio frame
     GenerateAudioFrame(static_cast<const int16_t*>(audioSamples),
                        nSamples,
@@ -452,26 +464,59 @@ TransmitMixer::EncodeAndSend()
     WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId, -1),
                  "TransmitMixer::EncodeAndSend()");
 
-    for (ChannelManager::Iterator it(_channelManagerPtr); it.IsValid();
-         it.Increment())
+    // The iterator keeps the channels alive until they are encoded.
+    ChannelManager::Iterator it(_channelManagerPtr);
+    for (; it.IsValid(); it.Increment())
     {
         Channel* channelPtr = it.GetChannel();
         if (channelPtr->Sending())
         {
-            channelPtr->EncodeAndSend();
+            encode_channels_.push_back(channelPtr);
         }
     }
+    EncodeChannels();
     return 0;
 }
 
 void TransmitMixer::EncodeAndSend(const int voe_channels[],
                                   int number_of_voe_channels) {
+  // Keeps the channels alive until they are encoded.
+  std::vector<voe::ChannelOwner> channels;
   for (int i = 0; i < number_of_voe_channels; ++i) {
     voe::ChannelOwner ch = _channelManagerPtr->GetChannel(voe_channels[i]);
     voe::Channel* channel_ptr = ch.channel();
-    if (channel_ptr && channel_ptr->Sending())
-      channel_ptr->EncodeAndSend();
+    if (channel_ptr && channel_ptr->Sending()) {
+      channels.push_back(ch);
+      encode_channels_.push_back(channel_ptr);
+    }
   }
+  EncodeChannels();
+}
+
+void TransmitMixer::EncodeChannels() {
+  const int num_channels = static_cast<int>(encode_channels_.size());
+  if (encode_threads_ > 1 && num_channels > 1) {
+    // Each channel has its own encoder and frame, so they can be encoded
+    // independently. The workers pick up the next channel when they are done.
+    if (!encode_workers_) {
+      // The capture thread waits for the workers, so they must not be
+      // preempted by anything it wouldn't be preempted by.
+      encode_workers_.reset(new RowBandWorkers(
+          encode_threads_, "VoEEncodeWorker", rtc::kRealtimePriority));
+    }
+    encode_workers_->Run(&EncodeChannel, this, num_channels);
+  } else {
+    for (Channel* channel : encode_channels_)
+      channel->EncodeAndSend();
+  }
+  encode_channels_.clear();
+
+  if (TickTime::MillisecondTimestamp() - capture_start_ms_ > 10)
+    rtc::AtomicOps::Increment(&capture_deadline_misses_);
+}
+
+void TransmitMixer::EncodeChannel(void* obj, int index) {
+  static_cast<TransmitMixer*>(obj)->encode_channels_[index]->EncodeAndSend();
 }
 
 uint32_t TransmitMixer::CaptureLevel() const
@@ -479,6 +524,10 @@ uint32_t TransmitMixer::CaptureLevel() const
     return _captureLevel;
 }
 
+int TransmitMixer::CaptureDeadlineMisses() const {
+  return rtc::AtomicOps::AcquireLoad(&capture_deadline_misses_);
+}
+
 void
 TransmitMixer::UpdateMuteMicrophoneTime(uint32_t lengthMs)
 {
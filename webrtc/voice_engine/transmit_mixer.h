@@ -11,6 +11,8 @@
 #ifndef WEBRTC_VOICE_ENGINE_TRANSMIT_MIXER_H
 #define WEBRTC_VOICE_ENGINE_TRANSMIT_MIXER_H
 
+#include <vector>
+
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/common_audio/resampler/include/push_resampler.h"
 #include "webrtc/common_types.h"
@@ -18,6 +20,7 @@
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/utility/include/file_player.h"
 #include "webrtc/modules/utility/include/file_recorder.h"
+#include "webrtc/system_wrappers/include/row_band_workers.h"
 #include "webrtc/voice_engine/include/voe_base.h"
 #include "webrtc/voice_engine/level_indicator.h"
 #include "webrtc/voice_engine/monitor_module.h"
@@ -32,6 +35,7 @@ class VoEMediaProcess;
 
 namespace voe {
 
+class Channel;
 class ChannelManager;
 class MixedAudio;
 class Statistics;
@@ -50,6 +54,10 @@ public:
     int32_t SetAudioProcessingModule(
         AudioProcessing* audioProcessingModule);
 
+    // Encodes the sending channels on up to |num_threads| threads, the
+    // capture thread included. See VoiceParallelEncode.
+    void SetEncodeThreads(int num_threads);
+
     int32_t PrepareDemux(const void* audioSamples,
                          size_t nSamples,
                          uint8_t  nChannels,
@@ -73,6 +81,10 @@ public:
     // Must be called on the same thread as PrepareDemux().
     uint32_t CaptureLevel() const;
 
+    // Number of captured 10 ms frames that took longer than 10 ms from
+    // PrepareDemux() to the end of EncodeAndSend().
+    int CaptureDeadlineMisses() const;
+
     int32_t StopSend();
 
     // VoEDtmf
@@ -184,6 +196,11 @@ private:
     void ProcessAudio(int delay_ms, int clock_drift, int current_mic_level,
                       bool key_pressed);
 
+    // Encodes |encode_channels_|, on |encode_workers_| if there are several,
+    // and counts a deadline miss if the frame took too long.
+    void EncodeChannels();
+    static void EncodeChannel(void* obj, int index);
+
 #ifdef WEBRTC_VOICE_ENGINE_TYPING_DETECTION
     void TypingDetection(bool keyPressed);
 #endif
@@ -229,6 +246,13 @@ private:
     int32_t _remainingMuteMicTimeMs;
     bool stereo_codec_;
     bool swap_stereo_channels_;
+
+    int encode_threads_;
+    rtc::scoped_ptr<RowBandWorkers> encode_workers_;
+    // The sending channels, valid during EncodeChannels().
+    std::vector<Channel*> encode_channels_;
+    int64_t capture_start_ms_;
+    volatile int capture_deadline_misses_;
 };
 
 }  // namespace voe
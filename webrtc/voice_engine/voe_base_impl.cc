@@ -823,4 +823,8 @@ int VoEBaseImpl::AssociateSendChannel(int channel,
   return 0;
 }
 
+int VoEBaseImpl::CaptureDeadlineMisses() {
+  return shared_->transmit_mixer()->CaptureDeadlineMisses();
+}
+
 }  // namespace webrtc
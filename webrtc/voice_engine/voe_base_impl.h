@@ -53,6 +53,8 @@ class VoEBaseImpl : public VoEBase,
 
   int AssociateSendChannel(int channel, int accociate_send_channel) override;
 
+  int CaptureDeadlineMisses() override;
+
   // AudioTransport
   int32_t RecordedDataIsAvailable(const void* audioSamples,
                                   const size_t nSamples,
@@ -11,12 +11,22 @@
 #include "webrtc/voice_engine/include/voe_base.h"
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common.h"
+#include "webrtc/config.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
+#include "webrtc/system_wrappers/include/sleep.h"
 #include "webrtc/voice_engine/channel_manager.h"
 #include "webrtc/voice_engine/shared_data.h"
 #include "webrtc/voice_engine/voice_engine_fixture.h"
 #include "webrtc/voice_engine/voice_engine_impl.h"
 
+using ::testing::_;
+using ::testing::AtLeast;
+using ::testing::DoAll;
+using ::testing::InvokeWithoutArgs;
+using ::testing::NiceMock;
+using ::testing::Return;
+
 namespace webrtc {
 
 class VoEBaseTest : public VoiceEngineFixture {};
@@ -84,4 +94,96 @@ TEST_F(VoEBaseTest, GetVersion) {
   std::string v2 = VoiceEngine::GetVersionString() + "\n";
   EXPECT_EQ(v2, v1);
 }
+
+// Every sending channel gets the captured audio, whether the channels are
+// encoded on the capture thread or on several threads.
+TEST(VoEBaseParallelEncodeTest, EncodesAllSendingChannels) {
+  const int kNumChannels = 6;
+  const size_t kSamplesPer10Ms = 160;
+  const int kThreads[] = {1, 4};
+  for (int num_threads : kThreads) {
+    Config config;
+    config.Set<VoiceParallelEncode>(new VoiceParallelEncode(num_threads));
+    VoiceEngine* voe = VoiceEngine::Create(config);
+    VoEBase* base = VoEBase::GetInterface(voe);
+    VoENetwork* network = VoENetwork::GetInterface(voe);
+    FakeAudioDeviceModule adm;
+    EXPECT_EQ(0, base->Init(&adm, nullptr));
+
+    NiceMock<MockTransport> transports[kNumChannels];
+    int channels[kNumChannels];
+    for (int i = 0; i < kNumChannels; ++i) {
+      channels[i] = base->CreateChannel();
+      ASSERT_NE(-1, channels[i]);
+      EXPECT_CALL(transports[i], SendRtp(_, _, _))
+          .Times(AtLeast(1))
+          .WillRepeatedly(Return(true));
+      EXPECT_EQ(0, network->RegisterExternalTransport(channels[i],
+                                                      transports[i]));
+      EXPECT_EQ(0, base->StartSend(channels[i]));
+    }
+
+    int16_t audio[kSamplesPer10Ms];
+    for (size_t i = 0; i < kSamplesPer10Ms; ++i)
+      audio[i] = static_cast<int16_t>(i * 100);
+    for (int frame = 0; frame < 10; ++frame) {
+      uint32_t new_mic_level = 0;
+      EXPECT_EQ(0, base->audio_transport()->RecordedDataIsAvailable(
+                       audio, kSamplesPer10Ms, sizeof(int16_t), 1, 16000, 0,
+                       0, 0, false, new_mic_level));
+    }
+
+    for (int i = 0; i < kNumChannels; ++i) {
+      EXPECT_EQ(0, base->StopSend(channels[i]));
+      EXPECT_EQ(0, network->DeRegisterExternalTransport(channels[i]));
+      EXPECT_EQ(0, base->DeleteChannel(channels[i]));
+    }
+    EXPECT_EQ(2, network->Release());
+    EXPECT_EQ(0, base->Terminate());
+    EXPECT_EQ(1, base->Release());
+    EXPECT_TRUE(VoiceEngine::Delete(voe));
+  }
+}
+
+// A transport that takes longer than a capture period to send makes every
+// frame that sends a packet miss its deadline.
+TEST(VoEBaseParallelEncodeTest, CountsCaptureDeadlineMisses) {
+  const size_t kSamplesPer10Ms = 160;
+  VoiceEngine* voe = VoiceEngine::Create();
+  VoEBase* base = VoEBase::GetInterface(voe);
+  VoENetwork* network = VoENetwork::GetInterface(voe);
+  FakeAudioDeviceModule adm;
+  EXPECT_EQ(0, base->Init(&adm, nullptr));
+  EXPECT_EQ(0, base->CaptureDeadlineMisses());
+
+  NiceMock<MockTransport> transport;
+  EXPECT_CALL(transport, SendRtp(_, _, _))
+      .Times(AtLeast(1))
+      .WillRepeatedly(DoAll(InvokeWithoutArgs([] { SleepMs(20); }),
+                            Return(true)));
+  const int channel = base->CreateChannel();
+  ASSERT_NE(-1, channel);
+  EXPECT_EQ(0, network->RegisterExternalTransport(channel, transport));
+  EXPECT_EQ(0, base->StartSend(channel));
+
+  int16_t audio[kSamplesPer10Ms];
+  for (size_t i = 0; i < kSamplesPer10Ms; ++i)
+    audio[i] = static_cast<int16_t>(i * 100);
+  for (int frame = 0; frame < 10; ++frame) {
+    uint32_t new_mic_level = 0;
+    EXPECT_EQ(0, base->audio_transport()->RecordedDataIsAvailable(
+                     audio, kSamplesPer10Ms, sizeof(int16_t), 1, 16000, 0, 0,
+                     0, false, new_mic_level));
+  }
+  EXPECT_GT(base->CaptureDeadlineMisses(), 0);
+
+  EXPECT_EQ(0, base->StopSend(channel));
+  EXPECT_EQ(0, network->DeRegisterExternalTransport(channel));
+  EXPECT_EQ(0, base->DeleteChannel(channel));
+  EXPECT_EQ(2, network->Release());
+  EXPECT_EQ(0, base->Terminate());
+  EXPECT_EQ(1, base->Release());
+  EXPECT_TRUE(VoiceEngine::Delete(voe));
+}
+
 }  // namespace webrtc